@@ -0,0 +1,109 @@
+#include "AdaptiveBufferController.h"
+#include <algorithm>
+
+void AdaptiveBufferController::configure(const Params& params, const AudioBufferConfig& start) {
+    AudioBufferConfig safe = start.clamped();
+
+    m_params = params;
+    m_params.minBufferFrames = std::clamp(m_params.minBufferFrames,
+                                          AudioBufferConfig::MIN_BUFFER_FRAMES, AudioBufferConfig::MAX_BUFFER_FRAMES);
+    m_params.maxBufferFrames = std::clamp(m_params.maxBufferFrames,
+                                          m_params.minBufferFrames, AudioBufferConfig::MAX_BUFFER_FRAMES);
+    m_params.maxBuffers = std::clamp(m_params.maxBuffers, AudioBufferConfig::MIN_BUFFERS, AudioBufferConfig::MAX_BUFFERS);
+    m_params.maxBufferFrames = std::max(m_params.maxBufferFrames, safe.playbackBufferFrames);
+    m_params.maxBuffers = std::max(m_params.maxBuffers, safe.playbackBuffers);
+
+    m_startFrames = std::clamp(safe.playbackBufferFrames, m_params.minBufferFrames, m_params.maxBufferFrames);
+    m_startBuffers = std::min(safe.playbackBuffers, m_params.maxBuffers);
+    reset();
+}
+
+void AdaptiveBufferController::reset() {
+    m_bufferFrames = m_startFrames;
+    m_bufferCount = m_startBuffers;
+    m_quietWindows = 0;
+    m_holding = false;
+    startWindow();
+}
+
+bool AdaptiveBufferController::onBlock(float load, bool underrun, double periodSeconds) {
+    ++m_windowBlocks;
+    m_windowElapsed += periodSeconds;
+    m_windowMaxLoad = std::max(m_windowMaxLoad, load);
+    if (load >= m_params.growLoad) {
+        ++m_windowHeavyBlocks;
+    }
+
+    // Audible trouble can't wait for the window to finish
+    if (!m_holding && (underrun || load >= 1.0f)) {
+        return grow();
+    }
+
+    if (m_windowElapsed < m_params.windowSeconds) {
+        return false;
+    }
+
+    // Window complete
+    bool heavy = m_windowHeavyBlocks > m_params.growFraction * m_windowBlocks;
+    bool quiet = m_windowMaxLoad < m_params.shrinkLoad;
+    bool wasHolding = m_holding;
+    m_holding = false;
+    startWindow();
+
+    if (wasHolding) {
+        return false;
+    }
+    if (heavy) {
+        return grow();
+    }
+
+    m_quietWindows = quiet ? m_quietWindows + 1 : 0;
+    if (m_quietWindows >= m_params.shrinkWindows) {
+        return shrink();
+    }
+    return false;
+}
+
+bool AdaptiveBufferController::grow() {
+    m_quietWindows = 0;
+    startWindow();
+
+    if (m_bufferFrames < m_params.maxBufferFrames) {
+        m_bufferFrames = std::min(m_bufferFrames * 2, m_params.maxBufferFrames);
+    }
+    else if (m_bufferCount < m_params.maxBuffers) {
+        ++m_bufferCount;
+    }
+    else {
+        return false;
+    }
+
+    m_holding = true;
+    return true;
+}
+
+bool AdaptiveBufferController::shrink() {
+    m_quietWindows = 0;
+
+    // Undo extra buffers first, then halve the size while above the target
+    if (m_bufferCount > m_startBuffers) {
+        --m_bufferCount;
+    }
+    else if (m_bufferFrames / 2 >= m_params.minBufferFrames &&
+             m_bufferCount * (m_bufferFrames / 2) >= m_params.targetLatencyFrames) {
+        m_bufferFrames /= 2;
+    }
+    else {
+        return false;
+    }
+
+    m_holding = true;
+    return true;
+}
+
+void AdaptiveBufferController::startWindow() {
+    m_windowElapsed = 0.0;
+    m_windowBlocks = 0;
+    m_windowHeavyBlocks = 0;
+    m_windowMaxLoad = 0.0f;
+}
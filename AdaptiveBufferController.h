@@ -0,0 +1,61 @@
+#pragma once
+#include "AudioBufferConfig.h"
+
+// Picks the playback buffer layout from measured callback load. Trouble (an
+// underrun, a late block, or too many heavily loaded blocks in a window) grows
+// the buffers straight away: size first, then count once size is at its
+// maximum. Several quiet windows in a row shrink back towards the starting
+// layout and the latency target. Each change is held for a window before the
+// next is considered so the measurements reflect the new layout.
+//
+// Pure logic with no timing of its own; the audio thread feeds it one call per
+// rendered block and applies the layout at the next buffer boundary.
+class AdaptiveBufferController {
+public:
+    struct Params {
+        int minBufferFrames = 256;
+        int maxBufferFrames = AudioBufferConfig::MAX_BUFFER_FRAMES;
+        int maxBuffers = 8;
+        int targetLatencyFrames = 2048;  // Output latency to shrink towards
+        float growLoad = 0.75f;          // Blocks at or above this count as heavy
+        float growFraction = 0.1f;       // Share of heavy blocks in a window that triggers growth
+        float shrinkLoad = 0.4f;         // Every block in a window must stay below this to shrink
+        double windowSeconds = 1.0;
+        int shrinkWindows = 5;           // Consecutive quiet windows before shrinking
+    };
+
+    // The limits are raised to the start layout if needed, so adapting never
+    // begins below what the user configured
+    void configure(const Params& params, const AudioBufferConfig& start);
+    void reset();
+
+    // One rendered block. Returns true when the layout changed.
+    bool onBlock(float load, bool underrun, double periodSeconds);
+
+    int getBufferFrames() const { return m_bufferFrames; }
+    int getBufferCount() const { return m_bufferCount; }
+    const Params& getParams() const { return m_params; }
+
+    // Largest layout this controller can ask for (for pre-allocating buffers)
+    int getMaxBufferFrames() const { return m_params.maxBufferFrames; }
+    int getMaxBufferCount() const { return m_params.maxBuffers; }
+
+private:
+    bool grow();
+    bool shrink();
+    void startWindow();
+
+    Params m_params;
+    int m_startFrames = 2048;
+    int m_startBuffers = 3;
+    int m_bufferFrames = 2048;
+    int m_bufferCount = 3;
+
+    // Current window
+    double m_windowElapsed = 0.0;
+    int m_windowBlocks = 0;
+    int m_windowHeavyBlocks = 0;
+    float m_windowMaxLoad = 0.0f;
+    int m_quietWindows = 0;
+    bool m_holding = false;  // Window right after a change is only observed
+};
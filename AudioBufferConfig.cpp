@@ -0,0 +1,28 @@
+#include "AudioBufferConfig.h"
+#include <algorithm>
+
+AudioBufferConfig AudioBufferConfig::clamped() const {
+    AudioBufferConfig result;
+    result.playbackBuffers = std::clamp(playbackBuffers, MIN_BUFFERS, MAX_BUFFERS);
+    result.playbackBufferFrames = std::clamp(playbackBufferFrames, MIN_BUFFER_FRAMES, MAX_BUFFER_FRAMES);
+    result.recordBuffers = std::clamp(recordBuffers, MIN_BUFFERS, MAX_BUFFERS);
+    result.recordBufferFrames = std::clamp(recordBufferFrames, MIN_BUFFER_FRAMES, MAX_BUFFER_FRAMES);
+    return result;
+}
+
+AudioLatency AudioLatency::compute(const AudioBufferConfig& config, uint32_t sampleRate, uint32_t monitorFrames) {
+    AudioBufferConfig safe = config.clamped();
+
+    AudioLatency latency;
+    latency.inputFrames = static_cast<uint32_t>(safe.recordBufferFrames);
+    latency.outputFrames = static_cast<uint32_t>(safe.playbackBuffers * safe.playbackBufferFrames);
+    latency.roundTripFrames = latency.inputFrames + monitorFrames + latency.outputFrames;
+
+    if (sampleRate > 0) {
+        const double msPerFrame = 1000.0 / sampleRate;
+        latency.inputMs = latency.inputFrames * msPerFrame;
+        latency.outputMs = latency.outputFrames * msPerFrame;
+        latency.roundTripMs = latency.roundTripFrames * msPerFrame;
+    }
+    return latency;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+// Device buffer layout for the playback and recording streams. More or larger
+// buffers ride out longer scheduling stalls at the cost of latency; each
+// workstation picks its own trade-off and it is persisted in Settings.
+struct AudioBufferConfig {
+    static constexpr int MIN_BUFFERS = 2;
+    static constexpr int MAX_BUFFERS = 16;
+    static constexpr int MIN_BUFFER_FRAMES = 64;
+    static constexpr int MAX_BUFFER_FRAMES = 16384;
+
+    int playbackBuffers = 3;
+    int playbackBufferFrames = 2048;
+    int recordBuffers = 4;
+    int recordBufferFrames = 4096;
+
+    // Copy with every field limited to the supported range
+    AudioBufferConfig clamped() const;
+
+    bool operator==(const AudioBufferConfig& other) const {
+        return playbackBuffers == other.playbackBuffers &&
+               playbackBufferFrames == other.playbackBufferFrames &&
+               recordBuffers == other.recordBuffers &&
+               recordBufferFrames == other.recordBufferFrames;
+    }
+    bool operator!=(const AudioBufferConfig& other) const { return !(*this == other); }
+};
+
+// Latency implied by a buffer configuration at a given sample rate
+struct AudioLatency {
+    uint32_t inputFrames = 0;      // One recording buffer must fill before it is delivered
+    uint32_t outputFrames = 0;     // Every queued playback buffer plays before a new one
+    uint32_t roundTripFrames = 0;  // Input + monitor buffering + output
+    double inputMs = 0.0;
+    double outputMs = 0.0;
+    double roundTripMs = 0.0;
+
+    // monitorFrames is whatever sits between input and output (e.g. the
+    // input monitor ring); pass 0 for the bare device round trip
+    static AudioLatency compute(const AudioBufferConfig& config, uint32_t sampleRate,
+                                uint32_t monitorFrames = 0);
+};
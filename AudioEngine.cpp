@@ -1,8 +1,13 @@
 #include "AudioEngine.h"
 #include "Track.h"
+#include "WavWriter.h"
+#include "RecordingRecovery.h"
+#include "ThreadPriority.h"
+#include <mmreg.h>
 #include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 // ============================================================================
 // AudioClip Implementation
@@ -24,8 +29,8 @@ bool AudioClip::loadFromFile(const std::wstring& filename) {
     file.read(wave, 4);
     if (strncmp(wave, "WAVE", 4) != 0) return false;
 
-    // Parse chunks
-    std::vector<uint8_t> rawData;
+    // Parse chunks up to the start of the sample data
+    uint32_t dataSize = 0;
     
     while (file) {
         char chunkId[4];
@@ -48,15 +53,23 @@ bool AudioClip::loadFromFile(const std::wstring& filename) {
             file.read(reinterpret_cast<char*>(&byteRate), 4);
             file.read(reinterpret_cast<char*>(&blockAlign), 2);
             file.read(reinterpret_cast<char*>(&m_format.bitsPerSample), 2);
+
+            // WAVE_FORMAT_EXTENSIBLE stores the real format tag at the start of the SubFormat GUID
+            uint32_t fmtBytesRead = 16;
+            if (audioFormat == 0xFFFE && chunkSize >= 40) {
+                file.seekg(8, std::ios::cur);  // cbSize, valid bits, channel mask
+                file.read(reinterpret_cast<char*>(&audioFormat), 2);
+                fmtBytesRead = 26;
+            }
+            m_format.isFloat = (audioFormat == 3);  // WAVE_FORMAT_IEEE_FLOAT
             
             // Skip any extra format bytes
-            if (chunkSize > 16) {
-                file.seekg(chunkSize - 16, std::ios::cur);
+            if (chunkSize > fmtBytesRead) {
+                file.seekg(chunkSize - fmtBytesRead, std::ios::cur);
             }
         }
         else if (strncmp(chunkId, "data", 4) == 0) {
-            rawData.resize(chunkSize);
-            file.read(reinterpret_cast<char*>(rawData.data()), chunkSize);
+            dataSize = chunkSize;
             break;
         }
         else {
@@ -65,39 +78,59 @@ bool AudioClip::loadFromFile(const std::wstring& filename) {
         }
     }
 
-    if (rawData.empty()) return false;
+    uint32_t bytesPerSample = m_format.bytesPerSample();
+    if (dataSize == 0 || bytesPerSample == 0 || !file) return false;
+
+    // Never trust the chunk size beyond the end of the file
+    std::streampos dataStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    uint64_t remaining = static_cast<uint64_t>(file.tellg() - dataStart);
+    file.seekg(dataStart);
+    dataSize = static_cast<uint32_t>(std::min<uint64_t>(dataSize, remaining));
 
-    // Convert to normalized float samples
-    size_t sampleCount = rawData.size() / m_format.bytesPerSample();
+    // Convert to normalized float samples block by block, straight from the
+    // file into m_samples. No intermediate copy of the whole data chunk is
+    // held, which matters for long recorded takes.
+    size_t sampleCount = dataSize / bytesPerSample;
     m_samples.resize(sampleCount);
 
-    if (m_format.bitsPerSample == 16) {
-        const int16_t* src = reinterpret_cast<const int16_t*>(rawData.data());
-        for (size_t i = 0; i < sampleCount; ++i) {
-            m_samples[i] = src[i] / 32768.0f;
+    SampleFormat sampleFormat;
+    bool converterFormat = SampleConvert::fromWaveFormat(m_format.bitsPerSample, m_format.isFloat, sampleFormat);
+
+    constexpr size_t BLOCK_SAMPLES = 65536;
+    std::vector<uint8_t> block(BLOCK_SAMPLES * bytesPerSample);
+    size_t samplesRead = 0;
+
+    while (samplesRead < sampleCount) {
+        size_t count = std::min(BLOCK_SAMPLES, sampleCount - samplesRead);
+        file.read(reinterpret_cast<char*>(block.data()), count * bytesPerSample);
+        count = static_cast<size_t>(file.gcount()) / bytesPerSample;
+        if (count == 0) break;
+
+        float* dst = m_samples.data() + samplesRead;
+        if (converterFormat) {
+            SampleConvert::toFloat(block.data(), dst, count, sampleFormat);
         }
-    }
-    else if (m_format.bitsPerSample == 8) {
-        const uint8_t* src = rawData.data();
-        for (size_t i = 0; i < sampleCount; ++i) {
-            m_samples[i] = (src[i] - 128) / 128.0f;
+        else if (m_format.bitsPerSample == 8) {
+            for (size_t i = 0; i < count; ++i) {
+                dst[i] = (block[i] - 128) / 128.0f;
+            }
         }
-    }
-    else if (m_format.bitsPerSample == 24) {
-        for (size_t i = 0; i < sampleCount; ++i) {
-            int32_t sample = (rawData[i * 3] << 8) | 
-                             (rawData[i * 3 + 1] << 16) | 
-                             (rawData[i * 3 + 2] << 24);
-            sample >>= 8;  // Sign extend
-            m_samples[i] = sample / 8388608.0f;
+        else if (m_format.bitsPerSample == 32) {
+            const int32_t* src = reinterpret_cast<const int32_t*>(block.data());
+            for (size_t i = 0; i < count; ++i) {
+                dst[i] = src[i] / 2147483648.0f;
+            }
         }
+        samplesRead += count;
     }
-    else if (m_format.bitsPerSample == 32) {
-        const int32_t* src = reinterpret_cast<const int32_t*>(rawData.data());
-        for (size_t i = 0; i < sampleCount; ++i) {
-            m_samples[i] = src[i] / 2147483648.0f;
-        }
+
+    // A truncated file keeps whatever whole frames were actually present
+    if (m_format.channels > 0) {
+        samplesRead -= samplesRead % m_format.channels;
     }
+    m_samples.resize(samplesRead);
+    if (m_samples.empty()) return false;
 
     m_filename = filename;
     return true;
@@ -236,67 +269,258 @@ void AudioClip::invalidateWaveformCache() const {
 // AudioEngine Implementation
 // ============================================================================
 
-AudioEngine::AudioEngine() {
-    // ... existing initialization ...
-    m_inputMonitorBuffer.assign(INPUT_MONITOR_BUFFER_SIZE, 0.0f);
+namespace {
+
+// KSDATAFORMAT_SUBTYPE_PCM / KSDATAFORMAT_SUBTYPE_IEEE_FLOAT (avoids pulling in ksmedia.h)
+const GUID SUBTYPE_PCM = {0x00000001, 0x0000, 0x0010, {0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71}};
+const GUID SUBTYPE_IEEE_FLOAT = {0x00000003, 0x0000, 0x0010, {0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71}};
 
-    // Pre-allocate float conversion buffer (avoids per-buffer allocation in audio callback)
+} // namespace
+
+AudioEngine::AudioEngine() : m_masterReverb(std::make_unique<ConvolutionReverb>()) {
+    // ... existing initialization ...
+    // Pre-allocate callback scratch (avoids per-buffer allocation in audio callback)
     // Size: max buffer size * max channels (stereo)
-    m_floatConversionBuffer.resize(BUFFER_SIZE_FRAMES * 2);
+    m_playbackScratch.configure(ScratchArena::bytesForBlock(m_bufferConfig.playbackBufferFrames, 2,
+                                                            PLAYBACK_SCRATCH_SPANS));
+
+    m_renderWake = CreateEvent(nullptr, FALSE, FALSE, nullptr);
 }
 
 AudioEngine::~AudioEngine() {
     shutdown();
+
+    if (m_renderWake) {
+        CloseHandle(m_renderWake);
+        m_renderWake = nullptr;
+    }
+
+    // Nothing renders any more, so the audio thread's snapshot goes too
+    delete m_pendingTracks.exchange(nullptr);
+    delete m_retiredTracks.exchange(nullptr);
+    delete m_activeTracks;
+    m_activeTracks = nullptr;
 }
 
-bool AudioEngine::initialize(uint32_t sampleRate, uint16_t channels) {
-    m_waveFormat.wFormatTag = WAVE_FORMAT_PCM;
-    m_waveFormat.nChannels = channels;
-    m_waveFormat.nSamplesPerSec = sampleRate;
-    m_waveFormat.wBitsPerSample = 16;
-    m_waveFormat.nBlockAlign = channels * (m_waveFormat.wBitsPerSample / 8);
-    m_waveFormat.nAvgBytesPerSec = sampleRate * m_waveFormat.nBlockAlign;
-    m_waveFormat.cbSize = 0;
+bool AudioEngine::initialize(uint32_t sampleRate, uint16_t channels, SampleFormat preferredFormat) {
+    // Try the preferred format first, then step down towards 16-bit PCM which
+    // every device supports
+    const SampleFormat candidates[] = {SampleFormat::Float32, SampleFormat::Int24, SampleFormat::Int16};
+    bool opened = false;
+    for (SampleFormat format : candidates) {
+        if (SampleConvert::bytesPerSample(format) > SampleConvert::bytesPerSample(preferredFormat)) {
+            continue;
+        }
+        if (openOutputDevice(sampleRate, channels, format)) {
+            opened = true;
+            break;
+        }
+    }
+
+    if (!opened) {
+        return false;
+    }
+
+    // Recording stays 16-bit PCM regardless of the output format
+    m_inputFormat.wFormatTag = WAVE_FORMAT_PCM;
+    m_inputFormat.nChannels = channels;
+    m_inputFormat.nSamplesPerSec = sampleRate;
+    m_inputFormat.wBitsPerSample = 16;
+    m_inputFormat.nBlockAlign = channels * (m_inputFormat.wBitsPerSample / 8);
+    m_inputFormat.nAvgBytesPerSec = sampleRate * m_inputFormat.nBlockAlign;
+    m_inputFormat.cbSize = 0;
+
+    // Input monitoring needs at least one playback buffer plus one recording
+    // buffer queued to ride out the two callbacks' different block sizes
+    m_inputMonitor.configure(channels, INPUT_MONITOR_CAPACITY_FRAMES,
+                             m_bufferConfig.playbackBufferFrames + m_bufferConfig.recordBufferFrames);
+
+    allocatePlaybackBuffers();
+    return true;
+}
+
+void AudioEngine::allocatePlaybackBuffers() {
+    // The configured layout is also the latency target adaptive buffering returns to
+    AdaptiveBufferController::Params params;
+    params.minBufferFrames = std::min(params.minBufferFrames, m_bufferConfig.playbackBufferFrames);
+    params.targetLatencyFrames = m_bufferConfig.playbackBuffers * m_bufferConfig.playbackBufferFrames;
+    m_adaptiveController.configure(params, m_bufferConfig);
+
+    // With adaptive buffering every buffer is allocated and prepared at the
+    // largest layout up front, so switching later is just a different length
+    int capacityFrames = m_bufferConfig.playbackBufferFrames;
+    int capacityCount = m_bufferConfig.playbackBuffers;
+    if (m_adaptiveBuffering) {
+        capacityFrames = std::max(capacityFrames, m_adaptiveController.getMaxBufferFrames());
+        capacityCount = std::max(capacityCount, m_adaptiveController.getMaxBufferCount());
+        m_activeBufferFrames = m_adaptiveController.getBufferFrames();
+        m_activeBufferCount = m_adaptiveController.getBufferCount();
+    }
+    else {
+        m_activeBufferFrames = m_bufferConfig.playbackBufferFrames;
+        m_activeBufferCount = m_bufferConfig.playbackBuffers;
+    }
+
+    const size_t frames = static_cast<size_t>(capacityFrames);
+    const size_t bufferSizeBytes = frames * m_waveFormat.nBlockAlign;
+    m_playbackScratch.configure(ScratchArena::bytesForBlock(frames, m_waveFormat.nChannels, PLAYBACK_SCRATCH_SPANS));
+
+    m_buffers.resize(capacityCount);
+    m_headers.assign(capacityCount, WAVEHDR{});
+    m_bufferStartFrames.assign(capacityCount, 0);
+    m_bufferSequence.assign(capacityCount, 0);
+
+    for (size_t i = 0; i < m_headers.size(); ++i) {
+        m_buffers[i].assign(bufferSizeBytes, 0);
+        
+        m_headers[i].lpData = reinterpret_cast<LPSTR>(m_buffers[i].data());
+        m_headers[i].dwBufferLength = static_cast<DWORD>(bufferSizeBytes);
+        m_headers[i].dwUser = i;
+        m_headers[i].dwFlags = 0;
+        
+        waveOutPrepareHeader(m_waveOut, &m_headers[i], sizeof(WAVEHDR));
+    }
+}
+
+void AudioEngine::releasePlaybackBuffers() {
+    for (WAVEHDR& header : m_headers) {
+        waveOutUnprepareHeader(m_waveOut, &header, sizeof(WAVEHDR));
+    }
+    m_headers.clear();
+}
+
+void AudioEngine::rebuildPlaybackBuffers() {
+    // Return every queued buffer before the headers are rebuilt
+    stop();
+    waveOutReset(m_waveOut);
+    releasePlaybackBuffers();
+    allocatePlaybackBuffers();
+}
+
+bool AudioEngine::setBufferConfig(const AudioBufferConfig& config) {
+    AudioBufferConfig newConfig = config.clamped();
+    if (newConfig == m_bufferConfig) {
+        return true;
+    }
+
+    // Recording buffers are queued on the device for the whole take
+    if (m_isRecording) {
+        OutputDebugStringW(L"setBufferConfig() failed: recording in progress\n");
+        return false;
+    }
+
+    m_bufferConfig = newConfig;
+
+    if (!m_waveOut) {
+        // Applied by initialize()
+        return true;
+    }
+
+    rebuildPlaybackBuffers();
+
+    // Recording buffers are rebuilt the next time the input device is opened
+    shutdownRecording();
+
+    m_inputMonitor.setTargetLatency(m_bufferConfig.playbackBufferFrames + m_bufferConfig.recordBufferFrames);
+    m_inputMonitor.flush();
+
+    AudioLatency latency = getLatency();
+    wchar_t buf[160];
+    swprintf_s(buf, L"Audio buffers: %d x %d playback, %d x %d record; latency in %.1f ms, out %.1f ms, round trip %.1f ms\n",
+               m_bufferConfig.playbackBuffers, m_bufferConfig.playbackBufferFrames,
+               m_bufferConfig.recordBuffers, m_bufferConfig.recordBufferFrames,
+               latency.inputMs, latency.outputMs, latency.roundTripMs);
+    OutputDebugStringW(buf);
+    return true;
+}
+
+bool AudioEngine::setAdaptiveBuffering(bool enabled) {
+    if (enabled == m_adaptiveBuffering) {
+        return true;
+    }
+
+    if (m_isRecording) {
+        OutputDebugStringW(L"setAdaptiveBuffering() failed: recording in progress\n");
+        return false;
+    }
+
+    m_adaptiveBuffering = enabled;
+    if (m_waveOut) {
+        rebuildPlaybackBuffers();
+    }
+    return true;
+}
+
+AudioBufferConfig AudioEngine::getActiveBufferConfig() const {
+    AudioBufferConfig active = m_bufferConfig;
+    active.playbackBufferFrames = m_activeBufferFrames;
+    active.playbackBuffers = m_activeBufferCount;
+    return active;
+}
+
+AudioLatency AudioEngine::getLatency() const {
+    // Round trip is input monitored through the mix: record buffer, monitor
+    // ring, render-ahead look-ahead (input is mixed when rendered), playback queue
+    uint32_t sampleRate = m_waveFormat.nSamplesPerSec ? m_waveFormat.nSamplesPerSec : 44100;
+    size_t buffered = m_inputMonitor.getTargetLatency();
+    if (m_renderAheadEnabled) {
+        buffered += m_renderAhead.getLookAheadFrames();
+    }
+    return AudioLatency::compute(getActiveBufferConfig(), sampleRate, static_cast<uint32_t>(buffered));
+}
+
+bool AudioEngine::openOutputDevice(uint32_t sampleRate, uint16_t channels, SampleFormat format) {
+    // Formats above 16-bit must be described with WAVEFORMATEXTENSIBLE
+    WAVEFORMATEXTENSIBLE waveFormat = {};
+    bool extensible = (format != SampleFormat::Int16);
+
+    waveFormat.Format.wFormatTag = extensible ? WAVE_FORMAT_EXTENSIBLE : WAVE_FORMAT_PCM;
+    waveFormat.Format.nChannels = channels;
+    waveFormat.Format.nSamplesPerSec = sampleRate;
+    waveFormat.Format.wBitsPerSample = SampleConvert::bitsPerSample(format);
+    waveFormat.Format.nBlockAlign = channels * (waveFormat.Format.wBitsPerSample / 8);
+    waveFormat.Format.nAvgBytesPerSec = sampleRate * waveFormat.Format.nBlockAlign;
+    waveFormat.Format.cbSize = extensible ? sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX) : 0;
+
+    if (extensible) {
+        waveFormat.Samples.wValidBitsPerSample = waveFormat.Format.wBitsPerSample;
+        waveFormat.dwChannelMask = (channels == 2) ? (SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT)
+                                                   : SPEAKER_FRONT_CENTER;
+        waveFormat.SubFormat = (format == SampleFormat::Float32) ? SUBTYPE_IEEE_FLOAT : SUBTYPE_PCM;
+    }
 
     MMRESULT result = waveOutOpen(
         &m_waveOut,
         WAVE_MAPPER,
-        &m_waveFormat,
+        &waveFormat.Format,
         reinterpret_cast<DWORD_PTR>(waveOutProc),
         reinterpret_cast<DWORD_PTR>(this),
         CALLBACK_FUNCTION
     );
 
     if (result != MMSYSERR_NOERROR) {
+        m_waveOut = nullptr;
         return false;
     }
 
-    // Allocate and prepare buffers
-    size_t bufferSizeBytes = BUFFER_SIZE_FRAMES * m_waveFormat.nBlockAlign;
-    
-    for (int i = 0; i < NUM_BUFFERS; ++i) {
-        m_buffers[i].resize(BUFFER_SIZE_FRAMES * m_waveFormat.nChannels);
-        
-        m_headers[i].lpData = reinterpret_cast<LPSTR>(m_buffers[i].data());
-        m_headers[i].dwBufferLength = static_cast<DWORD>(bufferSizeBytes);
-        m_headers[i].dwUser = i;
-        m_headers[i].dwFlags = 0;
-        
-        waveOutPrepareHeader(m_waveOut, &m_headers[i], sizeof(WAVEHDR));
-    }
+    m_waveFormat = waveFormat.Format;
+    m_outputFormat = format;
 
+    wchar_t buf[96];
+    swprintf_s(buf, L"Audio output opened: %u Hz, %u-bit%s\n", sampleRate,
+               waveFormat.Format.wBitsPerSample, format == SampleFormat::Float32 ? L" float" : L"");
+    OutputDebugStringW(buf);
     return true;
 }
 
 void AudioEngine::shutdown() {
+    m_directMonitor.stop();
     stop();
     stopRecording();
     shutdownRecording();
 
     if (m_waveOut) {
-        for (int i = 0; i < NUM_BUFFERS; ++i) {
-            waveOutUnprepareHeader(m_waveOut, &m_headers[i], sizeof(WAVEHDR));
-        }
+        releasePlaybackBuffers();
         waveOutClose(m_waveOut);
         m_waveOut = nullptr;
     }
@@ -324,44 +548,48 @@ bool AudioEngine::play() {
     // If we were paused, just restart - buffers are already queued
     if (m_isPaused) {
         m_isPaused = false;
+        if (m_renderAheadEnabled) {
+            startRenderAhead(false);
+        }
+        PlayheadClock::Snapshot paused = m_playhead.read();
+        m_playhead.publish(paused.frame, PlayheadClock::Clock::now(), m_waveFormat.nSamplesPerSec, false);
         waveOutRestart(m_waveOut);
         return true;
     }
 
     // Make sure device is not paused
     waveOutRestart(m_waveOut);
+
+    // Fill the look-ahead before the first device buffers are queued
+    m_renderReachedEnd = false;
+    if (m_renderAheadEnabled) {
+        startRenderAhead(true);
+    }
     
-    // Queue fresh buffers
-    for (int i = 0; i < NUM_BUFFERS; ++i) {
-        // Clear done flag before resubmitting
-        m_headers[i].dwFlags &= ~WHDR_DONE;
-        fillBuffer(&m_headers[i]);
-        MMRESULT result = waveOutWrite(m_waveOut, &m_headers[i], sizeof(WAVEHDR));
-        if (result != MMSYSERR_NOERROR) {
-            wchar_t buf[64];
-            swprintf_s(buf, L"waveOutWrite failed with error %d\n", result);
-            OutputDebugStringW(buf);
+    // Queue fresh buffers; the first one starts playing straight away
+    const size_t startFrame = m_playbackPosition;
+    for (int i = 0; i < m_activeBufferCount; ++i) {
+        if (!queueBuffer(&m_headers[i])) {
             m_isPlaying = false;
             return false;
         }
     }
-
-    if (!m_isPaused) {
-        m_playbackStartTime = std::chrono::steady_clock::now();
-        m_playbackStarted = true;
-    }
+    m_playhead.publish(static_cast<int64_t>(startFrame), PlayheadClock::Clock::now(),
+                       m_waveFormat.nSamplesPerSec, true);
     
     return true;
 }
 
 void AudioEngine::pause() {
     if (m_isPlaying) {
-        // Save current position before pausing
-        m_playbackPosition = static_cast<size_t>(getPosition() * m_waveFormat.nSamplesPerSec);
-        m_playbackStarted = false;
+        // Freeze the playhead where it is heard; queued buffers resume from there
+        auto now = PlayheadClock::Clock::now();
+        double frame = PlayheadClock::frameAt(m_playhead.read(), now, getPlayheadMaxExtrapolation());
+        m_playhead.publish(static_cast<int64_t>(frame), now, 0.0, false);
         m_isPlaying = false;
         m_isPaused = true;
         waveOutPause(m_waveOut);
+        stopRenderAhead();  // Keeps the look-ahead for resume
     }
 }
 
@@ -369,25 +597,29 @@ void AudioEngine::stop() {
     if (m_waveOut) {
         m_isPlaying = false;
         m_isPaused = false;
+        stopRenderAhead();
         waveOutReset(m_waveOut);
         // Restart from reset state so device is ready to play
         waveOutRestart(m_waveOut);
-        m_playbackStarted = false;
         m_playbackPosition = 0;
+        m_playhead.publish(0, PlayheadClock::Clock::now(), 0.0, true);
     }
 }
 
 void AudioEngine::setPosition(double seconds) {
     size_t frame = static_cast<size_t>(seconds * m_waveFormat.nSamplesPerSec);
-    
-    if (m_isPlaying) {
-        // Adjust start time to maintain correct position
-        double currentPos = getPosition();
-        double offset = seconds - currentPos;
-        m_playbackStartTime += std::chrono::microseconds(static_cast<long long>(offset * 1e6));
-    } else {
-        m_playbackPosition = frame;
+
+    // While playing, the playhead moves once the new position is heard (see
+    // publishPlayhead); otherwise it moves now
+    if (!m_isPlaying) {
+        m_playhead.publish(static_cast<int64_t>(frame), PlayheadClock::Clock::now(), 0.0, true);
     }
+
+    // The next rendered block starts at the new position; anything mixed
+    // ahead from the old one is dropped
+    m_playbackPosition = frame;
+    m_renderReachedEnd = false;
+    flushRenderAhead(frame);
 }
 
 double AudioEngine::getPosition() const {
@@ -395,7 +627,9 @@ double AudioEngine::getPosition() const {
         return 0.0;
     }
 
-    return static_cast<double>(m_playbackPosition.load()) / m_waveFormat.nSamplesPerSec;
+    double frame = PlayheadClock::frameAt(m_playhead.read(), PlayheadClock::Clock::now(),
+                                          getPlayheadMaxExtrapolation());
+    return std::max(frame, 0.0) / m_waveFormat.nSamplesPerSec;
 }
 
 double AudioEngine::getDuration() const {
@@ -417,163 +651,559 @@ void AudioEngine::setClip(std::shared_ptr<AudioClip> clip) {
 }
 
 void AudioEngine::setTracks(std::vector<std::shared_ptr<Track>>* tracks) {
-    // Protect track access with mutex to prevent race conditions with audio callback
-    std::lock_guard<std::mutex> lock(m_tracksMutex);
-    m_tracks = tracks;
+    // Copy the list here so the audio thread never sees the project's vector
+    // change under it, and reserve its work list so it never has to grow
+    auto* snapshot = new TrackSnapshot();
+    if (tracks) {
+        snapshot->tracks = *tracks;
+    }
+    snapshot->mix.reserve(snapshot->tracks.size());
+    publishTracks(snapshot);
+    invalidateRenderAhead();
+}
+
+void AudioEngine::publishTracks(TrackSnapshot* snapshot) {
+    // Free what the audio thread gave back, and any snapshot it never took.
+    // Tracks removed from the project are released here, on the UI thread.
+    delete m_retiredTracks.exchange(nullptr, std::memory_order_acquire);
+    delete m_pendingTracks.exchange(snapshot, std::memory_order_acq_rel);
+}
+
+void AudioEngine::takePendingTracks() {
+    // Only once the last snapshot we handed back has been freed, so nothing
+    // is ever freed here
+    if (m_retiredTracks.load(std::memory_order_acquire) != nullptr) return;
+    TrackSnapshot* next = m_pendingTracks.exchange(nullptr, std::memory_order_acq_rel);
+    if (!next) return;
+
+    if (m_activeTracks) {
+        m_retiredTracks.store(m_activeTracks, std::memory_order_release);
+    }
+    m_activeTracks = next;
+}
+
+void AudioEngine::setInputMonitoring(bool enabled) {
+    m_inputMonitoring = enabled;
+    updateMonitoringPath();
+}
+
+void AudioEngine::setDirectMonitoring(bool enabled, uint32_t blockFrames) {
+    m_directMonitoringEnabled = enabled;
+    if (blockFrames != m_directMonitorBlockFrames) {
+        m_directMonitorBlockFrames = blockFrames;
+        m_directMonitor.stop();  // Reopened below with the new block size
+    }
+    updateMonitoringPath();
+}
+
+void AudioEngine::updateMonitoringPath() {
+    bool wantDirect = m_inputMonitoring && m_directMonitoringEnabled && m_waveOut;
+
+    if (wantDirect && !m_directMonitor.isRunning()) {
+        if (!m_directMonitor.start(m_inputDeviceIndex, m_waveFormat.nSamplesPerSec,
+                                   m_waveFormat.nChannels, m_directMonitorBlockFrames)) {
+            OutputDebugStringW(L"Direct monitoring unavailable, monitoring through the mix\n");
+        }
+    }
+    else if (!wantDirect && m_directMonitor.isRunning()) {
+        m_directMonitor.stop();
+    }
+
+    // The mix path only carries input when the direct path isn't
+    bool mixMonitoring = m_inputMonitoring && !m_directMonitor.isRunning();
+    if (mixMonitoring && !m_mixMonitoring) {
+        // Start from a fresh ring so stale input isn't played back
+        m_inputMonitor.flush();
+    }
+    m_mixMonitoring = mixMonitoring;
+}
+
+void AudioEngine::setInputMonitorLatency(size_t frames) {
+    m_inputMonitor.setTargetLatency(std::max<size_t>(frames, m_activeBufferFrames.load()));
+    m_inputMonitor.flush();
 }
 
 void AudioEngine::setVolume(float volume) {
     m_volume = std::clamp(volume, 0.0f, 1.0f);
+    invalidateRenderAhead();
+}
+
+bool AudioEngine::setRenderAhead(bool enabled, size_t lookAheadFrames) {
+    if (m_isRecording) {
+        OutputDebugStringW(L"setRenderAhead() failed: recording in progress\n");
+        return false;
+    }
+
+    stop();
+
+    if (enabled) {
+        // Whole blocks, at least two so one can render while the other plays
+        size_t blocks = std::max<size_t>((lookAheadFrames + RENDER_AHEAD_BLOCK_FRAMES - 1) / RENDER_AHEAD_BLOCK_FRAMES, 2);
+        uint16_t channels = m_waveFormat.nChannels ? m_waveFormat.nChannels : 2;
+        m_renderAhead.configure(channels, RENDER_AHEAD_BLOCK_FRAMES, blocks);
+        m_renderScratch.configure(ScratchArena::bytesForBlock(RENDER_AHEAD_BLOCK_FRAMES, channels, 2));
+    }
+    m_renderAheadEnabled = enabled;
+    return true;
+}
+
+void AudioEngine::invalidateRenderAhead() {
+    // The render thread re-renders from what the device has been given so
+    // far, throttled so a slider drag doesn't refeed the effects every move
+    if (m_renderAheadEnabled && m_isPlaying) {
+        m_renderAhead.requestFlush();
+        if (m_renderWake) {
+            RealtimeCheck::blockingCall("SetEvent");
+            SetEvent(m_renderWake);
+        }
+    }
+}
+
+void AudioEngine::restartRenderAhead(size_t fromFrame) {
+    m_renderSeekFrame.store(fromFrame, std::memory_order_relaxed);
+    m_renderGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void AudioEngine::flushRenderAhead(size_t fromFrame) {
+    restartRenderAhead(fromFrame);
+    if (m_renderWake) {
+        RealtimeCheck::blockingCall("SetEvent");
+        SetEvent(m_renderWake);
+    }
+}
+
+void AudioEngine::startRenderAhead(bool fresh) {
+    // A renderer left over from playback that ran to the end may still be
+    // running (or have exited without being joined)
+    stopRenderAhead();
+
+    if (fresh) {
+        m_renderAhead.reset();
+        flushRenderAhead(m_playbackPosition.load());
+        m_renderedGeneration = m_renderGeneration.load();
+        m_renderPosition = m_playbackPosition.load();
+
+        // Prime on this thread so the first device buffers have audio
+        while (renderAheadBlock()) {
+        }
+    }
+
+    m_renderThreadRunning = true;
+    m_renderThread = std::thread(&AudioEngine::renderAheadLoop, this);
+}
+
+void AudioEngine::stopRenderAhead() {
+    if (!m_renderThread.joinable()) {
+        return;
+    }
+
+    m_renderThreadRunning = false;
+    RealtimeCheck::blockingCall("SetEvent");
+    SetEvent(m_renderWake);
+    m_renderThread.join();
+}
+
+void AudioEngine::renderAheadLoop() {
+    while (m_renderThreadRunning) {
+        ThreadPriority::ensureCurrentThreadRealtime(ThreadPriority::Task::ProAudio);
+
+        // Render until the look-ahead is full, then wait for the callback to
+        // free a block (or for a flush)
+        if (!renderAheadBlock()) {
+            // Done once playback has reached the end and the callback has
+            // drained the look-ahead; the next play() joins this thread
+            if (m_renderReachedEnd && !m_isPlaying) {
+                break;
+            }
+            RealtimeCheck::blockingCall("WaitForSingleObject");
+            WaitForSingleObject(m_renderWake, RENDER_AHEAD_WAIT_MS);
+        }
+    }
+    ThreadPriority::revertCurrentThread();
+}
+
+bool AudioEngine::renderAheadBlock() {
+    RealtimeCheck::Scope realtime("AudioEngine::renderAheadBlock");
+
+    // Pick up seeks and parameter changes before rendering anything else
+    const size_t played = m_playbackPosition.load();
+    if (m_renderAhead.takeFlush(played)) {
+        restartRenderAhead(played);
+    }
+    uint64_t generation = m_renderGeneration.load(std::memory_order_acquire);
+    if (generation != m_renderedGeneration) {
+        m_renderedGeneration = generation;
+        m_renderPosition = m_renderSeekFrame.load(std::memory_order_relaxed);
+        m_renderReachedEnd = false;
+    }
+
+    if (m_renderReachedEnd) {
+        return false;
+    }
+
+    RenderAheadQueue::Block* block = m_renderAhead.acquire();
+    if (!block) {
+        return false;
+    }
+
+    const size_t frames = m_renderAhead.getBlockFrames();
+    auto renderStart = std::chrono::steady_clock::now();
+
+    block->generation = generation;
+    block->startFrame = m_renderPosition;
+    ScratchArena::Frame scratch(m_renderScratch);
+    processAudio(block->samples.data(), frames, m_renderPosition, m_renderScratch);
+    m_renderAhead.publish(block);
+
+    // Load is measured here rather than in the callback, which only copies
+    std::chrono::duration<double> renderTime = std::chrono::steady_clock::now() - renderStart;
+    double period = static_cast<double>(frames) / m_waveFormat.nSamplesPerSec;
+    m_loadMonitor.recordBlock(renderTime.count(), period);
+    m_lastBlockLoad = static_cast<float>(renderTime.count() / period);
+    return true;
 }
 
 void CALLBACK AudioEngine::waveOutProc(HWAVEOUT hwo, UINT uMsg,
                                         DWORD_PTR dwInstance, DWORD_PTR dwParam1, DWORD_PTR dwParam2) {
     if (uMsg == WOM_DONE) {
+        RealtimeCheck::Scope realtime("AudioEngine::waveOutProc");
+        ThreadPriority::ensureCurrentThreadRealtime(ThreadPriority::Task::ProAudio);
         AudioEngine* engine = reinterpret_cast<AudioEngine*>(dwInstance);
         WAVEHDR* header = reinterpret_cast<WAVEHDR*>(dwParam1);
         
         if (engine->m_isPlaying) {
-            engine->fillBuffer(header);
-            waveOutWrite(hwo, header, sizeof(WAVEHDR));
-            
-            // Notify position update
-            if (engine->m_positionCallback) {
-                engine->m_positionCallback(engine->getPosition());
+            engine->publishPlayhead(header);
+
+            // Every other buffer already played out: the device is starving
+            int queued = engine->countQueuedBuffers();
+            bool underrun = (queued == 0);
+            if (underrun) {
+                engine->m_loadMonitor.recordUnderrun();
+            }
+
+            if (engine->m_adaptiveBuffering) {
+                engine->updateAdaptiveLayout(underrun);
+            }
+
+            // Resubmit this buffer unless the layout just dropped a buffer,
+            // then top the queue up if it just gained one
+            const int target = engine->m_activeBufferCount;
+            if (queued < target && engine->queueBuffer(header)) {
+                ++queued;
+            }
+            while (queued < target) {
+                WAVEHDR* idle = engine->findIdleBuffer();
+                if (!idle || !engine->queueBuffer(idle)) break;
+                ++queued;
             }
         }
     }
 }
 
+bool AudioEngine::queueBuffer(WAVEHDR* header) {
+    fillBuffer(header);
+
+    // WinMM only takes a finished buffer back through waveOutWrite, so the
+    // callback's resubmit is accepted rather than reported
+    MMRESULT result;
+    {
+        RealtimeCheck::Allow resubmit;
+        RealtimeCheck::blockingCall("waveOutWrite");
+        result = waveOutWrite(m_waveOut, header, sizeof(WAVEHDR));
+    }
+    if (result != MMSYSERR_NOERROR) {
+        wchar_t buf[64];
+        swprintf_s(buf, L"waveOutWrite failed with error %d\n", result);
+        OutputDebugStringW(buf);
+        return false;
+    }
+    return true;
+}
+
+int AudioEngine::countQueuedBuffers() const {
+    int queued = 0;
+    for (const WAVEHDR& header : m_headers) {
+        if (header.dwFlags & WHDR_INQUEUE) {
+            ++queued;
+        }
+    }
+    return queued;
+}
+
+void AudioEngine::publishPlayhead(const WAVEHDR* completed) {
+    // The oldest buffer still queued is the one the device just moved on to
+    const WAVEHDR* next = nullptr;
+    for (const WAVEHDR& header : m_headers) {
+        if ((header.dwFlags & WHDR_INQUEUE) &&
+            (!next || m_bufferSequence[header.dwUser] < m_bufferSequence[next->dwUser])) {
+            next = &header;
+        }
+    }
+
+    const size_t completedEnd = m_bufferStartFrames[completed->dwUser] +
+                                completed->dwBufferLength / m_waveFormat.nBlockAlign;
+    auto now = PlayheadClock::Clock::now();
+    if (next) {
+        size_t frame = m_bufferStartFrames[next->dwUser];
+        m_playhead.publish(static_cast<int64_t>(frame), now, m_waveFormat.nSamplesPerSec, frame != completedEnd);
+    }
+    else {
+        // Starved: nothing is playing until the next buffer arrives
+        m_playhead.publish(static_cast<int64_t>(completedEnd), now, 0.0, false);
+    }
+}
+
+WAVEHDR* AudioEngine::findIdleBuffer() {
+    for (WAVEHDR& header : m_headers) {
+        if (!(header.dwFlags & WHDR_INQUEUE)) {
+            return &header;
+        }
+    }
+    return nullptr;
+}
+
+void AudioEngine::updateAdaptiveLayout(bool underrun) {
+    double period = static_cast<double>(m_activeBufferFrames) / m_waveFormat.nSamplesPerSec;
+    if (!m_adaptiveController.onBlock(m_lastBlockLoad, underrun, period)) {
+        return;
+    }
+
+    // Picked up by the next fillBuffer; buffers already queued play out unchanged
+    int frames = m_adaptiveController.getBufferFrames();
+    m_activeBufferFrames = frames;
+    m_activeBufferCount = m_adaptiveController.getBufferCount();
+
+    // Mix monitoring needs at least one playback buffer of input queued
+    if (m_inputMonitor.getTargetLatency() < static_cast<size_t>(frames)) {
+        m_inputMonitor.setTargetLatency(frames + m_bufferConfig.recordBufferFrames);
+    }
+}
+
 void AudioEngine::fillBuffer(WAVEHDR* header) {
     // Clear the done flag before resubmitting
     header->dwFlags &= ~WHDR_DONE;
     
     int bufferIndex = static_cast<int>(header->dwUser);
-    int16_t* buffer = m_buffers[bufferIndex].data();
     
-    processAudio(buffer, BUFFER_SIZE_FRAMES);
+    // Render the float mix, then convert to the device format once. The whole
+    // render is timed against the time the buffer takes to play. Buffers are
+    // prepared at full capacity; the active layout sets how much is used.
+    const size_t frames = static_cast<size_t>(m_activeBufferFrames.load());
+    header->dwBufferLength = static_cast<DWORD>(frames * m_waveFormat.nBlockAlign);
+
+    // Queue order and start frame let publishPlayhead() tell what is audible
+    m_bufferSequence[bufferIndex] = ++m_nextBufferSequence;
+    m_bufferStartFrames[bufferIndex] = m_playbackPosition.load();
+
+    ScratchArena::Frame scratch(m_playbackScratch);
+    float* mix = m_playbackScratch.allocate<float>(frames * m_waveFormat.nChannels);
+    if (!mix) {
+        // Scratch is sized from the buffer layout, so this means a misconfiguration
+        memset(header->lpData, 0, header->dwBufferLength);
+        return;
+    }
+
+    if (m_renderAheadEnabled) {
+        // Copy mixed audio out of the look-ahead; the render thread does the work
+        size_t nextFrame = m_playbackPosition.load();
+        size_t copied = m_renderAhead.read(mix, frames,
+                                           m_renderGeneration.load(std::memory_order_acquire), nextFrame);
+        m_bufferStartFrames[bufferIndex] = nextFrame - copied;
+        if (copied < frames) {
+            std::fill(mix + copied * m_waveFormat.nChannels,
+                      mix + frames * m_waveFormat.nChannels, 0.0f);
+            if (m_renderReachedEnd) {
+                m_isPlaying = false;
+            }
+            else {
+                m_loadMonitor.recordUnderrun();  // Renderer fell behind
+            }
+        }
+        if (copied > 0) {
+            m_playbackPosition = nextFrame;
+        }
+
+        // Wake the renderer for the block just freed. Signalling never
+        // waits, so it is accepted on the callback.
+        {
+            RealtimeCheck::Allow signal;
+            RealtimeCheck::blockingCall("SetEvent");
+            SetEvent(m_renderWake);
+        }
+
+        SampleConvert::fromFloat(mix, m_buffers[bufferIndex].data(),
+                                 frames * m_waveFormat.nChannels, m_outputFormat);
+        return;
+    }
+
+    auto renderStart = std::chrono::steady_clock::now();
+
+    size_t position = m_playbackPosition.load();
+    processAudio(mix, frames, position, m_playbackScratch);
+    m_playbackPosition = position;
+    if (m_renderReachedEnd) {
+        m_isPlaying = false;
+    }
+
+    SampleConvert::fromFloat(mix, m_buffers[bufferIndex].data(),
+                             frames * m_waveFormat.nChannels, m_outputFormat);
+
+    std::chrono::duration<double> renderTime = std::chrono::steady_clock::now() - renderStart;
+    double period = static_cast<double>(frames) / m_waveFormat.nSamplesPerSec;
+    m_loadMonitor.recordBlock(renderTime.count(), period);
+    m_lastBlockLoad = static_cast<float>(renderTime.count() / period);
+}
+
+void AudioEngine::initializeOffline(uint32_t sampleRate, uint16_t channels, size_t maxFrames) {
+    m_waveFormat = {};
+    m_waveFormat.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+    m_waveFormat.nChannels = channels;
+    m_waveFormat.nSamplesPerSec = sampleRate;
+    m_waveFormat.wBitsPerSample = 32;
+    m_waveFormat.nBlockAlign = channels * sizeof(float);
+    m_waveFormat.nAvgBytesPerSec = sampleRate * m_waveFormat.nBlockAlign;
+    m_outputFormat = SampleFormat::Float32;
+
+    m_playbackScratch.configure(ScratchArena::bytesForBlock(maxFrames, channels, PLAYBACK_SCRATCH_SPANS));
+}
+
+void AudioEngine::render(float* buffer, size_t frameCount, size_t& position) {
+    ScratchArena::Frame scratch(m_playbackScratch);
+    processAudio(buffer, frameCount, position, m_playbackScratch);
+}
+
+void AudioEngine::processMasterBus(float* buffer, size_t frameCount, uint16_t channels, uint32_t sampleRate,
+                                   ConvolutionReverb* reverb, const EQCallback& eq) {
+    if (reverb && channels == 2) {
+        reverb->process(buffer, buffer, frameCount);
+    }
+
+    // EQ runs in place on the float bus
+    if (eq) {
+        eq(buffer, frameCount, static_cast<int>(sampleRate));
+    }
 }
 
-void AudioEngine::processAudio(int16_t* buffer, size_t frameCount) {
+void AudioEngine::processAudio(float* buffer, size_t frameCount, size_t& position, ScratchArena& scratch) {
     float masterVolume = m_volume.load();
-    size_t pos = m_playbackPosition.load();
+    size_t pos = position;
     double sampleRate = static_cast<double>(m_waveFormat.nSamplesPerSec);
     double duration = getDuration();
     size_t totalFrames = static_cast<size_t>(duration * sampleRate);
+    size_t sampleCount = frameCount * m_waveFormat.nChannels;
 
     // If no duration, output silence
     if (totalFrames == 0 && !m_clip) {
-        memset(buffer, 0, frameCount * m_waveFormat.nBlockAlign);
+        std::fill(buffer, buffer + sampleCount, 0.0f);
         return;
     }
 
-    // Check if we have tracks to mix
-    // Use lock to safely access m_tracks (prevents race condition with setTracks)
-    std::vector<Track*> activeTracks;
-    {
-        std::lock_guard<std::mutex> lock(m_tracksMutex);
-        if (m_tracks && m_duration > 0.0) {
-            // Pre-filter tracks to avoid checking conditions in the hot path (frame loop)
-            // This optimization reduces checks from O(tracks * frames) to O(tracks + frames)
-            activeTracks.reserve(m_tracks->size());
-
-            // Check if any track is soloed
-            bool hasSolo = false;
-            for (const auto& track : *m_tracks) {
-                if (track->isSolo() && track->isVisible()) {
-                    hasSolo = true;
-                    break;
-                }
-            }
+    // Pull one block of live input up front (padded with silence if short)
+    const float* monitor = nullptr;
+    if (m_mixMonitoring) {
+        if (float* input = scratch.allocate<float>(sampleCount)) {
+            m_inputMonitor.pull(input, frameCount);
+            monitor = input;
+        }
+    }
 
-            // Build list of tracks that should be processed
-            // Note: Muted tracks are still processed for VU metering
-            for (const auto& track : *m_tracks) {
-                if (!track->isVisible()) continue;
-                if (hasSolo && !track->isSolo()) continue;
-                activeTracks.push_back(track.get());
+    // Check if we have tracks to mix, picking up the latest list first
+    takePendingTracks();
+    const std::vector<MixTrack>* mixTracks = nullptr;
+    size_t tailFrames = 0;  // Playback runs on this long after the project ends
+    if (m_activeTracks && m_duration > 0.0) {
+        // Pre-filter tracks so the render loop below only visits tracks it has
+        // work for. The list's capacity covers every track, so this never allocates.
+        std::vector<MixTrack>& mix = m_activeTracks->mix;
+        mix.clear();
+
+        // Check if any track is soloed
+        bool hasSolo = false;
+        for (const auto& track : m_activeTracks->tracks) {
+            if (track->isSolo() && track->isVisible()) {
+                hasSolo = true;
+                break;
             }
         }
-    } // Release lock here
 
-    if (!activeTracks.empty() && m_duration > 0.0) {
-        // Pre-calculate time increment to avoid per-frame division
-        double currentTime = static_cast<double>(pos) / sampleRate;
-        const double timeIncrement = 1.0 / sampleRate;
-        float bufferPeakLevel = 0.0f;  // Track peak for this buffer
+        // Build list of tracks that should be processed
+        // Note: Muted tracks are still processed for VU metering, and
+        // tracks that can't be heard still feed their reverb silence
+        size_t trackTail = 0;
+        for (const auto& track : m_activeTracks->tracks) {
+            bool audible = track->isVisible() && (!hasSolo || track->isSolo());
+            const ConvolutionReverb& reverb = track->getReverb();
+            if (!audible && !reverb.hasImpulseResponse()) continue;
+            trackTail = std::max(trackTail, reverb.getTailFrames());
+            mix.push_back({track.get(), audible});
+        }
+        mixTracks = &mix;
 
-        for (size_t frame = 0; frame < frameCount; ++frame) {
+        // Track tails pass through the master reverb, which adds its own
+        tailFrames = trackTail + m_masterReverb->getTailFrames();
+    }
 
-            if (pos + frame >= totalFrames) {
-                // End of project - output silence
-                buffer[frame * m_waveFormat.nChannels] = 0;
-                if (m_waveFormat.nChannels > 1) {
-                    buffer[frame * m_waveFormat.nChannels + 1] = 0;
-                }
+    if (mixTracks && !mixTracks->empty()) {
+        const uint16_t channels = m_waveFormat.nChannels;
+        const uint32_t rate = m_waveFormat.nSamplesPerSec;
+
+        // Frames before the end of the project; the rest of the block is
+        // silent apart from reverb tails
+        const size_t audibleFrames = pos < totalFrames ? std::min(frameCount, totalFrames - pos) : 0;
+
+        // The mix starts from the monitored input, if any
+        if (monitor) {
+            for (size_t i = 0; i < sampleCount; ++i) {
+                buffer[i] = monitor[i] * masterVolume;
             }
-            else {
-                float leftMix = 0.0f;
-                float rightMix = 0.0f;
-
-                // Mix audio from active tracks only (pre-filtered)
-                for (Track* track : activeTracks) {
-                    float left = 0.0f, right = 0.0f;
-                    track->getAudioAtTime(currentTime, &left, &right, m_waveFormat.nSamplesPerSec);
-                    leftMix += left;
-                    rightMix += right;
-                }
+        } else {
+            std::fill(buffer, buffer + sampleCount, 0.0f);
+        }
 
-                // Mix in input monitoring if enabled
-                if (m_inputMonitoring) {
-                    size_t readPos = m_inputMonitorReadPos.load();
-                    float inputLeft = m_inputMonitorBuffer[readPos];
-                    readPos = (readPos + 1) % INPUT_MONITOR_BUFFER_SIZE;
-                    float inputRight = (m_waveFormat.nChannels > 1) ? m_inputMonitorBuffer[readPos] : inputLeft;
-                    readPos = (readPos + 1) % INPUT_MONITOR_BUFFER_SIZE;
-                    m_inputMonitorReadPos.store(readPos);
-                    leftMix += inputLeft;
-                    rightMix += inputRight;
+        // Each track is rendered once (EQ, volume, pan, mute) and that block
+        // feeds both the mix and the track's reverb send. Master volume is
+        // applied without clamping - the bus has float headroom until the
+        // final conversion.
+        if (float* trackBlock = scratch.allocate<float>(frameCount * 2)) {
+            for (const MixTrack& mix : *mixTracks) {
+                Track* track = mix.track;
+                size_t renderedFrames = 0;
+                if (mix.audible) {
+                    float peak = track->renderBlock(pos, audibleFrames, rate, trackBlock, track->getPlaybackEQ());
+                    track->updatePeakLevel(peak);
+                    renderedFrames = audibleFrames;
                 }
+                std::fill(trackBlock + renderedFrames * 2, trackBlock + frameCount * 2, 0.0f);
 
-                // Apply master volume and clamp
-                leftMix *= masterVolume;
-                rightMix *= masterVolume;
-                leftMix = std::clamp(leftMix, -1.0f, 1.0f);
-                rightMix = std::clamp(rightMix, -1.0f, 1.0f);
-
-                // Track peak level for master VU meter
-                float framePeak = std::max(std::abs(leftMix), std::abs(rightMix));
-                bufferPeakLevel = std::max(bufferPeakLevel, framePeak);
+                for (size_t i = 0; i < renderedFrames * 2; ++i) {
+                    trackBlock[i] *= masterVolume;
+                }
+                for (size_t frame = 0; frame < renderedFrames; ++frame) {
+                    float* out = buffer + frame * channels;
+                    out[0] += trackBlock[frame * 2];
+                    if (channels > 1) {
+                        out[1] += trackBlock[frame * 2 + 1];
+                    }
+                }
 
-                // Convert to int16
-                buffer[frame * m_waveFormat.nChannels] = static_cast<int16_t>(leftMix * 32767.0f);
-                if (m_waveFormat.nChannels > 1) {
-                    buffer[frame * m_waveFormat.nChannels + 1] = static_cast<int16_t>(rightMix * 32767.0f);
+                // Track reverb: the track's own signal, at the bus level,
+                // through its response and added to the mix. It runs over the
+                // whole block, on silence once the track stops, so tails
+                // always ring out instead of freezing.
+                ConvolutionReverb& reverb = track->getReverb();
+                if (channels == 2 && reverb.hasImpulseResponse()) {
+                    reverb.process(trackBlock, buffer, frameCount);
                 }
             }
-
-            // Increment time for next frame (avoids per-frame division)
-            currentTime += timeIncrement;
         }
 
-        // Apply peak level decay to all active tracks
-        constexpr float DECAY_RATE = 0.995f;  // Slight decay per buffer
-        for (Track* track : activeTracks) {
-            track->updatePeakLevel(0.0f);  // Apply decay
-        }
-
-        // Update master peak level with decay
-        float currentPeak = m_masterPeakLevel.load();
-        currentPeak *= DECAY_RATE;  // Apply decay
-        currentPeak = bufferPeakLevel;
-        m_masterPeakLevel.store(currentPeak);
-
-        // Advance playback position
+        // Advance the render position; playback stops once this block has
+        // played and the reverb tails have died away
         pos += frameCount;
-        if (pos >= totalFrames) {
-            m_isPlaying = false;
+        if (pos >= totalFrames + tailFrames) {
+            m_renderReachedEnd = true;
         }
-        m_playbackPosition = pos;
+        position = pos;
     }
     // Fall back to single clip playback
     else if (m_clip) {
@@ -585,11 +1215,11 @@ void AudioEngine::processAudio(int16_t* buffer, size_t frameCount) {
             if (pos >= totalFrames) {
                 // End of clip - output silence
                 for (uint16_t ch = 0; ch < m_waveFormat.nChannels; ++ch) {
-                    buffer[frame * m_waveFormat.nChannels + ch] = 0;
+                    buffer[frame * m_waveFormat.nChannels + ch] = 0.0f;
                 }
             }
             else {
-                // Copy and convert samples
+                // Copy samples
                 for (uint16_t ch = 0; ch < m_waveFormat.nChannels; ++ch) {
                     float sample = 0.0f;
                     
@@ -602,74 +1232,43 @@ void AudioEngine::processAudio(int16_t* buffer, size_t frameCount) {
                     }
                     
                     // Mix in input monitoring if enabled
-                    if (m_inputMonitoring) {
-                        size_t readPos = m_inputMonitorReadPos.load();
-                        float inputSample = m_inputMonitorBuffer[readPos];
-                        m_inputMonitorReadPos.store((readPos + 1) % INPUT_MONITOR_BUFFER_SIZE);
-                        sample += inputSample;
+                    if (monitor) {
+                        sample += monitor[frame * m_waveFormat.nChannels + ch];
                     }
                     
-                    // Apply volume and convert to int16
-                    sample *= masterVolume;
-                    sample = std::clamp(sample, -1.0f, 1.0f);
-                    buffer[frame * m_waveFormat.nChannels + ch] = 
-                        static_cast<int16_t>(sample * 32767.0f);
+                    buffer[frame * m_waveFormat.nChannels + ch] = sample * masterVolume;
                 }
                 ++pos;
             }
         }
         
-        // Update playback position
-        m_playbackPosition = pos;
+        // Update render position
+        position = pos;
     }
     else {
         // No audio source - output silence, but still monitor input if enabled
-        if (m_inputMonitoring) {
-            for (size_t frame = 0; frame < frameCount; ++frame) {
-                for (uint16_t ch = 0; ch < m_waveFormat.nChannels; ++ch) {
-                    size_t readPos = m_inputMonitorReadPos.load();
-                    float inputSample = m_inputMonitorBuffer[readPos];
-                    m_inputMonitorReadPos.store((readPos + 1) % INPUT_MONITOR_BUFFER_SIZE);
-                    inputSample *= masterVolume;
-                    inputSample = std::clamp(inputSample, -1.0f, 1.0f);
-                    buffer[frame * m_waveFormat.nChannels + ch] = static_cast<int16_t>(inputSample * 32767.0f);
-                }
+        if (monitor) {
+            for (size_t i = 0; i < sampleCount; ++i) {
+                buffer[i] = monitor[i] * masterVolume;
             }
         } else {
-            memset(buffer, 0, frameCount * m_waveFormat.nBlockAlign);
+            std::fill(buffer, buffer + sampleCount, 0.0f);
         }
     }
 
-    // Apply EQ and/or spectrum analysis if callbacks are set
-    if (m_eqCallback || m_spectrumCallback) {
-        // Use pre-allocated buffer to avoid per-buffer allocation
-        size_t sampleCount = frameCount * m_waveFormat.nChannels;
-        if (m_floatConversionBuffer.size() < sampleCount) {
-            m_floatConversionBuffer.resize(sampleCount);
-        }
-
-        // Convert int16 buffer to float for EQ/spectrum processing
-        for (size_t i = 0; i < sampleCount; ++i) {
-            m_floatConversionBuffer[i] = buffer[i] / 32768.0f;
-        }
+    processMasterBus(buffer, frameCount, m_waveFormat.nChannels, m_waveFormat.nSamplesPerSec,
+                     m_masterReverb.get(), m_eqCallback);
 
-        // Apply EQ if callback is set
-        if (m_eqCallback) {
-            m_eqCallback(m_floatConversionBuffer.data(), frameCount, m_waveFormat.nSamplesPerSec);
-
-            // Convert back to int16 after EQ
-            for (size_t i = 0; i < sampleCount; ++i) {
-                float sample = std::clamp(m_floatConversionBuffer[i], -1.0f, 1.0f);
-                buffer[i] = static_cast<int16_t>(sample * 32767.0f);
-            }
-        }
+    // Master VU meter sees the post-EQ signal (clamped to the meter range)
+    float bufferPeakLevel = 0.0f;
+    for (size_t i = 0; i < sampleCount; ++i) {
+        bufferPeakLevel = std::max(bufferPeakLevel, std::abs(buffer[i]));
+    }
+    m_masterPeakLevel.store(std::min(bufferPeakLevel, 1.0f));
 
-        // Call spectrum analyzer with EQ'd samples (if EQ was applied)
-        // Note: If EQ was applied, buffer has been updated and floatConversionBuffer has EQ'd data
-        // If no EQ, floatConversionBuffer has original data
-        if (m_spectrumCallback) {
-            m_spectrumCallback(m_floatConversionBuffer.data(), sampleCount, m_waveFormat.nSamplesPerSec);
-        }
+    // Spectrum analyzer gets the same float data the device will play
+    if (m_spectrumCallback) {
+        m_spectrumCallback(buffer, sampleCount, m_waveFormat.nSamplesPerSec);
     }
 }
 
@@ -700,6 +1299,12 @@ bool AudioEngine::setInputDevice(int deviceIndex) {
     }
     
     m_inputDeviceIndex = deviceIndex;
+
+    // Reopen the direct monitor on the new device
+    if (m_directMonitor.isRunning()) {
+        m_directMonitor.stop();
+        updateMonitoringPath();
+    }
     return true;
 }
 
@@ -709,7 +1314,7 @@ bool AudioEngine::initializeRecording() {
     MMRESULT result = waveInOpen(
         &m_waveIn,
         m_inputDeviceIndex,
-        &m_waveFormat,
+        &m_inputFormat,
         reinterpret_cast<DWORD_PTR>(waveInProc),
         reinterpret_cast<DWORD_PTR>(this),
         CALLBACK_FUNCTION
@@ -721,10 +1326,13 @@ bool AudioEngine::initializeRecording() {
     }
     
     // Allocate and prepare recording buffers
-    size_t bufferSizeBytes = RECORD_BUFFER_SIZE_FRAMES * m_waveFormat.nBlockAlign;
+    const size_t frames = static_cast<size_t>(m_bufferConfig.recordBufferFrames);
+    size_t bufferSizeBytes = frames * m_inputFormat.nBlockAlign;
+    m_recordBuffers.resize(m_bufferConfig.recordBuffers);
+    m_recordHeaders.assign(m_bufferConfig.recordBuffers, WAVEHDR{});
     
-    for (int i = 0; i < NUM_RECORD_BUFFERS; ++i) {
-        m_recordBuffers[i].resize(RECORD_BUFFER_SIZE_FRAMES * m_waveFormat.nChannels);
+    for (size_t i = 0; i < m_recordHeaders.size(); ++i) {
+        m_recordBuffers[i].resize(frames * m_inputFormat.nChannels);
         
         m_recordHeaders[i].lpData = reinterpret_cast<LPSTR>(m_recordBuffers[i].data());
         m_recordHeaders[i].dwBufferLength = static_cast<DWORD>(bufferSizeBytes);
@@ -742,8 +1350,8 @@ void AudioEngine::shutdownRecording() {
     if (m_waveIn) {
         waveInReset(m_waveIn);
         
-        for (int i = 0; i < NUM_RECORD_BUFFERS; ++i) {
-            waveInUnprepareHeader(m_waveIn, &m_recordHeaders[i], sizeof(WAVEHDR));
+        for (WAVEHDR& header : m_recordHeaders) {
+            waveInUnprepareHeader(m_waveIn, &header, sizeof(WAVEHDR));
         }
         
         waveInClose(m_waveIn);
@@ -759,109 +1367,159 @@ bool AudioEngine::startRecording() {
         return false;
     }
 
-    // Clear any previous recorded data and pre-allocate to avoid O(N²) growth
-    {
-        std::lock_guard<std::mutex> lock(m_recordMutex);
-        m_recordedSamples.clear();
-        // Pre-allocate for ~30 seconds at 44.1kHz stereo (reduces reallocations)
-        // 30 seconds * 44100 samples/sec * 2 channels = 2,646,000 samples
-        m_recordedSamples.reserve(30 * m_waveFormat.nSamplesPerSec * m_waveFormat.nChannels);
+    // Open the take file the writer thread streams into
+    if (!m_takeWriter) {
+        m_takeWriter = std::make_unique<WavWriter>();
     }
 
-    // Clear pending samples buffer and pre-allocate
-    m_pendingSamples.clear();
-    m_pendingSamples.reserve(m_waveFormat.nSamplesPerSec * m_waveFormat.nChannels); // 1 second buffer
+    AudioFormat format;
+    format.channels = m_inputFormat.nChannels;
+    format.sampleRate = m_inputFormat.nSamplesPerSec;
+    format.bitsPerSample = m_inputFormat.wBitsPerSample;
+
+    m_takeFilename = RecordingRecovery::makeTakeFilename();
+    if (!m_takeWriter->open(m_takeFilename, format)) {
+        OutputDebugStringW(L"startRecording() failed: could not create take file\n");
+        return false;
+    }
+
+    // Size the ring and conversion scratch up front so the callback never allocates
+    m_recordRing.resize(static_cast<size_t>(RECORD_RING_SECONDS) *
+                        m_inputFormat.nSamplesPerSec * m_inputFormat.nChannels);
+    m_recordScratch.configure(ScratchArena::bytesForBlock(m_bufferConfig.recordBufferFrames, m_inputFormat.nChannels, 1));
+    m_recordedFrames = 0;
+    m_recordDroppedSamples = 0;
+    m_recordedClip = std::make_shared<AudioClip>();
+    m_recordedClip->setFormat(format);
+    m_recordedClip->setFilename(m_takeFilename);
+
+    m_recordWriterRunning = true;
+    m_recordWriterThread = std::thread(&AudioEngine::recordWriterLoop, this);
     
     // If input monitoring is enabled and we're not already playing, start playback to hear tracks
-    if (m_inputMonitoring && !m_isPlaying && (m_duration > 0.0 || m_clip)) {
+    if (m_mixMonitoring && !m_isPlaying && (m_duration > 0.0 || m_clip)) {
         play();
     }
     
     // Queue all recording buffers
-    for (int i = 0; i < NUM_RECORD_BUFFERS; ++i) {
-        m_recordHeaders[i].dwBytesRecorded = 0;
-        waveInAddBuffer(m_waveIn, &m_recordHeaders[i], sizeof(WAVEHDR));
+    for (WAVEHDR& header : m_recordHeaders) {
+        header.dwBytesRecorded = 0;
+        waveInAddBuffer(m_waveIn, &header, sizeof(WAVEHDR));
     }
     
-    // Start recording
+    // Start recording (monitoring re-primes from the first new input)
+    m_inputMonitor.flush();
+    m_isRecording = true;
     MMRESULT result = waveInStart(m_waveIn);
     if (result != MMSYSERR_NOERROR) {
+        m_isRecording = false;
+        waveInReset(m_waveIn);
+        m_recordWriterRunning = false;
+        m_recordWriterThread.join();
+        m_takeWriter->close();
+        m_recordedClip.reset();
+        DeleteFile(m_takeFilename.c_str());
         return false;
     }
     
-    m_isRecording = true;
     return true;
 }
 
 void AudioEngine::stopRecording() {
     if (!m_isRecording || !m_waveIn) return;
     
-    // Set stopping flag - callbacks will write to pending buffer
+    // Set stopping flag - returned buffers are captured but not re-queued
     m_isStopping = true;
     
-    // Clear pending samples buffer (no lock needed, we own it during stopping)
-    m_pendingSamples.clear();
-    
     // Stop recording
     waveInStop(m_waveIn);
     
-    // Reset returns all buffers - they go to m_pendingSamples
+    // Reset returns all buffers - their contents still go into the ring
     waveInReset(m_waveIn);
     
-    // Now merge pending samples into recorded samples
-    {
-        std::lock_guard<std::mutex> lock(m_recordMutex);
-        m_recordedSamples.insert(m_recordedSamples.end(), 
-                                  m_pendingSamples.begin(), 
-                                  m_pendingSamples.end());
-    }
-    
     // Now safe to clear flags
     m_isRecording = false;
     m_isStopping = false;
+
+    // Let the writer drain what is left in the ring, then finalize the file
+    m_recordWriterRunning = false;
+    if (m_recordWriterThread.joinable()) {
+        m_recordWriterThread.join();
+    }
+    m_takeWriter->close();
+
+    if (m_recordDroppedSamples > 0) {
+        wchar_t buf[128];
+        swprintf_s(buf, L"Recording overflow: %llu samples dropped\n",
+                   static_cast<unsigned long long>(m_recordDroppedSamples.load()));
+        OutputDebugStringW(buf);
+    }
+
+    // The writer built the in-memory clip as it went. The take file stays on
+    // disk for the owner of the clip to adopt.
+    if (m_recordedFrames == 0) {
+        m_recordedClip.reset();
+        DeleteFile(m_takeFilename.c_str());
+    }
     
     // Notify callback if set
     if (m_recordingCallback) {
         auto clip = getRecordedClip();
         if (clip) {
-            m_recordingCallback(clip);
+            m_recordingCallback(std::move(clip));
         }
     }
 }
 
 std::shared_ptr<AudioClip> AudioEngine::getRecordedClip() {
-    std::lock_guard<std::mutex> lock(m_recordMutex);
-    
-    if (m_recordedSamples.empty()) {
-        return nullptr;
-    }
-    
-    auto clip = std::make_shared<AudioClip>();
-    
-    AudioFormat format;
-    format.channels = m_waveFormat.nChannels;
-    format.sampleRate = m_waveFormat.nSamplesPerSec;
-    format.bitsPerSample = m_waveFormat.wBitsPerSample;
-    clip->setFormat(format);
-    
-    clip->getSamplesWritable() = m_recordedSamples;
-    
-    return clip;
+    return std::move(m_recordedClip);
 }
 
 double AudioEngine::getRecordingDuration() const {
-    if (m_waveFormat.nSamplesPerSec == 0 || m_waveFormat.nChannels == 0) {
+    if (m_inputFormat.nSamplesPerSec == 0) {
         return 0.0;
     }
     
-    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(m_recordMutex));
-    size_t frameCount = m_recordedSamples.size() / m_waveFormat.nChannels;
-    return static_cast<double>(frameCount) / m_waveFormat.nSamplesPerSec;
+    return static_cast<double>(m_recordedFrames.load()) / m_inputFormat.nSamplesPerSec;
+}
+
+void AudioEngine::recordWriterLoop() {
+    // Drain in blocks of whole frames
+    const size_t channels = m_inputFormat.nChannels;
+    std::vector<float> block(static_cast<size_t>(m_bufferConfig.recordBufferFrames) * channels);
+    std::vector<float>& clipSamples = m_recordedClip->getSamplesWritable();
+    auto lastHeaderPatch = std::chrono::steady_clock::now();
+
+    while (true) {
+        // Sample the flag before draining so nothing pushed before stop is missed
+        bool running = m_recordWriterRunning.load();
+
+        size_t count;
+        while ((count = m_recordRing.read(block.data(), block.size())) > 0) {
+            if (!m_takeWriter->write(block.data(), count / channels)) {
+                OutputDebugStringW(L"Recording: failed to write take file\n");
+            }
+            clipSamples.insert(clipSamples.end(), block.data(), block.data() + count);
+        }
+
+        if (!running) break;
+
+        // Keep the take file a valid WAV on disk in case the app dies mid-take
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastHeaderPatch >= std::chrono::milliseconds(RECORD_HEADER_PATCH_MS)) {
+            m_takeWriter->flushHeader();
+            lastHeaderPatch = now;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(RECORD_WRITER_INTERVAL_MS));
+    }
 }
 
 void CALLBACK AudioEngine::waveInProc(HWAVEIN hwi, UINT uMsg,
                                        DWORD_PTR dwInstance, DWORD_PTR dwParam1, DWORD_PTR dwParam2) {
     if (uMsg == WIM_DATA) {
+        RealtimeCheck::Scope realtime("AudioEngine::waveInProc");
+        ThreadPriority::ensureCurrentThreadRealtime(ThreadPriority::Task::ProAudio);
         AudioEngine* engine = reinterpret_cast<AudioEngine*>(dwInstance);
         WAVEHDR* header = reinterpret_cast<WAVEHDR*>(dwParam1);
         
@@ -877,35 +1535,30 @@ void CALLBACK AudioEngine::waveInProc(HWAVEIN hwi, UINT uMsg,
 }
 
 void AudioEngine::processRecordedBuffer(WAVEHDR* header) {
-    if (!header || header->dwBytesRecorded == 0) return;
+    if (!header || header->dwBytesRecorded == 0 || !m_isRecording) return;
     
     const int16_t* inputBuffer = reinterpret_cast<const int16_t*>(header->lpData);
     size_t sampleCount = header->dwBytesRecorded / sizeof(int16_t);
-    
-    // During stopping phase, write directly to pending buffer (no lock needed)
-    if (m_isStopping) {
-        size_t oldSize = m_pendingSamples.size();
-        m_pendingSamples.resize(oldSize + sampleCount);
-        for (size_t i = 0; i < sampleCount; ++i) {
-            m_pendingSamples[oldSize + i] = inputBuffer[i] / 32768.0f;
-        }
-        return;
-    }
 
-    // Normal recording - use mutex
-    std::lock_guard<std::mutex> lock(m_recordMutex);
+    ScratchArena::Frame scratch(m_recordScratch);
+    float* samples = m_recordScratch.allocate<float>(sampleCount);
+    if (!samples) return;
+    SampleConvert::toFloat(inputBuffer, samples, sampleCount, SampleFormat::Int16);
 
-    size_t oldSize = m_recordedSamples.size();
-    m_recordedSamples.resize(oldSize + sampleCount);
+    const size_t channels = m_inputFormat.nChannels;
+    if (m_mixMonitoring) {
+        m_inputMonitor.push(samples, sampleCount / channels);
+    }
 
-    for (size_t i = 0; i < sampleCount; ++i) {
-        float sample = inputBuffer[i] / 32768.0f;
-        m_recordedSamples[oldSize + i] = sample;
+    // Hand off to the writer thread. Only whole frames go into the ring; if
+    // the writer has fallen behind the remainder is counted and dropped
+    // rather than blocking the callback.
+    size_t writable = std::min(sampleCount, m_recordRing.availableToWrite());
+    writable -= writable % channels;
+    size_t written = m_recordRing.write(samples, writable);
 
-        if (m_inputMonitoring) {
-            size_t writePos = m_inputMonitorWritePos.load();
-            m_inputMonitorBuffer[writePos] = sample;
-            m_inputMonitorWritePos = (writePos + 1) % INPUT_MONITOR_BUFFER_SIZE;
-        }
+    m_recordedFrames += written / channels;
+    if (written < sampleCount) {
+        m_recordDroppedSamples += sampleCount - written;
     }
 }
@@ -9,14 +9,29 @@
 #include <memory>
 #include <mutex>
 #include <chrono>
+#include <thread>
+#include "SampleFormat.h"
+#include "AudioBufferConfig.h"
+#include "AudioLoadMonitor.h"
+#include "AdaptiveBufferController.h"
+#include "RenderAheadQueue.h"
+#include "SpscRingBuffer.h"
+#include "InputMonitorBuffer.h"
+#include "DirectMonitor.h"
+#include "RealtimeCheck.h"
+#include "ScratchArena.h"
+#include "PlayheadClock.h"
 
-// Forward declaration
+// Forward declarations
 class Track;
+class WavWriter;
+class ConvolutionReverb;
 
 struct AudioFormat {
     uint16_t channels = 2;
     uint32_t sampleRate = 44100;
     uint16_t bitsPerSample = 16;
+    bool isFloat = false;  // IEEE float samples (32-bit only)
     
     uint32_t bytesPerSample() const { return bitsPerSample / 8; }
     uint32_t bytesPerFrame() const { return bytesPerSample() * channels; }
@@ -32,6 +47,10 @@ public:
     const AudioFormat& getFormat() const { return m_format; }
     void setFormat(const AudioFormat& format) { m_format = format; }
     double getDuration() const;
+    // File the clip was loaded from (empty for clips never loaded from disk)
+    const std::wstring& getFilename() const { return m_filename; }
+    // Point the clip at the file now holding its samples (e.g. after a take is moved)
+    void setFilename(const std::wstring& filename) { m_filename = filename; }
     size_t getSampleCount() const { return m_samples.size() / m_format.channels; }
     
     // Get min/max values for waveform display (returns pairs of min,max for each block)
@@ -60,7 +79,6 @@ private:
 
 class AudioEngine {
 public:
-    using PositionCallback = std::function<void(double positionSeconds)>;
     using RecordingCallback = std::function<void(std::shared_ptr<AudioClip> recordedClip)>;
     using SpectrumCallback = std::function<void(const float* samples, size_t sampleCount, int sampleRate)>;
     using EQCallback = std::function<void(float* samples, size_t frameCount, int sampleRate)>;
@@ -68,7 +86,11 @@ public:
     AudioEngine();
     ~AudioEngine();
 
-    bool initialize(uint32_t sampleRate = 44100, uint16_t channels = 2);
+    // Opens the output device in the preferred sample format, falling back to
+    // 24-bit and then 16-bit PCM if the device does not accept it.
+    // Uses the buffer layout from setBufferConfig().
+    bool initialize(uint32_t sampleRate = 44100, uint16_t channels = 2,
+                    SampleFormat preferredFormat = SampleFormat::Float32);
     void shutdown();
 
     // Transport controls
@@ -77,22 +99,44 @@ public:
     void stop();
     void setPosition(double seconds);
     
+    // Audible position, extrapolated from the last device update
     double getPosition() const;
     double getDuration() const;
+
+    // Audible frame and when it started playing, for UI interpolation
+    PlayheadClock::Snapshot getPlayhead() const { return m_playhead.read(); }
+    // Audio still ahead of the listener once a buffer has left the device
+    // queue: WinMM plays through the shared-mode system mixer, which buffers
+    // about two of its 10 ms periods. WinMM doesn't report it, so this is an
+    // estimate; the UI subtracts it when drawing the playhead.
+    static constexpr double POST_QUEUE_LATENCY_SECONDS = 0.02;
+    double getPostQueueLatency() const { return POST_QUEUE_LATENCY_SECONDS; }
+    // How far past the last update the playhead may be extrapolated
+    double getPlayheadMaxExtrapolation() const { return 2.0 * m_activeBufferFrames.load(); }
     bool isPlaying() const { return m_isPlaying; }
 
     // Recording controls
     bool startRecording();
     void stopRecording();
     bool isRecording() const { return m_isRecording; }
+
+    // Hands the last take over to the caller; the engine keeps no reference.
+    // The samples live in the returned clip and the audio is already on disk
+    // at getRecordedFilename(), so callers can adopt the file (move/rename)
+    // instead of re-saving it.
     std::shared_ptr<AudioClip> getRecordedClip();
+    const std::wstring& getRecordedFilename() const { return m_takeFilename; }
+
+    // Samples the writer thread could not keep up with during the last take
+    uint64_t getRecordingDroppedSamples() const { return m_recordDroppedSamples.load(); }
     
     // Get list of available input devices
     static std::vector<std::wstring> getInputDevices();
     bool setInputDevice(int deviceIndex);
     int getInputDevice() const { return m_inputDeviceIndex; }
 
-    // Track management for mixing
+    // Track management for mixing. The engine mixes a copy of the list, so
+    // call again whenever tracks are added or removed.
     void setTracks(std::vector<std::shared_ptr<Track>>* tracks);
     void setDuration(double duration) { m_duration = duration; }
     
@@ -108,20 +152,92 @@ public:
     float getMasterPeakLevel() const { return m_masterPeakLevel.load(); }
 
     // Input monitoring
-    void setInputMonitoring(bool enabled) { m_inputMonitoring = enabled; }
+    void setInputMonitoring(bool enabled);
     bool getInputMonitoring() const { return m_inputMonitoring; }
 
+    // Direct monitoring runs input through its own small-buffer device path
+    // (DirectMonitor) instead of the playback buffers. Falls back to the mix
+    // path if the direct path cannot be opened.
+    void setDirectMonitoring(bool enabled, uint32_t blockFrames = DirectMonitor::DEFAULT_BLOCK_FRAMES);
+    bool getDirectMonitoring() const { return m_directMonitoringEnabled; }
+    bool isDirectMonitorActive() const { return m_directMonitor.isRunning(); }
+    const DirectMonitor& getDirectMonitor() const { return m_directMonitor; }
+
+    // Input-to-output monitoring latency in frames for the mix path (at least one playback buffer)
+    void setInputMonitorLatency(size_t frames);
+    size_t getInputMonitorLatency() const { return m_inputMonitor.getTargetLatency(); }
+    InputMonitorBuffer::Stats getInputMonitorStats() const { return m_inputMonitor.getStats(); }
+
+    // Device buffer counts and sizes. Can be called before or after
+    // initialize(); a running engine stops playback and rebuilds its buffers.
+    // Fails while recording.
+    bool setBufferConfig(const AudioBufferConfig& config);
+    const AudioBufferConfig& getBufferConfig() const { return m_bufferConfig; }
+
+    // Adaptive buffering grows the playback buffers when measured load or
+    // underruns call for it and shrinks them back towards the configured
+    // layout when there is headroom. Changes take effect at buffer boundaries
+    // without stopping playback; turning the mode on or off rebuilds the
+    // buffers once (playback stops). Fails while recording.
+    bool setAdaptiveBuffering(bool enabled);
+    bool getAdaptiveBuffering() const { return m_adaptiveBuffering; }
+
+    // Playback layout in use right now (differs from getBufferConfig() only
+    // while adaptive buffering has moved it)
+    AudioBufferConfig getActiveBufferConfig() const;
+
+    // Input, output and round-trip (mix monitoring) latency of the active buffers
+    AudioLatency getLatency() const;
+
+    // Playback callback timing: DSP load per block against the buffer period,
+    // late blocks and device underruns. Lock-free; poll from the UI.
+    AudioLoadMonitor::Snapshot getStats() const { return m_loadMonitor.getSnapshot(); }
+    void resetStats() { m_loadMonitor.reset(); }
+
+    // Render-ahead mixes on a dedicated thread up to lookAheadFrames ahead of
+    // the device, so the playback callback only copies finished audio and
+    // expensive DSP has the whole look-ahead as slack instead of the device
+    // buffers. Seeks flush the look-ahead; parameter changes that must be heard
+    // immediately call invalidateRenderAhead(). Each flush feeds the re-rendered
+    // audio through the EQs and reverbs a second time (their state is not
+    // rolled back), so invalidations are throttled to one per look-ahead of
+    // playback, see RenderAheadQueue. Stops playback; fails while recording.
+    static constexpr size_t DEFAULT_RENDER_AHEAD_FRAMES = 8192;
+    bool setRenderAhead(bool enabled, size_t lookAheadFrames = DEFAULT_RENDER_AHEAD_FRAMES);
+    bool getRenderAhead() const { return m_renderAheadEnabled; }
+    size_t getRenderAheadFrames() const { return m_renderAhead.getLookAheadFrames(); }
+    void invalidateRenderAhead();
+
     // Callbacks
-    void setPositionCallback(PositionCallback callback) { m_positionCallback = callback; }
     void setRecordingCallback(RecordingCallback callback) { m_recordingCallback = callback; }
     void setSpectrumCallback(SpectrumCallback callback) { m_spectrumCallback = callback; }
     void setEQCallback(EQCallback callback) { m_eqCallback = callback; }
 
+    // Convolution reverb on the whole master bus (stereo output only), ahead of the EQ
+    ConvolutionReverb& getMasterReverb() { return *m_masterReverb; }
+
+    // The master bus after the mix and master volume: reverb (stereo only),
+    // then EQ, in place. Playback runs it on every block and the stem
+    // exporter on the master stem, so an export sounds like playback.
+    static void processMasterBus(float* buffer, size_t frameCount, uint16_t channels, uint32_t sampleRate,
+                                 ConvolutionReverb* reverb, const EQCallback& eq);
+
+    // Mixing without an output device, for tests and offline checks:
+    // initializeOffline() sets the mix format and scratch for blocks of up to
+    // maxFrames, and render() mixes the next frameCount frames from position
+    // into buffer (interleaved float) exactly as a playback buffer would be.
+    // Not while playing.
+    void initializeOffline(uint32_t sampleRate, uint16_t channels, size_t maxFrames);
+    void render(float* buffer, size_t frameCount, size_t& position);
+
     // Get current playback sample position
     size_t getPlaybackPosition() const { return m_playbackPosition; }
     
     // Get sample rate
     uint32_t getSampleRate() const { return m_waveFormat.nSamplesPerSec; }
+
+    // Sample format negotiated with the output device
+    SampleFormat getOutputFormat() const { return m_outputFormat; }
     
     // Get recording duration in seconds
     double getRecordingDuration() const;
@@ -130,8 +246,25 @@ private:
     // Playback
     static void CALLBACK waveOutProc(HWAVEOUT hwo, UINT uMsg, 
                                       DWORD_PTR dwInstance, DWORD_PTR dwParam1, DWORD_PTR dwParam2);
+    bool openOutputDevice(uint32_t sampleRate, uint16_t channels, SampleFormat format);
+    void allocatePlaybackBuffers();
+    void releasePlaybackBuffers();
+    void rebuildPlaybackBuffers();
+    bool queueBuffer(WAVEHDR* header);
+    WAVEHDR* findIdleBuffer();
+    int countQueuedBuffers() const;
+    void publishPlayhead(const WAVEHDR* completed);
+    void updateAdaptiveLayout(bool underrun);
     void fillBuffer(WAVEHDR* header);
-    void processAudio(int16_t* buffer, size_t frameCount);
+    void processAudio(float* buffer, size_t frameCount, size_t& position, ScratchArena& scratch);
+
+    // Render-ahead thread
+    void startRenderAhead(bool fresh);
+    void stopRenderAhead();
+    void restartRenderAhead(size_t fromFrame);  // Seek the renderer without waking it
+    void flushRenderAhead(size_t fromFrame);
+    void renderAheadLoop();
+    bool renderAheadBlock();
 
     // Recording
     static void CALLBACK waveInProc(HWAVEIN hwi, UINT uMsg,
@@ -139,55 +272,125 @@ private:
     void processRecordedBuffer(WAVEHDR* header);
     bool initializeRecording();
     void shutdownRecording();
+    void recordWriterLoop();
+    void updateMonitoringPath();
 
     // Playback members
     HWAVEOUT m_waveOut = nullptr;
-    WAVEFORMATEX m_waveFormat = {};
+    WAVEFORMATEX m_waveFormat = {};   // Output device format
+    WAVEFORMATEX m_inputFormat = {};  // Recording format (always 16-bit PCM)
+    SampleFormat m_outputFormat = SampleFormat::Int16;
     
-    static constexpr int NUM_BUFFERS = 3;
-    static constexpr int BUFFER_SIZE_FRAMES = 2048;
-    WAVEHDR m_headers[NUM_BUFFERS] = {};
-    std::vector<int16_t> m_buffers[NUM_BUFFERS];
+    AudioBufferConfig m_bufferConfig;  // Always clamped
+    std::vector<WAVEHDR> m_headers;    // Sized for the largest layout adaptive buffering can pick
+    std::vector<std::vector<uint8_t>> m_buffers;  // Raw device samples in m_outputFormat
+
+    // Layout being rendered; only the playback callback changes it while playing
+    std::atomic<int> m_activeBufferFrames{2048};
+    std::atomic<int> m_activeBufferCount{3};
+    std::atomic<bool> m_adaptiveBuffering{false};
+    AdaptiveBufferController m_adaptiveController;  // Playback callback only while playing
+    std::atomic<float> m_lastBlockLoad{0.0f};       // Latest render load (callback or render thread)
+
+    // Render-ahead: mixed blocks flow render thread -> m_renderAhead -> callback.
+    // A flush bumps m_renderGeneration after storing m_renderSeekFrame; the
+    // render thread restarts from there and the callback drops older blocks.
+    static constexpr size_t RENDER_AHEAD_BLOCK_FRAMES = 512;
+    static constexpr DWORD RENDER_AHEAD_WAIT_MS = 5;
+    std::atomic<bool> m_renderAheadEnabled{false};
+    RenderAheadQueue m_renderAhead;
+    ScratchArena m_renderScratch;  // Render thread's monitor input and track block, one block each
+    std::thread m_renderThread;
+    std::atomic<bool> m_renderThreadRunning{false};
+    HANDLE m_renderWake = nullptr;  // Auto-reset; set by the callback as blocks free up
+    std::atomic<uint64_t> m_renderGeneration{0};
+    std::atomic<size_t> m_renderSeekFrame{0};
+    std::atomic<bool> m_renderReachedEnd{false};
+    uint64_t m_renderedGeneration = 0;  // Render thread only
+    size_t m_renderPosition = 0;        // Render thread only
 
     std::shared_ptr<AudioClip> m_clip;
-    std::vector<std::shared_ptr<Track>>* m_tracks = nullptr;  // Pointer to tracks for mixing
-    mutable std::mutex m_tracksMutex;  // Protects m_tracks access
+
+    // Tracks being mixed. setTracks() copies the list into a snapshot on the
+    // UI thread and hands it over lock-free, as ConvolutionReverb does with its
+    // engines: UI -> audio in m_pendingTracks, audio -> UI in m_retiredTracks.
+    // The snapshot also carries the per-block work list, reserved up front,
+    // so mixing never allocates or locks.
+    struct MixTrack {
+        Track* track;
+        bool audible;  // False: only visited so its reverb tail rings out
+    };
+    struct TrackSnapshot {
+        std::vector<std::shared_ptr<Track>> tracks;
+        std::vector<MixTrack> mix;  // Audio thread; capacity tracks.size()
+    };
+    void publishTracks(TrackSnapshot* snapshot);
+    void takePendingTracks();
+    std::atomic<TrackSnapshot*> m_pendingTracks{nullptr};
+    std::atomic<TrackSnapshot*> m_retiredTracks{nullptr};
+    TrackSnapshot* m_activeTracks = nullptr;  // Audio thread
     double m_duration = 0.0;  // Total project duration
-    std::atomic<size_t> m_playbackPosition{0};
+    std::atomic<size_t> m_playbackPosition{0};  // Next frame to render (ahead of what is heard)
+
+    // Audible playhead. Each device buffer remembers the project frame it
+    // starts at and the order it was queued in, so when one finishes the
+    // next one to play - and so the frame now audible - is known exactly.
+    PlayheadClock m_playhead;
+    std::vector<size_t> m_bufferStartFrames;
+    std::vector<uint64_t> m_bufferSequence;
+    uint64_t m_nextBufferSequence = 0;
     std::atomic<bool> m_isPlaying{false};
     std::atomic<bool> m_isPaused{false};  // True if paused (vs stopped)
     std::atomic<float> m_volume{1.0f};
     std::atomic<float> m_masterPeakLevel{0.0f};  // Master output peak level for VU meter
+    AudioLoadMonitor m_loadMonitor;
 
-    // Pre-allocated buffer for float conversion (avoids per-buffer allocation)
-    std::vector<float> m_floatConversionBuffer;
+    // Playback callback scratch: the float mix bus, pulled monitor input and
+    // the block of the track being mixed. The whole chain - mixing, EQ, metering, spectrum -
+    // runs on the mix span and it is converted to the device format exactly once.
+    static constexpr size_t PLAYBACK_SCRATCH_SPANS = 3;
+    ScratchArena m_playbackScratch;
     
     // Recording members
     HWAVEIN m_waveIn = nullptr;
-    static constexpr int NUM_RECORD_BUFFERS = 4;
-    static constexpr int RECORD_BUFFER_SIZE_FRAMES = 4096;
-    WAVEHDR m_recordHeaders[NUM_RECORD_BUFFERS] = {};
-    std::vector<int16_t> m_recordBuffers[NUM_RECORD_BUFFERS];
-    
-    std::vector<float> m_recordedSamples;
-    std::vector<float> m_pendingSamples;  // NEW: Buffer for samples during stop
-    mutable std::mutex m_recordMutex;
+    std::vector<WAVEHDR> m_recordHeaders;
+    std::vector<std::vector<int16_t>> m_recordBuffers;
+    ScratchArena m_recordScratch;  // Callback-side int16 -> float conversion
+
+    // Recorded audio goes callback -> lock-free ring -> writer thread -> take
+    // file on disk, so the callback never blocks and take length is bounded
+    // by disk space rather than memory. The writer also appends each block to
+    // the take's clip, so stopping never has to read the file back in.
+    // The header is patched periodically so a crash leaves a recoverable take
+    // (see RecordingRecovery).
+    static constexpr int RECORD_RING_SECONDS = 10;
+    static constexpr int RECORD_WRITER_INTERVAL_MS = 10;
+    static constexpr int RECORD_HEADER_PATCH_MS = 2000;
+    SpscRingBuffer<float> m_recordRing;
+    std::unique_ptr<WavWriter> m_takeWriter;  // Only touched by the writer thread while recording
+    std::wstring m_takeFilename;
+    std::thread m_recordWriterThread;
+    std::atomic<bool> m_recordWriterRunning{false};
+    std::atomic<uint64_t> m_recordedFrames{0};
+    std::atomic<uint64_t> m_recordDroppedSamples{0};
+    std::shared_ptr<AudioClip> m_recordedClip;  // Filled by the writer thread while recording
+
     std::atomic<bool> m_isRecording{false};
     std::atomic<bool> m_isStopping{false};
-    std::atomic<bool> m_inputMonitoring{false};
+    std::atomic<bool> m_inputMonitoring{false};  // User setting
+    std::atomic<bool> m_mixMonitoring{false};    // Monitoring through the playback buffers
+    bool m_directMonitoringEnabled = true;
+    uint32_t m_directMonitorBlockFrames = DirectMonitor::DEFAULT_BLOCK_FRAMES;
+    DirectMonitor m_directMonitor;
     int m_inputDeviceIndex = 0;  // WAVE_MAPPER by default
     
-    PositionCallback m_positionCallback;
     RecordingCallback m_recordingCallback;
     SpectrumCallback m_spectrumCallback;
     EQCallback m_eqCallback;
+    std::unique_ptr<ConvolutionReverb> m_masterReverb;
 
-    std::chrono::steady_clock::time_point m_playbackStartTime;
-    bool m_playbackStarted = false;
 
-    // Input monitoring buffer for real-time audio
-    std::vector<float> m_inputMonitorBuffer;
-    std::atomic<size_t> m_inputMonitorWritePos{0};
-    std::atomic<size_t> m_inputMonitorReadPos{0};  // Fixed: Made atomic for thread safety
-    static constexpr size_t INPUT_MONITOR_BUFFER_SIZE = 8192;
+    // Input monitoring: recording callback -> ring -> playback callback
+    InputMonitorBuffer m_inputMonitor;
+    static constexpr size_t INPUT_MONITOR_CAPACITY_FRAMES = 32768;
 };
@@ -0,0 +1,64 @@
+#include "AudioLoadMonitor.h"
+#include <algorithm>
+
+void AudioLoadMonitor::recordBlock(double renderSeconds, double periodSeconds) {
+    if (periodSeconds <= 0.0) return;
+
+    float load = static_cast<float>(renderSeconds / periodSeconds);
+
+    m_blocks.fetch_add(1, std::memory_order_relaxed);
+    m_histogram[binForLoad(load)].fetch_add(1, std::memory_order_relaxed);
+    if (load >= 1.0f) {
+        m_lateBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Single writer, so plain load/store is enough for the derived values
+    m_lastLoad.store(load, std::memory_order_relaxed);
+    float average = m_averageLoad.load(std::memory_order_relaxed);
+    m_averageLoad.store(average + LOAD_SMOOTHING * (load - average), std::memory_order_relaxed);
+    if (load > m_peakLoad.load(std::memory_order_relaxed)) {
+        m_peakLoad.store(load, std::memory_order_relaxed);
+    }
+}
+
+AudioLoadMonitor::Snapshot AudioLoadMonitor::getSnapshot() const {
+    Snapshot snapshot;
+    snapshot.blocks = m_blocks.load(std::memory_order_relaxed);
+    snapshot.lateBlocks = m_lateBlocks.load(std::memory_order_relaxed);
+    snapshot.underruns = m_underruns.load(std::memory_order_relaxed);
+    snapshot.lastLoad = m_lastLoad.load(std::memory_order_relaxed);
+    snapshot.averageLoad = m_averageLoad.load(std::memory_order_relaxed);
+    snapshot.peakLoad = m_peakLoad.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < HISTOGRAM_BINS; ++i) {
+        snapshot.loadHistogram[i] = m_histogram[i].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+void AudioLoadMonitor::reset() {
+    m_blocks = 0;
+    m_lateBlocks = 0;
+    m_underruns = 0;
+    m_lastLoad = 0.0f;
+    m_averageLoad = 0.0f;
+    m_peakLoad = 0.0f;
+    for (auto& bin : m_histogram) {
+        bin = 0;
+    }
+}
+
+size_t AudioLoadMonitor::binForLoad(float load) {
+    if (!(load > 0.0f)) return 0;
+    return std::min(static_cast<size_t>(load * 10.0f), HISTOGRAM_BINS - 1);
+}
+
+double AudioLoadMonitor::Snapshot::fractionAtOrAbove(float minLoad) const {
+    uint64_t total = 0;
+    uint64_t above = 0;
+    size_t firstBin = binForLoad(minLoad);
+    for (size_t i = 0; i < HISTOGRAM_BINS; ++i) {
+        total += loadHistogram[i];
+        if (i >= firstBin) above += loadHistogram[i];
+    }
+    return total > 0 ? static_cast<double>(above) / total : 0.0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Measures how much of each buffer period the audio callback spends rendering
+// and counts the callbacks that did not make it. All counters are lock-free;
+// the audio thread is the only writer and the UI reads snapshots at any time.
+//
+// A block's load is its render time as a fraction of the buffer's playback
+// time. A block at or over 100% is late: the device drains faster than we can
+// fill it. An underrun is the device actually running dry (see AudioEngine).
+class AudioLoadMonitor {
+public:
+    // Ten 10% bins plus one for late blocks (>= 100%)
+    static constexpr size_t HISTOGRAM_BINS = 11;
+
+    struct Snapshot {
+        uint64_t blocks = 0;         // Blocks rendered since the last reset
+        uint64_t lateBlocks = 0;     // Render time exceeded the buffer period
+        uint64_t underruns = 0;      // Device ran out of queued audio
+        float lastLoad = 0.0f;       // 0..1+ of the buffer period
+        float averageLoad = 0.0f;    // Smoothed over recent blocks
+        float peakLoad = 0.0f;       // Highest since the last reset
+        std::array<uint64_t, HISTOGRAM_BINS> loadHistogram{};
+
+        // Share of blocks with at least minLoad load, from the histogram
+        double fractionAtOrAbove(float minLoad) const;
+    };
+
+    // Audio thread: one rendered block
+    void recordBlock(double renderSeconds, double periodSeconds);
+
+    // Audio thread: the device had nothing queued when a buffer completed
+    void recordUnderrun() { m_underruns.fetch_add(1, std::memory_order_relaxed); }
+
+    Snapshot getSnapshot() const;
+
+    // Safe from any thread; a block in flight may land in either period
+    void reset();
+
+    static size_t binForLoad(float load);
+
+private:
+    static constexpr float LOAD_SMOOTHING = 0.1f;  // EMA weight per block
+
+    std::atomic<uint64_t> m_blocks{0};
+    std::atomic<uint64_t> m_lateBlocks{0};
+    std::atomic<uint64_t> m_underruns{0};
+    std::atomic<float> m_lastLoad{0.0f};
+    std::atomic<float> m_averageLoad{0.0f};
+    std::atomic<float> m_peakLoad{0.0f};
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BINS> m_histogram{};
+};
@@ -0,0 +1,261 @@
+#include "BiquadCascade.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+BiquadCascade::Coefficients BiquadCascade::peakingEQ(float centerFreq, float gainDB, float Q, float sampleRate) {
+    float A = std::pow(10.0f, gainDB / 40.0f);  // sqrt of linear gain
+    float omega = 2.0f * static_cast<float>(M_PI) * centerFreq / sampleRate;
+    float sinOmega = std::sin(omega);
+    float cosOmega = std::cos(omega);
+    float alpha = sinOmega / (2.0f * Q);
+
+    // RBJ Audio EQ Cookbook - Peaking EQ
+    Coefficients c;
+    float a0 = 1.0f + alpha / A;
+    c.b0 = (1.0f + alpha * A) / a0;
+    c.b1 = (-2.0f * cosOmega) / a0;
+    c.b2 = (1.0f - alpha * A) / a0;
+    c.a1 = (-2.0f * cosOmega) / a0;
+    c.a2 = (1.0f - alpha / A) / a0;
+    return c;
+}
+
+namespace {
+
+// RBJ Audio EQ Cookbook - low shelf (sign -1) or high shelf (sign +1), S = 1
+BiquadCascade::Coefficients shelf(float cornerFreq, float gainDB, float sampleRate, float sign) {
+    // Flat shelves are exact identity, so the cascade can leave them out
+    if (gainDB == 0.0f) {
+        return {};
+    }
+
+    float A = std::pow(10.0f, gainDB / 40.0f);
+    float omega = 2.0f * static_cast<float>(M_PI) * cornerFreq / sampleRate;
+    float cosOmega = std::cos(omega);
+    float alpha = std::sin(omega) / 2.0f * std::sqrt(2.0f);
+    float twoSqrtAAlpha = 2.0f * std::sqrt(A) * alpha;
+
+    BiquadCascade::Coefficients c;
+    float a0 = (A + 1.0f) - sign * (A - 1.0f) * cosOmega + twoSqrtAAlpha;
+    c.b0 = A * ((A + 1.0f) + sign * (A - 1.0f) * cosOmega + twoSqrtAAlpha) / a0;
+    c.b1 = -sign * 2.0f * A * ((A - 1.0f) + sign * (A + 1.0f) * cosOmega) / a0;
+    c.b2 = A * ((A + 1.0f) + sign * (A - 1.0f) * cosOmega - twoSqrtAAlpha) / a0;
+    c.a1 = sign * 2.0f * ((A - 1.0f) - sign * (A + 1.0f) * cosOmega) / a0;
+    c.a2 = ((A + 1.0f) - sign * (A - 1.0f) * cosOmega - twoSqrtAAlpha) / a0;
+    return c;
+}
+
+} // namespace
+
+BiquadCascade::Coefficients BiquadCascade::lowShelf(float cornerFreq, float gainDB, float sampleRate) {
+    return shelf(cornerFreq, gainDB, sampleRate, -1.0f);
+}
+
+BiquadCascade::Coefficients BiquadCascade::highShelf(float cornerFreq, float gainDB, float sampleRate) {
+    return shelf(cornerFreq, gainDB, sampleRate, 1.0f);
+}
+
+BiquadCascade::BiquadCascade() {
+    std::memset(m_coeffs, 0, sizeof(m_coeffs));
+    reset();
+}
+
+void BiquadCascade::setStages(const Coefficients* stages, int count) {
+    count = std::clamp(count, 0, MAX_STAGES);
+
+    m_stageCount = count;
+    m_activeCount = 0;
+    for (int stage = 0; stage < count; ++stage) {
+        const Coefficients& c = stages[stage];
+        m_stages[stage] = c;
+        const float values[COEFF_COUNT] = {c.b0, c.b1, c.b2, c.a1, c.a2};
+        for (int k = 0; k < COEFF_COUNT; ++k) {
+            for (int lane = 0; lane < MAX_CHANNELS; ++lane) {
+                m_coeffs[stage][k][lane] = values[k];
+            }
+        }
+
+        if (c.isIdentity()) {
+            // Skipped stages restart from silence if they come back
+            std::memset(m_z1[stage], 0, sizeof(m_z1[stage]));
+            std::memset(m_z2[stage], 0, sizeof(m_z2[stage]));
+        } else {
+            m_active[m_activeCount++] = stage;
+        }
+    }
+}
+
+void BiquadCascade::reset() {
+    std::memset(m_z1, 0, sizeof(m_z1));
+    std::memset(m_z2, 0, sizeof(m_z2));
+}
+
+void BiquadCascade::publish(const Coefficients* stages, int count) {
+    count = std::clamp(count, 0, MAX_STAGES);
+
+    // Fill the buffer the reader isn't pointed at
+    uint32_t next = m_published.load(std::memory_order_relaxed) + 1;
+    Slot& slot = m_slots[next & 1];
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.count.store(count, std::memory_order_relaxed);
+    for (int stage = 0; stage < count; ++stage) {
+        const Coefficients& c = stages[stage];
+        const float values[COEFF_COUNT] = {c.b0, c.b1, c.b2, c.a1, c.a2};
+        for (int k = 0; k < COEFF_COUNT; ++k) {
+            slot.values[stage][k].store(values[k], std::memory_order_relaxed);
+        }
+    }
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    m_published.store(next, std::memory_order_release);
+}
+
+bool BiquadCascade::takePublished(Coefficients* stages, int& count) {
+    uint32_t published = m_published.load(std::memory_order_acquire);
+    if (published == m_consumed) return false;
+
+    // The writer only reuses this slot two publishes from now; if that has
+    // already started, keep the current set and look again next block
+    const Slot& slot = m_slots[published & 1];
+    uint32_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before & 1) return false;
+
+    count = slot.count.load(std::memory_order_relaxed);
+    for (int stage = 0; stage < count; ++stage) {
+        Coefficients& c = stages[stage];
+        c.b0 = slot.values[stage][B0].load(std::memory_order_relaxed);
+        c.b1 = slot.values[stage][B1].load(std::memory_order_relaxed);
+        c.b2 = slot.values[stage][B2].load(std::memory_order_relaxed);
+        c.a1 = slot.values[stage][A1].load(std::memory_order_relaxed);
+        c.a2 = slot.values[stage][A2].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != before) return false;
+
+    m_consumed = published;
+    return true;
+}
+
+void BiquadCascade::rampTo(const Coefficients* target, int targetCount, float* samples, size_t frameCount, int channels) {
+    // Missing stages on either side are identity, so bands can come and go
+    int count = std::max(m_stageCount, targetCount);
+    Coefficients from[MAX_STAGES], to[MAX_STAGES], stages[MAX_STAGES];
+    for (int i = 0; i < count; ++i) {
+        from[i] = i < m_stageCount ? m_stages[i] : Coefficients{};
+        to[i] = i < targetCount ? target[i] : Coefficients{};
+    }
+
+    // Linear steps between two stable biquads stay stable (the stable a1/a2
+    // region is a triangle, which is convex). The last step lands exactly on
+    // the target so 0 dB bands are recognized as identity again.
+    size_t steps = (frameCount + RAMP_STEP_FRAMES - 1) / RAMP_STEP_FRAMES;
+    for (size_t step = 1; step < steps; ++step) {
+        float t = static_cast<float>(step) / static_cast<float>(steps);
+        for (int i = 0; i < count; ++i) {
+            stages[i].b0 = from[i].b0 + (to[i].b0 - from[i].b0) * t;
+            stages[i].b1 = from[i].b1 + (to[i].b1 - from[i].b1) * t;
+            stages[i].b2 = from[i].b2 + (to[i].b2 - from[i].b2) * t;
+            stages[i].a1 = from[i].a1 + (to[i].a1 - from[i].a1) * t;
+            stages[i].a2 = from[i].a2 + (to[i].a2 - from[i].a2) * t;
+        }
+        setStages(stages, count);
+        processBlock(samples, RAMP_STEP_FRAMES, channels);
+        samples += RAMP_STEP_FRAMES * channels;
+        frameCount -= RAMP_STEP_FRAMES;
+    }
+
+    setStages(to, count);
+    processBlock(samples, frameCount, channels);
+}
+
+void BiquadCascade::process(float* samples, size_t frameCount, int channels) {
+    if (channels < 1 || channels > MAX_CHANNELS) return;
+
+    // Swap in a published set only here, between blocks
+    Coefficients target[MAX_STAGES];
+    int targetCount = 0;
+    if (takePublished(target, targetCount)) {
+        rampTo(target, targetCount, samples, frameCount, channels);
+    } else {
+        processBlock(samples, frameCount, channels);
+    }
+}
+
+void BiquadCascade::processBlock(float* samples, size_t frameCount, int channels) {
+    if (m_activeCount == 0) return;
+
+#ifdef WAVPLAYER_USE_SSE2
+    // Keep the whole chain's state in registers for the block
+    __m128 z1[MAX_STAGES], z2[MAX_STAGES];
+    for (int i = 0; i < m_activeCount; ++i) {
+        z1[i] = _mm_load_ps(m_z1[m_active[i]]);
+        z2[i] = _mm_load_ps(m_z2[m_active[i]]);
+    }
+
+    alignas(16) float lanes[MAX_CHANNELS] = {};
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        float* frameSamples = samples + frame * channels;
+        __m128 x;
+        if (channels == 2) {
+            x = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(frameSamples)));
+        } else if (channels == 4) {
+            x = _mm_loadu_ps(frameSamples);
+        } else {
+            for (int ch = 0; ch < channels; ++ch) {
+                lanes[ch] = frameSamples[ch];
+            }
+            x = _mm_load_ps(lanes);
+        }
+
+        for (int i = 0; i < m_activeCount; ++i) {
+            const float (*c)[MAX_CHANNELS] = m_coeffs[m_active[i]];
+            __m128 y = _mm_add_ps(_mm_mul_ps(_mm_load_ps(c[B0]), x), z1[i]);
+            z1[i] = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(c[B1]), x), z2[i]), _mm_mul_ps(_mm_load_ps(c[A1]), y));
+            z2[i] = _mm_sub_ps(_mm_mul_ps(_mm_load_ps(c[B2]), x), _mm_mul_ps(_mm_load_ps(c[A2]), y));
+            x = y;
+        }
+
+        if (channels == 2) {
+            _mm_store_sd(reinterpret_cast<double*>(frameSamples), _mm_castps_pd(x));
+        } else if (channels == 4) {
+            _mm_storeu_ps(frameSamples, x);
+        } else {
+            _mm_store_ps(lanes, x);
+            for (int ch = 0; ch < channels; ++ch) {
+                frameSamples[ch] = lanes[ch];
+            }
+        }
+    }
+
+    for (int i = 0; i < m_activeCount; ++i) {
+        _mm_store_ps(m_z1[m_active[i]], z1[i]);
+        _mm_store_ps(m_z2[m_active[i]], z2[i]);
+    }
+#else
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        float* frameSamples = samples + frame * channels;
+        for (int ch = 0; ch < channels; ++ch) {
+            float x = frameSamples[ch];
+            for (int i = 0; i < m_activeCount; ++i) {
+                int stage = m_active[i];
+                const float (*c)[MAX_CHANNELS] = m_coeffs[stage];
+                float y = c[B0][ch] * x + m_z1[stage][ch];
+                m_z1[stage][ch] = c[B1][ch] * x + m_z2[stage][ch] - c[A1][ch] * y;
+                m_z2[stage][ch] = c[B2][ch] * x - c[A2][ch] * y;
+                x = y;
+            }
+            frameSamples[ch] = x;
+        }
+    }
+#endif
+}
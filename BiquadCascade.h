@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// A chain of biquads (Direct Form II Transposed) applied in series to up to
+// MAX_CHANNELS interleaved channels. Channels run side by side in SIMD
+// lanes, so a stereo block costs one vector chain instead of two scalar
+// ones, and the coefficients are kept structure-of-arrays, pre-splatted
+// across the lanes. Stages that are exactly identity (a peaking band at
+// 0 dB) are left out of the chain entirely.
+//
+// Coefficients can change while audio runs: publish() fills one of two
+// buffers and process() swaps it in at the start of its next block, ramping
+// from the old set to the new one across that block. The audio side never
+// locks and never sees a half-written set.
+class BiquadCascade {
+public:
+    static constexpr int MAX_STAGES = 16;
+    static constexpr int MAX_CHANNELS = 4;  // SIMD lanes
+
+    struct Coefficients {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;  // Numerator
+        float a1 = 0.0f, a2 = 0.0f;              // Denominator (a0 normalized to 1)
+
+        // Numerator equal to denominator: the stage passes input through
+        bool isIdentity() const { return b0 == 1.0f && b1 == a1 && b2 == a2; }
+    };
+
+    // RBJ Audio EQ Cookbook peaking filter; 0 dB gives identity
+    static Coefficients peakingEQ(float centerFreq, float gainDB, float Q, float sampleRate);
+
+    // RBJ shelving filters with a shelf slope of 1; 0 dB gives identity
+    static Coefficients lowShelf(float cornerFreq, float gainDB, float sampleRate);
+    static Coefficients highShelf(float cornerFreq, float gainDB, float sampleRate);
+
+    BiquadCascade();
+
+    // Replace the chain's coefficients immediately, on the processing thread.
+    // Stage i keeps its own filter state across calls, so changing one band
+    // doesn't disturb the others.
+    void setStages(const Coefficients* stages, int count);
+
+    // Any other thread, one writer at a time (callers serialize). Picked up
+    // by the next process() call; if a newer set arrives first, it wins.
+    void publish(const Coefficients* stages, int count);
+    int getActiveStageCount() const { return m_activeCount; }
+
+    // Current set on the processing thread, after any ramp has finished
+    int getStageCount() const { return m_stageCount; }
+    const Coefficients& getStage(int index) const { return m_stages[index]; }
+
+    void reset();
+
+    // In place over interleaved frames; channels must be 1..MAX_CHANNELS
+    void process(float* samples, size_t frameCount, int channels);
+
+private:
+    enum { B0, B1, B2, A1, A2, COEFF_COUNT };
+
+    // While ramping, coefficients step every this many frames
+    static constexpr size_t RAMP_STEP_FRAMES = 32;
+
+    // Latest published set, if it's new and wasn't being rewritten meanwhile
+    bool takePublished(Coefficients* stages, int& count);
+    void rampTo(const Coefficients* target, int targetCount, float* samples, size_t frameCount, int channels);
+    void processBlock(float* samples, size_t frameCount, int channels);
+
+    // One published buffer; the sequence is odd while a write is in progress
+    struct Slot {
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<int> count{0};
+        std::atomic<float> values[MAX_STAGES][COEFF_COUNT];
+    };
+    Slot m_slots[2];
+    std::atomic<uint32_t> m_published{0};  // Sets published so far; the latest is in slot (n & 1)
+    uint32_t m_consumed = 0;               // Processing thread
+
+    Coefficients m_stages[MAX_STAGES];     // Current set, as given to setStages()
+    int m_stageCount = 0;
+
+    // Per stage: each coefficient repeated across the lanes
+    alignas(16) float m_coeffs[MAX_STAGES][COEFF_COUNT][MAX_CHANNELS];
+    alignas(16) float m_z1[MAX_STAGES][MAX_CHANNELS];
+    alignas(16) float m_z2[MAX_STAGES][MAX_CHANNELS];
+    int m_active[MAX_STAGES];  // Stage indices in chain order, identity stages left out
+    int m_activeCount = 0;
+};
@@ -0,0 +1,376 @@
+#include "ClipSpectrogram.h"
+#include "FftPlan.h"
+#include "Spectrogram.h"
+#include <Windows.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+constexpr char MAGIC[4] = {'W', 'P', 'S', 'G'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t FIXED_HEADER_BYTES = 4 + 6 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+template <typename T>
+void writeValue(std::ofstream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+std::vector<uint64_t> levelColumnsFor(size_t frames) {
+    std::vector<uint64_t> columns;
+    uint64_t count = (frames + ClipSpectrogram::BASE_HOP - 1) / ClipSpectrogram::BASE_HOP;
+    columns.push_back(count);
+    while (count > 1 && static_cast<int>(columns.size()) < ClipSpectrogram::MAX_LEVELS) {
+        count = (count + 1) / 2;
+        columns.push_back(count);
+    }
+    return columns;
+}
+
+std::vector<uint64_t> levelOffsetsFor(const std::vector<uint64_t>& levelColumns) {
+    std::vector<uint64_t> offsets;
+    uint64_t offset = FIXED_HEADER_BYTES + levelColumns.size() * sizeof(uint64_t);
+    for (uint64_t columns : levelColumns) {
+        offsets.push_back(offset);
+        offset += columns * ClipSpectrogram::ROWS;
+    }
+    return offsets;
+}
+
+// Streams each level of the pyramid into its region of the file, a tile at
+// a time, pooling pairs of columns into the next level as they complete
+class PyramidWriter {
+public:
+    PyramidWriter(std::ofstream& out, const std::vector<uint64_t>& levelColumns)
+        : m_out(out), m_offsets(levelOffsetsFor(levelColumns)), m_levels(levelColumns.size()) {
+        for (Level& level : m_levels) {
+            level.buffer.resize(ClipSpectrogram::TILE_COLUMNS * ClipSpectrogram::ROWS);
+            level.pending.resize(ClipSpectrogram::ROWS);
+        }
+    }
+
+    void push(size_t levelIndex, const uint8_t* column) {
+        Level& level = m_levels[levelIndex];
+        std::memcpy(level.buffer.data() + level.buffered * ClipSpectrogram::ROWS, column, ClipSpectrogram::ROWS);
+        if (++level.buffered == ClipSpectrogram::TILE_COLUMNS) {
+            flush(levelIndex);
+        }
+
+        if (levelIndex + 1 >= m_levels.size()) return;
+        if (!level.hasPending) {
+            std::memcpy(level.pending.data(), column, ClipSpectrogram::ROWS);
+            level.hasPending = true;
+            return;
+        }
+        for (size_t row = 0; row < ClipSpectrogram::ROWS; ++row) {
+            level.pending[row] = std::max(level.pending[row], column[row]);
+        }
+        level.hasPending = false;
+        push(levelIndex + 1, level.pending.data());
+    }
+
+    // An odd column left at the end of a level goes up on its own
+    void finish() {
+        for (size_t levelIndex = 0; levelIndex < m_levels.size(); ++levelIndex) {
+            Level& level = m_levels[levelIndex];
+            if (level.hasPending && levelIndex + 1 < m_levels.size()) {
+                level.hasPending = false;
+                push(levelIndex + 1, level.pending.data());
+            }
+            flush(levelIndex);
+        }
+    }
+
+private:
+    struct Level {
+        std::vector<uint8_t> buffer;
+        size_t buffered = 0;
+        uint64_t written = 0;
+        std::vector<uint8_t> pending;
+        bool hasPending = false;
+    };
+
+    void flush(size_t levelIndex) {
+        Level& level = m_levels[levelIndex];
+        if (level.buffered == 0) return;
+        m_out.seekp(static_cast<std::streamoff>(m_offsets[levelIndex] + level.written * ClipSpectrogram::ROWS));
+        m_out.write(reinterpret_cast<const char*>(level.buffer.data()),
+                    static_cast<std::streamsize>(level.buffered * ClipSpectrogram::ROWS));
+        level.written += level.buffered;
+        level.buffered = 0;
+    }
+
+    std::ofstream& m_out;
+    std::vector<uint64_t> m_offsets;
+    std::vector<Level> m_levels;
+};
+
+} // namespace
+
+ClipSpectrogram::ClipSpectrogram(std::shared_ptr<const AudioClip> clip, const std::wstring& sidecarPath)
+    : m_clip(std::move(clip)), m_path(sidecarPath) {
+    if (m_clip) {
+        m_sampleRate = m_clip->getFormat().sampleRate;
+    }
+}
+
+ClipSpectrogram::~ClipSpectrogram() {
+    m_cancel = true;
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+std::wstring ClipSpectrogram::sidecarPathFor(const AudioClip& clip) {
+    if (!clip.getFilename().empty()) {
+        return clip.getFilename() + L".spec";
+    }
+
+    std::error_code ec;
+    std::filesystem::path directory = std::filesystem::temp_directory_path(ec);
+    wchar_t name[64];
+    swprintf(name, 64, L"WavPlayer-%016llx.spec", static_cast<unsigned long long>(fingerprint(clip)));
+    return (directory / name).wstring();
+}
+
+void ClipSpectrogram::start(ReadyCallback onReady) {
+    if (m_worker.joinable() || !m_clip) return;
+    m_onReady = std::move(onReady);
+    m_worker = std::thread(&ClipSpectrogram::buildLoop, this);
+}
+
+void ClipSpectrogram::buildLoop() {
+    // Background work: stay out of the way of the audio and UI threads
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    if (!openSidecar()) {
+        if (!build(*m_clip, m_path, m_cancel, m_progress) || !openSidecar()) {
+            if (!m_cancel) {
+                OutputDebugStringW(L"ClipSpectrogram: failed to build sidecar\n");
+            }
+            m_failed = true;
+            return;
+        }
+    }
+
+    m_progress = 1.0f;
+    m_ready = true;
+    if (m_onReady) {
+        m_onReady();
+    }
+}
+
+bool ClipSpectrogram::openSidecar() {
+    std::vector<uint64_t> levelColumns;
+    if (!readHeader(m_path, *m_clip, levelColumns)) {
+        return false;
+    }
+    m_levelColumns = levelColumns;
+    m_levelOffsets = levelOffsetsFor(levelColumns);
+    return true;
+}
+
+uint64_t ClipSpectrogram::getColumnCount(int level) const {
+    if (level < 0 || level >= getLevelCount()) return 0;
+    return m_levelColumns[level];
+}
+
+double ClipSpectrogram::getColumnSeconds(int level) const {
+    return static_cast<double>(BASE_HOP << level) / m_sampleRate;
+}
+
+int ClipSpectrogram::chooseLevel(double secondsPerPixel) const {
+    int level = 0;
+    while (level + 1 < getLevelCount() && getColumnSeconds(level + 1) <= secondsPerPixel) {
+        ++level;
+    }
+    return level;
+}
+
+std::shared_ptr<const ClipSpectrogram::Tile> ClipSpectrogram::getTile(int level, uint64_t tileIndex) {
+    if (!m_ready || level < 0 || level >= getLevelCount()) return nullptr;
+    const uint64_t firstColumn = tileIndex * TILE_COLUMNS;
+    if (firstColumn >= m_levelColumns[level]) return nullptr;
+
+    const uint64_t key = (static_cast<uint64_t>(level) << 48) | tileIndex;
+    auto found = m_tiles.find(key);
+    if (found != m_tiles.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, found->second.lru);
+        return found->second.tile;
+    }
+
+    if (!m_file.is_open()) {
+        m_file.open(std::filesystem::path(m_path), std::ios::binary);
+        if (!m_file) return nullptr;
+    }
+
+    auto tile = std::make_shared<Tile>(TILE_COLUMNS * ROWS, uint8_t(0));
+    uint64_t columns = std::min<uint64_t>(TILE_COLUMNS, m_levelColumns[level] - firstColumn);
+    m_file.seekg(static_cast<std::streamoff>(m_levelOffsets[level] + firstColumn * ROWS));
+    if (!m_file.read(reinterpret_cast<char*>(tile->data()), static_cast<std::streamsize>(columns * ROWS))) {
+        m_file.clear();
+        return nullptr;
+    }
+
+    m_lru.push_front(key);
+    m_tiles[key] = {tile, m_lru.begin()};
+    if (m_tiles.size() > MAX_CACHED_TILES) {
+        m_tiles.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+    return tile;
+}
+
+uint64_t ClipSpectrogram::fingerprint(const AudioClip& clip) {
+    // FNV-1a over the format and up to 4096 evenly spaced samples: cheap,
+    // and enough to tell an edited or different clip apart
+    const std::vector<float>& samples = clip.getSamples();
+    const AudioFormat& format = clip.getFormat();
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+    };
+
+    mix(samples.size());
+    mix(format.channels);
+    mix(format.sampleRate);
+    size_t step = std::max<size_t>(1, samples.size() / 4096);
+    for (size_t i = 0; i < samples.size(); i += step) {
+        uint32_t bits;
+        std::memcpy(&bits, &samples[i], sizeof(bits));
+        mix(bits);
+    }
+    return hash;
+}
+
+bool ClipSpectrogram::build(const AudioClip& clip, const std::wstring& path,
+                            const std::atomic<bool>& cancel, std::atomic<float>& progress) {
+    const AudioFormat& format = clip.getFormat();
+    const size_t channels = format.channels;
+    const size_t frames = clip.getSampleCount();
+    const FftPlan* plan = FftPlan::get(FFT_SIZE);
+    if (frames == 0 || channels == 0 || format.sampleRate == 0 || !plan) {
+        return false;
+    }
+
+    const std::vector<uint64_t> levelColumns = levelColumnsFor(frames);
+    const std::wstring tempPath = path + L".tmp";
+    {
+        std::ofstream out(std::filesystem::path(tempPath), std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        out.write(MAGIC, sizeof(MAGIC));
+        writeValue<uint32_t>(out, VERSION);
+        writeValue<uint32_t>(out, format.sampleRate);
+        writeValue<uint32_t>(out, static_cast<uint32_t>(FFT_SIZE));
+        writeValue<uint32_t>(out, static_cast<uint32_t>(BASE_HOP));
+        writeValue<uint32_t>(out, static_cast<uint32_t>(ROWS));
+        writeValue<uint32_t>(out, static_cast<uint32_t>(levelColumns.size()));
+        writeValue<uint64_t>(out, frames);
+        writeValue<uint64_t>(out, fingerprint(clip));
+        for (uint64_t columns : levelColumns) {
+            writeValue<uint64_t>(out, columns);
+        }
+
+        std::vector<uint32_t> rowStart, rowEnd;
+        Spectrogram::computeRowBins(plan->getBinCount(), static_cast<int>(format.sampleRate), ROWS, rowStart, rowEnd);
+        const float scale = 2.0f / plan->getWindowSum(FftPlan::Window::Hann);
+
+        std::vector<float> mono(FFT_SIZE);
+        std::vector<float> re(plan->getBinCount()), im(plan->getBinCount());
+        std::vector<float> workspace(plan->getWorkspaceSize());
+        std::vector<float> magnitudes(plan->getBinCount());
+        std::vector<uint8_t> column(ROWS);
+        const std::vector<float>& samples = clip.getSamples();
+        const float channelScale = 1.0f / channels;
+        PyramidWriter writer(out, levelColumns);
+
+        for (uint64_t index = 0; index < levelColumns[0]; ++index) {
+            if (cancel) return false;
+
+            // Window centred on the middle of this column's hop
+            int64_t first = static_cast<int64_t>(index * BASE_HOP + BASE_HOP / 2) - static_cast<int64_t>(FFT_SIZE / 2);
+            for (size_t i = 0; i < FFT_SIZE; ++i) {
+                int64_t frame = first + static_cast<int64_t>(i);
+                float sum = 0.0f;
+                if (frame >= 0 && frame < static_cast<int64_t>(frames)) {
+                    const float* sample = &samples[static_cast<size_t>(frame) * channels];
+                    for (size_t ch = 0; ch < channels; ++ch) {
+                        sum += sample[ch];
+                    }
+                }
+                mono[i] = sum * channelScale;
+            }
+
+            plan->forward(mono.data(), re.data(), im.data(), workspace.data(), FftPlan::Window::Hann);
+            for (size_t bin = 0; bin < magnitudes.size(); ++bin) {
+                magnitudes[bin] = std::hypot(re[bin], im[bin]) * scale;
+            }
+            for (size_t row = 0; row < ROWS; ++row) {
+                column[row] = Spectrogram::levelFor(magnitudes.data(), rowStart[row], rowEnd[row]);
+            }
+            writer.push(0, column.data());
+
+            if ((index & 255) == 0) {
+                progress = static_cast<float>(index) / levelColumns[0];
+            }
+        }
+
+        writer.finish();
+        if (!out) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool ClipSpectrogram::readHeader(const std::wstring& path, const AudioClip& clip,
+                                 std::vector<uint64_t>& levelColumns) {
+    std::ifstream in(std::filesystem::path(path), std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    uint32_t version, sampleRate, fftSize, hop, rows, levelCount;
+    uint64_t frames, stamp;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !readValue(in, version) || !readValue(in, sampleRate) || !readValue(in, fftSize) ||
+        !readValue(in, hop) || !readValue(in, rows) || !readValue(in, levelCount) ||
+        !readValue(in, frames) || !readValue(in, stamp)) {
+        return false;
+    }
+
+    if (version != VERSION || sampleRate != clip.getFormat().sampleRate || fftSize != FFT_SIZE ||
+        hop != BASE_HOP || rows != ROWS || frames != clip.getSampleCount() || stamp != fingerprint(clip)) {
+        return false;
+    }
+
+    // The layout is fully determined by the frame count; anything else is corrupt
+    std::vector<uint64_t> expected = levelColumnsFor(static_cast<size_t>(frames));
+    if (levelCount != expected.size()) return false;
+    levelColumns.resize(levelCount);
+    for (uint64_t& columns : levelColumns) {
+        if (!readValue(in, columns)) return false;
+    }
+    if (levelColumns != expected) return false;
+
+    // Reject a truncated file
+    std::vector<uint64_t> offsets = levelOffsetsFor(levelColumns);
+    uint64_t expectedSize = offsets.back() + levelColumns.back() * ROWS;
+    in.seekg(0, std::ios::end);
+    return static_cast<uint64_t>(in.tellg()) >= expectedSize;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "AudioEngine.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Offline spectrogram of a whole clip for the timeline's spectral view.
+// Level 0 has one column per BASE_HOP frames (an FFT_SIZE real FFT centred
+// on the hop); each further level max-pools pairs of columns from the one
+// below, like mipmaps, so any zoom reads at most a screen's worth of
+// columns. Columns are ROWS log-frequency levels quantized to 8-bit dB, the
+// same scale as the live Spectrogram.
+//
+// The pyramid is built once on a background thread and kept in a sidecar
+// file next to the audio (tagged with a fingerprint of the samples, so a
+// changed clip is rebuilt). The view then reads it TILE_COLUMNS columns at a
+// time through a small LRU cache, so even an hour-long clip never sits in
+// memory as a whole.
+class ClipSpectrogram {
+public:
+    static constexpr size_t FFT_SIZE = 2048;
+    static constexpr size_t BASE_HOP = 512;
+    static constexpr size_t ROWS = 128;
+    static constexpr size_t TILE_COLUMNS = 256;
+    static constexpr size_t MAX_CACHED_TILES = 96;
+    static constexpr int MAX_LEVELS = 16;
+
+    using Tile = std::vector<uint8_t>;  // TILE_COLUMNS x ROWS, column-major, zero past the end
+    using ReadyCallback = std::function<void()>;
+
+    ClipSpectrogram(std::shared_ptr<const AudioClip> clip, const std::wstring& sidecarPath);
+    ~ClipSpectrogram();
+
+    ClipSpectrogram(const ClipSpectrogram&) = delete;
+    ClipSpectrogram& operator=(const ClipSpectrogram&) = delete;
+
+    // Sidecar next to the clip's file, or in the temp directory for clips
+    // that were never saved
+    static std::wstring sidecarPathFor(const AudioClip& clip);
+
+    // Opens a matching sidecar or builds one on a worker thread. onReady runs
+    // on that thread once tiles can be read.
+    void start(ReadyCallback onReady);
+
+    const std::shared_ptr<const AudioClip>& getClip() const { return m_clip; }
+
+    bool isReady() const { return m_ready; }
+    bool hasFailed() const { return m_failed; }
+    float getProgress() const { return m_progress; }
+
+    // Valid once ready
+    int getLevelCount() const { return static_cast<int>(m_levelColumns.size()); }
+    uint64_t getColumnCount(int level) const;
+    double getColumnSeconds(int level) const;
+
+    // Coarsest level whose columns are still no wider than secondsPerPixel
+    int chooseLevel(double secondsPerPixel) const;
+
+    // UI thread. nullptr until ready or if the read fails.
+    std::shared_ptr<const Tile> getTile(int level, uint64_t tileIndex);
+
+    // Headless pieces, also used by the tests
+    static uint64_t fingerprint(const AudioClip& clip);
+    static bool build(const AudioClip& clip, const std::wstring& path,
+                      const std::atomic<bool>& cancel, std::atomic<float>& progress);
+    // Column counts per level if the file is a sidecar for this clip
+    static bool readHeader(const std::wstring& path, const AudioClip& clip,
+                           std::vector<uint64_t>& levelColumns);
+
+private:
+    void buildLoop();
+    bool openSidecar();
+
+    std::shared_ptr<const AudioClip> m_clip;
+    std::wstring m_path;
+    uint32_t m_sampleRate = 44100;
+
+    std::thread m_worker;
+    std::atomic<bool> m_cancel{false};
+    std::atomic<bool> m_ready{false};
+    std::atomic<bool> m_failed{false};
+    std::atomic<float> m_progress{0.0f};
+    ReadyCallback m_onReady;
+
+    // Set before m_ready, read-only afterwards
+    std::vector<uint64_t> m_levelColumns;
+    std::vector<uint64_t> m_levelOffsets;  // Byte offset of each level in the file
+
+    // UI thread only
+    std::ifstream m_file;
+    struct CachedTile {
+        std::shared_ptr<const Tile> tile;
+        std::list<uint64_t>::iterator lru;
+    };
+    std::unordered_map<uint64_t, CachedTile> m_tiles;  // Key: level << 48 | tile
+    std::list<uint64_t> m_lru;                          // Most recent first
+};
@@ -0,0 +1,430 @@
+#include "ConvolutionReverb.h"
+#include "RealtimeCheck.h"
+#include "ThreadPriority.h"
+#include <cmath>
+#include <thread>
+
+namespace {
+
+using Kernel = PartitionedConvolver::Kernel;
+
+// Input history the worker reads from: a few of the largest blocks
+constexpr size_t INPUT_RING = 4 * ConvolutionReverb::TAIL_BLOCKS[ConvolutionReverb::TAIL_LEVELS - 1];
+constexpr DWORD WORKER_WAIT_MS = 50;
+constexpr float TRIM_THRESHOLD = 1e-4f;  // -80 dB of the peak
+
+// Offset into the response where level `level` starts (the head ends at level 0's)
+constexpr size_t levelOffset(size_t level) {
+    return 2 * ConvolutionReverb::TAIL_BLOCKS[level];
+}
+
+std::shared_ptr<const Kernel> makeKernel(const std::vector<float>& ir, size_t begin, size_t end, size_t blockSize) {
+    end = std::min(end, ir.size());
+    if (begin >= end) {
+        return nullptr;
+    }
+    return PartitionedConvolver::makeKernel(ir.data() + begin, end - begin, blockSize);
+}
+
+} // namespace
+
+struct ConvolutionReverb::Engine {
+    struct Level {
+        size_t blockSize = 0;
+        size_t offset = 0;
+        std::shared_ptr<const Kernel> kernels[CHANNELS];
+        std::atomic<uint64_t> done{0};  // Blocks written to the output ring
+
+        // Worker
+        PartitionedConvolver convolvers[CHANNELS];
+        std::vector<float> block[CHANNELS];
+        uint64_t next = 0;
+
+        // Written by the worker, read by the audio thread once done says so.
+        // Indexed by output frame; 4 blocks, so the worker never catches up
+        // with the block being played.
+        std::vector<float> output[CHANNELS];
+
+        // Audio thread
+        uint64_t lastLate = UINT64_MAX;
+
+        std::thread worker;
+        HANDLE wake = nullptr;
+    };
+
+    Engine(const std::vector<float>& left, const std::vector<float>& right, bool offline);
+    ~Engine();
+
+    bool isEmpty() const { return !head[0]; }
+
+    // Worker (or the audio thread when offline): every block of the level
+    // whose input is complete
+    void runLevel(Level& level);
+    void workerLoop(Level& level, ThreadPriority::Task task);
+
+    std::shared_ptr<const Kernel> head[CHANNELS];
+    PartitionedConvolver headConvolvers[CHANNELS];
+    Level levels[TAIL_LEVELS];
+    size_t levelCount = 0;
+
+    // Input history, indexed by input frame
+    std::vector<float> input[CHANNELS];
+    std::atomic<uint64_t> inputFrames{0};
+
+    // Audio thread
+    uint64_t frames = 0;
+
+    bool offline;
+    std::atomic<bool> running{false};
+};
+
+ConvolutionReverb::Engine::Engine(const std::vector<float>& left, const std::vector<float>& right, bool offlineMode)
+    : offline(offlineMode) {
+    if (left.empty()) {
+        return;
+    }
+
+    // A mono response feeds both channels from the same kernels
+    const std::vector<float>* responses[CHANNELS] = {&left, &right};
+    bool shared = left == right;
+
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        head[ch] = shared && ch > 0 ? head[0] : makeKernel(*responses[ch], 0, levelOffset(0), HEAD_BLOCK);
+        if (!head[ch]) {
+            head[ch] = makeKernel(std::vector<float>{0.0f}, 0, 1, HEAD_BLOCK);
+        }
+        headConvolvers[ch].configure(HEAD_BLOCK, head[ch]->partitionCount);
+    }
+
+    size_t length = std::max(left.size(), right.size());
+    for (size_t i = 0; i < TAIL_LEVELS && levelOffset(i) < length; ++i) {
+        Level& level = levels[levelCount++];
+        level.blockSize = TAIL_BLOCKS[i];
+        level.offset = levelOffset(i);
+        size_t end = i + 1 < TAIL_LEVELS ? levelOffset(i + 1) : length;
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            level.kernels[ch] = shared && ch > 0 ? level.kernels[0]
+                                                 : makeKernel(*responses[ch], level.offset, end, level.blockSize);
+            if (!level.kernels[ch]) {
+                level.kernels[ch] = makeKernel(std::vector<float>{0.0f}, 0, 1, level.blockSize);
+            }
+            level.convolvers[ch].configure(level.blockSize, level.kernels[ch]->partitionCount);
+            level.block[ch].assign(level.blockSize, 0.0f);
+            level.output[ch].assign(level.blockSize * 4, 0.0f);
+        }
+    }
+
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        input[ch].assign(INPUT_RING, 0.0f);
+    }
+
+    // One worker per level, so a long FFT in a large level never holds up a
+    // smaller one with less slack; the largest runs below audio priority
+    if (!offline) {
+        running = true;
+        for (size_t i = 0; i < levelCount; ++i) {
+            Level& level = levels[i];
+            level.wake = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+            auto task = i == 0 ? ThreadPriority::Task::ProAudio : ThreadPriority::Task::Audio;
+            level.worker = std::thread(&Engine::workerLoop, this, std::ref(level), task);
+        }
+    }
+}
+
+ConvolutionReverb::Engine::~Engine() {
+    running = false;
+    for (size_t i = 0; i < levelCount; ++i) {
+        Level& level = levels[i];
+        if (level.wake) {
+            SetEvent(level.wake);
+        }
+        if (level.worker.joinable()) {
+            level.worker.join();
+        }
+        if (level.wake) {
+            CloseHandle(level.wake);
+        }
+    }
+}
+
+void ConvolutionReverb::Engine::workerLoop(Level& level, ThreadPriority::Task task) {
+    // MMCSS only: pinning to the audio core would put the tail levels on the
+    // core the device callback needs
+    ThreadPriority::makeCurrentThreadRealtime(task);
+    while (running) {
+        runLevel(level);
+        WaitForSingleObject(level.wake, WORKER_WAIT_MS);
+    }
+    ThreadPriority::revertCurrentThread();
+}
+
+void ConvolutionReverb::Engine::runLevel(Level& level) {
+    const size_t mask = INPUT_RING - 1;
+    const size_t block = level.blockSize;
+    const size_t outMask = level.output[0].size() - 1;
+
+    while ((level.next + 1) * block <= inputFrames.load(std::memory_order_acquire)) {
+        uint64_t start = level.next * block;
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            for (size_t j = 0; j < block; ++j) {
+                level.block[ch][j] = input[ch][(start + j) & mask];
+            }
+        }
+
+        // If the audio thread lapped us while we copied, the block is gone;
+        // keep the delay line in step with silence
+        if (inputFrames.load(std::memory_order_acquire) + HEAD_BLOCK > start + INPUT_RING) {
+            for (int ch = 0; ch < CHANNELS; ++ch) {
+                std::fill(level.block[ch].begin(), level.block[ch].end(), 0.0f);
+            }
+        }
+
+        // Block m's output is due from frame m * block + offset on
+        uint64_t outStart = start + level.offset;
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            level.convolvers[ch].processBlock(level.block[ch].data(), level.block[ch].data(),
+                                              *level.kernels[ch]);
+            for (size_t j = 0; j < block; ++j) {
+                level.output[ch][(outStart + j) & outMask] = level.block[ch][j];
+            }
+        }
+        level.done.store(++level.next, std::memory_order_release);
+    }
+}
+
+ConvolutionReverb::ConvolutionReverb(bool offline) : m_offline(offline) {}
+
+ConvolutionReverb::~ConvolutionReverb() {
+    delete m_current;
+    delete m_pending.exchange(nullptr);
+    delete m_retired.exchange(nullptr);
+}
+
+bool ConvolutionReverb::prepareResponse(const AudioClip& clip, uint32_t sampleRate,
+                                        std::vector<float>& left, std::vector<float>& right) {
+    const AudioFormat& format = clip.getFormat();
+    const std::vector<float>& samples = clip.getSamples();
+    size_t channels = format.channels;
+    if (channels == 0 || format.sampleRate == 0 || sampleRate == 0) {
+        return false;
+    }
+    size_t sourceFrames = samples.size() / channels;
+    if (sourceFrames == 0) {
+        return false;
+    }
+
+    // Linear interpolation is plenty for a reverb tail
+    double step = double(format.sampleRate) / sampleRate;
+    size_t frames = static_cast<size_t>((sourceFrames - 1) / step) + 1;
+    frames = std::min(frames, static_cast<size_t>(MAX_IR_SECONDS * sampleRate));
+
+    std::vector<float>* outputs[CHANNELS] = {&left, &right};
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        size_t source = std::min<size_t>(ch, channels - 1);
+        std::vector<float>& out = *outputs[ch];
+        out.resize(frames);
+        for (size_t n = 0; n < frames; ++n) {
+            double position = n * step;
+            size_t index = static_cast<size_t>(position);
+            float frac = static_cast<float>(position - index);
+            float a = samples[index * channels + source];
+            float b = index + 1 < sourceFrames ? samples[(index + 1) * channels + source] : a;
+            out[n] = a + (b - a) * frac;
+        }
+    }
+
+    // Trim the tail once both channels have decayed below the threshold
+    float peak = 0.0f;
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        for (float sample : *outputs[ch]) {
+            peak = std::max(peak, std::abs(sample));
+        }
+    }
+    if (peak <= 0.0f) {
+        left.clear();
+        right.clear();
+        return false;
+    }
+    size_t length = 0;
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        const std::vector<float>& out = *outputs[ch];
+        for (size_t n = out.size(); n > length; --n) {
+            if (std::abs(out[n - 1]) > peak * TRIM_THRESHOLD) {
+                length = n;
+                break;
+            }
+        }
+    }
+
+    // Unit energy in the louder channel, so a response doesn't come in at
+    // wildly different levels depending on how it was recorded
+    double energy = 0.0;
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        std::vector<float>& out = *outputs[ch];
+        out.resize(length);
+        double sum = 0.0;
+        for (float sample : out) {
+            sum += double(sample) * sample;
+        }
+        energy = std::max(energy, sum);
+    }
+    float scale = static_cast<float>(1.0 / std::sqrt(energy));
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        for (float& sample : *outputs[ch]) {
+            sample *= scale;
+        }
+    }
+    return true;
+}
+
+bool ConvolutionReverb::setImpulseResponse(const AudioClip& clip, uint32_t sampleRate, const std::wstring& path) {
+    std::vector<float> left, right;
+    if (!prepareResponse(clip, sampleRate, left, right)) {
+        OutputDebugStringW(L"ConvolutionReverb: impulse response is empty or silent\n");
+        return false;
+    }
+    return setImpulseResponse(left, right, path);
+}
+
+bool ConvolutionReverb::setImpulseResponse(const std::vector<float>& left, const std::vector<float>& right,
+                                           const std::wstring& path) {
+    if (left.empty() || right.empty()) {
+        return false;
+    }
+    publish(new Engine(left, right, m_offline));
+    m_path = path;
+    m_left = left;
+    m_right = right;
+    m_tailFrames = std::max(left.size(), right.size()) + HEAD_BLOCK;
+    m_hasResponse = true;
+    return true;
+}
+
+void ConvolutionReverb::clearImpulseResponse() {
+    // An empty engine, so the audio thread lets go of the old one
+    publish(new Engine({}, {}, m_offline));
+    m_path.clear();
+    m_left.clear();
+    m_right.clear();
+    m_tailFrames = 0;
+    m_hasResponse = false;
+}
+
+bool ConvolutionReverb::copyTo(ConvolutionReverb& other) const {
+    if (!m_hasResponse || !other.setImpulseResponse(m_left, m_right, m_path)) {
+        return false;
+    }
+    other.setWetLevel(getWetLevel());
+    return true;
+}
+
+void ConvolutionReverb::publish(Engine* engine) {
+    // Free what the audio thread gave back, and any engine it never took
+    delete m_retired.exchange(nullptr, std::memory_order_acquire);
+    delete m_pending.exchange(engine, std::memory_order_acq_rel);
+}
+
+void ConvolutionReverb::takePending() {
+    // Only once the last engine we handed back has been freed, so nothing
+    // is ever freed here
+    if (m_retired.load(std::memory_order_acquire) != nullptr) return;
+    Engine* next = m_pending.exchange(nullptr, std::memory_order_acq_rel);
+    if (!next) return;
+
+    if (m_current) {
+        m_retired.store(m_current, std::memory_order_release);
+    }
+    m_current = next;
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        std::fill(std::begin(m_input[ch]), std::end(m_input[ch]), 0.0f);
+        std::fill(std::begin(m_output[ch]), std::end(m_output[ch]), 0.0f);
+    }
+    m_fill = 0;
+}
+
+void ConvolutionReverb::process(const float* input, float* output, size_t frameCount) {
+    if (m_fill == 0) {
+        takePending();
+    }
+    if (!m_current || m_current->isEmpty()) {
+        return;
+    }
+
+    const float wet = m_wet.load(std::memory_order_relaxed);
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        // Both inputs before either output, as they may be the same samples
+        float in[CHANNELS];
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            in[ch] = input[frame * CHANNELS + ch];
+        }
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            m_input[ch][m_fill] = in[ch];
+            output[frame * CHANNELS + ch] += m_output[ch][m_fill] * wet;
+        }
+        if (++m_fill < HEAD_BLOCK) continue;
+
+        processBlock(*m_current);
+        m_fill = 0;
+        takePending();
+        if (m_current->isEmpty()) {
+            return;
+        }
+    }
+}
+
+void ConvolutionReverb::processBlock(Engine& engine) {
+    const uint64_t start = engine.frames;
+    const size_t mask = INPUT_RING - 1;
+
+    if (engine.levelCount > 0) {
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            for (size_t j = 0; j < HEAD_BLOCK; ++j) {
+                engine.input[ch][(start + j) & mask] = m_input[ch][j];
+            }
+        }
+        engine.inputFrames.store(start + HEAD_BLOCK, std::memory_order_release);
+
+        for (size_t i = 0; i < engine.levelCount; ++i) {
+            Engine::Level& level = engine.levels[i];
+            if (m_offline) {
+                engine.runLevel(level);
+            } else if ((start + HEAD_BLOCK) % level.blockSize == 0) {
+                // Signalling never waits, so it is accepted on the audio thread
+                RealtimeCheck::Allow signal;
+                RealtimeCheck::blockingCall("SetEvent");
+                SetEvent(level.wake);
+            }
+        }
+    }
+
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        engine.headConvolvers[ch].processBlock(m_input[ch], m_output[ch], *engine.head[ch]);
+    }
+
+    // This output block is frames [start, start + HEAD_BLOCK) of the wet
+    // signal; each level that has reached it adds its slice, which always
+    // lies inside one of its blocks
+    for (size_t i = 0; i < engine.levelCount; ++i) {
+        Engine::Level& level = engine.levels[i];
+        if (start < level.offset) continue;
+
+        uint64_t block = (start - level.offset) / level.blockSize;
+        if (level.done.load(std::memory_order_acquire) <= block) {
+            if (level.lastLate != block) {
+                level.lastLate = block;
+                m_lateBlocks.fetch_add(1, std::memory_order_relaxed);
+            }
+            continue;
+        }
+
+        const size_t outMask = level.output[0].size() - 1;
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            const float* ring = level.output[ch].data();
+            for (size_t j = 0; j < HEAD_BLOCK; ++j) {
+                m_output[ch][j] += ring[(start + j) & outMask];
+            }
+        }
+    }
+
+    engine.frames = start + HEAD_BLOCK;
+}
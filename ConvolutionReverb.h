@@ -0,0 +1,100 @@
+#pragma once
+#include "AudioEngine.h"
+#include "PartitionedConvolver.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Stereo convolution reverb with non-uniform partitions. The start of the
+// impulse response is convolved on the audio thread in HEAD_BLOCK partitions,
+// so the wet signal is only HEAD_BLOCK frames late. The rest is split into
+// levels of ever larger partitions (TAIL_BLOCKS), each computed by its own
+// worker thread. A level with block size B starts 2 * B into the response:
+// one block to collect its input and one block of slack for the worker. Long
+// responses then cost few large FFTs instead of many small ones.
+//
+// The response is loaded on the UI thread into a new engine that the audio
+// thread swaps in through an atomic pointer (the old one is handed back and
+// freed by the next load, or on destruction), so process() never locks,
+// allocates or waits. If a worker misses a deadline, that piece of the tail
+// is dropped and counted rather than waited for.
+class ConvolutionReverb {
+public:
+    static constexpr size_t HEAD_BLOCK = 128;
+    static constexpr size_t TAIL_LEVELS = 2;
+    static constexpr size_t TAIL_BLOCKS[TAIL_LEVELS] = {1024, 8192};
+    static constexpr double MAX_IR_SECONDS = 20.0;
+    static constexpr int CHANNELS = 2;
+
+    // offline runs the tail levels inline in process() instead of on
+    // workers, for rendering faster than real time (and for the tests)
+    explicit ConvolutionReverb(bool offline = false);
+    ~ConvolutionReverb();
+
+    ConvolutionReverb(const ConvolutionReverb&) = delete;
+    ConvolutionReverb& operator=(const ConvolutionReverb&) = delete;
+
+    // UI thread. Mono responses feed both channels; the response is resampled
+    // to sampleRate, trimmed of trailing silence and normalized to unit
+    // energy. False (nothing changes) if the clip is empty.
+    bool setImpulseResponse(const AudioClip& clip, uint32_t sampleRate, const std::wstring& path = L"");
+    bool setImpulseResponse(const std::vector<float>& left, const std::vector<float>& right,
+                            const std::wstring& path = L"");
+    void clearImpulseResponse();
+    bool hasImpulseResponse() const { return m_hasResponse; }
+    // Frames the wet signal lasts after the input stops: the response plus
+    // the head block's delay (0 without a response). Any thread.
+    size_t getTailFrames() const { return m_tailFrames; }
+    const std::wstring& getImpulseResponsePath() const { return m_path; }
+
+    // UI thread: load the same response and wet level into another reverb,
+    // e.g. an offline one for export. False if there is no response.
+    bool copyTo(ConvolutionReverb& other) const;
+
+    // Linear gain of the wet signal
+    float getWetLevel() const { return m_wet; }
+    void setWetLevel(float gain) { m_wet = std::max(0.0f, gain); }
+
+    // Audio thread: adds the wet signal of frameCount interleaved stereo
+    // frames of input to output (which may be the input itself)
+    void process(const float* input, float* output, size_t frameCount);
+
+    // Tail blocks the worker finished too late to be heard
+    uint64_t getLateBlocks() const { return m_lateBlocks; }
+
+    // Normalized response as loaded (for inspection and tests)
+    static bool prepareResponse(const AudioClip& clip, uint32_t sampleRate,
+                                std::vector<float>& left, std::vector<float>& right);
+
+private:
+    struct Engine;
+
+    void publish(Engine* engine);
+    void takePending();
+    void processBlock(Engine& engine);
+
+    bool m_offline;
+    std::atomic<float> m_wet{0.3f};
+    std::atomic<uint64_t> m_lateBlocks{0};
+
+    std::atomic<bool> m_hasResponse{false};
+    std::atomic<size_t> m_tailFrames{0};
+
+    // UI thread: the response as loaded, kept for copyTo()
+    std::wstring m_path;
+    std::vector<float> m_left;
+    std::vector<float> m_right;
+
+    // Engine handoff: UI -> audio in m_pending, audio -> UI in m_retired
+    std::atomic<Engine*> m_pending{nullptr};
+    std::atomic<Engine*> m_retired{nullptr};
+
+    // Audio thread
+    Engine* m_current = nullptr;
+    float m_input[CHANNELS][HEAD_BLOCK] = {};
+    float m_output[CHANNELS][HEAD_BLOCK] = {};
+    size_t m_fill = 0;
+};
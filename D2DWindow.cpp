@@ -130,6 +130,7 @@ bool D2DWindow::createDeviceResources() {
 }
 
 void D2DWindow::discardDeviceResources() {
+    onDiscardDeviceResources();
     if (m_textFormatSmall) { m_textFormatSmall->Release(); m_textFormatSmall = nullptr; }
     if (m_textFormat) { m_textFormat->Release(); m_textFormat = nullptr; }
     if (m_brush) { m_brush->Release(); m_brush = nullptr; }
@@ -75,6 +75,7 @@ protected:
     virtual void onHScroll(HWND scrollBar, int request, int pos) {}
     virtual void onTimer(UINT_PTR timerId) {}
     virtual bool onClose() { return false; }  // Return true to hide instead of destroy
+    virtual void onDiscardDeviceResources() {}  // Release resources tied to the render target
 
     bool createDeviceResources();
     void discardDeviceResources();
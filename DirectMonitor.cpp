@@ -0,0 +1,207 @@
+#include "DirectMonitor.h"
+#include "SampleFormat.h"
+#include "ThreadPriority.h"
+#include "RealtimeCheck.h"
+#include <algorithm>
+
+namespace {
+
+void logFailure(const wchar_t* call, MMRESULT result) {
+    wchar_t buf[96];
+    swprintf_s(buf, L"Direct monitor: %s failed with error %d\n", call, result);
+    OutputDebugStringW(buf);
+}
+
+} // namespace
+
+DirectMonitor::~DirectMonitor() {
+    stop();
+}
+
+bool DirectMonitor::start(UINT inputDevice, uint32_t sampleRate, uint16_t channels, uint32_t blockFrames) {
+    stop();
+    configure(sampleRate, channels, blockFrames);
+
+    MMRESULT result = waveInOpen(&m_waveIn, inputDevice, &m_format,
+                                 reinterpret_cast<DWORD_PTR>(waveInProc),
+                                 reinterpret_cast<DWORD_PTR>(this), CALLBACK_FUNCTION);
+    if (result != MMSYSERR_NOERROR) {
+        m_waveIn = nullptr;
+        logFailure(L"waveInOpen", result);
+        return false;
+    }
+
+    result = waveOutOpen(&m_waveOut, WAVE_MAPPER, &m_format,
+                         reinterpret_cast<DWORD_PTR>(waveOutProc),
+                         reinterpret_cast<DWORD_PTR>(this), CALLBACK_FUNCTION);
+    if (result != MMSYSERR_NOERROR) {
+        m_waveOut = nullptr;
+        waveInClose(m_waveIn);
+        m_waveIn = nullptr;
+        logFailure(L"waveOutOpen", result);
+        return false;
+    }
+
+    size_t blockBytes = m_blockFrames * m_format.nBlockAlign;
+    for (int i = 0; i < NUM_BLOCKS; ++i) {
+        m_inBuffers[i].assign(m_blockFrames * m_format.nChannels, 0);
+        m_inHeaders[i] = {};
+        m_inHeaders[i].lpData = reinterpret_cast<LPSTR>(m_inBuffers[i].data());
+        m_inHeaders[i].dwBufferLength = static_cast<DWORD>(blockBytes);
+
+        m_outBuffers[i].assign(m_blockFrames * m_format.nChannels, 0);
+        m_outHeaders[i] = {};
+        m_outHeaders[i].lpData = reinterpret_cast<LPSTR>(m_outBuffers[i].data());
+        m_outHeaders[i].dwBufferLength = static_cast<DWORD>(blockBytes);
+    }
+
+    // A half-started stream is worse than none: on any failure close both
+    // devices so the caller falls back to monitoring through the mix
+    for (int i = 0; i < NUM_BLOCKS; ++i) {
+        result = waveInPrepareHeader(m_waveIn, &m_inHeaders[i], sizeof(WAVEHDR));
+        if (result != MMSYSERR_NOERROR) {
+            logFailure(L"waveInPrepareHeader", result);
+            stop();
+            return false;
+        }
+        result = waveOutPrepareHeader(m_waveOut, &m_outHeaders[i], sizeof(WAVEHDR));
+        if (result != MMSYSERR_NOERROR) {
+            logFailure(L"waveOutPrepareHeader", result);
+            stop();
+            return false;
+        }
+    }
+
+    m_running = true;
+
+    // Queue input blocks and start output with silence; output then pulls
+    // from the ring as each block completes
+    for (int i = 0; i < NUM_BLOCKS; ++i) {
+        result = waveInAddBuffer(m_waveIn, &m_inHeaders[i], sizeof(WAVEHDR));
+        if (result != MMSYSERR_NOERROR) {
+            logFailure(L"waveInAddBuffer", result);
+            stop();
+            return false;
+        }
+    }
+    for (int i = 0; i < NUM_BLOCKS; ++i) {
+        result = waveOutWrite(m_waveOut, &m_outHeaders[i], sizeof(WAVEHDR));
+        if (result != MMSYSERR_NOERROR) {
+            logFailure(L"waveOutWrite", result);
+            stop();
+            return false;
+        }
+    }
+
+    result = waveInStart(m_waveIn);
+    if (result != MMSYSERR_NOERROR) {
+        logFailure(L"waveInStart", result);
+        stop();
+        return false;
+    }
+
+    wchar_t buf[128];
+    swprintf_s(buf, L"Direct monitor started: %u-frame blocks, ~%u frames latency\n",
+               m_blockFrames, getLatencyFrames());
+    OutputDebugStringW(buf);
+    return true;
+}
+
+void DirectMonitor::configure(uint32_t sampleRate, uint16_t channels, uint32_t blockFrames) {
+    m_blockFrames = std::clamp(blockFrames, MIN_BLOCK_FRAMES, MAX_BLOCK_FRAMES);
+
+    m_format.wFormatTag = WAVE_FORMAT_PCM;
+    m_format.nChannels = channels;
+    m_format.nSamplesPerSec = sampleRate;
+    m_format.wBitsPerSample = 16;
+    m_format.nBlockAlign = channels * (m_format.wBitsPerSample / 8);
+    m_format.nAvgBytesPerSec = sampleRate * m_format.nBlockAlign;
+    m_format.cbSize = 0;
+
+    // Two blocks of slack covers the phase offset between the two devices
+    m_ring.configure(channels, m_blockFrames * 16, m_blockFrames * 2);
+    m_inScratch.resize(m_blockFrames * channels);
+    m_outScratch.resize(m_blockFrames * channels);
+}
+
+void DirectMonitor::stop() {
+    // Callbacks stop re-queuing once this is cleared
+    m_running = false;
+
+    if (m_waveIn) {
+        waveInReset(m_waveIn);
+        for (int i = 0; i < NUM_BLOCKS; ++i) {
+            waveInUnprepareHeader(m_waveIn, &m_inHeaders[i], sizeof(WAVEHDR));
+        }
+        waveInClose(m_waveIn);
+        m_waveIn = nullptr;
+    }
+
+    if (m_waveOut) {
+        waveOutReset(m_waveOut);
+        for (int i = 0; i < NUM_BLOCKS; ++i) {
+            waveOutUnprepareHeader(m_waveOut, &m_outHeaders[i], sizeof(WAVEHDR));
+        }
+        waveOutClose(m_waveOut);
+        m_waveOut = nullptr;
+    }
+}
+
+uint32_t DirectMonitor::getLatencyFrames() const {
+    // One input block must fill before it is delivered; output has its queue ahead of it
+    return m_blockFrames + static_cast<uint32_t>(m_ring.getTargetLatency()) + m_blockFrames * NUM_BLOCKS;
+}
+
+void CALLBACK DirectMonitor::waveInProc(HWAVEIN hwi, UINT uMsg,
+                                        DWORD_PTR dwInstance, DWORD_PTR dwParam1, DWORD_PTR dwParam2) {
+    if (uMsg == WIM_DATA) {
+        RealtimeCheck::Scope realtime("DirectMonitor::waveInProc");
+        ThreadPriority::ensureCurrentThreadRealtime(ThreadPriority::Task::ProAudio);
+        DirectMonitor* monitor = reinterpret_cast<DirectMonitor*>(dwInstance);
+        WAVEHDR* header = reinterpret_cast<WAVEHDR*>(dwParam1);
+
+        if (monitor->m_running) {
+            monitor->processInput(header);
+            header->dwBytesRecorded = 0;
+            waveInAddBuffer(hwi, header, sizeof(WAVEHDR));
+        }
+    }
+}
+
+void CALLBACK DirectMonitor::waveOutProc(HWAVEOUT hwo, UINT uMsg,
+                                         DWORD_PTR dwInstance, DWORD_PTR dwParam1, DWORD_PTR dwParam2) {
+    if (uMsg == WOM_DONE) {
+        RealtimeCheck::Scope realtime("DirectMonitor::waveOutProc");
+        ThreadPriority::ensureCurrentThreadRealtime(ThreadPriority::Task::ProAudio);
+        DirectMonitor* monitor = reinterpret_cast<DirectMonitor*>(dwInstance);
+        WAVEHDR* header = reinterpret_cast<WAVEHDR*>(dwParam1);
+
+        if (monitor->m_running) {
+            monitor->fillOutput(header);
+            waveOutWrite(hwo, header, sizeof(WAVEHDR));
+        }
+    }
+}
+
+void DirectMonitor::processInput(WAVEHDR* header) {
+    if (header->dwBytesRecorded == 0) return;
+
+    size_t sampleCount = std::min<size_t>(header->dwBytesRecorded / sizeof(int16_t), m_inScratch.size());
+    SampleConvert::toFloat(header->lpData, m_inScratch.data(), sampleCount, SampleFormat::Int16);
+    m_ring.push(m_inScratch.data(), sampleCount / m_format.nChannels);
+}
+
+void DirectMonitor::fillOutput(WAVEHDR* header) {
+    header->dwFlags &= ~WHDR_DONE;
+
+    m_ring.pull(m_outScratch.data(), m_blockFrames);
+
+    float gain = m_gain.load();
+    if (gain != 1.0f) {
+        for (float& sample : m_outScratch) {
+            sample *= gain;
+        }
+    }
+
+    SampleConvert::fromFloat(m_outScratch.data(), header->lpData, m_outScratch.size(), SampleFormat::Int16);
+}
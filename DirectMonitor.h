@@ -0,0 +1,75 @@
+#pragma once
+#include <Windows.h>
+#include <mmsystem.h>
+#include "InputMonitorBuffer.h"
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+// Low-latency input monitoring path that runs independently of the main mix.
+// It opens its own waveIn/waveOut pair with small blocks (64-256 frames) and
+// passes input straight to output with only a gain applied. The main mix keeps
+// its large, dropout-safe buffers on its own device stream; the OS mixer sums
+// the two streams, so the big mix never has to shrink for performers to hear
+// themselves without delay.
+class DirectMonitor {
+public:
+    static constexpr uint32_t MIN_BLOCK_FRAMES = 64;
+    static constexpr uint32_t MAX_BLOCK_FRAMES = 256;
+    static constexpr uint32_t DEFAULT_BLOCK_FRAMES = 128;
+
+    DirectMonitor() = default;
+    ~DirectMonitor();
+
+    DirectMonitor(const DirectMonitor&) = delete;
+    DirectMonitor& operator=(const DirectMonitor&) = delete;
+
+    bool start(UINT inputDevice, uint32_t sampleRate, uint16_t channels,
+               uint32_t blockFrames = DEFAULT_BLOCK_FRAMES);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    void setGain(float gain) { m_gain = gain; }
+    float getGain() const { return m_gain; }
+
+    uint32_t getBlockFrames() const { return m_blockFrames; }
+
+    // Set up the format, ring and block scratch without opening devices.
+    // start() calls this; tests use it to drive the block path headlessly.
+    void configure(uint32_t sampleRate, uint16_t channels, uint32_t blockFrames);
+
+    // Block handlers run by the device callbacks: a recorded input block goes
+    // into the ring, an output block is filled from the ring with the gain
+    void processInput(WAVEHDR* header);
+    void fillOutput(WAVEHDR* header);
+
+    // Approximate input-to-output latency: queued input + ring target + queued output
+    uint32_t getLatencyFrames() const;
+    InputMonitorBuffer::Stats getStats() const { return m_ring.getStats(); }
+
+private:
+    static void CALLBACK waveInProc(HWAVEIN hwi, UINT uMsg,
+                                    DWORD_PTR dwInstance, DWORD_PTR dwParam1, DWORD_PTR dwParam2);
+    static void CALLBACK waveOutProc(HWAVEOUT hwo, UINT uMsg,
+                                     DWORD_PTR dwInstance, DWORD_PTR dwParam1, DWORD_PTR dwParam2);
+
+    static constexpr int NUM_BLOCKS = 3;  // Per direction
+
+    HWAVEIN m_waveIn = nullptr;
+    HWAVEOUT m_waveOut = nullptr;
+    WAVEFORMATEX m_format = {};
+    uint32_t m_blockFrames = DEFAULT_BLOCK_FRAMES;
+
+    WAVEHDR m_inHeaders[NUM_BLOCKS] = {};
+    WAVEHDR m_outHeaders[NUM_BLOCKS] = {};
+    std::vector<int16_t> m_inBuffers[NUM_BLOCKS];
+    std::vector<int16_t> m_outBuffers[NUM_BLOCKS];
+
+    // Callback scratch, sized in start()
+    std::vector<float> m_inScratch;
+    std::vector<float> m_outScratch;
+
+    InputMonitorBuffer m_ring;
+    std::atomic<bool> m_running{false};
+    std::atomic<float> m_gain{1.0f};
+};
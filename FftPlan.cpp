@@ -0,0 +1,261 @@
+#include "FftPlan.h"
+#include "Simd.h"
+#include <array>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+int log2Of(size_t value) {
+    int bits = 0;
+    while ((size_t(1) << bits) < value) {
+        ++bits;
+    }
+    return bits;
+}
+
+// One fused radix-4 butterfly (two radix-2 stages: half-length h into 2h,
+// then 2h into 4h). w1 = W_2h^j, w2 = W_4h^j; W_4h^(j+h) = -i * w2.
+inline void butterfly4(float* re, float* im, size_t j, size_t h,
+                       float w1r, float w1i, float w2r, float w2i) {
+    float ar = re[j], ai = im[j];
+    float br = re[j + h], bi = im[j + h];
+    float cr = re[j + 2 * h], ci = im[j + 2 * h];
+    float dr = re[j + 3 * h], di = im[j + 3 * h];
+
+    float t1r = w1r * br - w1i * bi, t1i = w1r * bi + w1i * br;
+    float t2r = w1r * dr - w1i * di, t2i = w1r * di + w1i * dr;
+    float a2r = ar + t1r, a2i = ai + t1i;
+    float b2r = ar - t1r, b2i = ai - t1i;
+    float c2r = cr + t2r, c2i = ci + t2i;
+    float d2r = cr - t2r, d2i = ci - t2i;
+
+    float t3r = w2r * c2r - w2i * c2i, t3i = w2r * c2i + w2i * c2r;
+    float t4r = w2r * d2r - w2i * d2i, t4i = w2r * d2i + w2i * d2r;
+    // Multiply t4 by -i: (x + iy) * -i = y - ix
+    float t5r = t4i, t5i = -t4r;
+
+    re[j] = a2r + t3r;          im[j] = a2i + t3i;
+    re[j + 2 * h] = a2r - t3r;  im[j + 2 * h] = a2i - t3i;
+    re[j + h] = b2r + t5r;      im[j + h] = b2i + t5i;
+    re[j + 3 * h] = b2r - t5r;  im[j + 3 * h] = b2i - t5i;
+}
+
+#ifdef WAVPLAYER_USE_SSE2
+// Four butterflies at j..j+3 (h must be a multiple of 4)
+inline void butterfly4x4(float* re, float* im, size_t j, size_t h,
+                         const float* w1re, const float* w1im, const float* w2re, const float* w2im) {
+    __m128 ar = _mm_loadu_ps(re + j), ai = _mm_loadu_ps(im + j);
+    __m128 br = _mm_loadu_ps(re + j + h), bi = _mm_loadu_ps(im + j + h);
+    __m128 cr = _mm_loadu_ps(re + j + 2 * h), ci = _mm_loadu_ps(im + j + 2 * h);
+    __m128 dr = _mm_loadu_ps(re + j + 3 * h), di = _mm_loadu_ps(im + j + 3 * h);
+    __m128 w1r = _mm_loadu_ps(w1re + j), w1i = _mm_loadu_ps(w1im + j);
+    __m128 w2r = _mm_loadu_ps(w2re + j), w2i = _mm_loadu_ps(w2im + j);
+
+    __m128 t1r = _mm_sub_ps(_mm_mul_ps(w1r, br), _mm_mul_ps(w1i, bi));
+    __m128 t1i = _mm_add_ps(_mm_mul_ps(w1r, bi), _mm_mul_ps(w1i, br));
+    __m128 t2r = _mm_sub_ps(_mm_mul_ps(w1r, dr), _mm_mul_ps(w1i, di));
+    __m128 t2i = _mm_add_ps(_mm_mul_ps(w1r, di), _mm_mul_ps(w1i, dr));
+    __m128 a2r = _mm_add_ps(ar, t1r), a2i = _mm_add_ps(ai, t1i);
+    __m128 b2r = _mm_sub_ps(ar, t1r), b2i = _mm_sub_ps(ai, t1i);
+    __m128 c2r = _mm_add_ps(cr, t2r), c2i = _mm_add_ps(ci, t2i);
+    __m128 d2r = _mm_sub_ps(cr, t2r), d2i = _mm_sub_ps(ci, t2i);
+
+    __m128 t3r = _mm_sub_ps(_mm_mul_ps(w2r, c2r), _mm_mul_ps(w2i, c2i));
+    __m128 t3i = _mm_add_ps(_mm_mul_ps(w2r, c2i), _mm_mul_ps(w2i, c2r));
+    __m128 t4r = _mm_sub_ps(_mm_mul_ps(w2r, d2r), _mm_mul_ps(w2i, d2i));
+    __m128 t4i = _mm_add_ps(_mm_mul_ps(w2r, d2i), _mm_mul_ps(w2i, d2r));
+
+    _mm_storeu_ps(re + j, _mm_add_ps(a2r, t3r));
+    _mm_storeu_ps(im + j, _mm_add_ps(a2i, t3i));
+    _mm_storeu_ps(re + j + 2 * h, _mm_sub_ps(a2r, t3r));
+    _mm_storeu_ps(im + j + 2 * h, _mm_sub_ps(a2i, t3i));
+    // (b2 + -i*t4) and (b2 - -i*t4)
+    _mm_storeu_ps(re + j + h, _mm_add_ps(b2r, t4i));
+    _mm_storeu_ps(im + j + h, _mm_sub_ps(b2i, t4r));
+    _mm_storeu_ps(re + j + 3 * h, _mm_sub_ps(b2r, t4i));
+    _mm_storeu_ps(im + j + 3 * h, _mm_add_ps(b2i, t4r));
+}
+#endif
+
+} // namespace
+
+const FftPlan* FftPlan::get(size_t size) {
+    if (size < MIN_SIZE || size > MAX_SIZE || (size & (size - 1)) != 0) {
+        return nullptr;
+    }
+
+    static std::mutex s_mutex;
+    static std::array<std::unique_ptr<FftPlan>, 17> s_plans;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto& plan = s_plans[log2Of(size)];
+    if (!plan) {
+        plan.reset(new FftPlan(size));
+    }
+    return plan.get();
+}
+
+FftPlan::FftPlan(size_t size) : m_size(size), m_half(size / 2) {
+    const int bits = log2Of(m_half);
+    m_bitReverse.resize(m_half);
+    for (size_t i = 0; i < m_half; ++i) {
+        uint32_t reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    m_twiddleRe.resize(m_half);
+    m_twiddleIm.resize(m_half);
+    for (size_t len = 2; len <= m_half; len *= 2) {
+        size_t offset = len / 2 - 1;
+        for (size_t j = 0; j < len / 2; ++j) {
+            double angle = -2.0 * PI * j / len;
+            m_twiddleRe[offset + j] = static_cast<float>(std::cos(angle));
+            m_twiddleIm[offset + j] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    m_splitRe.resize(m_half);
+    m_splitIm.resize(m_half);
+    for (size_t k = 0; k < m_half; ++k) {
+        double angle = -2.0 * PI * k / m_size;
+        m_splitRe[k] = static_cast<float>(std::cos(angle));
+        m_splitIm[k] = static_cast<float>(std::sin(angle));
+    }
+
+    // Periodic windows (the analysis frame repeats every N samples)
+    for (int type = 0; type < 4; ++type) {
+        std::vector<float>& window = m_windows[type];
+        window.resize(m_size);
+        double sum = 0.0;
+        for (size_t i = 0; i < m_size; ++i) {
+            double phase = 2.0 * PI * i / m_size;
+            double value = 1.0;
+            switch (static_cast<Window>(type)) {
+            case Window::Rectangular: value = 1.0; break;
+            case Window::Hann: value = 0.5 - 0.5 * std::cos(phase); break;
+            case Window::Hamming: value = 0.54 - 0.46 * std::cos(phase); break;
+            case Window::BlackmanHarris:
+                value = 0.35875 - 0.48829 * std::cos(phase) + 0.14128 * std::cos(2 * phase) -
+                        0.01168 * std::cos(3 * phase);
+                break;
+            }
+            window[i] = static_cast<float>(value);
+            sum += value;
+        }
+        m_windowSums[type] = static_cast<float>(sum);
+    }
+}
+
+const float* FftPlan::getWindow(Window window) const {
+    return m_windows[static_cast<int>(window)].data();
+}
+
+float FftPlan::getWindowSum(Window window) const {
+    return m_windowSums[static_cast<int>(window)];
+}
+
+void FftPlan::transform(float* re, float* im) const {
+    const size_t n = m_half;
+    size_t len = 1;
+
+    // An odd number of radix-2 stages leaves one plain radix-2 pass first
+    if (log2Of(n) % 2 == 1) {
+        for (size_t i = 0; i < n; i += 2) {
+            float ar = re[i], ai = im[i];
+            float br = re[i + 1], bi = im[i + 1];
+            re[i] = ar + br;      im[i] = ai + bi;
+            re[i + 1] = ar - br;  im[i + 1] = ai - bi;
+        }
+        len = 2;
+    }
+
+    for (; len < n; len *= 4) {
+        const size_t h = len;
+        const float* w1re = m_twiddleRe.data() + (h - 1);      // Stage length 2h
+        const float* w1im = m_twiddleIm.data() + (h - 1);
+        const float* w2re = m_twiddleRe.data() + (2 * h - 1);  // Stage length 4h
+        const float* w2im = m_twiddleIm.data() + (2 * h - 1);
+
+        for (size_t block = 0; block < n; block += 4 * h) {
+            float* blockRe = re + block;
+            float* blockIm = im + block;
+            size_t j = 0;
+#ifdef WAVPLAYER_USE_SSE2
+            for (; j + 4 <= h; j += 4) {
+                butterfly4x4(blockRe, blockIm, j, h, w1re, w1im, w2re, w2im);
+            }
+#endif
+            for (; j < h; ++j) {
+                butterfly4(blockRe, blockIm, j, h, w1re[j], w1im[j], w2re[j], w2im[j]);
+            }
+        }
+    }
+}
+
+void FftPlan::forward(const float* input, float* outRe, float* outIm, float* workspace, Window window) const {
+    const size_t m = m_half;
+    float* re = workspace;
+    float* im = workspace + m;
+    const float* w = getWindow(window);
+
+    // Pack even/odd samples as one complex sequence, in bit-reversed order
+    for (size_t i = 0; i < m; ++i) {
+        size_t source = 2 * static_cast<size_t>(m_bitReverse[i]);
+        re[i] = input[source] * w[source];
+        im[i] = input[source + 1] * w[source + 1];
+    }
+
+    transform(re, im);
+
+    // Split into the spectrum of the real input:
+    // X[k] = E[k] + W^k O[k], E = (Z[k] + conj Z[m-k]) / 2, O = (Z[k] - conj Z[m-k]) / 2i
+    outRe[0] = re[0] + im[0];
+    outIm[0] = 0.0f;
+    outRe[m] = re[0] - im[0];
+    outIm[m] = 0.0f;
+    for (size_t k = 1; k < m; ++k) {
+        float zr = re[k], zi = im[k];
+        float cr = re[m - k], ci = im[m - k];
+        float er = 0.5f * (zr + cr), ei = 0.5f * (zi - ci);
+        float orr = 0.5f * (zi + ci), oi = -0.5f * (zr - cr);
+        float wr = m_splitRe[k], wi = m_splitIm[k];
+        outRe[k] = er + wr * orr - wi * oi;
+        outIm[k] = ei + wr * oi + wi * orr;
+    }
+}
+
+void FftPlan::inverse(const float* inRe, const float* inIm, float* output, float* workspace) const {
+    const size_t m = m_half;
+    float* re = workspace;
+    float* im = workspace + m;
+
+    // Rebuild Z[k] = E[k] + i O[k] (O = (X[k] - conj X[m-k]) / 2W^k), conjugated so
+    // the forward transform computes the inverse, stored in bit-reversed order
+    for (size_t k = 0; k < m; ++k) {
+        float xr = inRe[k], xi = inIm[k];
+        float cr = inRe[m - k], ci = -inIm[m - k];
+        float er = 0.5f * (xr + cr), ei = 0.5f * (xi + ci);
+        float dr = 0.5f * (xr - cr), di = 0.5f * (xi - ci);
+        // Divide by W^k: multiply by its conjugate
+        float wr = m_splitRe[k], wi = -m_splitIm[k];
+        float orr = dr * wr - di * wi, oi = dr * wi + di * wr;
+        size_t target = m_bitReverse[k];
+        re[target] = er - oi;
+        im[target] = -(ei + orr);
+    }
+
+    transform(re, im);
+
+    const float scale = 1.0f / static_cast<float>(m);
+    for (size_t i = 0; i < m; ++i) {
+        output[2 * i] = re[i] * scale;
+        output[2 * i + 1] = -im[i] * scale;
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Real-input FFT for analysis and convolution. A size-N real transform is run
+// as an N/2-point complex FFT over the even/odd samples followed by a split
+// step, so it costs about half of a complex transform. The complex FFT is
+// radix-4 (fused pairs of radix-2 stages, so half the passes over memory)
+// on split real/imaginary arrays, which lets SSE run four butterflies at
+// once. Bit-reversal tables, twiddles and windows are all precomputed.
+//
+// Plans are immutable and shared: get() builds each size once (any power of
+// two from MIN_SIZE to MAX_SIZE) and keeps it for the life of the process.
+// Callers provide their own workspace, so one plan can serve several threads.
+class FftPlan {
+public:
+    static constexpr size_t MIN_SIZE = 64;
+    static constexpr size_t MAX_SIZE = 65536;
+
+    enum class Window { Rectangular, Hann, Hamming, BlackmanHarris };
+
+    // nullptr if size isn't a supported power of two. Not for the audio
+    // thread: the first request for a size allocates.
+    static const FftPlan* get(size_t size);
+
+    size_t getSize() const { return m_size; }
+    size_t getBinCount() const { return m_size / 2 + 1; }
+    size_t getWorkspaceSize() const { return m_size; }  // Floats
+
+    // size() coefficients; the sum is the window's coherent gain
+    const float* getWindow(Window window) const;
+    float getWindowSum(Window window) const;
+
+    // getBinCount() bins of the unscaled DFT of size() real samples, with the
+    // window applied on the way in
+    void forward(const float* input, float* outRe, float* outIm, float* workspace,
+                 Window window = Window::Rectangular) const;
+
+    // Inverse of forward() (including the 1/N scaling), writing size() samples
+    void inverse(const float* inRe, const float* inIm, float* output, float* workspace) const;
+
+private:
+    explicit FftPlan(size_t size);
+
+    // In-place complex FFT of m_half points, input in bit-reversed order
+    void transform(float* re, float* im) const;
+
+    size_t m_size = 0;
+    size_t m_half = 0;
+    std::vector<uint32_t> m_bitReverse;  // Over m_half
+    // W_L^j for every stage length L, stage L stored at offset L/2 - 1
+    std::vector<float> m_twiddleRe;
+    std::vector<float> m_twiddleIm;
+    // W_N^k for the real/complex split
+    std::vector<float> m_splitRe;
+    std::vector<float> m_splitIm;
+    std::vector<float> m_windows[4];
+    float m_windowSums[4] = {};
+};
@@ -0,0 +1,258 @@
+#include "FractionalOctaveBank.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// A band runs at the deepest level where its upper edge stays below this
+// fraction of the level's rate
+constexpr double LEVEL_TOP = 0.2;
+// Upper edges must stay this far below Nyquist at the full rate
+constexpr double MAX_EDGE = 0.48;
+// Decimator cutoff as a fraction of the rate it filters: flat to the next
+// level's top band (0.1), over 90 dB down where aliases would land on it (0.4)
+constexpr double DECIMATOR_CUTOFF = 0.15;
+
+} // namespace
+
+float FractionalOctaveBank::bandCenter(int k, int bandsPerOctave) {
+    return static_cast<float>(1000.0 * std::pow(2.0, double(k) / bandsPerOctave));
+}
+
+bool FractionalOctaveBank::configure(int bandsPerOctave, int sampleRate) {
+    if (bandsPerOctave < 1 || bandsPerOctave > MAX_BANDS_PER_OCTAVE || sampleRate <= 0) {
+        return false;
+    }
+
+    const double edge = std::pow(2.0, 0.5 / bandsPerOctave);
+    std::vector<float> centers;
+    std::vector<int> bandLevel;
+    int kMin = static_cast<int>(std::ceil(bandsPerOctave * std::log2(MIN_FREQ / edge / 1000.0)));
+    int kMax = static_cast<int>(std::floor(bandsPerOctave * std::log2(MAX_FREQ / 1000.0)));
+    for (int k = kMin; k <= kMax; ++k) {
+        double center = bandCenter(k, bandsPerOctave);
+        double upper = center * edge;
+        if (upper >= MAX_EDGE * sampleRate) break;
+
+        int level = 0;
+        while (level + 1 < MAX_LEVELS && upper < LEVEL_TOP * sampleRate / std::pow(2.0, level + 1)) {
+            ++level;
+        }
+        centers.push_back(static_cast<float>(center));
+        bandLevel.push_back(level);
+    }
+    if (centers.empty()) {
+        return false;
+    }
+
+    int levelCount = *std::max_element(bandLevel.begin(), bandLevel.end()) + 1;
+    std::vector<Level> levels(levelCount);
+
+    for (int d = 0; d < levelCount; ++d) {
+        Level& level = levels[d];
+        const double rate = sampleRate / std::pow(2.0, d);
+        level.buffer.resize(CHUNK);
+
+        // Butterworth 6th order low-pass as three RBJ sections
+        const double w = 2.0 * M_PI * DECIMATOR_CUTOFF;
+        const double qs[SECTIONS] = {0.5176380902, 0.7071067812, 1.9318516526};
+        for (int s = 0; s < SECTIONS; ++s) {
+            double alpha = std::sin(w) / (2.0 * qs[s]);
+            double a0 = 1.0 + alpha;
+            level.decimator.b0[s] = static_cast<float>((1.0 - std::cos(w)) / 2.0 / a0);
+            level.decimator.b1[s] = static_cast<float>((1.0 - std::cos(w)) / a0);
+            level.decimator.b2[s] = level.decimator.b0[s];
+            level.decimator.a1[s] = static_cast<float>(-2.0 * std::cos(w) / a0);
+            level.decimator.a2[s] = static_cast<float>((1.0 - alpha) / a0);
+        }
+
+        // Bandpasses: the Butterworth prototype's poles moved to each band
+        // edge pair (analog, prewarped), then through the bilinear transform
+        for (size_t band = 0; band < centers.size(); ++band) {
+            if (bandLevel[band] != d) continue;
+
+            const double fs2 = 2.0 * rate;
+            const double w1 = fs2 * std::tan(M_PI * centers[band] / edge / rate);
+            const double w2 = fs2 * std::tan(M_PI * centers[band] * edge / rate);
+            const double w0 = std::sqrt(w1 * w2);
+            const double bw = w2 - w1;
+
+            std::vector<std::complex<double>> poles;
+            for (int k = 0; k < SECTIONS; ++k) {
+                std::complex<double> p = std::polar(1.0, M_PI * (2.0 * k + SECTIONS + 1) / (2.0 * SECTIONS));
+                std::complex<double> root = std::sqrt(p * p * bw * bw - 4.0 * w0 * w0);
+                for (std::complex<double> s : {(p * bw + root) / 2.0, (p * bw - root) / 2.0}) {
+                    std::complex<double> z = (fs2 + s) / (fs2 - s);
+                    if (z.imag() > 0.0) {
+                        poles.push_back(z);
+                    }
+                }
+            }
+            if (poles.size() != SECTIONS) {
+                return false;
+            }
+
+            // Unity gain at the centre, spread evenly over the sections
+            const std::complex<double> zc = std::polar(1.0, 2.0 * std::atan(w0 / fs2));
+            std::complex<double> response = 1.0;
+            for (const auto& pole : poles) {
+                response *= (1.0 - 1.0 / (zc * zc)) /
+                            (1.0 - 2.0 * pole.real() / zc + std::norm(pole) / (zc * zc));
+            }
+            const double gain = std::pow(1.0 / std::abs(response), 1.0 / SECTIONS);
+
+            if (level.groups.empty() || level.groups.back().band[LANES - 1] >= 0) {
+                level.groups.emplace_back();
+            }
+            Group& group = level.groups.back();
+            int lane = 0;
+            while (group.band[lane] >= 0) ++lane;
+            group.band[lane] = static_cast<int>(band);
+            for (int s = 0; s < SECTIONS; ++s) {
+                group.b0[s][lane] = static_cast<float>(gain);
+                group.a1[s][lane] = static_cast<float>(-2.0 * poles[s].real());
+                group.a2[s][lane] = static_cast<float>(std::norm(poles[s]));
+            }
+        }
+    }
+
+    m_bandsPerOctave = bandsPerOctave;
+    m_sampleRate = sampleRate;
+    m_centers = std::move(centers);
+    m_bandLevel = std::move(bandLevel);
+    m_energy.assign(m_centers.size(), 0.0);
+    m_levels = std::move(levels);
+    return true;
+}
+
+void FractionalOctaveBank::reset() {
+    for (Level& level : m_levels) {
+        for (Group& group : level.groups) {
+            std::fill(&group.z1[0][0], &group.z1[0][0] + SECTIONS * LANES, 0.0f);
+            std::fill(&group.z2[0][0], &group.z2[0][0] + SECTIONS * LANES, 0.0f);
+        }
+        std::fill(std::begin(level.decimator.z1), std::end(level.decimator.z1), 0.0f);
+        std::fill(std::begin(level.decimator.z2), std::end(level.decimator.z2), 0.0f);
+        level.decimator.skip = false;
+        level.samples = 0;
+    }
+    std::fill(m_energy.begin(), m_energy.end(), 0.0);
+}
+
+void FractionalOctaveBank::process(const float* samples, size_t count) {
+    if (m_levels.empty()) return;
+
+    while (count > 0) {
+        size_t take = std::min(count, CHUNK);
+        const float* input = samples;
+
+        // Each level's bands, then its low-passed, halved signal feeds the next
+        for (size_t d = 0; d < m_levels.size() && take > 0; ++d) {
+            Level& level = m_levels[d];
+            for (Group& group : level.groups) {
+                runGroup(group, input, take);
+            }
+            level.samples += take;
+
+            if (d + 1 < m_levels.size()) {
+                float* next = m_levels[d + 1].buffer.data();
+                take = decimate(level.decimator, input, take, next);
+                input = next;
+            }
+        }
+
+        size_t done = std::min(count, CHUNK);
+        samples += done;
+        count -= done;
+    }
+}
+
+void FractionalOctaveBank::runGroup(Group& group, const float* input, size_t count) {
+    float energy[LANES];
+
+#ifdef WAVPLAYER_USE_SSE2
+    __m128 b0[SECTIONS], a1[SECTIONS], a2[SECTIONS], z1[SECTIONS], z2[SECTIONS];
+    for (int s = 0; s < SECTIONS; ++s) {
+        b0[s] = _mm_loadu_ps(group.b0[s]);
+        a1[s] = _mm_loadu_ps(group.a1[s]);
+        a2[s] = _mm_loadu_ps(group.a2[s]);
+        z1[s] = _mm_loadu_ps(group.z1[s]);
+        z2[s] = _mm_loadu_ps(group.z2[s]);
+    }
+    __m128 acc = _mm_setzero_ps();
+    for (size_t n = 0; n < count; ++n) {
+        __m128 x = _mm_set1_ps(input[n]);
+        for (int s = 0; s < SECTIONS; ++s) {
+            // DF2T with b1 = 0, b2 = -b0
+            __m128 bx = _mm_mul_ps(b0[s], x);
+            __m128 y = _mm_add_ps(bx, z1[s]);
+            z1[s] = _mm_sub_ps(z2[s], _mm_mul_ps(a1[s], y));
+            z2[s] = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(bx, _mm_mul_ps(a2[s], y)));
+            x = y;
+        }
+        acc = _mm_add_ps(acc, _mm_mul_ps(x, x));
+    }
+    for (int s = 0; s < SECTIONS; ++s) {
+        _mm_storeu_ps(group.z1[s], z1[s]);
+        _mm_storeu_ps(group.z2[s], z2[s]);
+    }
+    _mm_storeu_ps(energy, acc);
+#else
+    for (int lane = 0; lane < LANES; ++lane) {
+        float acc = 0.0f;
+        for (size_t n = 0; n < count; ++n) {
+            float x = input[n];
+            for (int s = 0; s < SECTIONS; ++s) {
+                float bx = group.b0[s][lane] * x;
+                float y = bx + group.z1[s][lane];
+                group.z1[s][lane] = group.z2[s][lane] - group.a1[s][lane] * y;
+                group.z2[s][lane] = -(bx + group.a2[s][lane] * y);
+                x = y;
+            }
+            acc += x * x;
+        }
+        energy[lane] = acc;
+    }
+#endif
+
+    for (int lane = 0; lane < LANES; ++lane) {
+        if (group.band[lane] >= 0) {
+            m_energy[group.band[lane]] += energy[lane];
+        }
+    }
+}
+
+size_t FractionalOctaveBank::decimate(Decimator& decimator, const float* input, size_t count, float* output) {
+    size_t written = 0;
+    for (size_t n = 0; n < count; ++n) {
+        float x = input[n];
+        for (int s = 0; s < SECTIONS; ++s) {
+            float y = decimator.b0[s] * x + decimator.z1[s];
+            decimator.z1[s] = decimator.b1[s] * x - decimator.a1[s] * y + decimator.z2[s];
+            decimator.z2[s] = decimator.b2[s] * x - decimator.a2[s] * y;
+            x = y;
+        }
+        if (!decimator.skip) {
+            output[written++] = x;
+        }
+        decimator.skip = !decimator.skip;
+    }
+    return written;
+}
+
+void FractionalOctaveBank::takeLevels(float* levels) {
+    for (size_t band = 0; band < m_centers.size(); ++band) {
+        uint64_t samples = m_levels[m_bandLevel[band]].samples;
+        levels[band] = samples > 0 ? static_cast<float>(std::sqrt(2.0 * m_energy[band] / samples)) : 0.0f;
+        m_energy[band] = 0.0;
+    }
+    for (Level& level : m_levels) {
+        level.samples = 0;
+    }
+}
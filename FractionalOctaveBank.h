@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fractional-octave analyzer (1/3, 1/6 octave...) as a multirate IIR filter
+// bank, in the style of ANSI S1.11 analyzers. Each band is a 6th-order
+// Butterworth bandpass (three biquads). Rather than running every band at the
+// full rate, the input is repeatedly low-passed and halved, and each band
+// runs at the lowest rate that still holds it, where it sits between 0.1 and
+// 0.2 of that rate. Low bands then get their full selectivity with well
+// conditioned coefficients, and the whole bank costs about twice the top
+// octave's bands. A 20 Hz band at 1/6 octave is ~2 Hz wide, which an FFT
+// would need 32768 points or more to resolve.
+//
+// Bands of one rate run four at a time in SIMD lanes. Each band integrates
+// its output energy until takeLevels().
+//
+// Not thread-safe; owned by one analysis thread.
+class FractionalOctaveBank {
+public:
+    static constexpr float MIN_FREQ = 20.0f;
+    static constexpr float MAX_FREQ = 20000.0f;
+    static constexpr int MAX_BANDS_PER_OCTAVE = 12;
+
+    // Centre of band k (k = 0 at 1 kHz) on the base-2 series
+    static float bandCenter(int k, int bandsPerOctave);
+
+    // Bands reaching above MIN_FREQ with centres up to MAX_FREQ, and upper
+    // edges clear of Nyquist. False (nothing changes) for unsupported arguments.
+    bool configure(int bandsPerOctave, int sampleRate);
+    int getBandsPerOctave() const { return m_bandsPerOctave; }
+    int getSampleRate() const { return m_sampleRate; }
+
+    size_t getBandCount() const { return m_centers.size(); }
+    const std::vector<float>& getCenters() const { return m_centers; }
+
+    // Clears filter state and accumulated energy
+    void reset();
+
+    // Mono input in any block size
+    void process(const float* samples, size_t count);
+
+    // Per band, the RMS since the last call as the amplitude of an equal-power
+    // sine (1.0 = full-scale sine); getBandCount() values. Bands that saw no
+    // samples at their rate yet report 0.
+    void takeLevels(float* levels);
+
+private:
+    static constexpr int SECTIONS = 3;    // Biquads per bandpass
+    static constexpr int LANES = 4;       // Bands per SIMD group
+    static constexpr int MAX_LEVELS = 12; // Rates: sampleRate / 2^level
+    static constexpr size_t CHUNK = 256;  // Frames per pass through the levels
+
+    // Four bands of one level, one per lane. Numerators are b0 (1 - z^-2).
+    struct Group {
+        float b0[SECTIONS][LANES] = {};
+        float a1[SECTIONS][LANES] = {};
+        float a2[SECTIONS][LANES] = {};
+        float z1[SECTIONS][LANES] = {};
+        float z2[SECTIONS][LANES] = {};
+        int band[LANES] = {-1, -1, -1, -1};
+    };
+
+    // Decimating low-pass ahead of the next level down (Butterworth, 6th order)
+    struct Decimator {
+        float b0[SECTIONS] = {}, b1[SECTIONS] = {}, b2[SECTIONS] = {};
+        float a1[SECTIONS] = {}, a2[SECTIONS] = {};
+        float z1[SECTIONS] = {}, z2[SECTIONS] = {};
+        bool skip = false;  // Drop the next filtered sample
+    };
+
+    struct Level {
+        std::vector<Group> groups;
+        Decimator decimator;
+        std::vector<float> buffer;  // This level's input for the current chunk
+        uint64_t samples = 0;       // Since the last takeLevels()
+    };
+
+    void runGroup(Group& group, const float* input, size_t count);
+    static size_t decimate(Decimator& decimator, const float* input, size_t count, float* output);
+
+    int m_bandsPerOctave = 0;
+    int m_sampleRate = 0;
+    std::vector<float> m_centers;
+    std::vector<int> m_bandLevel;
+    std::vector<double> m_energy;
+    std::vector<Level> m_levels;
+};
@@ -0,0 +1,41 @@
+#include "FramePacer.h"
+#include <dwmapi.h>
+
+#pragma comment(lib, "Dwmapi.lib")
+
+FramePacer::~FramePacer() {
+    stop();
+}
+
+bool FramePacer::start(HWND hwnd, UINT message) {
+    if (m_running || !hwnd) {
+        return m_running;
+    }
+
+    m_hwnd = hwnd;
+    m_message = message;
+    m_pending = false;
+    m_running = true;
+    m_thread = std::thread(&FramePacer::loop, this);
+    return true;
+}
+
+void FramePacer::stop() {
+    m_running = false;
+    if (m_thread.joinable()) {
+        m_thread.join();  // At most one refresh away
+    }
+}
+
+void FramePacer::loop() {
+    while (m_running) {
+        if (FAILED(DwmFlush())) {
+            Sleep(FALLBACK_INTERVAL_MS);
+        }
+
+        // Skip this frame if the window hasn't got round to the last one
+        if (!m_pending.exchange(true) && !PostMessage(m_hwnd, m_message, 0, 0)) {
+            m_pending = false;
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <Windows.h>
+#include <atomic>
+#include <thread>
+
+// Posts a message to a window once per display refresh. A worker thread
+// waits in DwmFlush(), which returns after the compositor's next vertical
+// blank, so animation driven from the message (the playhead) moves once per
+// frame actually shown. WM_TIMER can't do this: its period is rounded up to
+// USER_TIMER_MINIMUM (10 ms) and then to the system timer tick (15.6 ms by
+// default). At most one message is outstanding; the window calls
+// frameHandled() once it has processed it.
+class FramePacer {
+public:
+    FramePacer() = default;
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    bool start(HWND hwnd, UINT message);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    void frameHandled() { m_pending = false; }
+
+private:
+    void loop();
+
+    // Without desktop composition DwmFlush() fails; fall back to about 60 Hz
+    static constexpr DWORD FALLBACK_INTERVAL_MS = 16;
+
+    HWND m_hwnd = nullptr;
+    UINT m_message = 0;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_pending{false};
+};
@@ -0,0 +1,110 @@
+#include "InputMonitorBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+void InputMonitorBuffer::configure(uint16_t channels, size_t capacityFrames, size_t targetLatencyFrames) {
+    m_channels = std::max<uint16_t>(channels, 1);
+    m_ring.resize(capacityFrames * m_channels);
+    setTargetLatency(targetLatencyFrames);
+
+    m_flushRequested = false;
+    m_priming = true;
+    m_averageFill = 0.0;
+    resetStats();
+}
+
+void InputMonitorBuffer::setTargetLatency(size_t frames) {
+    // Leave headroom above the target for bursty producers
+    size_t capacityFrames = m_ring.capacity() / m_channels;
+    m_targetLatency = std::min(frames, capacityFrames / 2);
+}
+
+void InputMonitorBuffer::push(const float* samples, size_t frameCount) {
+    // Only whole frames go in so the ring stays frame-aligned
+    size_t framesFree = m_ring.availableToWrite() / m_channels;
+    size_t framesToWrite = std::min(frameCount, framesFree);
+    m_ring.write(samples, framesToWrite * m_channels);
+
+    if (framesToWrite < frameCount) {
+        ++m_overruns;
+    }
+}
+
+void InputMonitorBuffer::pull(float* out, size_t frameCount) {
+    const size_t channels = m_channels;
+
+    if (m_flushRequested.exchange(false)) {
+        discardFrames(m_ring.availableToRead() / channels);
+        m_priming = true;
+    }
+
+    const size_t target = m_targetLatency.load();
+    size_t available = m_ring.availableToRead() / channels;
+
+    // Wait until the ring holds the target latency before (re)starting output
+    if (m_priming) {
+        if (available < std::max(target, frameCount)) {
+            std::fill(out, out + frameCount * channels, 0.0f);
+            return;
+        }
+        m_priming = false;
+        m_averageFill = static_cast<double>(available);
+    }
+
+    // Output stalled or input burst: cut latency straight back to the target
+    if (available > 2 * target + frameCount) {
+        discardFrames(available - target);
+        available = target;
+        m_averageFill = static_cast<double>(target);
+        ++m_overruns;
+    }
+
+    // Clock drift: nudge the average fill back towards the target one frame at a time
+    m_averageFill += FILL_SMOOTHING * (static_cast<double>(available) - m_averageFill);
+    const double tolerance = static_cast<double>(std::max(MIN_DRIFT_TOLERANCE, target / 4));
+
+    size_t framesToRead = frameCount;
+    bool repeatFrame = false;
+    if (m_averageFill > target + tolerance && available > frameCount) {
+        discardFrames(1);
+        --available;
+        ++m_correctedFrames;
+    }
+    else if (m_averageFill < target - tolerance && frameCount > 1) {
+        repeatFrame = true;
+        --framesToRead;
+    }
+
+    size_t framesRead = m_ring.read(out, std::min(framesToRead, available) * channels) / channels;
+
+    if (repeatFrame && framesRead > 0) {
+        memcpy(out + framesRead * channels, out + (framesRead - 1) * channels, channels * sizeof(float));
+        ++framesRead;
+        ++m_correctedFrames;
+    }
+
+    if (framesRead < frameCount) {
+        std::fill(out + framesRead * channels, out + frameCount * channels, 0.0f);
+        ++m_underruns;
+        m_priming = true;
+    }
+}
+
+InputMonitorBuffer::Stats InputMonitorBuffer::getStats() const {
+    Stats stats;
+    stats.overruns = m_overruns.load();
+    stats.underruns = m_underruns.load();
+    stats.correctedFrames = m_correctedFrames.load();
+    stats.fillFrames = m_ring.availableToRead() / m_channels;
+    return stats;
+}
+
+void InputMonitorBuffer::resetStats() {
+    m_overruns = 0;
+    m_underruns = 0;
+    m_correctedFrames = 0;
+}
+
+void InputMonitorBuffer::discardFrames(size_t frames) {
+    m_ring.discard(frames * m_channels);
+}
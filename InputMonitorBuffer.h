@@ -0,0 +1,62 @@
+#pragma once
+#include "SpscRingBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Carries live input from the recording callback to the playback callback for
+// input monitoring. The two devices run on independent clocks and block sizes,
+// so besides the lock-free ring this keeps the fill level around a target
+// latency: a slowly drifting level is nudged back by dropping or repeating a
+// single frame per pull, a runaway level is cut back to the target, and an
+// empty ring is re-primed to the target before output resumes.
+//
+// push() is called from the input thread only, pull() from the output thread
+// only. configure() must be called before either side is running.
+class InputMonitorBuffer {
+public:
+    struct Stats {
+        uint64_t overruns = 0;         // Input dropped (ring full) or latency cut back to target
+        uint64_t underruns = 0;        // Output padded with silence
+        uint64_t correctedFrames = 0;  // Frames dropped or repeated by drift correction
+        size_t fillFrames = 0;         // Current buffered input
+    };
+
+    void configure(uint16_t channels, size_t capacityFrames, size_t targetLatencyFrames);
+
+    // Target fill level in frames (clamped to the ring capacity)
+    void setTargetLatency(size_t frames);
+    size_t getTargetLatency() const { return m_targetLatency.load(); }
+
+    // Ask the consumer to discard everything and re-prime on its next pull.
+    // Safe to call from any thread.
+    void flush() { m_flushRequested = true; }
+
+    // Producer side: queue interleaved input frames (whole frames only)
+    void push(const float* samples, size_t frameCount);
+
+    // Consumer side: write exactly frameCount interleaved frames to out
+    void pull(float* out, size_t frameCount);
+
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    void discardFrames(size_t frames);
+
+    SpscRingBuffer<float> m_ring;
+    uint16_t m_channels = 2;
+    std::atomic<size_t> m_targetLatency{0};
+    std::atomic<bool> m_flushRequested{false};
+
+    // Consumer-only state
+    bool m_priming = true;
+    double m_averageFill = 0.0;
+
+    std::atomic<uint64_t> m_overruns{0};
+    std::atomic<uint64_t> m_underruns{0};
+    std::atomic<uint64_t> m_correctedFrames{0};
+
+    static constexpr double FILL_SMOOTHING = 0.05;   // EMA weight per pull
+    static constexpr size_t MIN_DRIFT_TOLERANCE = 32; // Frames of slack before correcting
+};
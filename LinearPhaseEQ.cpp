@@ -0,0 +1,183 @@
+#include "LinearPhaseEQ.h"
+#include "BiquadCascade.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+LinearPhaseEQ::LinearPhaseEQ(std::vector<float> bandFrequencies, float q)
+    : m_bandFrequencies(std::move(bandFrequencies)), m_q(q), m_gains(m_bandFrequencies.size()) {
+    for (auto& gain : m_gains) {
+        gain.store(0.0f, std::memory_order_relaxed);
+    }
+
+    size_t partitions = (FIR_LENGTH + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        m_convolvers[ch].configure(BLOCK_SIZE, partitions);
+        m_input[ch].assign(BLOCK_SIZE, 0.0f);
+        m_output[ch].assign(BLOCK_SIZE, 0.0f);
+    }
+}
+
+LinearPhaseEQ::~LinearPhaseEQ() {
+    stop();
+    delete m_current;
+    delete m_pending.exchange(nullptr);
+    delete m_retired.exchange(nullptr);
+}
+
+void LinearPhaseEQ::start() {
+    if (m_running) return;
+    rebuild();
+    m_running = true;
+    m_worker = std::thread(&LinearPhaseEQ::workerLoop, this);
+}
+
+void LinearPhaseEQ::stop() {
+    m_running = false;
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+void LinearPhaseEQ::prepare(int sampleRate) {
+    m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+    rebuild();
+}
+
+void LinearPhaseEQ::setGains(const float* gains, size_t count) {
+    count = std::min(count, m_gains.size());
+    for (size_t i = 0; i < count; ++i) {
+        m_gains[i].store(gains[i], std::memory_order_relaxed);
+    }
+    m_gainGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void LinearPhaseEQ::workerLoop() {
+    while (m_running) {
+        if (m_gainGeneration.load(std::memory_order_acquire) != m_builtGeneration ||
+            m_sampleRate.load(std::memory_order_relaxed) != m_builtRate) {
+            rebuild();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(WORKER_INTERVAL_MS));
+    }
+}
+
+void LinearPhaseEQ::rebuild() {
+    // A generation bumped while the gains are read just causes another rebuild
+    m_builtGeneration = m_gainGeneration.load(std::memory_order_acquire);
+    m_builtRate = m_sampleRate.load(std::memory_order_relaxed);
+    std::vector<float> gains(m_gains.size());
+    for (size_t i = 0; i < gains.size(); ++i) {
+        gains[i] = m_gains[i].load(std::memory_order_relaxed);
+    }
+
+    std::vector<float> fir = designFir(m_bandFrequencies, gains.data(), m_q, static_cast<float>(m_builtRate));
+    std::unique_ptr<Kernel> kernel = PartitionedConvolver::makeKernel(fir.data(), fir.size(), BLOCK_SIZE);
+    if (!kernel) {
+        return;
+    }
+
+    // Free what the audio thread gave back, and any kernel it never took
+    delete m_retired.exchange(nullptr, std::memory_order_acquire);
+    delete m_pending.exchange(kernel.release(), std::memory_order_acq_rel);
+}
+
+std::vector<float> LinearPhaseEQ::designFir(const std::vector<float>& bandFrequencies, const float* gains,
+                                            float q, float sampleRate) {
+    const FftPlan* plan = FftPlan::get(DESIGN_SIZE);
+    std::vector<float> fir(FIR_LENGTH, 0.0f);
+    if (!plan || sampleRate <= 0.0f) {
+        fir[(FIR_LENGTH - 1) / 2] = 1.0f;
+        return fir;
+    }
+
+    // Zero-phase target: the product of the peaking bands' magnitudes, the
+    // same curve the minimum-phase EQ has
+    size_t bins = plan->getBinCount();
+    std::vector<float> re(bins, 1.0f);
+    std::vector<float> im(bins, 0.0f);
+    for (size_t band = 0; band < bandFrequencies.size(); ++band) {
+        BiquadCascade::Coefficients c = BiquadCascade::peakingEQ(bandFrequencies[band], gains[band], q, sampleRate);
+        if (c.isIdentity()) continue;
+
+        // |B(e^jw)|^2 = b0^2 + b1^2 + b2^2 + 2(b0 b1 + b1 b2) cos w + 2 b0 b2 cos 2w, same for A
+        double nb0 = double(c.b0) * c.b0 + double(c.b1) * c.b1 + double(c.b2) * c.b2;
+        double nb1 = 2.0 * (double(c.b0) * c.b1 + double(c.b1) * c.b2);
+        double nb2 = 2.0 * double(c.b0) * c.b2;
+        double na0 = 1.0 + double(c.a1) * c.a1 + double(c.a2) * c.a2;
+        double na1 = 2.0 * (double(c.a1) + double(c.a1) * c.a2);
+        double na2 = 2.0 * double(c.a2);
+        for (size_t k = 0; k < bins; ++k) {
+            double w = 2.0 * M_PI * k / DESIGN_SIZE;
+            double cos1 = std::cos(w), cos2 = std::cos(2.0 * w);
+            double num = nb0 + nb1 * cos1 + nb2 * cos2;
+            double den = na0 + na1 * cos1 + na2 * cos2;
+            re[k] *= static_cast<float>(std::sqrt(std::max(num, 0.0) / den));
+        }
+    }
+
+    // The impulse is symmetric around sample 0 of the circular result; centre
+    // it in the FIR and taper the ends. Mirroring one half keeps the phase
+    // exactly linear despite rounding in the transform.
+    std::vector<float> impulse(DESIGN_SIZE);
+    std::vector<float> workspace(plan->getWorkspaceSize());
+    plan->inverse(re.data(), im.data(), impulse.data(), workspace.data());
+
+    const size_t center = (FIR_LENGTH - 1) / 2;
+    for (size_t n = 0; n <= center; ++n) {
+        double phase = 2.0 * M_PI * n / (FIR_LENGTH - 1);
+        double blackman = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        float tap = impulse[center - n] * static_cast<float>(blackman);
+        fir[n] = tap;
+        fir[FIR_LENGTH - 1 - n] = tap;
+    }
+    return fir;
+}
+
+void LinearPhaseEQ::reset() {
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        m_convolvers[ch].reset();
+        std::fill(m_input[ch].begin(), m_input[ch].end(), 0.0f);
+        std::fill(m_output[ch].begin(), m_output[ch].end(), 0.0f);
+    }
+    m_fill = 0;
+}
+
+void LinearPhaseEQ::process(float* samples, size_t frameCount, int sampleRate) {
+    m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            m_input[ch][m_fill] = samples[frame * CHANNELS + ch];
+            samples[frame * CHANNELS + ch] = m_output[ch][m_fill];
+        }
+        if (++m_fill < BLOCK_SIZE) continue;
+        m_fill = 0;
+
+        // Take a new kernel only once the worker has freed the last one we
+        // handed back, so nothing is ever freed here
+        Kernel* fadeFrom = nullptr;
+        if (m_retired.load(std::memory_order_acquire) == nullptr) {
+            if (Kernel* next = m_pending.exchange(nullptr, std::memory_order_acq_rel)) {
+                fadeFrom = m_current;
+                m_current = next;
+            }
+        }
+
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            if (m_current) {
+                m_convolvers[ch].processBlock(m_input[ch].data(), m_output[ch].data(), *m_current, fadeFrom);
+            } else {
+                std::fill(m_output[ch].begin(), m_output[ch].end(), 0.0f);
+            }
+        }
+
+        if (fadeFrom) {
+            m_retired.store(fadeFrom, std::memory_order_release);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "PartitionedConvolver.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Linear-phase version of the graphic EQ for mastering. The magnitude
+// response of the peaking bands is sampled on a fine grid, turned into a
+// symmetric FIR (zero phase, windowed, then delayed by half its length) and
+// run through a uniformly partitioned convolution. Every frequency is
+// delayed by the same amount, getLatencyFrames(), whatever the gains.
+//
+// Gain changes are picked up by a worker thread that designs the new FIR
+// and hands its kernel to the audio thread through an atomic pointer; the
+// audio thread crossfades to it over one block and hands the old one back
+// for the worker to free, so process() never locks or allocates.
+class LinearPhaseEQ {
+public:
+    static constexpr size_t BLOCK_SIZE = 256;     // Partition size
+    static constexpr size_t FIR_LENGTH = 16383;   // Odd, so the delay is whole samples
+    static constexpr size_t DESIGN_SIZE = 32768;  // Frequency grid for the design
+    static constexpr int CHANNELS = 2;
+
+    LinearPhaseEQ(std::vector<float> bandFrequencies, float q);
+    ~LinearPhaseEQ();
+
+    LinearPhaseEQ(const LinearPhaseEQ&) = delete;
+    LinearPhaseEQ& operator=(const LinearPhaseEQ&) = delete;
+
+    // Designs the first filter before returning, then follows changes on a worker
+    void start();
+    void stop();
+
+    // Offline use without the worker: design the current gains for
+    // sampleRate now, so process() at that rate filters from the first block
+    void prepare(int sampleRate);
+
+    // Any thread, lock-free. Gains in dB, one per band.
+    void setGains(const float* gains, size_t count);
+
+    // Audio thread: interleaved stereo, in place
+    void process(float* samples, size_t frameCount, int sampleRate);
+    // Audio thread: forget past input (e.g. when switching back to this mode)
+    void reset();
+
+    // Input block buffering plus the FIR's group delay
+    static constexpr size_t getLatencyFrames() { return BLOCK_SIZE + (FIR_LENGTH - 1) / 2; }
+
+    // FIR_LENGTH taps whose magnitude matches the peaking bands at these gains
+    static std::vector<float> designFir(const std::vector<float>& bandFrequencies, const float* gains,
+                                        float q, float sampleRate);
+
+private:
+    using Kernel = PartitionedConvolver::Kernel;
+
+    void workerLoop();
+    void rebuild();
+
+    static constexpr int WORKER_INTERVAL_MS = 20;
+
+    std::vector<float> m_bandFrequencies;
+    float m_q;
+
+    // Requested design, written by anyone
+    std::vector<std::atomic<float>> m_gains;
+    std::atomic<uint32_t> m_gainGeneration{0};
+    std::atomic<int> m_sampleRate{44100};
+
+    // Worker
+    std::thread m_worker;
+    std::atomic<bool> m_running{false};
+    uint32_t m_builtGeneration = 0;
+    int m_builtRate = 0;
+
+    // Kernel handoff: worker -> audio in m_pending, audio -> worker in m_retired
+    std::atomic<Kernel*> m_pending{nullptr};
+    std::atomic<Kernel*> m_retired{nullptr};
+
+    // Audio thread
+    Kernel* m_current = nullptr;
+    PartitionedConvolver m_convolvers[CHANNELS];
+    std::vector<float> m_input[CHANNELS];   // Block being collected
+    std::vector<float> m_output[CHANNELS];  // Block being played out
+    size_t m_fill = 0;
+};
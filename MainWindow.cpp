@@ -1,6 +1,9 @@
 #include "MainWindow.h"
 #include "Application.h"
 #include "resource.h"
+#include "StemExporter.h"
+#include "RecordingRecovery.h"
+#include "ThreadPriority.h"
 
 #include <Shlwapi.h>
 #include <commdlg.h>
@@ -15,8 +18,7 @@
 
 namespace {
 constexpr wchar_t WINDOW_CLASS_NAME[] = L"DAWMainWindow";
-constexpr UINT_PTR TIMER_PLAYBACK = 1;
-constexpr UINT PLAYBACK_TIMER_INTERVAL_MS = 33;
+constexpr UINT WM_PLAYBACK_FRAME = WM_APP + 1;  // Posted by m_framePacer once per display refresh
 constexpr int TRANSPORT_HEIGHT = 50;
 constexpr double MAX_RECORDING_SECONDS = 3600.0;
 constexpr std::array<uint32_t, 5> TRACK_COLORS = {
@@ -32,6 +34,7 @@ enum MenuID {
     ID_FILE_SAVE_AS,
     ID_FILE_CLOSE,
     ID_FILE_IMPORT_AUDIO,
+    ID_FILE_EXPORT_STEMS,
     ID_FILE_EXIT,
     ID_EDIT_UNDO,
     ID_EDIT_REDO,
@@ -43,21 +46,54 @@ enum MenuID {
     ID_TRANSPORT_STOP,
     ID_TRANSPORT_REWIND,
     ID_TRANSPORT_RECORD,
+    ID_TRANSPORT_INPUT_MONITOR,
+    ID_TRANSPORT_BUFFERS_LOW,
+    ID_TRANSPORT_BUFFERS_BALANCED,
+    ID_TRANSPORT_BUFFERS_SAFE,
+    ID_TRANSPORT_BUFFERS_ADAPTIVE,
+    ID_TRANSPORT_RENDER_AHEAD,
+    ID_TRANSPORT_LATENCY,
     ID_TRACK_ADD,
     ID_TRACK_DELETE,
+    ID_TRACK_LOAD_REVERB,
+    ID_TRACK_REMOVE_REVERB,
+    ID_TRACK_LOAD_MASTER_REVERB,
+    ID_TRACK_REMOVE_MASTER_REVERB,
     ID_VIEW_ZOOM_IN,
     ID_VIEW_ZOOM_OUT,
     ID_VIEW_ZOOM_FIT,
     ID_VIEW_FOLLOW_PLAYHEAD,
     ID_VIEW_SPECTRUM,
     ID_VIEW_MIXER,
+    ID_VIEW_AUDIO_STATS,
+    ID_VIEW_REGION_SPECTROGRAM,
+    ID_VIEW_LINEAR_PHASE_EQ,
+    ID_VIEW_ANALYZER_OCTAVE,
+    ID_VIEW_ANALYZER_THIRD_OCTAVE,
+    ID_VIEW_ANALYZER_SIXTH_OCTAVE,
     ID_HELP_ABOUT
 };
 
+namespace {
+
+// Analyzer Resolution menu item for a bands-per-octave setting
+int analyzerResolutionFor(int bandsPerOctave) {
+    switch (bandsPerOctave) {
+    case 3:
+        return ID_VIEW_ANALYZER_THIRD_OCTAVE;
+    case 6:
+        return ID_VIEW_ANALYZER_SIXTH_OCTAVE;
+    default:
+        return ID_VIEW_ANALYZER_OCTAVE;
+    }
+}
+
+} // namespace
+
 MainWindow::MainWindow() = default;
 
 MainWindow::~MainWindow() {
-    stopPlaybackTimer();
+    stopPlaybackUpdates();
 }
 
 bool MainWindow::create(const wchar_t* title, int width, int height) {
@@ -113,8 +149,11 @@ bool MainWindow::create(const wchar_t* title, int width, int height) {
     ShowWindow(m_hwnd, showCmd);
     UpdateWindow(m_hwnd);
 
-    startPlaybackTimer();
+    startPlaybackUpdates();
     updateWindowTitle();
+
+    // Offer to restore takes left behind by a crash during recording
+    recoverOrphanedTakes();
     return true;
 }
 
@@ -155,8 +194,28 @@ bool MainWindow::createNativeWindow(const wchar_t* title, int width, int height)
 }
 
 bool MainWindow::initializeAudioEngine() {
+    // Audio threads pick this up the first time they run
+    ThreadPriority::setAudioCore(m_settings.getAudioCore());
+
     m_audioEngine = std::make_unique<AudioEngine>();
-    return m_audioEngine->initialize(44100, 2);
+    m_audioEngine->setBufferConfig(m_settings.getAudioBufferConfig());
+    m_audioEngine->setAdaptiveBuffering(m_settings.getAdaptiveBuffering());
+    if (!m_audioEngine->initialize(44100, 2)) {
+        return false;
+    }
+
+    // Look-ahead blocks are sized for the negotiated channel count
+    if (m_settings.getRenderAhead()) {
+        m_audioEngine->setRenderAhead(true, static_cast<size_t>(m_settings.getRenderAheadFrames()));
+    }
+
+    // A master reverb whose file has gone away is just dropped
+    ConvolutionReverb& masterReverb = m_audioEngine->getMasterReverb();
+    masterReverb.setWetLevel(static_cast<float>(m_settings.getMasterReverbWet()));
+    if (!m_settings.getMasterReverbPath().empty()) {
+        loadReverbResponse(masterReverb, m_settings.getMasterReverbPath());
+    }
+    return true;
 }
 
 void MainWindow::createChildViews() {
@@ -174,8 +233,21 @@ void MainWindow::createChildViews() {
 
     // Create spectrum window (hidden by default)
     m_spectrumWindow = std::make_unique<SpectrumWindow>();
-    m_spectrumWindow->create(nullptr, 100, 100, 600, 400, L"SpectrumWindow");
+    m_spectrumWindow->create(nullptr, 100, 100, 600, 520, L"SpectrumWindow");
     SetWindowText(m_spectrumWindow->getHWND(), L"Spectrum Analyzer");
+    Stft::Config analysis;
+    analysis.fftSize = static_cast<size_t>(std::max(m_settings.getSpectrumFftSize(), 0));
+    analysis.hop = static_cast<size_t>(std::max(m_settings.getSpectrumHop(), 0));
+    analysis.window = static_cast<FftPlan::Window>(std::clamp(m_settings.getSpectrumWindow(), 0, 3));
+    m_spectrumWindow->setAnalysisConfig(analysis);
+    m_spectrumWindow->setLinearPhase(m_settings.getLinearPhaseEQ());
+    m_spectrumWindow->setChangeCallback([this]() {
+        // EQ moves must be heard now, not after the look-ahead plays out
+        if (m_audioEngine) {
+            m_audioEngine->invalidateRenderAhead();
+        }
+    });
+    setAnalyzerResolution(analyzerResolutionFor(m_settings.getSpectrumBands()));
 
     // Create mixer window (hidden by default) with saved position
     m_mixerWindow = std::make_unique<MixerWindow>();
@@ -191,6 +263,10 @@ void MainWindow::createChildViews() {
         if (m_timelineView) {
             m_timelineView->invalidate();
         }
+        // Mixer moves must be heard now, not after the look-ahead plays out
+        if (m_audioEngine) {
+            m_audioEngine->invalidateRenderAhead();
+        }
     });
     m_mixerWindow->setMasterPeakGetter([this]() {
         return m_audioEngine ? m_audioEngine->getMasterPeakLevel() : 0.0f;
@@ -248,17 +324,13 @@ void MainWindow::configureAudioCallbacks() {
     }
 }
 
-void MainWindow::startPlaybackTimer() {
-    if (!m_timerId) {
-        m_timerId = SetTimer(m_hwnd, TIMER_PLAYBACK, PLAYBACK_TIMER_INTERVAL_MS, nullptr);
-    }
+void MainWindow::startPlaybackUpdates() {
+    // Playhead, meters and stats move once per frame the display shows
+    m_framePacer.start(m_hwnd, WM_PLAYBACK_FRAME);
 }
 
-void MainWindow::stopPlaybackTimer() {
-    if (m_timerId) {
-        KillTimer(m_hwnd, m_timerId);
-        m_timerId = 0;
-    }
+void MainWindow::stopPlaybackUpdates() {
+    m_framePacer.stop();
 }
 
 void MainWindow::ensureAudioEngineTracks() {
@@ -335,6 +407,11 @@ void MainWindow::markProjectModified() {
         m_project->setModified(true);
         updateWindowTitle();
     }
+
+    // Edits change what is already mixed ahead
+    if (m_audioEngine) {
+        m_audioEngine->invalidateRenderAhead();
+    }
 }
 
 void MainWindow::handleTrackAdd() {
@@ -348,6 +425,7 @@ void MainWindow::handleTrackAdd() {
 
     m_project->addTrack(track);
     m_timelineView->addTrack(track);
+    ensureAudioEngineTracks();
     markProjectModified();
     m_timelineView->invalidate();
 }
@@ -376,6 +454,78 @@ void MainWindow::handleTrackDelete() {
     resetTrackNumbering();
 }
 
+bool MainWindow::chooseReverbResponse(std::wstring& filename) {
+    OPENFILENAME ofn = {};
+    wchar_t path[MAX_PATH] = {};
+
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = m_hwnd;
+    ofn.lpstrFilter = L"WAV Files (*.wav)\0*.wav\0All Files (*.*)\0*.*\0";
+    ofn.lpstrFile = path;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.lpstrTitle = L"Load Reverb Impulse Response";
+    ofn.Flags = OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST;
+
+    if (!GetOpenFileName(&ofn)) {
+        return false;
+    }
+    filename = path;
+    return true;
+}
+
+bool MainWindow::loadReverbResponse(ConvolutionReverb& reverb, const std::wstring& filename) {
+    // Responses are resampled to the rate the engine mixes at
+    AudioClip response;
+    if (!response.loadFromFile(filename)) {
+        return false;
+    }
+    uint32_t sampleRate = m_audioEngine->getSampleRate() ? m_audioEngine->getSampleRate() : 44100;
+    return reverb.setImpulseResponse(response, sampleRate, filename);
+}
+
+void MainWindow::loadTrackReverb() {
+    const int index = m_timelineView->getSelectedTrackIndex();
+    if (index < 0 || index >= static_cast<int>(m_project->getTracks().size())) {
+        MessageBox(m_hwnd, L"Please select a track for the reverb.", L"No Selection", MB_OK);
+        return;
+    }
+
+    std::wstring filename;
+    if (!chooseReverbResponse(filename)) {
+        return;
+    }
+    if (!loadReverbResponse(m_project->getTracks()[index]->getReverb(), filename)) {
+        MessageBox(m_hwnd, L"Failed to load impulse response", L"Error", MB_OK);
+        return;
+    }
+    markProjectModified();
+}
+
+void MainWindow::removeTrackReverb() {
+    const int index = m_timelineView->getSelectedTrackIndex();
+    if (index < 0 || index >= static_cast<int>(m_project->getTracks().size())) {
+        return;
+    }
+
+    ConvolutionReverb& reverb = m_project->getTracks()[index]->getReverb();
+    if (reverb.hasImpulseResponse()) {
+        reverb.clearImpulseResponse();
+        markProjectModified();
+    }
+}
+
+void MainWindow::loadMasterReverb() {
+    std::wstring filename;
+    if (!m_audioEngine || !chooseReverbResponse(filename)) {
+        return;
+    }
+    if (!loadReverbResponse(m_audioEngine->getMasterReverb(), filename)) {
+        MessageBox(m_hwnd, L"Failed to load impulse response", L"Error", MB_OK);
+        return;
+    }
+    m_audioEngine->invalidateRenderAhead();
+}
+
 bool MainWindow::shouldDeleteTrackAudio(
     const std::shared_ptr<Track>& track,
     std::vector<std::wstring>& filesToDelete) const {
@@ -497,6 +647,7 @@ void MainWindow::setupMenus() const {
     AppendMenu(fileMenu, MF_STRING, ID_FILE_CLOSE, L"&Close Project");
     AppendMenu(fileMenu, MF_SEPARATOR, 0, nullptr);
     AppendMenu(fileMenu, MF_STRING, ID_FILE_IMPORT_AUDIO, L"&Import Audio...\tCtrl+I");
+    AppendMenu(fileMenu, MF_STRING, ID_FILE_EXPORT_STEMS, L"&Export Stems...");
     AppendMenu(fileMenu, MF_SEPARATOR, 0, nullptr);
     AppendMenu(fileMenu, MF_STRING, ID_FILE_EXIT, L"E&xit\tAlt+F4");
     AppendMenu(menuBar, MF_POPUP, reinterpret_cast<UINT_PTR>(fileMenu), L"&File");
@@ -514,6 +665,12 @@ void MainWindow::setupMenus() const {
     HMENU trackMenu = CreatePopupMenu();
     AppendMenu(trackMenu, MF_STRING, ID_TRACK_ADD, L"&Add Track\tCtrl+T");
     AppendMenu(trackMenu, MF_STRING, ID_TRACK_DELETE, L"&Delete Track");
+    AppendMenu(trackMenu, MF_SEPARATOR, 0, nullptr);
+    AppendMenu(trackMenu, MF_STRING, ID_TRACK_LOAD_REVERB, L"Load &Reverb Response...");
+    AppendMenu(trackMenu, MF_STRING, ID_TRACK_REMOVE_REVERB, L"Remo&ve Reverb");
+    AppendMenu(trackMenu, MF_SEPARATOR, 0, nullptr);
+    AppendMenu(trackMenu, MF_STRING, ID_TRACK_LOAD_MASTER_REVERB, L"Load &Master Reverb Response...");
+    AppendMenu(trackMenu, MF_STRING, ID_TRACK_REMOVE_MASTER_REVERB, L"Remove Master Reve&rb");
     AppendMenu(menuBar, MF_POPUP, reinterpret_cast<UINT_PTR>(trackMenu), L"&Track");
 
     HMENU transportMenu = CreatePopupMenu();
@@ -522,6 +679,17 @@ void MainWindow::setupMenus() const {
     AppendMenu(transportMenu, MF_STRING, ID_TRANSPORT_REWIND, L"&Rewind\tHome");
     AppendMenu(transportMenu, MF_SEPARATOR, 0, nullptr);
     AppendMenu(transportMenu, MF_STRING, ID_TRANSPORT_RECORD, L"&Record\tR");
+    AppendMenu(transportMenu, MF_STRING, ID_TRANSPORT_INPUT_MONITOR, L"Input &Monitoring");
+    AppendMenu(transportMenu, MF_SEPARATOR, 0, nullptr);
+    HMENU bufferMenu = CreatePopupMenu();
+    AppendMenu(bufferMenu, MF_STRING, ID_TRANSPORT_BUFFERS_LOW, L"&Low Latency");
+    AppendMenu(bufferMenu, MF_STRING, ID_TRANSPORT_BUFFERS_BALANCED, L"&Balanced");
+    AppendMenu(bufferMenu, MF_STRING, ID_TRANSPORT_BUFFERS_SAFE, L"&Safe (Fewer Dropouts)");
+    AppendMenu(bufferMenu, MF_SEPARATOR, 0, nullptr);
+    AppendMenu(bufferMenu, MF_STRING, ID_TRANSPORT_BUFFERS_ADAPTIVE, L"&Adapt to Load");
+    AppendMenu(bufferMenu, MF_STRING, ID_TRANSPORT_RENDER_AHEAD, L"&Render Ahead");
+    AppendMenu(bufferMenu, MF_STRING, ID_TRANSPORT_LATENCY, L"Show &Latency...");
+    AppendMenu(transportMenu, MF_POPUP, reinterpret_cast<UINT_PTR>(bufferMenu), L"Audio &Buffers");
     AppendMenu(menuBar, MF_POPUP, reinterpret_cast<UINT_PTR>(transportMenu), L"T&ransport");
 
     HMENU viewMenu = CreatePopupMenu();
@@ -532,7 +700,16 @@ void MainWindow::setupMenus() const {
     AppendMenu(viewMenu, MF_STRING, ID_VIEW_FOLLOW_PLAYHEAD, L"&Follow Playhead\tF");
     AppendMenu(viewMenu, MF_SEPARATOR, 0, nullptr);
     AppendMenu(viewMenu, MF_STRING, ID_VIEW_SPECTRUM, L"Show &Spectrum");
+    AppendMenu(viewMenu, MF_STRING, ID_VIEW_LINEAR_PHASE_EQ, L"&Linear-Phase EQ");
+    HMENU analyzerMenu = CreatePopupMenu();
+    AppendMenu(analyzerMenu, MF_STRING, ID_VIEW_ANALYZER_OCTAVE, L"&Octave Bands (FFT)");
+    AppendMenu(analyzerMenu, MF_STRING, ID_VIEW_ANALYZER_THIRD_OCTAVE, L"1/&3 Octave");
+    AppendMenu(analyzerMenu, MF_STRING, ID_VIEW_ANALYZER_SIXTH_OCTAVE, L"1/&6 Octave");
+    AppendMenu(viewMenu, MF_POPUP, reinterpret_cast<UINT_PTR>(analyzerMenu), L"Analyzer &Resolution");
     AppendMenu(viewMenu, MF_STRING, ID_VIEW_MIXER, L"Show &Mixer");
+    AppendMenu(viewMenu, MF_STRING, ID_VIEW_AUDIO_STATS, L"Show Audio S&tats");
+    AppendMenu(viewMenu, MF_SEPARATOR, 0, nullptr);
+    AppendMenu(viewMenu, MF_STRING, ID_VIEW_REGION_SPECTROGRAM, L"Region Spectro&gram\tG");
     AppendMenu(menuBar, MF_POPUP, reinterpret_cast<UINT_PTR>(viewMenu), L"&View");
 
     HMENU helpMenu = CreatePopupMenu();
@@ -746,6 +923,65 @@ bool MainWindow::loadAudioFile(const std::wstring& filename) {
     return true;
 }
 
+bool MainWindow::exportStems() {
+    const double duration = calculateProjectDuration();
+    if (duration <= 0.0) {
+        MessageBox(m_hwnd, L"There is no audio to export.", L"Export Stems", MB_OK | MB_ICONINFORMATION);
+        return false;
+    }
+
+    // The chosen file receives the master mix; stems are written next to it
+    OPENFILENAME ofn = {};
+    wchar_t filename[MAX_PATH] = {};
+    wcscpy_s(filename, m_project->getProjectName().c_str());
+
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = m_hwnd;
+    ofn.lpstrFilter = L"WAV Files (*.wav)\0*.wav\0All Files (*.*)\0*.*\0";
+    ofn.lpstrFile = filename;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.Flags = OFN_OVERWRITEPROMPT | OFN_PATHMUSTEXIST;
+    ofn.lpstrDefExt = L"wav";
+    ofn.lpstrTitle = L"Export Stems (Master Mix File)";
+
+    if (!GetSaveFileName(&ofn)) {
+        return false;
+    }
+
+    std::filesystem::path masterPath(filename);
+
+    StemExporter::Options options;
+    options.directory = masterPath.parent_path().wstring();
+    options.baseName = masterPath.stem().wstring();
+    options.sampleRate = m_audioEngine ? m_audioEngine->getSampleRate() : 44100;
+    options.duration = duration;
+    options.masterVolume = m_audioEngine ? m_audioEngine->getVolume() : 1.0f;
+
+    // The master goes through its own copy of the playback bus chain
+    if (m_audioEngine) {
+        options.masterReverb = &m_audioEngine->getMasterReverb();
+    }
+    if (m_spectrumWindow) {
+        options.masterEQ = m_spectrumWindow->createOfflineEQ(static_cast<int>(options.sampleRate),
+                                                            options.masterEQLatencyFrames);
+    }
+
+    HCURSOR previousCursor = SetCursor(LoadCursor(nullptr, IDC_WAIT));
+    const auto result = StemExporter::exportStems(m_project->getTracks(), options);
+    SetCursor(previousCursor);
+
+    if (!result.success) {
+        const std::wstring message = L"Failed to export stems:\n" + result.error;
+        MessageBox(m_hwnd, message.c_str(), L"Export Stems", MB_OK | MB_ICONERROR);
+        return false;
+    }
+
+    const std::wstring message = L"Exported " + std::to_wstring(result.files.size()) +
+        L" files to:\n" + options.directory;
+    MessageBox(m_hwnd, message.c_str(), L"Export Stems", MB_OK | MB_ICONINFORMATION);
+    return true;
+}
+
 void MainWindow::play() {
     ensureAudioEngineTracks();
     refreshProjectDuration();
@@ -904,6 +1140,220 @@ void MainWindow::toggleFollowPlayhead() {
     updateFollowPlayheadMenu();
 }
 
+void MainWindow::toggleInputMonitoring() {
+    if (!m_audioEngine) {
+        return;
+    }
+
+    // Uses the low-latency direct monitor path when the device allows it
+    bool newState = !m_audioEngine->getInputMonitoring();
+    m_audioEngine->setInputMonitoring(newState);
+
+    HMENU menuBar = GetMenu(m_hwnd);
+    if (menuBar) {
+        CheckMenuItem(menuBar, ID_TRANSPORT_INPUT_MONITOR,
+            MF_BYCOMMAND | (newState ? MF_CHECKED : MF_UNCHECKED));
+    }
+}
+
+namespace {
+
+// Buffer presets offered in the Transport menu
+AudioBufferConfig bufferPresetFor(int menuId) {
+    AudioBufferConfig config;  // Balanced: the defaults
+    if (menuId == ID_TRANSPORT_BUFFERS_LOW) {
+        config.playbackBuffers = 3;
+        config.playbackBufferFrames = 512;
+        config.recordBuffers = 4;
+        config.recordBufferFrames = 512;
+    }
+    else if (menuId == ID_TRANSPORT_BUFFERS_SAFE) {
+        config.playbackBuffers = 4;
+        config.playbackBufferFrames = 4096;
+        config.recordBuffers = 6;
+        config.recordBufferFrames = 4096;
+    }
+    return config;
+}
+
+} // namespace
+
+void MainWindow::setBufferPreset(int menuId) {
+    if (!m_audioEngine) {
+        return;
+    }
+
+    if (!m_audioEngine->setBufferConfig(bufferPresetFor(menuId))) {
+        MessageBox(m_hwnd, L"Buffer sizes cannot be changed while recording.",
+                   L"Audio Buffers", MB_OK | MB_ICONWARNING);
+        return;
+    }
+
+    // Playback was stopped to rebuild the device buffers
+    if (m_transportBar) {
+        m_transportBar->setPlaying(false);
+    }
+    m_settings.setAudioBufferConfig(m_audioEngine->getBufferConfig());
+    updateBufferMenu();
+}
+
+void MainWindow::toggleAdaptiveBuffering() {
+    if (!m_audioEngine) {
+        return;
+    }
+
+    if (!m_audioEngine->setAdaptiveBuffering(!m_audioEngine->getAdaptiveBuffering())) {
+        MessageBox(m_hwnd, L"Buffer sizes cannot be changed while recording.",
+                   L"Audio Buffers", MB_OK | MB_ICONWARNING);
+        return;
+    }
+
+    if (m_transportBar) {
+        m_transportBar->setPlaying(false);
+    }
+    m_settings.setAdaptiveBuffering(m_audioEngine->getAdaptiveBuffering());
+    updateBufferMenu();
+}
+
+void MainWindow::toggleRenderAhead() {
+    if (!m_audioEngine) {
+        return;
+    }
+
+    bool enabled = !m_audioEngine->getRenderAhead();
+    size_t lookAhead = static_cast<size_t>(m_settings.getRenderAheadFrames());
+    if (!m_audioEngine->setRenderAhead(enabled, lookAhead)) {
+        MessageBox(m_hwnd, L"Render ahead cannot be changed while recording.",
+                   L"Audio Buffers", MB_OK | MB_ICONWARNING);
+        return;
+    }
+
+    if (m_transportBar) {
+        m_transportBar->setPlaying(false);
+    }
+    m_settings.setRenderAhead(enabled);
+    updateBufferMenu();
+}
+
+void MainWindow::updateBufferMenu() {
+    HMENU menuBar = GetMenu(m_hwnd);
+    if (!menuBar || !m_audioEngine) {
+        return;
+    }
+
+    // A hand-edited configuration matches no preset and leaves all unchecked
+    const AudioBufferConfig& current = m_audioEngine->getBufferConfig();
+    for (int id : {ID_TRANSPORT_BUFFERS_LOW, ID_TRANSPORT_BUFFERS_BALANCED, ID_TRANSPORT_BUFFERS_SAFE}) {
+        CheckMenuItem(menuBar, id,
+            MF_BYCOMMAND | (bufferPresetFor(id) == current ? MF_CHECKED : MF_UNCHECKED));
+    }
+    CheckMenuItem(menuBar, ID_TRANSPORT_BUFFERS_ADAPTIVE,
+        MF_BYCOMMAND | (m_audioEngine->getAdaptiveBuffering() ? MF_CHECKED : MF_UNCHECKED));
+    CheckMenuItem(menuBar, ID_TRANSPORT_RENDER_AHEAD,
+        MF_BYCOMMAND | (m_audioEngine->getRenderAhead() ? MF_CHECKED : MF_UNCHECKED));
+}
+
+void MainWindow::showLatencyReport() const {
+    if (!m_audioEngine) {
+        return;
+    }
+
+    AudioBufferConfig config = m_audioEngine->getActiveBufferConfig();
+    AudioLatency latency = m_audioEngine->getLatency();
+
+    wchar_t message[640];
+    int length = swprintf_s(message,
+        L"Playback: %d buffers x %d frames%s\n"
+        L"Recording: %d buffers x %d frames\n\n"
+        L"Input latency: %u frames (%.1f ms)\n"
+        L"Output latency: %u frames (%.1f ms)\n"
+        L"Round trip (monitoring through the mix): %u frames (%.1f ms)",
+        config.playbackBuffers, config.playbackBufferFrames,
+        m_audioEngine->getAdaptiveBuffering() ? L" (adapting to load)" : L"",
+        config.recordBuffers, config.recordBufferFrames,
+        latency.inputFrames, latency.inputMs,
+        latency.outputFrames, latency.outputMs,
+        latency.roundTripFrames, latency.roundTripMs);
+
+    // The linear-phase EQ delays everything on the master bus
+    size_t eqFrames = m_spectrumWindow ? m_spectrumWindow->getEQLatencyFrames() : 0;
+    if (eqFrames > 0 && length > 0) {
+        uint32_t sampleRate = m_audioEngine->getSampleRate() ? m_audioEngine->getSampleRate() : 44100;
+        swprintf_s(message + length, _countof(message) - length,
+            L"\n\nLinear-phase EQ: %zu frames (%.1f ms)",
+            eqFrames, eqFrames * 1000.0 / sampleRate);
+    }
+    MessageBox(m_hwnd, message, L"Audio Latency", MB_OK | MB_ICONINFORMATION);
+}
+
+void MainWindow::toggleStatsOverlay() {
+    if (!m_timelineView || !m_audioEngine) {
+        return;
+    }
+
+    // Start each viewing with fresh counters
+    bool visible = !m_timelineView->getStatsOverlayVisible();
+    if (visible) {
+        m_audioEngine->resetStats();
+        m_timelineView->setAudioStats(m_audioEngine->getStats());
+    }
+    m_timelineView->setStatsOverlayVisible(visible);
+
+    HMENU menuBar = GetMenu(m_hwnd);
+    if (menuBar) {
+        CheckMenuItem(menuBar, ID_VIEW_AUDIO_STATS,
+            MF_BYCOMMAND | (visible ? MF_CHECKED : MF_UNCHECKED));
+    }
+}
+
+void MainWindow::toggleLinearPhaseEQ() {
+    if (!m_spectrumWindow) {
+        return;
+    }
+
+    m_spectrumWindow->setLinearPhase(!m_spectrumWindow->isLinearPhase());
+    updateLinearPhaseMenu();
+    updateAnalyzerMenu();
+}
+
+void MainWindow::updateLinearPhaseMenu() {
+    HMENU menuBar = GetMenu(m_hwnd);
+    if (!menuBar || !m_spectrumWindow) {
+        return;
+    }
+
+    CheckMenuItem(menuBar, ID_VIEW_LINEAR_PHASE_EQ,
+        MF_BYCOMMAND | (m_spectrumWindow->isLinearPhase() ? MF_CHECKED : MF_UNCHECKED));
+}
+
+void MainWindow::setAnalyzerResolution(int menuId) {
+    if (!m_spectrumWindow) {
+        return;
+    }
+
+    SpectrumAnalyzer::BandSource source = SpectrumAnalyzer::BandSource::Fft;
+    if (menuId == ID_VIEW_ANALYZER_THIRD_OCTAVE) {
+        source = SpectrumAnalyzer::BandSource::ThirdOctave;
+    }
+    else if (menuId == ID_VIEW_ANALYZER_SIXTH_OCTAVE) {
+        source = SpectrumAnalyzer::BandSource::SixthOctave;
+    }
+    m_spectrumWindow->setBandSource(source);
+    updateAnalyzerMenu();
+}
+
+void MainWindow::updateAnalyzerMenu() {
+    HMENU menuBar = GetMenu(m_hwnd);
+    if (!menuBar || !m_spectrumWindow) {
+        return;
+    }
+
+    int current = analyzerResolutionFor(static_cast<int>(m_spectrumWindow->getBandSource()));
+    for (int id : {ID_VIEW_ANALYZER_OCTAVE, ID_VIEW_ANALYZER_THIRD_OCTAVE, ID_VIEW_ANALYZER_SIXTH_OCTAVE}) {
+        CheckMenuItem(menuBar, id, MF_BYCOMMAND | (id == current ? MF_CHECKED : MF_UNCHECKED));
+    }
+}
+
 void MainWindow::updateFollowPlayheadMenu() {
     if (!m_hwnd || !m_timelineView) {
         return;
@@ -949,7 +1399,7 @@ bool MainWindow::autoSaveRecordedClip(std::shared_ptr<AudioClip> clip) {
         std::to_wstring(m_recordingTrackIndex) + L"_Take" +
         std::to_wstring(recordingNum) + L".wav";
 
-    if (!clip->saveToFile(filename)) {
+    if (!RecordingRecovery::adoptTake(*clip, m_audioEngine->getRecordedFilename(), filename)) {
         MessageBox(m_hwnd, L"Failed to auto-save recording", L"Error", MB_OK | MB_ICONERROR);
         m_recordingTrack = nullptr;
         m_recordingTrackIndex = -1;
@@ -963,19 +1413,19 @@ bool MainWindow::autoSaveRecordedClip(std::shared_ptr<AudioClip> clip) {
     }
 
     if (targetTrack) {
-        auto loadedClip = m_project->getOrLoadClip(filename);
-        if (loadedClip) {
-            TrackRegion region;
-            region.clip = loadedClip;
-            region.startTime = m_recordingStartPosition;
-            region.clipOffset = 0.0;
-            region.duration = loadedClip->getDuration();
+        // The clip already holds the samples; register it instead of reloading
+        m_project->addClipToCache(filename, clip);
 
-            targetTrack->addRegion(region);
-            refreshProjectDuration();
-            markProjectModified();
-            m_timelineView->invalidate();
-        }
+        TrackRegion region;
+        region.clip = clip;
+        region.startTime = m_recordingStartPosition;
+        region.clipOffset = 0.0;
+        region.duration = clip->getDuration();
+
+        targetTrack->addRegion(region);
+        refreshProjectDuration();
+        markProjectModified();
+        m_timelineView->invalidate();
     }
 
     m_recordingTrack = nullptr;
@@ -984,6 +1434,66 @@ bool MainWindow::autoSaveRecordedClip(std::shared_ptr<AudioClip> clip) {
     return true;
 }
 
+void MainWindow::recoverOrphanedTakes() {
+    auto orphans = RecordingRecovery::findOrphanedTakes(RecordingRecovery::getJournalDirectory());
+    if (orphans.empty()) {
+        return;
+    }
+
+    std::wstring message = std::to_wstring(orphans.size()) +
+        L" unfinished recording(s) were found from a previous session that did not close normally.\n\n"
+        L"Yes - recover them onto new tracks\n"
+        L"No - discard them\n"
+        L"Cancel - decide next time";
+    int choice = MessageBox(m_hwnd, message.c_str(), L"Recover Recordings", MB_YESNOCANCEL | MB_ICONQUESTION);
+
+    if (choice == IDNO) {
+        for (const auto& take : orphans) {
+            DeleteFile(take.c_str());
+        }
+        return;
+    }
+    if (choice != IDYES) {
+        return;
+    }
+
+    int recovered = 0;
+    for (const auto& take : orphans) {
+        std::wstring filename = RecordingRecovery::recoverTake(take);
+        if (filename.empty()) {
+            continue;
+        }
+
+        auto clip = m_project->getOrLoadClip(filename);
+        if (!clip) {
+            continue;
+        }
+
+        // Each take gets its own track so nothing overlaps existing audio
+        handleTrackAdd();
+        auto track = m_project->getTracks().back();
+        track->setName(L"Recovered " + std::to_wstring(++recovered));
+
+        TrackRegion region;
+        region.clip = clip;
+        region.startTime = 0.0;
+        region.clipOffset = 0.0;
+        region.duration = clip->getDuration();
+        track->addRegion(region);
+    }
+
+    if (recovered > 0) {
+        refreshProjectDuration();
+        markProjectModified();
+        m_timelineView->invalidate();
+    }
+
+    if (recovered < static_cast<int>(orphans.size())) {
+        MessageBox(m_hwnd, L"Some recordings could not be recovered.", L"Recover Recordings",
+                   MB_OK | MB_ICONWARNING);
+    }
+}
+
 bool MainWindow::saveRecordedClip(std::shared_ptr<AudioClip> clip) {
     ++m_recordingCount;
     std::wstring projectName = m_project->getProjectName();
@@ -1042,8 +1552,20 @@ bool MainWindow::saveRecordedClip(std::shared_ptr<AudioClip> clip) {
 }
 
 void MainWindow::updatePlaybackPosition() {
-    if (m_audioEngine->isPlaying()) {
-        const double pos = m_audioEngine->getPosition();
+    if (m_audioEngine->isPlaying() && m_audioEngine->getSampleRate() > 0) {
+        // Exact audible position for this frame, not the last buffer boundary.
+        // What is heard lags the device queue by the system mixer and by the
+        // master EQ's delay (linear phase).
+        const uint32_t sampleRate = m_audioEngine->getSampleRate();
+        double outputLatency = m_audioEngine->getPostQueueLatency();
+        if (m_spectrumWindow) {
+            outputLatency += static_cast<double>(m_spectrumWindow->getEQLatencyFrames()) / sampleRate;
+        }
+        m_playheadInterpolator.setOutputLatency(outputLatency);
+        m_playheadInterpolator.setMaxExtrapolation(m_audioEngine->getPlayheadMaxExtrapolation());
+        const double frame = m_playheadInterpolator.frameAt(m_audioEngine->getPlayhead(),
+                                                            PlayheadClock::Clock::now());
+        const double pos = frame / sampleRate;
         m_transportBar->setPosition(pos);
         m_timelineView->setPlayheadPosition(pos);
 
@@ -1058,6 +1580,10 @@ void MainWindow::updatePlaybackPosition() {
         m_transportBar->setPosition(recordDuration);
         m_timelineView->setPlayheadPosition(recordDuration);
     }
+
+    if (m_timelineView->getStatsOverlayVisible()) {
+        m_timelineView->setAudioStats(m_audioEngine->getStats());
+    }
 }
 
 void MainWindow::onResize(int width, int height) {
@@ -1096,6 +1622,9 @@ void MainWindow::onCommand(int id) {
     case ID_FILE_IMPORT_AUDIO:
         importAudioFile();
         break;
+    case ID_FILE_EXPORT_STEMS:
+        exportStems();
+        break;
     case ID_FILE_EXIT:
         onClose();
         break;
@@ -1111,12 +1640,44 @@ void MainWindow::onCommand(int id) {
     case ID_TRANSPORT_RECORD:
         toggleRecording();
         break;
+    case ID_TRANSPORT_INPUT_MONITOR:
+        toggleInputMonitoring();
+        break;
+    case ID_TRANSPORT_BUFFERS_LOW:
+    case ID_TRANSPORT_BUFFERS_BALANCED:
+    case ID_TRANSPORT_BUFFERS_SAFE:
+        setBufferPreset(id);
+        break;
+    case ID_TRANSPORT_BUFFERS_ADAPTIVE:
+        toggleAdaptiveBuffering();
+        break;
+    case ID_TRANSPORT_RENDER_AHEAD:
+        toggleRenderAhead();
+        break;
+    case ID_TRANSPORT_LATENCY:
+        showLatencyReport();
+        break;
     case ID_TRACK_ADD:
         handleTrackAdd();
         break;
     case ID_TRACK_DELETE:
         handleTrackDelete();
         break;
+    case ID_TRACK_LOAD_REVERB:
+        loadTrackReverb();
+        break;
+    case ID_TRACK_REMOVE_REVERB:
+        removeTrackReverb();
+        break;
+    case ID_TRACK_LOAD_MASTER_REVERB:
+        loadMasterReverb();
+        break;
+    case ID_TRACK_REMOVE_MASTER_REVERB:
+        if (m_audioEngine) {
+            m_audioEngine->getMasterReverb().clearImpulseResponse();
+            m_audioEngine->invalidateRenderAhead();
+        }
+        break;
     case ID_VIEW_ZOOM_IN:
         m_timelineView->setPixelsPerSecond(m_timelineView->getPixelsPerSecond() * 1.5);
         break;
@@ -1139,6 +1700,20 @@ void MainWindow::onCommand(int id) {
             m_mixerWindow->invalidate();
         }
         break;
+    case ID_VIEW_AUDIO_STATS:
+        toggleStatsOverlay();
+        break;
+    case ID_VIEW_REGION_SPECTROGRAM:
+        m_timelineView->toggleSelectedRegionSpectrogram();
+        break;
+    case ID_VIEW_LINEAR_PHASE_EQ:
+        toggleLinearPhaseEQ();
+        break;
+    case ID_VIEW_ANALYZER_OCTAVE:
+    case ID_VIEW_ANALYZER_THIRD_OCTAVE:
+    case ID_VIEW_ANALYZER_SIXTH_OCTAVE:
+        setAnalyzerResolution(id);
+        break;
     case ID_HELP_ABOUT:
         showAboutDialog();
         break;
@@ -1197,6 +1772,8 @@ void MainWindow::loadSettings() {
 
     // Update menu checkmark for follow playhead
     updateFollowPlayheadMenu();
+    updateBufferMenu();
+    updateLinearPhaseMenu();
 }
 
 void MainWindow::saveSettings() {
@@ -1217,6 +1794,24 @@ void MainWindow::saveSettings() {
         m_settings.setBPM(120.0);  // BPM is currently hardcoded, update when it becomes dynamic
     }
 
+    // Save audio buffer layout
+    if (m_audioEngine) {
+        m_settings.setAudioBufferConfig(m_audioEngine->getBufferConfig());
+        m_settings.setAdaptiveBuffering(m_audioEngine->getAdaptiveBuffering());
+        m_settings.setRenderAhead(m_audioEngine->getRenderAhead());
+    }
+
+    if (m_spectrumWindow) {
+        m_settings.setLinearPhaseEQ(m_spectrumWindow->isLinearPhase());
+        m_settings.setSpectrumBands(static_cast<int>(m_spectrumWindow->getBandSource()));
+    }
+
+    if (m_audioEngine) {
+        const ConvolutionReverb& masterReverb = m_audioEngine->getMasterReverb();
+        m_settings.setMasterReverbPath(masterReverb.getImpulseResponsePath());
+        m_settings.setMasterReverbWet(masterReverb.getWetLevel());
+    }
+
     // Save last project path if a project is loaded
     if (m_project && m_project->hasFilename()) {
         m_settings.setLastProjectPath(m_project->getFilename());
@@ -1284,10 +1879,9 @@ LRESULT CALLBACK MainWindow::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM
         case WM_DROPFILES:
             window->onDropFiles(reinterpret_cast<HDROP>(wParam));
             return 0;
-        case WM_TIMER:
-            if (wParam == TIMER_PLAYBACK) {
-                window->updatePlaybackPosition();
-            }
+        case WM_PLAYBACK_FRAME:
+            window->m_framePacer.frameHandled();
+            window->updatePlaybackPosition();
             return 0;
         case WM_KEYDOWN:
             switch (wParam) {
@@ -1340,6 +1934,11 @@ LRESULT CALLBACK MainWindow::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM
             case 'F':
                 window->toggleFollowPlayhead();
                 return 0;
+            case 'G':
+                if (window->m_timelineView) {
+                    window->m_timelineView->toggleSelectedRegionSpectrogram();
+                }
+                return 0;
             default:
                 break;
             }
@@ -7,6 +7,7 @@
 #include "SpectrumWindow.h"
 #include "MixerWindow.h"
 #include "Settings.h"
+#include "FramePacer.h"
 #include <memory>
 #include <filesystem>
 #include <string>
@@ -30,6 +31,7 @@ public:
     // File operations
     bool importAudioFile();
     bool loadAudioFile(const std::wstring& filename);
+    bool exportStems();
     
     // Playback
     void play();
@@ -57,6 +59,7 @@ private:
     void onRecordingComplete(std::shared_ptr<AudioClip> clip);
     bool saveRecordedClip(std::shared_ptr<AudioClip> clip);
     bool autoSaveRecordedClip(std::shared_ptr<AudioClip> clip);
+    void recoverOrphanedTakes();
 
     bool registerWindowClass() const;
     bool createNativeWindow(const wchar_t* title, int width, int height);
@@ -65,8 +68,8 @@ private:
     void configureTimelineCallbacks();
     void configureTransportCallbacks();
     void configureAudioCallbacks();
-    void startPlaybackTimer();
-    void stopPlaybackTimer();
+    void startPlaybackUpdates();
+    void stopPlaybackUpdates();
     void ensureAudioEngineTracks();
     double calculateProjectDuration() const;
     void applyProjectDuration(double duration);
@@ -80,7 +83,23 @@ private:
     bool shouldDeleteTrackAudio(const std::shared_ptr<Track>& track,
         std::vector<std::wstring>& filesToDelete) const;
     void deleteAudioFiles(const std::vector<std::wstring>& filesToDelete);
+    bool chooseReverbResponse(std::wstring& filename);
+    bool loadReverbResponse(ConvolutionReverb& reverb, const std::wstring& filename);
+    void loadTrackReverb();
+    void removeTrackReverb();
+    void loadMasterReverb();
     void toggleFollowPlayhead();
+    void toggleInputMonitoring();
+    void setBufferPreset(int menuId);
+    void toggleAdaptiveBuffering();
+    void toggleRenderAhead();
+    void updateBufferMenu();
+    void showLatencyReport() const;
+    void toggleStatsOverlay();
+    void toggleLinearPhaseEQ();
+    void updateLinearPhaseMenu();
+    void setAnalyzerResolution(int menuId);
+    void updateAnalyzerMenu();
     void updateFollowPlayheadMenu();
     void loadSettings();
     void saveSettings();
@@ -90,7 +109,8 @@ private:
 	void showAboutDialog() const;
 
     HWND m_hwnd = nullptr;
-    UINT_PTR m_timerId = 0;
+    FramePacer m_framePacer;  // Drives updatePlaybackPosition() once per display refresh
+    PlayheadInterpolator m_playheadInterpolator;  // Smooths the engine playhead for drawing
     Settings m_settings;
     
     std::unique_ptr<TransportBar> m_transportBar;
@@ -0,0 +1,126 @@
+#include "PartitionedConvolver.h"
+#include "Simd.h"
+#include <algorithm>
+
+std::unique_ptr<PartitionedConvolver::Kernel> PartitionedConvolver::makeKernel(const float* ir, size_t length,
+                                                                               size_t blockSize) {
+    const FftPlan* plan = FftPlan::get(blockSize * 2);
+    if (!plan || length == 0) {
+        return nullptr;
+    }
+
+    auto kernel = std::make_unique<Kernel>();
+    kernel->blockSize = blockSize;
+    kernel->partitionCount = (length + blockSize - 1) / blockSize;
+    size_t bins = plan->getBinCount();
+    kernel->re.resize(kernel->partitionCount * bins);
+    kernel->im.resize(kernel->partitionCount * bins);
+
+    // Each partition zero-padded to the FFT size, so the second half of the
+    // circular result is the linear convolution
+    std::vector<float> padded(plan->getSize());
+    std::vector<float> workspace(plan->getWorkspaceSize());
+    for (size_t p = 0; p < kernel->partitionCount; ++p) {
+        size_t offset = p * blockSize;
+        size_t count = std::min(blockSize, length - offset);
+        std::fill(padded.begin(), padded.end(), 0.0f);
+        std::copy(ir + offset, ir + offset + count, padded.begin());
+        plan->forward(padded.data(), &kernel->re[p * bins], &kernel->im[p * bins], workspace.data());
+    }
+    return kernel;
+}
+
+bool PartitionedConvolver::configure(size_t blockSize, size_t maxPartitions) {
+    const FftPlan* plan = FftPlan::get(blockSize * 2);
+    if (!plan || maxPartitions == 0) {
+        return false;
+    }
+
+    m_plan = plan;
+    m_blockSize = blockSize;
+    m_bins = plan->getBinCount();
+    m_maxPartitions = maxPartitions;
+
+    m_window.assign(plan->getSize(), 0.0f);
+    m_spectraRe.assign(maxPartitions * m_bins, 0.0f);
+    m_spectraIm.assign(maxPartitions * m_bins, 0.0f);
+    m_accRe.assign(m_bins, 0.0f);
+    m_accIm.assign(m_bins, 0.0f);
+    m_time.assign(plan->getSize(), 0.0f);
+    m_fadeTime.assign(plan->getSize(), 0.0f);
+    m_workspace.assign(plan->getWorkspaceSize(), 0.0f);
+    m_head = 0;
+    return true;
+}
+
+void PartitionedConvolver::reset() {
+    std::fill(m_window.begin(), m_window.end(), 0.0f);
+    std::fill(m_spectraRe.begin(), m_spectraRe.end(), 0.0f);
+    std::fill(m_spectraIm.begin(), m_spectraIm.end(), 0.0f);
+    m_head = 0;
+}
+
+void PartitionedConvolver::accumulate(const Kernel& kernel) {
+    std::fill(m_accRe.begin(), m_accRe.end(), 0.0f);
+    std::fill(m_accIm.begin(), m_accIm.end(), 0.0f);
+
+    size_t partitions = std::min(kernel.partitionCount, m_maxPartitions);
+    float* accRe = m_accRe.data();
+    float* accIm = m_accIm.data();
+    for (size_t p = 0; p < partitions; ++p) {
+        // Partition p meets the input from p blocks ago
+        size_t slot = (m_head + m_maxPartitions - p) % m_maxPartitions;
+        const float* xRe = &m_spectraRe[slot * m_bins];
+        const float* xIm = &m_spectraIm[slot * m_bins];
+        const float* hRe = &kernel.re[p * m_bins];
+        const float* hIm = &kernel.im[p * m_bins];
+
+        size_t bin = 0;
+#ifdef WAVPLAYER_USE_SSE2
+        for (; bin + 4 <= m_bins; bin += 4) {
+            __m128 ar = _mm_loadu_ps(xRe + bin), ai = _mm_loadu_ps(xIm + bin);
+            __m128 br = _mm_loadu_ps(hRe + bin), bi = _mm_loadu_ps(hIm + bin);
+            __m128 re = _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi));
+            __m128 im = _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br));
+            _mm_storeu_ps(accRe + bin, _mm_add_ps(_mm_loadu_ps(accRe + bin), re));
+            _mm_storeu_ps(accIm + bin, _mm_add_ps(_mm_loadu_ps(accIm + bin), im));
+        }
+#endif
+        for (; bin < m_bins; ++bin) {
+            accRe[bin] += xRe[bin] * hRe[bin] - xIm[bin] * hIm[bin];
+            accIm[bin] += xRe[bin] * hIm[bin] + xIm[bin] * hRe[bin];
+        }
+    }
+}
+
+void PartitionedConvolver::processBlock(const float* input, float* output, const Kernel& kernel,
+                                        const Kernel* fadeFrom) {
+    if (!m_plan) {
+        return;
+    }
+
+    // Slide the window by one block and transform it into the delay line
+    std::copy(m_window.begin() + m_blockSize, m_window.end(), m_window.begin());
+    std::copy(input, input + m_blockSize, m_window.begin() + m_blockSize);
+    m_head = (m_head + 1) % m_maxPartitions;
+    m_plan->forward(m_window.data(), &m_spectraRe[m_head * m_bins], &m_spectraIm[m_head * m_bins],
+                    m_workspace.data());
+
+    // The first half of the inverse is circular wrap-around; keep the second
+    accumulate(kernel);
+    m_plan->inverse(m_accRe.data(), m_accIm.data(), m_time.data(), m_workspace.data());
+    const float* wet = m_time.data() + m_blockSize;
+
+    if (fadeFrom) {
+        accumulate(*fadeFrom);
+        m_plan->inverse(m_accRe.data(), m_accIm.data(), m_fadeTime.data(), m_workspace.data());
+        const float* old = m_fadeTime.data() + m_blockSize;
+        float step = 1.0f / static_cast<float>(m_blockSize);
+        for (size_t i = 0; i < m_blockSize; ++i) {
+            float t = (i + 1) * step;
+            output[i] = old[i] + (wet[i] - old[i]) * t;
+        }
+    } else {
+        std::copy(wet, wet + m_blockSize, output);
+    }
+}
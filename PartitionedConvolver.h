@@ -0,0 +1,59 @@
+#pragma once
+#include "FftPlan.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Uniformly partitioned overlap-save convolution of one channel. The impulse
+// response is cut into partitions of blockSize samples and each is kept as
+// the spectrum of a 2 * blockSize FFT. Each input block is transformed once
+// into a frequency-domain delay line; the output block is the inverse FFT of
+// the sum over partitions of (delayed input spectrum x partition spectrum).
+// Per block that is one forward and one inverse FFT whatever the IR length,
+// plus a complex multiply-add per partition and bin.
+class PartitionedConvolver {
+public:
+    // Partition spectra of one impulse response. Immutable once built, so one
+    // kernel can be shared by several channels and convolvers.
+    struct Kernel {
+        size_t blockSize = 0;
+        size_t partitionCount = 0;
+        std::vector<float> re;  // partitionCount x (blockSize + 1) bins
+        std::vector<float> im;
+    };
+
+    // Not for the audio thread (allocates). nullptr if 2 * blockSize isn't a
+    // supported FFT size.
+    static std::unique_ptr<Kernel> makeKernel(const float* ir, size_t length, size_t blockSize);
+
+    // Allocates the delay line for kernels of up to maxPartitions partitions
+    bool configure(size_t blockSize, size_t maxPartitions);
+    size_t getBlockSize() const { return m_blockSize; }
+    void reset();
+
+    // One block of blockSize samples; output may alias input. With fadeFrom,
+    // the block crossfades linearly from fadeFrom's output to kernel's, so a
+    // new kernel comes in without a click. Kernel partitions beyond
+    // maxPartitions are ignored.
+    void processBlock(const float* input, float* output, const Kernel& kernel,
+                      const Kernel* fadeFrom = nullptr);
+
+private:
+    // Sum of delayed input spectra times the kernel's partitions into m_accRe/Im
+    void accumulate(const Kernel& kernel);
+
+    const FftPlan* m_plan = nullptr;
+    size_t m_blockSize = 0;
+    size_t m_bins = 0;
+    size_t m_maxPartitions = 0;
+
+    std::vector<float> m_window;      // Last two input blocks
+    std::vector<float> m_spectraRe;   // Delay line: maxPartitions x bins, newest at m_head
+    std::vector<float> m_spectraIm;
+    size_t m_head = 0;
+    std::vector<float> m_accRe;
+    std::vector<float> m_accIm;
+    std::vector<float> m_time;        // Inverse FFT output
+    std::vector<float> m_fadeTime;
+    std::vector<float> m_workspace;
+};
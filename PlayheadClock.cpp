@@ -0,0 +1,74 @@
+#include "PlayheadClock.h"
+#include <algorithm>
+
+void PlayheadClock::publish(int64_t frame, Clock::time_point time, double rate, bool discontinuity) {
+    // Claim the write by moving the sequence from even to odd
+    uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+    for (;;) {
+        if ((sequence & 1) == 0 &&
+            m_sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+            break;
+        }
+        sequence = m_sequence.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_frame.store(frame, std::memory_order_relaxed);
+    m_time.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+    m_rate.store(rate, std::memory_order_relaxed);
+    if (discontinuity) {
+        m_epoch.store(m_epoch.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+PlayheadClock::Snapshot PlayheadClock::read() const {
+    Snapshot snapshot;
+    for (;;) {
+        uint32_t before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;  // Writer mid-update
+        }
+
+        snapshot.frame = m_frame.load(std::memory_order_relaxed);
+        snapshot.time = Clock::time_point(Clock::duration(m_time.load(std::memory_order_relaxed)));
+        snapshot.rate = m_rate.load(std::memory_order_relaxed);
+        snapshot.epoch = m_epoch.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == before) {
+            return snapshot;
+        }
+    }
+}
+
+double PlayheadClock::frameAt(const Snapshot& snapshot, Clock::time_point time, double maxExtrapolationFrames) {
+    double elapsed = std::chrono::duration<double>(time - snapshot.time).count();
+    // Times before the snapshot extrapolate backwards (a reader that sampled
+    // its clock just before the device published)
+    double advance = std::min(elapsed * snapshot.rate, maxExtrapolationFrames);
+    return static_cast<double>(snapshot.frame) + advance;
+}
+
+double PlayheadInterpolator::frameAt(const PlayheadClock::Snapshot& snapshot, PlayheadClock::Clock::time_point time) {
+    auto heardAt = time - std::chrono::duration_cast<PlayheadClock::Clock::duration>(
+                              std::chrono::duration<double>(m_outputLatency));
+    double frame = std::max(PlayheadClock::frameAt(snapshot, heardAt, m_maxExtrapolation), 0.0);
+
+    if (m_hasLast && snapshot.epoch == m_lastEpoch && snapshot.rate > 0.0) {
+        frame = std::max(frame, m_lastFrame);
+    }
+
+    m_lastFrame = frame;
+    m_lastEpoch = snapshot.epoch;
+    m_hasLast = true;
+    return frame;
+}
+
+void PlayheadInterpolator::reset() {
+    m_lastFrame = 0.0;
+    m_lastEpoch = 0;
+    m_hasLast = false;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Publishes the audible playhead from the audio thread to the UI. The device
+// callback stores the frame that started playing and when it started, via a
+// seqlock so readers never block the writer and never see a torn pair. The
+// UI then extrapolates at the sample rate to get the exact frame for any
+// draw time, instead of stepping by a whole buffer per callback.
+//
+// publish() may be called from any thread (writers are serialized by the
+// sequence counter); read() is wait-free for the writer and retries on the reader.
+class PlayheadClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Snapshot {
+        int64_t frame = 0;         // Audible at `time`
+        Clock::time_point time;
+        double rate = 0.0;         // Frames per second; 0 while stopped or paused
+        uint32_t epoch = 0;        // Bumped on seeks and stops (jumps allowed)
+    };
+
+    // discontinuity marks a jump the interpolator should follow immediately
+    void publish(int64_t frame, Clock::time_point time, double rate, bool discontinuity);
+    Snapshot read() const;
+
+    // Extrapolated frame at `time`, held at the snapshot while stopped and
+    // never more than maxExtrapolationFrames ahead of it (e.g. when the device stalls)
+    static double frameAt(const Snapshot& snapshot, Clock::time_point time, double maxExtrapolationFrames);
+
+private:
+    std::atomic<uint32_t> m_sequence{0};  // Odd while a write is in progress
+    std::atomic<int64_t> m_frame{0};
+    std::atomic<int64_t> m_time{0};       // Clock ticks since epoch
+    std::atomic<double> m_rate{0.0};
+    std::atomic<uint32_t> m_epoch{0};
+};
+
+// UI-side smoothing on top of PlayheadClock::frameAt(). Each device callback
+// corrects the extrapolation slightly, which would make the playhead jitter
+// back by a few frames; within one epoch the interpolator never moves backwards
+// and instead lets the clock catch up. Output latency after the device queue
+// (e.g. the system mixer) is subtracted so the result is what's heard.
+class PlayheadInterpolator {
+public:
+    void setOutputLatency(double seconds) { m_outputLatency = seconds; }
+    double getOutputLatency() const { return m_outputLatency; }
+
+    // Limits extrapolation past the last update (about two device buffers)
+    void setMaxExtrapolation(double frames) { m_maxExtrapolation = frames; }
+
+    // Audible frame at `time`
+    double frameAt(const PlayheadClock::Snapshot& snapshot, PlayheadClock::Clock::time_point time);
+    void reset();
+
+private:
+    double m_outputLatency = 0.0;
+    double m_maxExtrapolation = 8192.0;
+    double m_lastFrame = 0.0;
+    uint32_t m_lastEpoch = 0;
+    bool m_hasLast = false;
+};
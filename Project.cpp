@@ -49,6 +49,14 @@ std::shared_ptr<AudioClip> Project::getOrLoadClip(const std::wstring& filepath)
     return nullptr;
 }
 
+void Project::addClipToCache(const std::wstring& filepath, std::shared_ptr<AudioClip> clip) {
+    if (!clip) return;
+
+    removeClipFromCache(filepath);
+    m_clipToPathCache[clip.get()] = filepath;
+    m_clipCache[filepath] = std::move(clip);
+}
+
 void Project::removeClipFromCache(const std::wstring& filepath) {
     auto it = m_clipCache.find(filepath);
     if (it != m_clipCache.end()) {
@@ -134,6 +142,11 @@ std::wstring Project::serializeProject() const {
         ss << L"Armed=" << (track->isArmed() ? 1 : 0) << L"\n";
         ss << L"Visible=" << (track->isVisible() ? 1 : 0) << L"\n";
         ss << L"Height=" << track->getHeight() << L"\n";
+        const ConvolutionReverb& reverb = track->getReverb();
+        if (reverb.hasImpulseResponse()) {
+            ss << L"ReverbIR=" << reverb.getImpulseResponsePath() << L"\n";
+            ss << L"ReverbWet=" << reverb.getWetLevel() << L"\n";
+        }
         ss << L"\n";
         
         // Track regions
@@ -218,6 +231,17 @@ bool Project::parseProjectFile(const std::wstring& content) {
             if (sectionData.count(L"Height")) {
                 track->setHeight(std::stoi(sectionData[L"Height"]));
             }
+            if (sectionData.count(L"ReverbIR") && !sectionData[L"ReverbIR"].empty()) {
+                // A missing response file leaves the track dry
+                AudioClip response;
+                if (response.loadFromFile(sectionData[L"ReverbIR"])) {
+                    track->getReverb().setImpulseResponse(response, static_cast<uint32_t>(m_sampleRate),
+                                                          sectionData[L"ReverbIR"]);
+                }
+            }
+            if (sectionData.count(L"ReverbWet")) {
+                track->getReverb().setWetLevel(std::stof(sectionData[L"ReverbWet"]));
+            }
             
             m_tracks.push_back(track);
         }
@@ -0,0 +1,184 @@
+#include "RealtimeCheck.h"
+#include <Windows.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local int t_scopeDepth = 0;
+thread_local int t_allowDepth = 0;
+thread_local const char* t_context = "";
+thread_local bool t_reporting = false;  // Guards against re-entry while recording
+
+std::atomic<size_t> g_violationCount{0};
+RealtimeCheck::Violation g_violations[RealtimeCheck::MAX_VIOLATIONS];
+
+} // namespace
+
+RealtimeCheck::Scope::Scope(const char* name) {
+#ifdef WAVPLAYER_RT_CHECKS
+    m_previous = t_context;
+    t_context = name;
+    ++t_scopeDepth;
+#else
+    (void)name;
+#endif
+}
+
+RealtimeCheck::Scope::~Scope() {
+#ifdef WAVPLAYER_RT_CHECKS
+    --t_scopeDepth;
+    t_context = m_previous;
+#endif
+}
+
+RealtimeCheck::Allow::Allow() {
+#ifdef WAVPLAYER_RT_CHECKS
+    ++t_allowDepth;
+#endif
+}
+
+RealtimeCheck::Allow::~Allow() {
+#ifdef WAVPLAYER_RT_CHECKS
+    --t_allowDepth;
+#endif
+}
+
+bool RealtimeCheck::isRealtimeThread() {
+    return ENABLED && t_scopeDepth > 0 && t_allowDepth == 0;
+}
+
+void RealtimeCheck::report(Kind kind, const char* what) {
+    if (!isRealtimeThread() || t_reporting) {
+        return;
+    }
+    t_reporting = true;
+
+    size_t index = g_violationCount.fetch_add(1);
+    if (index < MAX_VIOLATIONS) {
+        Violation& violation = g_violations[index];
+        violation.kind = kind;
+        violation.what = what;
+        violation.context = t_context;
+        violation.threadId = GetCurrentThreadId();
+        // Skip this frame; the caller's frame shows where the violation happened
+        violation.stackFrames = CaptureStackBackTrace(1, static_cast<DWORD>(STACK_DEPTH),
+                                                      violation.stack, nullptr);
+
+        // Format on the stack: the heap is exactly what we're reporting
+        char line[512];
+        int length = snprintf(line, sizeof(line), "RT violation: %s (%s) in %s, thread %u, stack:",
+                              kindName(kind), what, violation.context, violation.threadId);
+        for (uint16_t i = 0; i < violation.stackFrames && length > 0 && length < static_cast<int>(sizeof(line)) - 24; ++i) {
+            length += snprintf(line + length, sizeof(line) - length, " %p", violation.stack[i]);
+        }
+        OutputDebugStringA(line);
+        OutputDebugStringA("\n");
+    }
+
+    t_reporting = false;
+}
+
+size_t RealtimeCheck::getViolationCount() {
+    return g_violationCount.load();
+}
+
+RealtimeCheck::Violation RealtimeCheck::getViolation(size_t index) {
+    if (index >= MAX_VIOLATIONS || index >= g_violationCount.load()) {
+        return Violation();
+    }
+    return g_violations[index];
+}
+
+void RealtimeCheck::clearViolations() {
+    g_violationCount = 0;
+}
+
+const char* RealtimeCheck::kindName(Kind kind) {
+    switch (kind) {
+    case Kind::Allocation: return "heap allocation";
+    case Kind::Deallocation: return "heap free";
+    case Kind::Lock: return "mutex lock";
+    case Kind::Blocking: return "blocking call";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// Global allocation hooks
+// ============================================================================
+
+#ifdef WAVPLAYER_RT_CHECKS
+
+namespace {
+
+void* checkedAlloc(size_t size) {
+    RealtimeCheck::report(RealtimeCheck::Kind::Allocation, "operator new");
+    return std::malloc(size ? size : 1);
+}
+
+void checkedFree(void* ptr) {
+    if (ptr) {
+        RealtimeCheck::report(RealtimeCheck::Kind::Deallocation, "operator delete");
+        std::free(ptr);
+    }
+}
+
+void* checkedAlignedAlloc(size_t size, std::align_val_t alignment) {
+    RealtimeCheck::report(RealtimeCheck::Kind::Allocation, "operator new (aligned)");
+    size_t align = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    size_t rounded = ((size ? size : 1) + align - 1) / align * align;
+    return std::aligned_alloc(align, rounded);
+#endif
+}
+
+void checkedAlignedFree(void* ptr) {
+    if (ptr) {
+        RealtimeCheck::report(RealtimeCheck::Kind::Deallocation, "operator delete (aligned)");
+#ifdef _MSC_VER
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    if (void* ptr = checkedAlloc(size)) return ptr;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    if (void* ptr = checkedAlloc(size)) return ptr;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return checkedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return checkedAlloc(size); }
+
+void operator delete(void* ptr) noexcept { checkedFree(ptr); }
+void operator delete[](void* ptr) noexcept { checkedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { checkedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { checkedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { checkedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { checkedFree(ptr); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* ptr = checkedAlignedAlloc(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* ptr = checkedAlignedAlloc(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr, std::align_val_t) noexcept { checkedAlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { checkedAlignedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { checkedAlignedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { checkedAlignedFree(ptr); }
+
+#endif // WAVPLAYER_RT_CHECKS
@@ -0,0 +1,93 @@
+#pragma once
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+// Debug instrumentation that catches real-time safety mistakes on audio threads.
+// Code running inside a RealtimeCheck::Scope must not touch the heap, take a
+// lock that another thread may hold, or make a blocking call, since any of
+// these can stall the device callback long enough to glitch. While a scope is
+// active on the current thread, operator new/delete, CheckedMutex::lock() and
+// calls annotated with blockingCall() are recorded as violations, together with
+// the innermost scope name and a short stack trace.
+//
+// Checking is compiled in when WAVPLAYER_RT_CHECKS is defined (Debug builds
+// and the test project). Otherwise the scopes and hooks do nothing.
+class RealtimeCheck {
+public:
+#ifdef WAVPLAYER_RT_CHECKS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    static constexpr size_t MAX_VIOLATIONS = 64;  // Recorded in detail; the rest are only counted
+    static constexpr size_t STACK_DEPTH = 12;
+
+    enum class Kind { Allocation, Deallocation, Lock, Blocking };
+
+    struct Violation {
+        Kind kind = Kind::Allocation;
+        const char* what = "";     // Operation, e.g. "operator new" or the lock name
+        const char* context = "";  // Innermost real-time scope
+        uint32_t threadId = 0;
+        void* stack[STACK_DEPTH] = {};
+        uint16_t stackFrames = 0;
+    };
+
+    // Marks the current thread as real-time for its lifetime. Scopes nest.
+    class Scope {
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        const char* m_previous = nullptr;
+    };
+
+    // Suspends checking inside a real-time scope, for work that is known to
+    // be unsafe and is accepted deliberately
+    class Allow {
+    public:
+        Allow();
+        ~Allow();
+        Allow(const Allow&) = delete;
+        Allow& operator=(const Allow&) = delete;
+    };
+
+    static bool isRealtimeThread();
+
+    // Hooks for operations that can't be intercepted automatically
+    static void blockingCall(const char* what) { if (ENABLED) report(Kind::Blocking, what); }
+    static void report(Kind kind, const char* what);
+
+    // Total since the last clear, including ones beyond MAX_VIOLATIONS
+    static size_t getViolationCount();
+    static Violation getViolation(size_t index);
+    static void clearViolations();
+
+    static const char* kindName(Kind kind);
+};
+
+// std::mutex that reports lock() from a real-time scope. try_lock() never
+// blocks and is allowed. Drop-in for std::lock_guard and std::unique_lock.
+class CheckedMutex {
+public:
+    explicit CheckedMutex(const char* name = "mutex") : m_name(name) {}
+    CheckedMutex(const CheckedMutex&) = delete;
+    CheckedMutex& operator=(const CheckedMutex&) = delete;
+
+    void lock() {
+        if (RealtimeCheck::ENABLED) {
+            RealtimeCheck::report(RealtimeCheck::Kind::Lock, m_name);
+        }
+        m_mutex.lock();
+    }
+    bool try_lock() { return m_mutex.try_lock(); }
+    void unlock() { m_mutex.unlock(); }
+
+private:
+    std::mutex m_mutex;
+    const char* m_name;
+};
@@ -0,0 +1,167 @@
+#include "RecordingRecovery.h"
+#include "AudioEngine.h"
+#include <Windows.h>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+
+std::wstring RecordingRecovery::getJournalDirectory() {
+    wchar_t tempPath[MAX_PATH] = {};
+    GetTempPath(MAX_PATH, tempPath);
+
+    std::wstring directory = std::wstring(tempPath) + L"WavPlayer";
+    CreateDirectory(directory.c_str(), nullptr);
+    return directory;
+}
+
+std::wstring RecordingRecovery::makeTakeFilename() {
+    SYSTEMTIME time;
+    GetLocalTime(&time);
+    wchar_t name[64];
+    swprintf_s(name, L"\\take_%04u%02u%02u_%02u%02u%02u_%03u",
+               time.wYear, time.wMonth, time.wDay,
+               time.wHour, time.wMinute, time.wSecond, time.wMilliseconds);
+    return getJournalDirectory() + name + PARTIAL_SUFFIX;
+}
+
+std::vector<std::wstring> RecordingRecovery::findOrphanedTakes(const std::wstring& directory,
+                                                               int minAgeSeconds) {
+    namespace fs = std::filesystem;
+
+    std::vector<std::pair<fs::file_time_type, std::wstring>> found;
+    const std::wstring suffix = PARTIAL_SUFFIX;
+    const auto now = fs::file_time_type::clock::now();
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        if (!entry.is_regular_file(ec)) continue;
+
+        std::wstring name = entry.path().filename().wstring();
+        if (name.size() <= suffix.size() ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+
+        // Skip takes that are still being written by another instance
+        auto modified = entry.last_write_time(ec);
+        if (ec) continue;
+        if (now - modified < std::chrono::seconds(minAgeSeconds)) continue;
+
+        found.emplace_back(modified, entry.path().wstring());
+    }
+
+    std::sort(found.begin(), found.end());
+
+    std::vector<std::wstring> takes;
+    takes.reserve(found.size());
+    for (auto& take : found) {
+        takes.push_back(std::move(take.second));
+    }
+    return takes;
+}
+
+uint64_t RecordingRecovery::repairTake(const std::wstring& filename) {
+    std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file) return 0;
+
+    char riff[4];
+    char wave[4];
+    file.read(riff, 4);
+    file.seekg(4, std::ios::cur);
+    file.read(wave, 4);
+    if (!file || strncmp(riff, "RIFF", 4) != 0 || strncmp(wave, "WAVE", 4) != 0) {
+        return 0;
+    }
+
+    // Walk the chunks to find the block alignment and where the data starts.
+    // The data chunk's own size field can't be trusted, so stop as soon as it's found.
+    uint16_t blockAlign = 0;
+    std::streamoff dataOffset = -1;
+
+    while (file) {
+        char chunkId[4];
+        uint32_t chunkSize = 0;
+        file.read(chunkId, 4);
+        file.read(reinterpret_cast<char*>(&chunkSize), 4);
+        if (!file) break;
+
+        if (strncmp(chunkId, "data", 4) == 0) {
+            dataOffset = file.tellg();
+            break;
+        }
+
+        std::streamoff chunkStart = file.tellg();
+        if (strncmp(chunkId, "fmt ", 4) == 0 && chunkSize >= 16) {
+            file.seekg(12, std::ios::cur);  // Format tag, channels, sample rate, byte rate
+            file.read(reinterpret_cast<char*>(&blockAlign), 2);
+        }
+        file.seekg(chunkStart + chunkSize + (chunkSize & 1), std::ios::beg);
+    }
+
+    if (dataOffset < 0 || blockAlign == 0) return 0;
+
+    file.clear();
+    file.seekg(0, std::ios::end);
+    uint64_t fileLength = static_cast<uint64_t>(file.tellg());
+    if (fileLength <= static_cast<uint64_t>(dataOffset)) return 0;
+
+    // Only keep whole frames; WAV sizes are 32-bit
+    uint64_t maxData = std::numeric_limits<uint32_t>::max() - static_cast<uint64_t>(dataOffset - 8);
+    uint64_t dataBytes = std::min(fileLength - dataOffset, maxData);
+    dataBytes -= dataBytes % blockAlign;
+
+    uint32_t dataSize = static_cast<uint32_t>(dataBytes);
+    uint32_t riffSize = static_cast<uint32_t>((dataOffset - 8) + dataBytes);
+
+    file.seekp(4, std::ios::beg);
+    file.write(reinterpret_cast<const char*>(&riffSize), 4);
+    file.seekp(dataOffset - 4, std::ios::beg);
+    file.write(reinterpret_cast<const char*>(&dataSize), 4);
+    file.flush();
+
+    return file.good() ? dataBytes / blockAlign : 0;
+}
+
+std::wstring RecordingRecovery::recoverTake(const std::wstring& filename) {
+    std::error_code ec;
+    if (repairTake(filename) == 0) {
+        // A crash before the first samples arrived leaves just a header
+        if (std::filesystem::file_size(filename, ec) <= EMPTY_TAKE_BYTES && !ec) {
+            std::filesystem::remove(filename, ec);
+        }
+        return L"";
+    }
+
+    const std::wstring suffix = PARTIAL_SUFFIX;
+    if (filename.size() <= suffix.size()) {
+        return L"";
+    }
+
+    std::wstring recovered = filename.substr(0, filename.size() - suffix.size()) + L".wav";
+
+    std::filesystem::rename(filename, recovered, ec);
+    return ec ? L"" : recovered;
+}
+
+bool RecordingRecovery::adoptTake(AudioClip& clip, const std::wstring& takeFilename,
+                                  const std::wstring& destination) {
+    // The engine already streamed the take to disk - move that file into place
+    // rather than writing the samples out again
+    bool moved = !takeFilename.empty() &&
+        MoveFileEx(takeFilename.c_str(), destination.c_str(),
+                   MOVEFILE_REPLACE_EXISTING | MOVEFILE_COPY_ALLOWED);
+
+    if (!moved) {
+        if (!clip.saveToFile(destination)) {
+            return false;
+        }
+        if (!takeFilename.empty()) {
+            DeleteFile(takeFilename.c_str());
+        }
+    }
+
+    clip.setFilename(destination);
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class AudioClip;
+
+// Journal for in-progress recordings. Takes are streamed to
+// <journal dir>\take_<timestamp>.partial.wav and their WAV header is patched
+// every few seconds, so if the app dies mid-take the file on disk is a valid
+// WAV up to the last patch. A clean stop moves the take into the project, so
+// any .partial.wav still in the journal directory at startup is an orphan
+// from a crash and can be repaired and recovered.
+class RecordingRecovery {
+public:
+    static constexpr const wchar_t* PARTIAL_SUFFIX = L".partial.wav";
+
+    // Files younger than this may belong to another instance that is still recording
+    static constexpr int ORPHAN_MIN_AGE_SECONDS = 30;
+
+    // %TEMP%\WavPlayer (created if missing)
+    static std::wstring getJournalDirectory();
+
+    // New unique take filename inside the journal directory
+    static std::wstring makeTakeFilename();
+
+    // Orphaned .partial.wav takes in the given directory, oldest first
+    static std::vector<std::wstring> findOrphanedTakes(const std::wstring& directory,
+                                                       int minAgeSeconds = ORPHAN_MIN_AGE_SECONDS);
+
+    // Patch the RIFF and data sizes from the actual file length.
+    // Returns the number of whole frames in the repaired file (0 on failure).
+    static uint64_t repairTake(const std::wstring& filename);
+
+    // Repair an orphaned take and rename it without the .partial suffix.
+    // Returns the new filename, or an empty string on failure. Takes that
+    // hold nothing but a header are deleted.
+    static std::wstring recoverTake(const std::wstring& filename);
+
+    // Move a finished take to destination, or save the clip there if the take
+    // file can't be moved, and point the clip at its new home so its sidecars
+    // (e.g. the .spec) land next to it rather than in the journal directory
+    static bool adoptTake(AudioClip& clip, const std::wstring& takeFilename,
+                          const std::wstring& destination);
+
+private:
+    static constexpr uint64_t EMPTY_TAKE_BYTES = 44;  // Canonical WAV header only
+};
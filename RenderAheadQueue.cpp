@@ -0,0 +1,100 @@
+#include "RenderAheadQueue.h"
+#include <algorithm>
+#include <cstring>
+
+void RenderAheadQueue::configure(uint16_t channels, size_t blockFrames, size_t blockCount) {
+    m_channels = std::max<uint16_t>(channels, 1);
+    m_blockFrames = std::max<size_t>(blockFrames, 1);
+    blockCount = std::max<size_t>(blockCount, 1);
+
+    m_blocks.resize(blockCount);
+    for (Block& block : m_blocks) {
+        block.samples.assign(m_blockFrames * m_channels, 0.0f);
+    }
+
+    m_free.resize(blockCount);
+    m_ready.resize(blockCount);
+    reset();
+}
+
+void RenderAheadQueue::reset() {
+    m_free.reset();
+    m_ready.reset();
+    for (uint32_t i = 0; i < m_blocks.size(); ++i) {
+        m_free.write(&i, 1);
+    }
+    m_current = -1;
+    m_currentOffset = 0;
+    m_flushRequested = false;
+    m_hasFlushed = false;
+}
+
+bool RenderAheadQueue::takeFlush(size_t playedFrame) {
+    if (!m_flushRequested.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    if (m_hasFlushed && playedFrame >= m_lastFlushFrame &&
+        playedFrame - m_lastFlushFrame < getLookAheadFrames()) {
+        return false;  // Kept until the window ends
+    }
+
+    m_flushRequested.store(false, std::memory_order_relaxed);
+    m_lastFlushFrame = playedFrame;
+    m_hasFlushed = true;
+    return true;
+}
+
+RenderAheadQueue::Block* RenderAheadQueue::acquire() {
+    uint32_t index;
+    if (m_free.read(&index, 1) == 0) {
+        return nullptr;
+    }
+    return &m_blocks[index];
+}
+
+void RenderAheadQueue::publish(Block* block) {
+    uint32_t index = static_cast<uint32_t>(block - m_blocks.data());
+    m_ready.write(&index, 1);
+}
+
+size_t RenderAheadQueue::read(float* out, size_t frameCount, uint64_t generation, size_t& nextFrame) {
+    size_t copied = 0;
+
+    while (copied < frameCount) {
+        if (m_current < 0) {
+            uint32_t index;
+            if (m_ready.read(&index, 1) == 0) {
+                break;  // Renderer hasn't caught up
+            }
+            m_current = index;
+            m_currentOffset = 0;
+        }
+
+        const Block& block = m_blocks[static_cast<size_t>(m_current)];
+        if (block.generation != generation) {
+            recycleCurrent();  // Rendered before a seek or parameter change
+            continue;
+        }
+
+        size_t frames = std::min(frameCount - copied, m_blockFrames - m_currentOffset);
+        memcpy(out + copied * m_channels, block.samples.data() + m_currentOffset * m_channels,
+               frames * m_channels * sizeof(float));
+        copied += frames;
+        m_currentOffset += frames;
+        nextFrame = block.startFrame + m_currentOffset;
+
+        if (m_currentOffset == m_blockFrames) {
+            recycleCurrent();
+        }
+    }
+
+    return copied;
+}
+
+void RenderAheadQueue::recycleCurrent() {
+    uint32_t index = static_cast<uint32_t>(m_current);
+    m_free.write(&index, 1);
+    m_current = -1;
+    m_currentOffset = 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "SpscRingBuffer.h"
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Fixed pool of mixed audio blocks passed from the render-ahead thread to the
+// playback callback. Block indices circulate through two lock-free rings
+// (free: callback -> renderer, ready: renderer -> callback), so neither side
+// allocates or waits on the other.
+//
+// Every block is tagged with a generation. Seeks and parameter changes bump
+// the generation; the callback recycles blocks from older generations unheard,
+// so a flush never has to reach into the other thread's ring.
+//
+// A flush re-renders from the frame the device was last given, but stateful
+// effects (EQ filters, reverbs) keep the state they built from the discarded
+// blocks, so the re-rendered audio is fed through them a second time and its
+// echo lands in their tails. Parameter-change flushes are therefore throttled
+// to one per look-ahead's worth of playback; a change inside that window is
+// flushed when it ends. Seeks flush immediately.
+class RenderAheadQueue {
+public:
+    struct Block {
+        uint64_t generation = 0;
+        size_t startFrame = 0;       // Project frame of the first sample
+        std::vector<float> samples;  // blockFrames interleaved frames
+    };
+
+    // Neither side may be running
+    void configure(uint16_t channels, size_t blockFrames, size_t blockCount);
+    void reset();
+
+    size_t getBlockFrames() const { return m_blockFrames; }
+    size_t getBlockCount() const { return m_blocks.size(); }
+    size_t getLookAheadFrames() const { return m_blockFrames * m_blocks.size(); }
+
+    // Producer side: take a free block to render into (nullptr when the
+    // look-ahead is full), then hand it over
+    Block* acquire();
+    void publish(Block* block);
+
+    // Consumer side: copy up to frameCount frames of the given generation to
+    // out, recycling blocks from any other generation. nextFrame receives the
+    // project frame after the last frame copied. Returns frames copied.
+    size_t read(float* out, size_t frameCount, uint64_t generation, size_t& nextFrame);
+
+    // Parameter-change flushes. requestFlush() from any thread; the producer
+    // calls takeFlush() with the frame last handed to the device before each
+    // block and flushes when it returns true: the first request straight
+    // away, later ones once that frame has moved a whole look-ahead on (or
+    // back, after a seek) from the previous flush.
+    void requestFlush() { m_flushRequested.store(true, std::memory_order_release); }
+    bool takeFlush(size_t playedFrame);
+
+    // Blocks rendered and not yet fully read (any generation)
+    size_t readyBlocks() const { return m_ready.availableToRead() + (m_current >= 0 ? 1 : 0); }
+
+private:
+    void recycleCurrent();
+
+    std::vector<Block> m_blocks;
+    SpscRingBuffer<uint32_t> m_free;   // Written by the consumer, read by the producer
+    SpscRingBuffer<uint32_t> m_ready;  // Written by the producer, read by the consumer
+    size_t m_blockFrames = 0;
+    uint16_t m_channels = 2;
+
+    // Flush throttling; the last flush frame is producer-only
+    std::atomic<bool> m_flushRequested{false};
+    size_t m_lastFlushFrame = 0;
+    bool m_hasFlushed = false;
+
+    // Consumer-only: partially read block
+    int64_t m_current = -1;
+    size_t m_currentOffset = 0;
+};
@@ -0,0 +1,90 @@
+#include "SampleFormat.h"
+#include <algorithm>
+#include <cstring>
+
+namespace SampleConvert {
+
+uint32_t bytesPerSample(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::Int16:   return 2;
+        case SampleFormat::Int24:   return 3;
+        case SampleFormat::Float32: return 4;
+    }
+    return 2;
+}
+
+uint16_t bitsPerSample(SampleFormat format) {
+    return static_cast<uint16_t>(bytesPerSample(format) * 8);
+}
+
+bool fromWaveFormat(uint16_t bitsPerSample, bool isFloat, SampleFormat& format) {
+    if (isFloat) {
+        if (bitsPerSample != 32) return false;
+        format = SampleFormat::Float32;
+        return true;
+    }
+    if (bitsPerSample == 16) {
+        format = SampleFormat::Int16;
+        return true;
+    }
+    if (bitsPerSample == 24) {
+        format = SampleFormat::Int24;
+        return true;
+    }
+    return false;
+}
+
+void fromFloat(const float* src, void* dst, size_t sampleCount, SampleFormat format) {
+    switch (format) {
+        case SampleFormat::Int16: {
+            int16_t* out = static_cast<int16_t*>(dst);
+            for (size_t i = 0; i < sampleCount; ++i) {
+                float sample = std::clamp(src[i], -1.0f, 1.0f);
+                out[i] = static_cast<int16_t>(sample * 32767.0f);
+            }
+            break;
+        }
+        case SampleFormat::Int24: {
+            uint8_t* out = static_cast<uint8_t*>(dst);
+            for (size_t i = 0; i < sampleCount; ++i) {
+                float sample = std::clamp(src[i], -1.0f, 1.0f);
+                int32_t value = static_cast<int32_t>(sample * 8388607.0f);
+                out[i * 3] = static_cast<uint8_t>(value & 0xFF);
+                out[i * 3 + 1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+                out[i * 3 + 2] = static_cast<uint8_t>((value >> 16) & 0xFF);
+            }
+            break;
+        }
+        case SampleFormat::Float32:
+            memcpy(dst, src, sampleCount * sizeof(float));
+            break;
+    }
+}
+
+void toFloat(const void* src, float* dst, size_t sampleCount, SampleFormat format) {
+    switch (format) {
+        case SampleFormat::Int16: {
+            const int16_t* in = static_cast<const int16_t*>(src);
+            for (size_t i = 0; i < sampleCount; ++i) {
+                dst[i] = in[i] / 32768.0f;
+            }
+            break;
+        }
+        case SampleFormat::Int24: {
+            const uint8_t* in = static_cast<const uint8_t*>(src);
+            for (size_t i = 0; i < sampleCount; ++i) {
+                int32_t sample = (in[i * 3] << 8) |
+                                 (in[i * 3 + 1] << 16) |
+                                 (in[i * 3 + 2] << 24);
+                sample >>= 8;  // Sign extend
+                dst[i] = sample / 8388608.0f;
+            }
+            break;
+        }
+        case SampleFormat::Float32:
+            memcpy(dst, src, sampleCount * sizeof(float));
+            break;
+    }
+}
+
+} // namespace SampleConvert
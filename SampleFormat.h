@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// Device / file sample encodings. All processing happens in float; these are
+// only used for the single conversion at the edge (device buffer or WAV file).
+enum class SampleFormat {
+    Int16,    // 16-bit signed PCM
+    Int24,    // 24-bit signed PCM, packed little-endian
+    Float32   // 32-bit IEEE float
+};
+
+namespace SampleConvert {
+
+uint32_t bytesPerSample(SampleFormat format);
+uint16_t bitsPerSample(SampleFormat format);
+
+// Map a WAV/WAVEFORMATEX description to a SampleFormat. Returns false if the
+// combination is not supported.
+bool fromWaveFormat(uint16_t bitsPerSample, bool isFloat, SampleFormat& format);
+
+// Convert normalized float samples (-1.0 to 1.0) to the target encoding.
+// Integer formats are clamped; float output is passed through unclamped.
+void fromFloat(const float* src, void* dst, size_t sampleCount, SampleFormat format);
+
+// Convert encoded samples back to normalized float
+void toFloat(const void* src, float* dst, size_t sampleCount, SampleFormat format);
+
+} // namespace SampleConvert
@@ -0,0 +1,50 @@
+#include "ScratchArena.h"
+#include <algorithm>
+#include <new>
+
+ScratchArena::~ScratchArena() {
+    release();
+}
+
+size_t ScratchArena::spanBytes(size_t count, size_t elementSize) {
+    size_t bytes = count * elementSize;
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+size_t ScratchArena::bytesForBlock(size_t frames, uint16_t channels, size_t spanCount) {
+    return spanBytes(frames * std::max<uint16_t>(channels, 1), sizeof(float)) * spanCount;
+}
+
+void ScratchArena::configure(size_t capacityBytes) {
+    capacityBytes = spanBytes(capacityBytes, 1);
+    if (capacityBytes > m_capacity) {
+        release();
+        m_memory = static_cast<uint8_t*>(::operator new(capacityBytes, std::align_val_t(ALIGNMENT), std::nothrow));
+        m_capacity = m_memory ? capacityBytes : 0;
+    }
+    m_used = 0;
+    m_highWater = 0;
+    m_overflows = 0;
+}
+
+void ScratchArena::release() {
+    if (m_memory) {
+        ::operator delete(m_memory, std::align_val_t(ALIGNMENT));
+        m_memory = nullptr;
+    }
+    m_capacity = 0;
+    m_used = 0;
+}
+
+void* ScratchArena::allocateBytes(size_t bytes) {
+    size_t size = spanBytes(bytes, 1);
+    if (size > m_capacity - m_used) {
+        ++m_overflows;
+        return nullptr;
+    }
+
+    void* span = m_memory + m_used;
+    m_used += size;
+    m_highWater = std::max(m_highWater, m_used);
+    return span;
+}
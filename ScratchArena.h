@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+// Preallocated bump allocator for scratch buffers on one audio thread. The
+// block is reserved up front, sized from the buffer layout, so handing out a
+// span in the callback is a pointer bump and never touches the heap. Every
+// span starts on a 64-byte boundary (a cache line, and wide enough for any
+// SIMD load). Spans are uninitialized and stay valid until the arena is
+// reset, usually by a Frame at the end of the callback.
+//
+// Each arena belongs to a single thread. configure() and release() must not
+// run while that thread is using it.
+class ScratchArena {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    ScratchArena() = default;
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Bytes taken by a span of count elements, including alignment padding
+    static size_t spanBytes(size_t count, size_t elementSize);
+
+    // Capacity for spanCount float spans of frames * channels samples
+    static size_t bytesForBlock(size_t frames, uint16_t channels, size_t spanCount);
+
+    // Reallocates only when the capacity grows; always resets
+    void configure(size_t capacityBytes);
+    void release();
+
+    // nullptr (and counted as an overflow) when the arena is full
+    template <typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena spans are never destroyed");
+        static_assert(alignof(T) <= ALIGNMENT, "Arena spans are 64-byte aligned");
+        return static_cast<T*>(allocateBytes(count * sizeof(T)));
+    }
+
+    void reset() { m_used = 0; }
+
+    size_t getCapacity() const { return m_capacity; }
+    size_t getUsed() const { return m_used; }
+    size_t getHighWater() const { return m_highWater; }
+    uint64_t getOverflows() const { return m_overflows; }
+
+    // Releases everything allocated during its lifetime. Frames nest, so a
+    // callee can take its own without disturbing the caller's spans.
+    class Frame {
+    public:
+        explicit Frame(ScratchArena& arena) : m_arena(arena), m_mark(arena.m_used) {}
+        ~Frame() { m_arena.m_used = m_mark; }
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+    private:
+        ScratchArena& m_arena;
+        size_t m_mark;
+    };
+
+private:
+    void* allocateBytes(size_t bytes);
+
+    uint8_t* m_memory = nullptr;
+    size_t m_capacity = 0;
+    size_t m_used = 0;
+    size_t m_highWater = 0;
+    uint64_t m_overflows = 0;
+};
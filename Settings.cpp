@@ -48,6 +48,29 @@ void Settings::load() {
     m_snapToGrid = readBool(L"Timeline", L"SnapToGrid", m_snapToGrid);
     m_bpm = readDouble(L"Timeline", L"BPM", m_bpm);
 
+    // Audio buffers (out-of-range values from a hand-edited file are clamped)
+    AudioBufferConfig audio;
+    audio.playbackBuffers = readInt(L"Audio", L"BufferCount", m_audioBufferConfig.playbackBuffers);
+    audio.playbackBufferFrames = readInt(L"Audio", L"BufferFrames", m_audioBufferConfig.playbackBufferFrames);
+    audio.recordBuffers = readInt(L"Audio", L"RecordBufferCount", m_audioBufferConfig.recordBuffers);
+    audio.recordBufferFrames = readInt(L"Audio", L"RecordBufferFrames", m_audioBufferConfig.recordBufferFrames);
+    m_audioBufferConfig = audio.clamped();
+    m_adaptiveBuffering = readBool(L"Audio", L"AdaptiveBuffers", m_adaptiveBuffering);
+    m_renderAhead = readBool(L"Audio", L"RenderAhead", m_renderAhead);
+    setRenderAheadFrames(readInt(L"Audio", L"RenderAheadFrames", m_renderAheadFrames));
+    m_audioCore = readInt(L"Audio", L"AudioCore", m_audioCore);
+
+    // Spectrum analyzer (the analyzer rejects combinations it can't run)
+    m_spectrumFftSize = readInt(L"Spectrum", L"FftSize", m_spectrumFftSize);
+    m_spectrumHop = readInt(L"Spectrum", L"Hop", m_spectrumHop);
+    m_spectrumWindow = readInt(L"Spectrum", L"Window", m_spectrumWindow);
+    m_spectrumBands = readInt(L"Spectrum", L"Bands", m_spectrumBands);
+    m_linearPhaseEQ = readBool(L"Spectrum", L"LinearPhaseEQ", m_linearPhaseEQ);
+
+    // Master reverb
+    m_masterReverbPath = readString(L"Reverb", L"MasterIR", m_masterReverbPath);
+    m_masterReverbWet = readDouble(L"Reverb", L"MasterWet", m_masterReverbWet);
+
     // Last project
     m_lastProjectPath = readString(L"General", L"LastProjectPath", m_lastProjectPath);
 }
@@ -74,6 +97,27 @@ void Settings::save() {
     writeBool(L"Timeline", L"SnapToGrid", m_snapToGrid);
     writeDouble(L"Timeline", L"BPM", m_bpm);
 
+    // Audio buffers
+    writeInt(L"Audio", L"BufferCount", m_audioBufferConfig.playbackBuffers);
+    writeInt(L"Audio", L"BufferFrames", m_audioBufferConfig.playbackBufferFrames);
+    writeInt(L"Audio", L"RecordBufferCount", m_audioBufferConfig.recordBuffers);
+    writeInt(L"Audio", L"RecordBufferFrames", m_audioBufferConfig.recordBufferFrames);
+    writeBool(L"Audio", L"AdaptiveBuffers", m_adaptiveBuffering);
+    writeBool(L"Audio", L"RenderAhead", m_renderAhead);
+    writeInt(L"Audio", L"RenderAheadFrames", m_renderAheadFrames);
+    writeInt(L"Audio", L"AudioCore", m_audioCore);
+
+    // Spectrum analyzer
+    writeInt(L"Spectrum", L"FftSize", m_spectrumFftSize);
+    writeInt(L"Spectrum", L"Hop", m_spectrumHop);
+    writeInt(L"Spectrum", L"Window", m_spectrumWindow);
+    writeInt(L"Spectrum", L"Bands", m_spectrumBands);
+    writeBool(L"Spectrum", L"LinearPhaseEQ", m_linearPhaseEQ);
+
+    // Master reverb
+    writeString(L"Reverb", L"MasterIR", m_masterReverbPath);
+    writeDouble(L"Reverb", L"MasterWet", m_masterReverbWet);
+
     // Last project
     writeString(L"General", L"LastProjectPath", m_lastProjectPath);
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include <Windows.h>
 #include <string>
+#include <algorithm>
+#include "AudioBufferConfig.h"
 
 class Settings {
 public:
@@ -52,6 +54,45 @@ public:
     void setSnapToGrid(bool snap) { m_snapToGrid = snap; }
     void setBPM(double bpm) { m_bpm = bpm; }
 
+    // Audio device buffers
+    const AudioBufferConfig& getAudioBufferConfig() const { return m_audioBufferConfig; }
+    void setAudioBufferConfig(const AudioBufferConfig& config) { m_audioBufferConfig = config.clamped(); }
+    bool getAdaptiveBuffering() const { return m_adaptiveBuffering; }
+    void setAdaptiveBuffering(bool adaptive) { m_adaptiveBuffering = adaptive; }
+    bool getRenderAhead() const { return m_renderAhead; }
+    void setRenderAhead(bool renderAhead) { m_renderAhead = renderAhead; }
+    // Look-ahead length; out-of-range values (e.g. hand-edited) are clamped
+    static constexpr int MIN_RENDER_AHEAD_FRAMES = 1024;
+    static constexpr int MAX_RENDER_AHEAD_FRAMES = 65536;
+    int getRenderAheadFrames() const { return m_renderAheadFrames; }
+    void setRenderAheadFrames(int frames) {
+        m_renderAheadFrames = std::clamp(frames, MIN_RENDER_AHEAD_FRAMES, MAX_RENDER_AHEAD_FRAMES);
+    }
+    // Core to pin audio threads to (-1 = let the scheduler decide)
+    int getAudioCore() const { return m_audioCore; }
+    void setAudioCore(int core) { m_audioCore = core; }
+
+    // Spectrum analyzer STFT (window: 0 rectangular, 1 Hann, 2 Hamming, 3 Blackman-Harris)
+    int getSpectrumFftSize() const { return m_spectrumFftSize; }
+    void setSpectrumFftSize(int size) { m_spectrumFftSize = size; }
+    int getSpectrumHop() const { return m_spectrumHop; }
+    void setSpectrumHop(int hop) { m_spectrumHop = hop; }
+    int getSpectrumWindow() const { return m_spectrumWindow; }
+    void setSpectrumWindow(int window) { m_spectrumWindow = window; }
+    // Analyzer bars: 0 FFT octave bands, 3 or 6 bands per octave from the filter bank
+    int getSpectrumBands() const { return m_spectrumBands; }
+    void setSpectrumBands(int bandsPerOctave) { m_spectrumBands = bandsPerOctave; }
+
+    // Graphic EQ
+    bool getLinearPhaseEQ() const { return m_linearPhaseEQ; }
+    void setLinearPhaseEQ(bool enabled) { m_linearPhaseEQ = enabled; }
+
+    // Master bus reverb (empty path = none)
+    std::wstring getMasterReverbPath() const { return m_masterReverbPath; }
+    void setMasterReverbPath(const std::wstring& path) { m_masterReverbPath = path; }
+    double getMasterReverbWet() const { return m_masterReverbWet; }
+    void setMasterReverbWet(double gain) { m_masterReverbWet = gain; }
+
     // Last opened project
     std::wstring getLastProjectPath() const { return m_lastProjectPath; }
     void setLastProjectPath(const std::wstring& path) { m_lastProjectPath = path; }
@@ -91,6 +132,24 @@ private:
     bool m_snapToGrid = true;
     double m_bpm = 120.0;
 
+    // Audio device buffers
+    AudioBufferConfig m_audioBufferConfig;
+    bool m_adaptiveBuffering = false;
+    bool m_renderAhead = false;
+    int m_renderAheadFrames = 8192;
+    int m_audioCore = -1;
+
+    // Spectrum analyzer
+    int m_spectrumFftSize = 4096;
+    int m_spectrumHop = 1024;
+    int m_spectrumWindow = 1;
+    int m_spectrumBands = 0;
+    bool m_linearPhaseEQ = false;
+
+    // Master reverb
+    std::wstring m_masterReverbPath;
+    double m_masterReverbWet = 0.3;
+
     // Last opened project
     std::wstring m_lastProjectPath;
 };
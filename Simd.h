@@ -0,0 +1,9 @@
+#pragma once
+
+// SSE2 code paths are compiled in on every x64 target, on 32-bit MSVC
+// builds with /arch:SSE2 or later (the default, _M_IX86_FP == 2) and on
+// GCC/Clang targets with SSE2. Everything else uses the scalar fallbacks.
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define WAVPLAYER_USE_SSE2 1
+#endif
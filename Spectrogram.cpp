@@ -0,0 +1,108 @@
+#include "Spectrogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+Spectrogram::Spectrogram() {
+    m_columns.assign(CAPACITY * ROWS, 0);
+    m_rowStart.resize(ROWS);
+    m_rowEnd.resize(ROWS);
+}
+
+void Spectrogram::addColumn(const float* magnitudes, size_t binCount, int sampleRate) {
+    if (!magnitudes || binCount < 2 || sampleRate <= 0) return;
+
+    if (binCount != m_rangesBinCount || sampleRate != m_rangesSampleRate) {
+        computeRowBins(binCount, sampleRate, ROWS, m_rowStart, m_rowEnd);
+        m_rangesBinCount = binCount;
+        m_rangesSampleRate = sampleRate;
+    }
+
+    uint64_t written = m_written.load(std::memory_order_relaxed);
+    uint8_t* column = m_columns.data() + (written % CAPACITY) * ROWS;
+    for (size_t row = 0; row < ROWS; ++row) {
+        column[row] = levelFor(magnitudes, m_rowStart[row], m_rowEnd[row]);
+    }
+
+    m_written.store(written + 1, std::memory_order_release);
+}
+
+bool Spectrogram::readColumn(uint64_t index, uint8_t* levels) const {
+    // The writer may be filling slot (written % CAPACITY), which held
+    // column written - CAPACITY, so that one already counts as lost
+    uint64_t written = m_written.load(std::memory_order_acquire);
+    if (index >= written || written - index >= CAPACITY) {
+        return false;
+    }
+
+    std::memcpy(levels, m_columns.data() + (index % CAPACITY) * ROWS, ROWS);
+
+    // Discard the copy if the writer lapped it meanwhile
+    std::atomic_thread_fence(std::memory_order_acquire);
+    written = m_written.load(std::memory_order_relaxed);
+    return written - index < CAPACITY;
+}
+
+void Spectrogram::computeRowBins(size_t binCount, int sampleRate, size_t rows,
+                                 std::vector<uint32_t>& start, std::vector<uint32_t>& end) {
+    const float binHz = static_cast<float>(sampleRate) / (2.0f * (binCount - 1));
+    const float maxFreq = std::min(MAX_FREQ, sampleRate * 0.5f);
+    const float ratio = std::pow(maxFreq / MIN_FREQ, 1.0f / rows);
+    const uint32_t lastBin = static_cast<uint32_t>(binCount - 1);
+    start.resize(rows);
+    end.resize(rows);
+
+    for (size_t row = 0; row < rows; ++row) {
+        float low = MIN_FREQ * std::pow(ratio, static_cast<float>(row));
+        float high = low * ratio;
+        uint32_t first = std::min(static_cast<uint32_t>(std::lround(low / binHz)), lastBin);
+        uint32_t last = static_cast<uint32_t>(std::lround(high / binHz));
+        start[row] = first;
+        end[row] = std::clamp(last > 0 ? last - 1 : 0u, first, lastBin);
+    }
+}
+
+uint8_t Spectrogram::levelFor(const float* magnitudes, uint32_t firstBin, uint32_t lastBin) {
+    // Peak rather than average, so narrow tones survive wide rows
+    float peak = 0.0f;
+    for (uint32_t bin = firstBin; bin <= lastBin; ++bin) {
+        peak = std::max(peak, magnitudes[bin]);
+    }
+    float dB = 20.0f * std::log10(peak + 1e-10f);
+    float level = (dB - FLOOR_DB) / (CEIL_DB - FLOOR_DB) * 255.0f;
+    return static_cast<uint8_t>(std::clamp(level, 0.0f, 255.0f) + 0.5f);
+}
+
+const std::array<uint32_t, 256>& Spectrogram::getPalette() {
+    static const std::array<uint32_t, 256> palette = []() {
+        // Piecewise-linear ramp through these stops
+        struct Stop { float level, r, g, b; };
+        const Stop stops[] = {
+            {0.00f, 0.00f, 0.00f, 0.05f},
+            {0.30f, 0.10f, 0.00f, 0.45f},
+            {0.55f, 0.75f, 0.05f, 0.35f},
+            {0.75f, 1.00f, 0.45f, 0.00f},
+            {0.90f, 1.00f, 0.90f, 0.20f},
+            {1.00f, 1.00f, 1.00f, 1.00f},
+        };
+
+        std::array<uint32_t, 256> colors{};
+        for (int i = 0; i < 256; ++i) {
+            float level = i / 255.0f;
+            size_t stop = 1;
+            while (stop + 1 < std::size(stops) && level > stops[stop].level) {
+                ++stop;
+            }
+            const Stop& a = stops[stop - 1];
+            const Stop& b = stops[stop];
+            float t = std::clamp((level - a.level) / (b.level - a.level), 0.0f, 1.0f);
+            auto channel = [t](float from, float to) {
+                return static_cast<uint32_t>((from + (to - from) * t) * 255.0f + 0.5f);
+            };
+            colors[i] = 0xFF000000u | (channel(a.r, b.r) << 16) | (channel(a.g, b.g) << 8) | channel(a.b, b.b);
+        }
+        return colors;
+    }();
+    return palette;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Column history for the scrolling spectrogram. The analysis thread turns
+// each STFT frame into one column of ROWS log-frequency levels (0-255 over
+// FLOOR_DB..CEIL_DB) and writes it into a ring of CAPACITY columns; the UI
+// reads only the columns added since it last drew. Memory and per-column
+// work are fixed, so the view costs the same however long it runs.
+//
+// One writer (the analysis thread), any number of readers. A reader that
+// falls more than a ring behind gets false for the overwritten columns
+// rather than a torn one.
+class Spectrogram {
+public:
+    static constexpr size_t ROWS = 256;        // Row 0 = MIN_FREQ
+    static constexpr size_t CAPACITY = 2048;
+    static constexpr float MIN_FREQ = 20.0f;
+    static constexpr float MAX_FREQ = 20000.0f;
+    static constexpr float FLOOR_DB = -100.0f;
+    static constexpr float CEIL_DB = 0.0f;
+
+    Spectrogram();
+
+    Spectrogram(const Spectrogram&) = delete;
+    Spectrogram& operator=(const Spectrogram&) = delete;
+
+    // Analysis thread: magnitudes from one STFT frame (1.0 = full scale)
+    void addColumn(const float* magnitudes, size_t binCount, int sampleRate);
+
+    // Columns written so far; the newest is getColumnCount() - 1
+    uint64_t getColumnCount() const { return m_written.load(std::memory_order_acquire); }
+
+    // Copy ROWS levels of an absolute column index. False if it isn't
+    // written yet or has already been overwritten.
+    bool readColumn(uint64_t index, uint8_t* levels) const;
+
+    // Level -> 0xAARRGGBB, dark blue through red to white
+    static const std::array<uint32_t, 256>& getPalette();
+
+    // Inclusive bin range for each of `rows` log-spaced rows from MIN_FREQ
+    // to MAX_FREQ (or Nyquist); rows narrower than a bin repeat the nearest
+    static void computeRowBins(size_t binCount, int sampleRate, size_t rows,
+                               std::vector<uint32_t>& start, std::vector<uint32_t>& end);
+
+    // Peak magnitude over the bins (1.0 = full scale) as a 0-255 level
+    static uint8_t levelFor(const float* magnitudes, uint32_t firstBin, uint32_t lastBin);
+
+private:
+    std::vector<uint8_t> m_columns;  // CAPACITY x ROWS
+    std::atomic<uint64_t> m_written{0};
+
+    // Writer-only state
+    std::vector<uint32_t> m_rowStart;  // Bin range per row, inclusive
+    std::vector<uint32_t> m_rowEnd;
+    size_t m_rangesBinCount = 0;
+    int m_rangesSampleRate = 0;
+};
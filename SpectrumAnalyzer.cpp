@@ -0,0 +1,256 @@
+#include "SpectrumAnalyzer.h"
+#include <Windows.h>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+
+SpectrumAnalyzer::SpectrumAnalyzer(const std::vector<float>& bandCenters)
+    : m_bandCenters(bandCenters) {
+    m_ring.resize(RING_FRAMES * 2);
+    m_readBlock.resize(ANALYSIS_HOP * 2);
+    m_monoBlock.resize(ANALYSIS_HOP);
+    m_stft.configure({FFT_SIZE, ANALYSIS_HOP, FftPlan::Window::Hann});
+    m_pendingConfig = m_stft.getConfig();
+
+    const size_t bandCount = m_bandCenters.size();
+    m_bandValues.assign(bandCount, 0.0f);
+    m_bandPeaks.assign(bandCount, 0.0f);
+    m_bandAmplitudes.assign(bandCount, 0.0f);
+    m_activeCenters = m_bandCenters;
+    for (Snapshot& snapshot : m_snapshots) {
+        snapshot.bands.assign(bandCount, 0.0f);
+        snapshot.peaks.assign(bandCount, 0.0f);
+        snapshot.centers = m_bandCenters;
+    }
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    stop();
+}
+
+void SpectrumAnalyzer::start() {
+    if (m_running) return;
+    m_running = true;
+    m_worker = std::thread(&SpectrumAnalyzer::workerLoop, this);
+}
+
+void SpectrumAnalyzer::stop() {
+    m_running = false;
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+void SpectrumAnalyzer::pushSamples(const float* samples, size_t sampleCount, int sampleRate) {
+    if (!samples || sampleCount < 2) return;
+
+    m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+
+    // Whole stereo frames only
+    size_t writable = std::min(sampleCount, m_ring.availableToWrite()) & ~size_t(1);
+    size_t written = m_ring.write(samples, writable);
+    if (written < sampleCount) {
+        m_droppedFrames += (sampleCount - written) / 2;
+    }
+}
+
+void SpectrumAnalyzer::workerLoop() {
+    // Display only: never compete with the audio threads
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    while (m_running) {
+        if (analyzePending() && m_updateCallback) {
+            m_updateCallback();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(WORKER_INTERVAL_MS));
+    }
+}
+
+bool SpectrumAnalyzer::analyzePending() {
+    int sampleRate = m_sampleRate.load(std::memory_order_relaxed);
+
+    if (m_configPending.exchange(false)) {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        m_stft.configure(m_pendingConfig);
+        m_rangesFftSize = 0;
+        m_octaveFill = 0;
+        updateTimeConstants(sampleRate);
+    }
+
+    BandSource source = m_bandSource.load(std::memory_order_relaxed);
+    if (source != m_requestedSource || (source != BandSource::Fft && sampleRate != m_sourceRate)) {
+        applyBandSource(source, sampleRate);
+    }
+
+    if (m_clearRequested.exchange(false)) {
+        m_stft.reset();
+        m_octaveBank.reset();
+        m_octaveFill = 0;
+        std::fill(m_bandValues.begin(), m_bandValues.end(), 0.0f);
+        std::fill(m_bandPeaks.begin(), m_bandPeaks.end(), 0.0f);
+    }
+
+    // Run every hop of the new input through the STFT, and through the
+    // filter bank when it provides the bands
+    const size_t hop = m_stft.getConfig().hop;
+    bool analyzed = false;
+    size_t count;
+    while ((count = m_ring.read(m_readBlock.data(), m_readBlock.size())) > 0) {
+        size_t frames = count / 2;
+        for (size_t i = 0; i < frames; ++i) {
+            m_monoBlock[i] = (m_readBlock[i * 2] + m_readBlock[i * 2 + 1]) * 0.5f;
+        }
+        m_stft.process(m_monoBlock.data(), frames, [&](const float* magnitudes) {
+            if (m_activeSource == BandSource::Fft) {
+                analyzeFrame(magnitudes, sampleRate);
+            }
+            m_spectrogram.addColumn(magnitudes, m_stft.getBinCount(), sampleRate);
+            analyzed = true;
+        });
+
+        if (m_activeSource != BandSource::Fft) {
+            // Same frame rate as the STFT, so the smoothing behaves the same
+            for (size_t offset = 0; offset < frames;) {
+                size_t take = std::min(frames - offset, hop - m_octaveFill);
+                m_octaveBank.process(&m_monoBlock[offset], take);
+                offset += take;
+                m_octaveFill += take;
+                if (m_octaveFill == hop) {
+                    m_octaveFill = 0;
+                    m_octaveBank.takeLevels(m_bandAmplitudes.data());
+                    updateBands(m_bandAmplitudes.data());
+                    analyzed = true;
+                }
+            }
+        }
+    }
+
+    if (!analyzed) {
+        return false;
+    }
+
+    // Fill the back snapshot, then make it the front
+    std::unique_lock<std::mutex> lock(m_snapshotMutex);
+    Snapshot& back = m_snapshots[1 - m_front];
+    uint64_t sequence = m_snapshots[m_front].sequence + 1;
+    lock.unlock();
+
+    back.bands = m_bandValues;
+    back.peaks = m_bandPeaks;
+    back.centers = m_activeCenters;
+    back.source = m_activeSource;
+    back.sequence = sequence;
+
+    lock.lock();
+    m_front = 1 - m_front;
+    return true;
+}
+
+void SpectrumAnalyzer::analyzeFrame(const float* magnitudes, int sampleRate) {
+    const Stft::Config& config = m_stft.getConfig();
+    if (sampleRate != m_rangesSampleRate || config.fftSize != m_rangesFftSize) {
+        computeBandRanges(sampleRate);
+    }
+
+    for (size_t band = 0; band < m_bandCenters.size(); band++) {
+        // Average magnitude over the band's bins (1.0 = full-scale sine)
+        float sum = 0.0f;
+        int bins = 0;
+        for (int bin = m_binStart[band]; bin <= m_binEnd[band]; bin++) {
+            sum += magnitudes[bin];
+            bins++;
+        }
+        m_bandAmplitudes[band] = (bins > 0) ? (sum / bins) : 0.0f;
+    }
+    updateBands(m_bandAmplitudes.data());
+}
+
+void SpectrumAnalyzer::updateBands(const float* amplitudes) {
+    for (size_t band = 0; band < m_bandValues.size(); band++) {
+        float dB = 20.0f * std::log10(amplitudes[band] + 1e-10f);
+
+        // -80 dB (quiet) -> 0, -20 dB (loud) -> 1
+        float normalized = std::clamp((dB + 80.0f) / 60.0f, 0.0f, 1.0f);
+
+        m_bandValues[band] = m_bandValues[band] * m_smoothing + normalized * (1.0f - m_smoothing);
+        m_bandPeaks[band] = std::max(m_bandPeaks[band] * m_peakDecay, m_bandValues[band]);
+    }
+}
+
+SpectrumAnalyzer::Snapshot SpectrumAnalyzer::getSnapshot() const {
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    return m_snapshots[m_front];
+}
+
+void SpectrumAnalyzer::clear() {
+    m_clearRequested = true;
+
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    Snapshot& front = m_snapshots[m_front];
+    std::fill(front.bands.begin(), front.bands.end(), 0.0f);
+    std::fill(front.peaks.begin(), front.peaks.end(), 0.0f);
+}
+
+bool SpectrumAnalyzer::setStftConfig(const Stft::Config& config) {
+    if (!Stft::isValid(config)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    m_pendingConfig = config;
+    m_configPending = true;
+    return true;
+}
+
+Stft::Config SpectrumAnalyzer::getStftConfig() const {
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    return m_pendingConfig;
+}
+
+void SpectrumAnalyzer::computeBandRanges(int sampleRate) {
+    const Stft::Config& config = m_stft.getConfig();
+    const int fftSize = static_cast<int>(config.fftSize);
+    const size_t bandCount = m_bandCenters.size();
+    const float freqPerBin = static_cast<float>(sampleRate) / fftSize;
+    m_binStart.resize(bandCount);
+    m_binEnd.resize(bandCount);
+
+    for (size_t band = 0; band < bandCount; band++) {
+        float freqStart = (band == 0) ? MIN_FREQ : std::sqrt(m_bandCenters[band - 1] * m_bandCenters[band]);
+        float freqEnd = (band + 1 == bandCount) ? MAX_FREQ : std::sqrt(m_bandCenters[band] * m_bandCenters[band + 1]);
+        m_binStart[band] = std::clamp(static_cast<int>(freqStart / freqPerBin), 0, fftSize / 2 - 1);
+        m_binEnd[band] = std::clamp(static_cast<int>(freqEnd / freqPerBin), 0, fftSize / 2 - 1);
+    }
+
+    updateTimeConstants(sampleRate);
+    m_rangesSampleRate = sampleRate;
+    m_rangesFftSize = config.fftSize;
+}
+
+void SpectrumAnalyzer::updateTimeConstants(int sampleRate) {
+    // Per-frame smoothing for the time constants at this hop and rate
+    float frameSeconds = static_cast<float>(m_stft.getConfig().hop) / sampleRate;
+    m_smoothing = std::exp(-frameSeconds / SMOOTHING_SECONDS);
+    m_peakDecay = std::exp(-frameSeconds / PEAK_DECAY_SECONDS);
+}
+
+void SpectrumAnalyzer::applyBandSource(BandSource source, int sampleRate) {
+    m_requestedSource = source;
+    m_sourceRate = sampleRate;
+
+    // A bank the rate can't hold falls back to the FFT bands
+    if (source != BandSource::Fft && m_octaveBank.configure(static_cast<int>(source), sampleRate)) {
+        m_activeCenters = m_octaveBank.getCenters();
+    } else {
+        source = BandSource::Fft;
+        m_activeCenters = m_bandCenters;
+        m_rangesFftSize = 0;
+    }
+    m_activeSource = source;
+    m_octaveFill = 0;
+    updateTimeConstants(sampleRate);
+
+    const size_t bandCount = m_activeCenters.size();
+    m_bandValues.assign(bandCount, 0.0f);
+    m_bandPeaks.assign(bandCount, 0.0f);
+    m_bandAmplitudes.assign(bandCount, 0.0f);
+}
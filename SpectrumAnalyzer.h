@@ -0,0 +1,144 @@
+#pragma once
+#include "FractionalOctaveBank.h"
+#include "SpscRingBuffer.h"
+#include "Stft.h"
+#include "Spectrogram.h"
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <cstdint>
+
+// Spectrum analysis for the analyzer display, kept off the audio thread. The
+// audio callback only copies post-mix samples into a lock-free ring; a
+// low-priority worker drains it into an overlapped STFT and reduces each
+// frame's magnitudes to bands and to a spectrogram column. Smoothing and
+// peak decay are time constants applied per STFT frame, so the display
+// responds the same whatever the device buffer size or how often the worker
+// wakes. Band results go into a double buffer: the worker fills the back
+// snapshot without holding anything and swaps it in under a short lock, and
+// the UI copies the front one when it draws.
+//
+// The bars come either from FFT bins averaged into the bands given at
+// construction, or from a 1/3- or 1/6-octave filter bank fed the same mono
+// signal, which resolves the low end far better; the STFT keeps running for
+// the spectrogram either way.
+//
+// pushSamples() is the only call made from the audio thread.
+class SpectrumAnalyzer {
+public:
+    // Default STFT setup
+    static constexpr int FFT_SIZE = 4096;
+    static constexpr size_t ANALYSIS_HOP = 1024;          // New frames per STFT frame
+    static constexpr size_t RING_FRAMES = FFT_SIZE * 4;   // Slack for the worker waking late
+    static constexpr int WORKER_INTERVAL_MS = 15;
+
+    // Value = bands per octave for the filter banks
+    enum class BandSource { Fft = 0, ThirdOctave = 3, SixthOctave = 6 };
+
+    struct Snapshot {
+        std::vector<float> bands;    // 0.0 to 1.0, smoothed
+        std::vector<float> peaks;    // Decaying band peaks
+        std::vector<float> centers;  // Band centre frequencies (Hz)
+        BandSource source = BandSource::Fft;
+        uint64_t sequence = 0;       // Incremented per analysis
+    };
+
+    using UpdateCallback = std::function<void()>;
+
+    // Bands are centred on the given frequencies, edges halfway (geometrically)
+    // between neighbours
+    explicit SpectrumAnalyzer(const std::vector<float>& bandCenters);
+    ~SpectrumAnalyzer();
+
+    SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+    SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+
+    // Worker thread; the update callback runs on it after each new snapshot
+    void start();
+    void stop();
+    void setUpdateCallback(UpdateCallback callback) { m_updateCallback = callback; }
+
+    // Audio thread: interleaved stereo post-mix samples. Never blocks; drops
+    // input if the worker has fallen behind.
+    void pushSamples(const float* samples, size_t sampleCount, int sampleRate);
+
+    // Worker side: analyse if enough new input arrived. Returns true when a
+    // new snapshot was published. Called by the worker, or directly in tests.
+    bool analyzePending();
+
+    Snapshot getSnapshot() const;
+    void clear();
+
+    // One column per STFT frame, written by the worker; safe to read anywhere
+    const Spectrogram& getSpectrogram() const { return m_spectrogram; }
+
+    // FFT size, window and hop. Applied by the worker before its next pass;
+    // returns false for a config Stft rejects.
+    bool setStftConfig(const Stft::Config& config);
+    Stft::Config getStftConfig() const;
+
+    // Any thread; the worker switches before its next pass
+    void setBandSource(BandSource source) { m_bandSource = source; }
+    BandSource getBandSource() const { return m_bandSource; }
+
+    uint64_t getDroppedFrames() const { return m_droppedFrames; }
+
+private:
+    void workerLoop();
+    void computeBandRanges(int sampleRate);
+    void updateTimeConstants(int sampleRate);
+    void applyBandSource(BandSource source, int sampleRate);
+    void analyzeFrame(const float* magnitudes, int sampleRate);
+    // One analysis frame of per-band amplitudes (1.0 = full-scale sine)
+    void updateBands(const float* amplitudes);
+
+    static constexpr float MIN_FREQ = 20.0f;
+    static constexpr float MAX_FREQ = 20000.0f;
+    static constexpr float SMOOTHING_SECONDS = 0.065f;   // Band response time constant
+    static constexpr float PEAK_DECAY_SECONDS = 0.45f;   // Peak fall time constant
+
+    // Audio thread -> worker (interleaved stereo)
+    SpscRingBuffer<float> m_ring;
+    std::atomic<int> m_sampleRate{44100};
+    std::atomic<uint64_t> m_droppedFrames{0};
+    std::atomic<bool> m_clearRequested{false};
+    std::atomic<BandSource> m_bandSource{BandSource::Fft};
+
+    // Worker-only state
+    std::vector<float> m_bandCenters;
+    std::vector<float> m_readBlock;
+    std::vector<float> m_monoBlock;
+    Stft m_stft;
+    Spectrogram m_spectrogram;
+    std::vector<int> m_binStart;
+    std::vector<int> m_binEnd;
+    std::vector<float> m_bandValues;
+    std::vector<float> m_bandPeaks;
+    std::vector<float> m_bandAmplitudes;
+    BandSource m_requestedSource = BandSource::Fft;
+    BandSource m_activeSource = BandSource::Fft;  // Fft if the bank couldn't be set up
+    int m_sourceRate = 0;
+    std::vector<float> m_activeCenters;
+    FractionalOctaveBank m_octaveBank;
+    size_t m_octaveFill = 0;     // Frames into the current analysis hop
+    int m_rangesSampleRate = 0;
+    size_t m_rangesFftSize = 0;
+    float m_smoothing = 0.0f;    // Per-frame coefficients for the current hop and rate
+    float m_peakDecay = 0.0f;
+
+    // UI -> worker config handoff
+    mutable std::mutex m_configMutex;
+    Stft::Config m_pendingConfig;
+    std::atomic<bool> m_configPending{false};
+
+    // Double-buffered results: the worker owns the back snapshot
+    Snapshot m_snapshots[2];
+    int m_front = 0;
+    mutable std::mutex m_snapshotMutex;  // Guards m_front and reads of the front snapshot
+
+    std::thread m_worker;
+    std::atomic<bool> m_running{false};
+    UpdateCallback m_updateCallback;
+};
@@ -2,297 +2,172 @@
 #include <cmath>
 #include <algorithm>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-SpectrumWindow::SpectrumWindow() {
-    m_fftBuffer.resize(FFT_SIZE);
-    m_magnitudes.resize(FFT_SIZE / 2);
-    m_bandValues.resize(NUM_BANDS, 0.0f);
-    m_bandPeaks.resize(NUM_BANDS, 0.0f);
-    m_bandFreqs.resize(NUM_BANDS);
-
-    // Pre-allocate audio sample buffer (avoids per-frame allocation)
-    m_audioSampleBuffer.resize(FFT_SIZE, 0.0f);
-
-    // Use standard ISO graphic EQ center frequencies
-    for (int i = 0; i < NUM_BANDS; i++) {
-        m_bandFreqs[i] = BAND_FREQUENCIES[i];
-    }
-
-    // Pre-compute band frequency ranges (avoids per-frame sqrt calculations)
-    for (int band = 0; band < NUM_BANDS; band++) {
-        if (band == 0) {
-            m_bandRanges[band].freqStart = MIN_FREQ;
-            m_bandRanges[band].freqEnd = std::sqrt(BAND_FREQUENCIES[0] * BAND_FREQUENCIES[1]);
-        } else if (band == NUM_BANDS - 1) {
-            m_bandRanges[band].freqStart = std::sqrt(BAND_FREQUENCIES[NUM_BANDS - 2] * BAND_FREQUENCIES[NUM_BANDS - 1]);
-            m_bandRanges[band].freqEnd = MAX_FREQ;
-        } else {
-            m_bandRanges[band].freqStart = std::sqrt(BAND_FREQUENCIES[band - 1] * BAND_FREQUENCIES[band]);
-            m_bandRanges[band].freqEnd = std::sqrt(BAND_FREQUENCIES[band] * BAND_FREQUENCIES[band + 1]);
-        }
-    }
-
-    // Pre-compute FFT twiddle factors for forward transform (avoids per-FFT sin/cos)
-    // For each FFT stage (len = 2, 4, 8, ..., FFT_SIZE)
-    int numStages = 0;
-    for (int len = 2; len <= FFT_SIZE; len *= 2) {
-        numStages++;
-    }
-    m_twiddleFactors.resize(numStages);
-
-    int stage = 0;
-    for (int len = 2; len <= FFT_SIZE; len *= 2) {
-        int halfLen = len / 2;
-        m_twiddleFactors[stage].resize(halfLen);
-
-        float angle = -2.0f * M_PI / len; // Forward FFT uses negative angle
-        for (int j = 0; j < halfLen; j++) {
-            float theta = angle * j;
-            m_twiddleFactors[stage][j] = std::complex<float>(std::cos(theta), std::sin(theta));
-        }
-        stage++;
-    }
-
+SpectrumWindow::SpectrumWindow()
+    : m_analyzer(std::vector<float>(BAND_FREQUENCIES.begin(), BAND_FREQUENCIES.end())),
+      m_linearEQ(std::vector<float>(BAND_FREQUENCIES.begin(), BAND_FREQUENCIES.end()), Q_FACTOR) {
     // Initialize EQ gains to 0 dB (flat response)
     m_eqGains.fill(0.0f);
+
+    // Repaint whenever the worker has a new snapshot
+    m_analyzer.setUpdateCallback([this]() { invalidate(); });
+    m_analyzer.start();
 }
 
 SpectrumWindow::~SpectrumWindow() {
+    m_analyzer.stop();
+    onDiscardDeviceResources();
+}
+
+void SpectrumWindow::onDiscardDeviceResources() {
+    if (m_spectrogramBitmap) {
+        m_spectrogramBitmap->Release();
+        m_spectrogramBitmap = nullptr;
+    }
 }
 
 void SpectrumWindow::clear() {
-    std::lock_guard<std::mutex> lock(m_dataMutex);
-    std::fill(m_bandValues.begin(), m_bandValues.end(), 0.0f);
-    std::fill(m_bandPeaks.begin(), m_bandPeaks.end(), 0.0f);
+    m_analyzer.clear();
     invalidate();
 }
 
 void SpectrumWindow::updateSpectrum(const float* samples, size_t sampleCount, int sampleRate) {
-    if (!samples || sampleCount == 0) {
-        return;
-    }
-
-    m_sampleRate = sampleRate;
-
-    // Use pre-allocated buffer instead of creating new vector
-    std::fill(m_audioSampleBuffer.begin(), m_audioSampleBuffer.end(), 0.0f);
-
-    // Assuming stereo interleaved: sampleCount is total samples, frames = sampleCount / 2
-    size_t frameCount = sampleCount / 2;
-    size_t copyFrames = std::min(frameCount, static_cast<size_t>(FFT_SIZE));
+    m_analyzer.pushSamples(samples, sampleCount, sampleRate);
+}
 
-    // Convert stereo to mono (averaging left and right channels)
-    for (size_t i = 0; i < copyFrames; i++) {
-        m_audioSampleBuffer[i] = (samples[i * 2] + samples[i * 2 + 1]) * 0.5f;
+void SpectrumWindow::publishFilters() {
+    // Caller holds m_dataMutex, which also keeps publishers one at a time
+    std::array<BiquadCascade::Coefficients, NUM_BANDS> stages;
+    for (int i = 0; i < NUM_BANDS; i++) {
+        stages[i] = BiquadCascade::peakingEQ(BAND_FREQUENCIES[i], m_eqGains[i], Q_FACTOR,
+                                             static_cast<float>(m_sampleRate));
     }
-
-    performFFT(m_audioSampleBuffer);
-    invalidate();
+    m_eq.publish(stages.data(), NUM_BANDS);
+    m_linearEQ.setGains(m_eqGains.data(), NUM_BANDS);
 }
 
-void SpectrumWindow::performFFT(const std::vector<float>& samples) {
-    // Reuse class member buffers (already pre-allocated in constructor)
-    // Apply Hann window and copy to FFT buffer
-    for (int i = 0; i < FFT_SIZE; i++) {
-        float window = 0.5f * (1.0f - std::cos(2.0f * M_PI * i / (FFT_SIZE - 1)));
-        m_fftBuffer[i] = std::complex<float>(samples[i] * window, 0.0f);
+void SpectrumWindow::setLinearPhase(bool enabled) {
+    if (enabled) {
+        m_linearEQ.start();  // Designs the current curve before the switch
     }
-
-    // Perform FFT (expensive operation, uses pre-computed twiddle factors)
-    fft(m_fftBuffer, false);
-
-    // Calculate magnitudes (lock is inside calculateBands)
-    {
-        std::lock_guard<std::mutex> lock(m_dataMutex);
-        for (int i = 0; i < FFT_SIZE / 2; i++) {
-            float real = m_fftBuffer[i].real();
-            float imag = m_fftBuffer[i].imag();
-            m_magnitudes[i] = std::sqrt(real * real + imag * imag);
-        }
-        calculateBands();
+    else {
+        // No new designs are needed; the audio thread fades out on the last one
+        m_linearEQ.stop();
+    }
+    m_linearPhase = enabled;
+    if (m_changeCallback) {
+        m_changeCallback();
     }
+    invalidate();
 }
 
-void SpectrumWindow::fft(std::vector<std::complex<float>>& buffer, bool inverse) {
-    int n = static_cast<int>(buffer.size());
-
-    // Bit-reversal permutation
-    int j = 0;
-    for (int i = 0; i < n - 1; i++) {
-        if (i < j) {
-            std::swap(buffer[i], buffer[j]);
-        }
-        int k = n / 2;
-        while (k <= j) {
-            j -= k;
-            k /= 2;
+void SpectrumWindow::applyEQ(float* samples, size_t frameCount, int sampleRate) {
+    // Sliders publish new coefficients from the UI thread. Only a sample rate
+    // change is handled here, and try_lock keeps that from ever blocking: if
+    // the UI holds the lock, the next block tries again.
+    if (sampleRate != m_eqSampleRate) {
+        std::unique_lock<CheckedMutex> lock(m_dataMutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            m_sampleRate = sampleRate;
+            publishFilters();
+            m_eqSampleRate = sampleRate;
         }
-        j += k;
     }
 
-    // FFT computation using pre-computed twiddle factors (forward only)
-    if (!inverse && n == FFT_SIZE && !m_twiddleFactors.empty()) {
-        // Use pre-computed twiddle factors for forward FFT
-        int stage = 0;
-        for (int len = 2; len <= n; len *= 2) {
-            int halfLen = len / 2;
-            for (int i = 0; i < n; i += len) {
-                for (int j = 0; j < halfLen; j++) {
-                    std::complex<float> w = m_twiddleFactors[stage][j];
-                    std::complex<float> u = buffer[i + j];
-                    std::complex<float> v = buffer[i + j + halfLen] * w;
-                    buffer[i + j] = u + v;
-                    buffer[i + j + halfLen] = u - v;
-                }
-            }
-            stage++;
-        }
-    } else {
-        // Fallback to runtime computation (for inverse or non-standard sizes)
-        float sign = inverse ? 1.0f : -1.0f;
-        for (int len = 2; len <= n; len *= 2) {
-            float angle = sign * 2.0f * M_PI / len;
-            std::complex<float> wlen(std::cos(angle), std::sin(angle));
-
-            for (int i = 0; i < n; i += len) {
-                std::complex<float> w(1.0f, 0.0f);
-                for (int j = 0; j < len / 2; j++) {
-                    std::complex<float> u = buffer[i + j];
-                    std::complex<float> v = buffer[i + j + len / 2] * w;
-                    buffer[i + j] = u + v;
-                    buffer[i + j + len / 2] = u - v;
-                    w *= wlen;
-                }
-            }
-        }
+    const bool linear = m_linearPhase.load(std::memory_order_relaxed);
+    if (linear && !m_linearPhaseActive) {
+        // Start from silence rather than whatever it last saw
+        m_linearEQ.reset();
+        m_linearPrimedFrames = 0;
+        m_linearPhaseActive = true;
+    }
 
-        if (inverse) {
-            for (int i = 0; i < n; i++) {
-                buffer[i] /= static_cast<float>(n);
-            }
-        }
+    // Settled in linear phase: only the linear EQ runs
+    if (linear && m_linearMix >= 1.0f) {
+        m_linearEQ.process(samples, frameCount, sampleRate);
+        m_minimumPhaseActive = false;
+        return;
     }
-}
 
-void SpectrumWindow::calculateBands() {
-    float freqPerBin = static_cast<float>(m_sampleRate) / FFT_SIZE;
-
-    for (int band = 0; band < NUM_BANDS; band++) {
-        // Use pre-computed band frequency ranges (avoids per-frame sqrt calculations)
-        float freqStart = m_bandRanges[band].freqStart;
-        float freqEnd = m_bandRanges[band].freqEnd;
-
-        // Find corresponding FFT bins
-        int binStart = static_cast<int>(freqStart / freqPerBin);
-        int binEnd = static_cast<int>(freqEnd / freqPerBin);
-        binStart = std::max(0, std::min(binStart, FFT_SIZE / 2 - 1));
-        binEnd = std::max(0, std::min(binEnd, FFT_SIZE / 2 - 1));
-
-        // Average magnitude in this frequency range
-        float sum = 0.0f;
-        int count = 0;
-        for (int bin = binStart; bin <= binEnd; bin++) {
-            sum += m_magnitudes[bin];
-            count++;
+    // Switching one way or the other
+    if (m_linearPhaseActive) {
+        if (!m_minimumPhaseActive) {
+            m_eq.reset();
+            m_minimumPhaseActive = true;
         }
+        crossfadeModes(samples, frameCount, sampleRate, linear);
+        return;
+    }
 
-        float avgMagnitude = (count > 0) ? (sum / count) : 0.0f;
-
-        // Normalize magnitude relative to FFT size
-        // For a full-scale signal, FFT magnitude is approximately FFT_SIZE/2 after windowing
-        float normalizedMag = avgMagnitude / (FFT_SIZE / 4.0f);
-
-        // Convert to dB scale (with better range for typical audio)
-        float dB = 20.0f * std::log10(normalizedMag + 1e-10f);
-
-        // Map dB range to 0-1 (adjusted for better visualization)
-        // -80dB (quiet) -> 0, -20dB (loud) -> 1
-        float normalized = (dB + 80.0f) / 60.0f;
-        normalized = std::max(0.0f, std::min(1.0f, normalized));
+    // All bands in series, left and right side by side; flat bands are
+    // skipped and a published change ramps in across this block
+    m_eq.process(samples, frameCount, 2);
+}
 
-        // Apply smoothing
-        m_bandValues[band] = m_bandValues[band] * SMOOTHING + normalized * (1.0f - SMOOTHING);
+void SpectrumWindow::crossfadeModes(float* samples, size_t frameCount, int sampleRate, bool toLinear) {
+    const size_t latency = LinearPhaseEQ::getLatencyFrames();
+    const float step = 1.0f / MODE_CROSSFADE_FRAMES;
+
+    for (size_t start = 0; start < frameCount; start += MODE_CHUNK_FRAMES) {
+        const size_t frames = std::min(MODE_CHUNK_FRAMES, frameCount - start);
+        float* chunk = samples + start * 2;
+        std::copy(chunk, chunk + frames * 2, m_linearScratch);
+        m_eq.process(chunk, frames, 2);
+        m_linearEQ.process(m_linearScratch, frames, sampleRate);
+
+        for (size_t i = 0; i < frames; ++i) {
+            // The linear EQ is silent until its latency has passed, so it
+            // only fades in after that
+            if (!toLinear) {
+                m_linearMix = std::max(m_linearMix - step, 0.0f);
+            }
+            else if (m_linearPrimedFrames >= latency) {
+                m_linearMix = std::min(m_linearMix + step, 1.0f);
+            }
+            ++m_linearPrimedFrames;
 
-        // Update peaks with decay
-        m_bandPeaks[band] *= PEAK_DECAY;
-        if (m_bandValues[band] > m_bandPeaks[band]) {
-            m_bandPeaks[band] = m_bandValues[band];
+            for (size_t ch = 0; ch < 2; ++ch) {
+                float& out = chunk[i * 2 + ch];
+                out += m_linearMix * (m_linearScratch[i * 2 + ch] - out);
+            }
         }
     }
-}
-
-void SpectrumWindow::BiquadFilter::calculatePeakingEQ(float centerFreq, float gainDB, float Q, float sampleRate) {
-    float A = std::pow(10.0f, gainDB / 40.0f);  // sqrt of linear gain
-    float omega = 2.0f * M_PI * centerFreq / sampleRate;
-    float sinOmega = std::sin(omega);
-    float cosOmega = std::cos(omega);
-    float alpha = sinOmega / (2.0f * Q);
-
-    // RBJ Audio EQ Cookbook - Peaking EQ
-    float a0 = 1.0f + alpha / A;
-    b0 = (1.0f + alpha * A) / a0;
-    b1 = (-2.0f * cosOmega) / a0;
-    b2 = (1.0f - alpha * A) / a0;
-    a1 = (-2.0f * cosOmega) / a0;
-    a2 = (1.0f - alpha / A) / a0;
-}
-
-float SpectrumWindow::BiquadFilter::process(float input, float& z1, float& z2) {
-    // Direct Form II Transposed
-    float output = input * b0 + z1;
-    z1 = input * b1 + z2 - a1 * output;
-    z2 = input * b2 - a2 * output;
-    return output;
-}
 
-void SpectrumWindow::updateFilters() {
-    std::lock_guard<std::mutex> lock(m_dataMutex);
-    for (int i = 0; i < NUM_BANDS; i++) {
-        m_filters[i].calculatePeakingEQ(BAND_FREQUENCIES[i], m_eqGains[i], Q_FACTOR, m_sampleRate);
+    // Back in minimum phase: the linear EQ can stop
+    if (!toLinear && m_linearMix <= 0.0f) {
+        m_linearPhaseActive = false;
     }
-    m_filtersInitialized = true;
 }
 
-void SpectrumWindow::applyEQ(float* samples, size_t frameCount, int sampleRate) {
-    bool needsUpdate = false;
-
+std::function<void(float*, size_t, int)> SpectrumWindow::createOfflineEQ(int sampleRate, size_t& latencyFrames) {
+    std::array<float, NUM_BANDS> gains;
     {
-        std::lock_guard<std::mutex> lock(m_dataMutex);
-        if (m_sampleRate != sampleRate) {
-            m_sampleRate = sampleRate;
-            m_filtersInitialized = false;
-        }
-        needsUpdate = !m_filtersInitialized;
+        std::lock_guard<CheckedMutex> lock(m_dataMutex);
+        gains = m_eqGains;
     }
 
-    if (needsUpdate) {
-        updateFilters();  // This also locks the mutex
+    if (m_linearPhase) {
+        auto eq = std::make_shared<LinearPhaseEQ>(std::vector<float>(BAND_FREQUENCIES.begin(), BAND_FREQUENCIES.end()),
+                                                  Q_FACTOR);
+        eq->setGains(gains.data(), NUM_BANDS);
+        eq->prepare(sampleRate);
+        latencyFrames = LinearPhaseEQ::getLatencyFrames();
+        return [eq](float* samples, size_t frameCount, int rate) { eq->process(samples, frameCount, rate); };
     }
 
-    // Process audio - filters are stable once initialized, so we can read without lock
-    // The filter coefficients won't change mid-processing because updateFilters() is protected
-    for (size_t frame = 0; frame < frameCount; frame++) {
-        float left = samples[frame * 2];
-        float right = samples[frame * 2 + 1];
-
-        // Apply all EQ bands in series
-        for (int band = 0; band < NUM_BANDS; band++) {
-            left = m_filters[band].process(left, m_filters[band].z1_L, m_filters[band].z2_L);
-            right = m_filters[band].process(right, m_filters[band].z1_R, m_filters[band].z2_R);
-        }
-
-        samples[frame * 2] = left;
-        samples[frame * 2 + 1] = right;
+    std::array<BiquadCascade::Coefficients, NUM_BANDS> stages;
+    for (int i = 0; i < NUM_BANDS; i++) {
+        stages[i] = BiquadCascade::peakingEQ(BAND_FREQUENCIES[i], gains[i], Q_FACTOR, static_cast<float>(sampleRate));
     }
+    auto eq = std::make_shared<BiquadCascade>();
+    eq->setStages(stages.data(), NUM_BANDS);
+    latencyFrames = 0;
+    return [eq](float* samples, size_t frameCount, int) { eq->process(samples, frameCount, 2); };
 }
 
 int SpectrumWindow::getSliderAtPosition(int x, int y) {
     float margin = 20.0f;
     float topMargin = 40.0f;
-    float bottomMargin = 60.0f;
+    float bottomMargin = 60.0f + SPECTROGRAM_HEIGHT;
     float width = static_cast<float>(getWidth());
     float height = static_cast<float>(getHeight());
     float usableWidth = width - 2 * margin;
@@ -321,7 +196,7 @@ int SpectrumWindow::getSliderAtPosition(int x, int y) {
 
 float SpectrumWindow::getGainFromY(int y) {
     float topMargin = 40.0f;
-    float bottomMargin = 60.0f;
+    float bottomMargin = 60.0f + SPECTROGRAM_HEIGHT;
     float height = static_cast<float>(getHeight());
     float usableHeight = height - topMargin - bottomMargin;
 
@@ -337,17 +212,19 @@ float SpectrumWindow::getGainFromY(int y) {
 
 void SpectrumWindow::onRender(ID2D1RenderTarget* rt) {
     // Copy data we need for rendering (minimize critical section)
-    std::array<float, NUM_BANDS> bandValuesCopy;
+    SpectrumAnalyzer::Snapshot spectrum = m_analyzer.getSnapshot();
+    const std::vector<float>& bandValuesCopy = spectrum.bands;
     std::array<float, NUM_BANDS> eqGainsCopy;
     int draggedSliderCopy;
     bool isDraggingCopy;
+    int sampleRateCopy;
 
     {
-        std::lock_guard<std::mutex> lock(m_dataMutex);
-        std::copy(m_bandValues.begin(), m_bandValues.begin() + NUM_BANDS, bandValuesCopy.begin());
+        std::lock_guard<CheckedMutex> lock(m_dataMutex);
         eqGainsCopy = m_eqGains;
         draggedSliderCopy = m_draggedSlider;
         isDraggingCopy = m_isDragging;
+        sampleRateCopy = m_sampleRate;
     }
 
     // All rendering happens outside the lock
@@ -356,12 +233,19 @@ void SpectrumWindow::onRender(ID2D1RenderTarget* rt) {
              DAWColors::Background);
 
     // Draw title
-    drawText(L"12-Band Graphic Equalizer", 10, 10, DAWColors::TextPrimary);
+    if (m_linearPhase) {
+        wchar_t title[96];
+        swprintf(title, 96, L"12-Band Graphic Equalizer (linear phase, %.0f ms latency)",
+                 1000.0 * LinearPhaseEQ::getLatencyFrames() / sampleRateCopy);
+        drawText(title, 10, 10, DAWColors::TextPrimary);
+    } else {
+        drawText(L"12-Band Graphic Equalizer", 10, 10, DAWColors::TextPrimary);
+    }
 
     // Calculate dimensions
     float margin = 20.0f;
     float topMargin = 40.0f;
-    float bottomMargin = 60.0f;
+    float bottomMargin = 60.0f + SPECTROGRAM_HEIGHT;
     float width = static_cast<float>(getWidth());
     float height = static_cast<float>(getHeight());
     float usableWidth = width - 2 * margin;
@@ -402,9 +286,18 @@ void SpectrumWindow::onRender(ID2D1RenderTarget* rt) {
         drawText(label, x, height - bottomMargin + 10, DAWColors::TextSecondary);
     }
 
-    // Draw spectrum bars (dimmed, in background)
-    for (int i = 0; i < NUM_BANDS; i++) {
+    // Draw spectrum bars (dimmed, in background). Filter-bank bands sit on
+    // the same log axis as the sliders, one column per octave from 31.5 Hz.
+    const bool fractional = spectrum.source != SpectrumAnalyzer::BandSource::Fft;
+    const float bandsPerOctave = static_cast<float>(spectrum.source);
+    for (size_t i = 0; i < bandValuesCopy.size(); i++) {
         float x = margin + i * barWidth + barSpacing / 2;
+        float actualWidth = barActualWidth;
+        if (fractional) {
+            float column = 0.5f + std::log2(spectrum.centers[i] / BAND_FREQUENCIES[0]);
+            actualWidth = barActualWidth / bandsPerOctave;
+            x = std::max(margin, margin + column * barWidth - actualWidth / 2);
+        }
         float barHeight = bandValuesCopy[i] * usableHeight;
         float y = height - bottomMargin - barHeight;
 
@@ -419,9 +312,11 @@ void SpectrumWindow::onRender(ID2D1RenderTarget* rt) {
             barColor = Color(1.0f * 0.3f, hue * 6.0f * 0.3f, 0.0f);
         }
 
-        fillRect(x, y, barActualWidth, barHeight, barColor);
+        fillRect(x, y, actualWidth, barHeight, barColor);
     }
 
+    drawSpectrogram(rt, margin, height - SPECTROGRAM_HEIGHT - 10.0f, usableWidth, SPECTROGRAM_HEIGHT);
+
     // Draw EQ sliders on top
     float sliderWidth = barActualWidth * 0.4f;
     for (int i = 0; i < NUM_BANDS; i++) {
@@ -452,6 +347,60 @@ void SpectrumWindow::onRender(ID2D1RenderTarget* rt) {
     }
 }
 
+void SpectrumWindow::drawSpectrogram(ID2D1RenderTarget* rt, float x, float y, float width, float height) {
+    const UINT32 rows = static_cast<UINT32>(Spectrogram::ROWS);
+    const Spectrogram& spectrogram = m_analyzer.getSpectrogram();
+    const uint64_t count = spectrogram.getColumnCount();
+
+    if (!m_spectrogramBitmap) {
+        // New (or recreated) target: start from background and replay the
+        // newest history still in the ring
+        std::vector<uint32_t> blank(static_cast<size_t>(VIEW_COLUMNS) * rows, Spectrogram::getPalette()[0]);
+        D2D1_BITMAP_PROPERTIES props = D2D1::BitmapProperties(
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_IGNORE));
+        if (FAILED(rt->CreateBitmap(D2D1::SizeU(VIEW_COLUMNS, rows), blank.data(), VIEW_COLUMNS * 4,
+                                    props, &m_spectrogramBitmap))) {
+            return;
+        }
+        m_spectrogramWriteX = 0;
+        m_spectrogramNext = count > VIEW_COLUMNS ? count - VIEW_COLUMNS : 0;
+        m_columnLevels.resize(rows);
+        m_columnPixels.resize(rows);
+    }
+
+    // Only columns the view can show are uploaded
+    if (count - m_spectrogramNext > VIEW_COLUMNS) {
+        m_spectrogramNext = count - VIEW_COLUMNS;
+    }
+    const auto& palette = Spectrogram::getPalette();
+    for (; m_spectrogramNext < count; ++m_spectrogramNext) {
+        if (!spectrogram.readColumn(m_spectrogramNext, m_columnLevels.data())) {
+            continue;
+        }
+        // Bitmap row 0 is the top, so highest frequency first
+        for (UINT32 row = 0; row < rows; ++row) {
+            m_columnPixels[row] = palette[m_columnLevels[rows - 1 - row]];
+        }
+        D2D1_RECT_U column = D2D1::RectU(m_spectrogramWriteX, 0, m_spectrogramWriteX + 1, rows);
+        m_spectrogramBitmap->CopyFromMemory(&column, m_columnPixels.data(), 4);
+        m_spectrogramWriteX = (m_spectrogramWriteX + 1) % VIEW_COLUMNS;
+    }
+
+    // Oldest column is at the write position: draw [writeX, end) then [0, writeX)
+    float columnWidth = width / VIEW_COLUMNS;
+    float split = x + (VIEW_COLUMNS - m_spectrogramWriteX) * columnWidth;
+    rt->DrawBitmap(m_spectrogramBitmap, D2D1::RectF(x, y, split, y + height), 1.0f,
+                   D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+                   D2D1::RectF(static_cast<float>(m_spectrogramWriteX), 0.0f,
+                               static_cast<float>(VIEW_COLUMNS), static_cast<float>(rows)));
+    if (m_spectrogramWriteX > 0) {
+        rt->DrawBitmap(m_spectrogramBitmap, D2D1::RectF(split, y, x + width, y + height), 1.0f,
+                       D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+                       D2D1::RectF(0.0f, 0.0f, static_cast<float>(m_spectrogramWriteX), static_cast<float>(rows)));
+    }
+    drawRect(x, y, width, height, DAWColors::GridLine);
+}
+
 void SpectrumWindow::onResize(int width, int height) {
     invalidate();
 }
@@ -468,9 +417,12 @@ void SpectrumWindow::onMouseDown(int x, int y, int button) {
         float newGain = getGainFromY(y);
         if (std::abs(m_eqGains[slider] - newGain) > 0.1f) {
             {
-                std::lock_guard<std::mutex> lock(m_dataMutex);
+                std::lock_guard<CheckedMutex> lock(m_dataMutex);
                 m_eqGains[slider] = newGain;
-                m_filtersInitialized = false;  // Force filter recalculation
+                publishFilters();
+            }
+            if (m_changeCallback) {
+                m_changeCallback();
             }
             invalidate();
         }
@@ -492,14 +444,17 @@ void SpectrumWindow::onMouseMove(int x, int y) {
         float newGain = getGainFromY(y);
         bool shouldUpdate = false;
         {
-            std::lock_guard<std::mutex> lock(m_dataMutex);
+            std::lock_guard<CheckedMutex> lock(m_dataMutex);
             if (std::abs(m_eqGains[m_draggedSlider] - newGain) > 0.1f) {
                 m_eqGains[m_draggedSlider] = newGain;
-                m_filtersInitialized = false;  // Force filter recalculation
+                publishFilters();
                 shouldUpdate = true;
             }
         }
         if (shouldUpdate) {
+            if (m_changeCallback) {
+                m_changeCallback();
+            }
             invalidate();
         }
     }
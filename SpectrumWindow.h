@@ -1,27 +1,55 @@
 #pragma once
+#include "BiquadCascade.h"
 #include "D2DWindow.h"
+#include "LinearPhaseEQ.h"
+#include "RealtimeCheck.h"
+#include "SpectrumAnalyzer.h"
 #include <vector>
-#include <complex>
 #include <mutex>
 #include <array>
+#include <functional>
+#include <memory>
 
 class SpectrumWindow : public D2DWindow {
 public:
     SpectrumWindow();
     ~SpectrumWindow() override;
 
-    // Update spectrum with new audio samples
+    // Queue post-mix samples for analysis (audio thread; never blocks)
     void updateSpectrum(const float* samples, size_t sampleCount, int sampleRate);
 
     // Clear the spectrum display
     void clear();
 
+    // STFT size, window and hop; false (no change) if unsupported
+    bool setAnalysisConfig(const Stft::Config& config) { return m_analyzer.setStftConfig(config); }
+
+    // Where the bars come from: FFT bins per EQ band, or a fractional-octave bank
+    void setBandSource(SpectrumAnalyzer::BandSource source) { m_analyzer.setBandSource(source); }
+    SpectrumAnalyzer::BandSource getBandSource() const { return m_analyzer.getBandSource(); }
+
     // Get EQ gains for audio processing (in dB, -12 to +12)
     const std::array<float, 12>& getEQGains() const { return m_eqGains; }
 
     // Apply EQ to stereo audio buffer (interleaved L/R)
     void applyEQ(float* samples, size_t frameCount, int sampleRate);
 
+    // Linear-phase mode (for mastering): no phase shift, at the cost of
+    // getEQLatencyFrames() of delay on everything through the EQ
+    void setLinearPhase(bool enabled);
+    bool isLinearPhase() const { return m_linearPhase; }
+    size_t getEQLatencyFrames() const { return m_linearPhase ? LinearPhaseEQ::getLatencyFrames() : 0; }
+
+    // Called on the UI thread after the EQ curve or mode changes, so audio
+    // already mixed ahead through the old EQ can be re-rendered
+    using ChangeCallback = std::function<void()>;
+    void setChangeCallback(ChangeCallback callback) { m_changeCallback = callback; }
+
+    // A separate EQ with the current curve and mode for offline rendering
+    // (stem export), so the live filters are not disturbed. latencyFrames
+    // receives its delay; the returned processor has the applyEQ() signature.
+    std::function<void(float*, size_t, int)> createOfflineEQ(int sampleRate, size_t& latencyFrames);
+
 protected:
     void onRender(ID2D1RenderTarget* rt) override;
     void onResize(int width, int height) override;
@@ -29,35 +57,24 @@ protected:
     void onMouseUp(int x, int y, int button) override;
     void onMouseMove(int x, int y) override;
     bool onClose() override { return true; }  // Hide instead of destroy
+    void onDiscardDeviceResources() override;
 
 private:
-    // FFT implementation
-    void performFFT(const std::vector<float>& samples);
-    void fft(std::vector<std::complex<float>>& buffer, bool inverse = false);
-
-    // Calculate frequency bands from FFT results
-    void calculateBands();
-
-    // Biquad filter for each EQ band
-    struct BiquadFilter {
-        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;  // Numerator coefficients
-        float a1 = 0.0f, a2 = 0.0f;              // Denominator coefficients
-        float z1_L = 0.0f, z2_L = 0.0f;          // Left channel state
-        float z1_R = 0.0f, z2_R = 0.0f;          // Right channel state
-
-        void calculatePeakingEQ(float centerFreq, float gainDB, float Q, float sampleRate);
-        float process(float input, float& z1, float& z2);
-    };
+    // Design the bands for m_eqGains at m_sampleRate and hand them to the
+    // audio thread; m_dataMutex must be held
+    void publishFilters();
+
+    // Audio thread: both EQs over the block, mixed by m_linearMix as it
+    // moves towards the requested mode
+    void crossfadeModes(float* samples, size_t frameCount, int sampleRate, bool toLinear);
 
-    void updateFilters();
+    // Upload columns added since the last frame, then draw the ring in order
+    void drawSpectrogram(ID2D1RenderTarget* rt, float x, float y, float width, float height);
     int getSliderAtPosition(int x, int y);
     float getGainFromY(int y);
 
     // Constants
-    static constexpr int FFT_SIZE = 4096;
     static constexpr int NUM_BANDS = 12;
-    static constexpr float MIN_FREQ = 20.0f;
-    static constexpr float MAX_FREQ = 20000.0f;
 
     // Standard ISO graphic EQ center frequencies (Hz)
     static constexpr std::array<float, 12> BAND_FREQUENCIES = {
@@ -65,40 +82,45 @@ private:
         2000.0f, 4000.0f, 8000.0f, 16000.0f, 20000.0f, 20000.0f
     };
 
-    // FFT and spectrum data
-    std::vector<std::complex<float>> m_fftBuffer;
-    std::vector<float> m_magnitudes;
-    std::vector<float> m_bandValues;      // Current band values (0.0 to 1.0)
-    std::vector<float> m_bandPeaks;       // Peak values for each band
-    std::vector<float> m_bandFreqs;       // Center frequency for each band
-
-    // Pre-allocated buffer for stereo-to-mono conversion (avoids per-frame allocation)
-    std::vector<float> m_audioSampleBuffer;
-
-    // Pre-computed band frequency ranges (avoids per-frame sqrt calculations)
-    struct BandRange {
-        float freqStart;
-        float freqEnd;
-    };
-    std::array<BandRange, NUM_BANDS> m_bandRanges;
+    // FFT and band reduction run on the analyzer's worker thread
+    SpectrumAnalyzer m_analyzer;
 
-    // Pre-computed FFT twiddle factors (avoids per-FFT sin/cos calculations)
-    std::vector<std::vector<std::complex<float>>> m_twiddleFactors;
+    // Spectrogram strip: a VIEW_COLUMNS-wide bitmap used as a ring, one new
+    // column uploaded per STFT frame
+    static constexpr UINT32 VIEW_COLUMNS = 512;
+    static constexpr float SPECTROGRAM_HEIGHT = 120.0f;
+    ID2D1Bitmap* m_spectrogramBitmap = nullptr;
+    UINT32 m_spectrogramWriteX = 0;      // Next bitmap column to overwrite
+    uint64_t m_spectrogramNext = 0;      // Next Spectrogram column to upload
+    std::vector<uint8_t> m_columnLevels;
+    std::vector<uint32_t> m_columnPixels;
 
     // EQ data
     std::array<float, NUM_BANDS> m_eqGains;           // Gain in dB (-12 to +12)
-    std::array<BiquadFilter, NUM_BANDS> m_filters;    // One filter per band
-    bool m_filtersInitialized = false;
+    BiquadCascade m_eq;                               // One peaking stage per band
+    int m_eqSampleRate = 0;                           // Audio thread: rate m_eq was designed for
+    LinearPhaseEQ m_linearEQ;
+    std::atomic<bool> m_linearPhase{false};
+
+    // Switching modes crossfades rather than cutting. Turning linear phase on
+    // keeps the minimum-phase output until the linear EQ is past its
+    // start-up latency, then fades across; turning it off fades straight back.
+    static constexpr size_t MODE_CROSSFADE_FRAMES = 2048;
+    static constexpr size_t MODE_CHUNK_FRAMES = 256;
+    bool m_linearPhaseActive = false;                 // Audio thread: m_linearEQ has current input
+    bool m_minimumPhaseActive = true;                 // Audio thread: m_eq has current input
+    size_t m_linearPrimedFrames = 0;                  // Audio thread: input since m_linearEQ was reset
+    float m_linearMix = 0.0f;                         // Audio thread: 0 minimum phase .. 1 linear phase
+    float m_linearScratch[MODE_CHUNK_FRAMES * 2] = {};  // Audio thread: linear path while crossfading
+
+    ChangeCallback m_changeCallback;
 
     // UI interaction
     int m_draggedSlider = -1;
     bool m_isDragging = false;
 
-    std::mutex m_dataMutex;
+    CheckedMutex m_dataMutex{"SpectrumWindow::m_dataMutex"};
     int m_sampleRate = 44100;
 
-    // Smoothing
-    static constexpr float PEAK_DECAY = 0.95f;
-    static constexpr float SMOOTHING = 0.7f;
     static constexpr float Q_FACTOR = 1.414f;  // Q for peaking filters
 };
@@ -0,0 +1,104 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+
+// Lock-free single-producer / single-consumer ring buffer for real-time audio.
+// One thread may call write(), one other thread may call read()/discard();
+// neither ever blocks or allocates. Capacity is rounded up to a power of two
+// and positions are free-running counters, so full and empty are unambiguous.
+// The read and write indices live on separate cache lines to avoid false
+// sharing between the audio callback and the consumer thread.
+template <typename T>
+class SpscRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRingBuffer requires trivially copyable elements");
+
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    SpscRingBuffer() = default;
+    explicit SpscRingBuffer(size_t minCapacity) { resize(minCapacity); }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Allocate storage and clear. Not thread-safe: call while neither side is running.
+    void resize(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        m_buffer.assign(capacity, T{});
+        m_mask = capacity - 1;
+        reset();
+    }
+
+    // Drop all content. Not thread-safe: call while neither side is running.
+    void reset() {
+        m_writePos.store(0, std::memory_order_relaxed);
+        m_readPos.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return m_buffer.size(); }
+
+    size_t availableToRead() const {
+        return m_writePos.load(std::memory_order_acquire) - m_readPos.load(std::memory_order_acquire);
+    }
+
+    size_t availableToWrite() const {
+        return capacity() - availableToRead();
+    }
+
+    // Producer side. Copies as many elements as fit and returns the count written.
+    size_t write(const T* data, size_t count) {
+        size_t writePos = m_writePos.load(std::memory_order_relaxed);
+        size_t readPos = m_readPos.load(std::memory_order_acquire);
+        count = std::min(count, capacity() - (writePos - readPos));
+        if (count == 0) return 0;
+
+        // At most two contiguous copies (before and after the wrap point)
+        size_t offset = writePos & m_mask;
+        size_t firstPart = std::min(count, capacity() - offset);
+        memcpy(&m_buffer[offset], data, firstPart * sizeof(T));
+        memcpy(&m_buffer[0], data + firstPart, (count - firstPart) * sizeof(T));
+
+        m_writePos.store(writePos + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side. Copies up to count elements out and returns the count read.
+    size_t read(T* data, size_t count) {
+        size_t readPos = m_readPos.load(std::memory_order_relaxed);
+        size_t writePos = m_writePos.load(std::memory_order_acquire);
+        count = std::min(count, writePos - readPos);
+        if (count == 0) return 0;
+
+        size_t offset = readPos & m_mask;
+        size_t firstPart = std::min(count, capacity() - offset);
+        memcpy(data, &m_buffer[offset], firstPart * sizeof(T));
+        memcpy(data + firstPart, &m_buffer[0], (count - firstPart) * sizeof(T));
+
+        m_readPos.store(readPos + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side. Skips up to count elements and returns the count skipped.
+    size_t discard(size_t count) {
+        size_t readPos = m_readPos.load(std::memory_order_relaxed);
+        size_t writePos = m_writePos.load(std::memory_order_acquire);
+        count = std::min(count, writePos - readPos);
+        m_readPos.store(readPos + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::vector<T> m_buffer;
+    size_t m_mask = 0;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_writePos{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_readPos{0};
+    char m_padding[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)] = {};
+};
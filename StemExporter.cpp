@@ -0,0 +1,309 @@
+#include "StemExporter.h"
+#include "WavWriter.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <array>
+#include <set>
+#include <algorithm>
+
+namespace {
+
+struct Stem {
+    const Track* track = nullptr;
+    std::unique_ptr<TrackEQ> eq;  // Separate from the playback filter state
+    std::unique_ptr<ConvolutionReverb> reverb;  // Offline copy of the track's, if it has one
+};
+
+// One block of rendered audio travelling from the workers to the writers
+struct Slot {
+    size_t startFrame = 0;
+    size_t frameCount = 0;
+    size_t stemFrames = 0;    // Frames of the stems to write (the rest is past the end)
+    size_t masterOffset = 0;  // Leading frames of the master still inside the EQ latency
+    std::vector<std::vector<float>> stemBuffers;  // Interleaved stereo, one per stem
+    std::vector<float> master;
+    unsigned writersPending = 0;
+};
+
+} // namespace
+
+std::wstring StemExporter::sanitizeFileName(const std::wstring& name) {
+    std::wstring result = name;
+    for (auto& ch : result) {
+        if (ch < 32 || wcschr(L"\\/:*?\"<>|", ch)) {
+            ch = L'_';
+        }
+    }
+    return result.empty() ? L"Track" : result;
+}
+
+StemExporter::Result StemExporter::exportStems(const std::vector<std::shared_ptr<Track>>& tracks,
+                                               const Options& options,
+                                               ProgressCallback progress) {
+    Result result;
+
+    size_t totalFrames = static_cast<size_t>(options.duration * options.sampleRate);
+    if (totalFrames == 0 || options.blockFrames == 0) {
+        result.error = L"Nothing to export";
+        return result;
+    }
+
+    // Select the same tracks playback would hear (visible, not muted or armed, solo-filtered)
+    bool hasSolo = std::any_of(tracks.begin(), tracks.end(), [](const auto& track) {
+        return track->isSolo() && track->isVisible();
+    });
+
+    std::vector<Stem> stems;
+    for (const auto& track : tracks) {
+        if (!track->isVisible() || track->isMuted() || track->isArmed()) continue;
+        if (hasSolo && !track->isSolo()) continue;
+
+        Stem stem;
+        stem.track = track.get();
+        stem.eq = std::make_unique<TrackEQ>();
+        if (track->getReverb().hasImpulseResponse()) {
+            stem.reverb = std::make_unique<ConvolutionReverb>(true);
+            if (!track->getReverb().copyTo(*stem.reverb)) {
+                stem.reverb.reset();
+            }
+        }
+        stems.push_back(std::move(stem));
+    }
+
+    if (stems.empty()) {
+        result.error = L"No audible tracks to export";
+        return result;
+    }
+
+    // Open one writer per stem (plus the master mix)
+    AudioFormat format;
+    format.channels = 2;
+    format.sampleRate = options.sampleRate;
+
+    std::vector<std::unique_ptr<WavWriter>> writers;
+    std::set<std::wstring> usedNames;
+    for (const auto& stem : stems) {
+        std::wstring name = sanitizeFileName(stem.track->getName());
+        std::wstring uniqueName = name;
+        for (int suffix = 2; usedNames.count(uniqueName); ++suffix) {
+            uniqueName = name + L" (" + std::to_wstring(suffix) + L")";
+        }
+        usedNames.insert(uniqueName);
+
+        std::wstring filename = options.directory + L"\\" + options.baseName + L"_" + uniqueName + L".wav";
+        auto writer = std::make_unique<WavWriter>();
+        if (!writer->open(filename, format)) {
+            result.error = L"Failed to create " + filename;
+            return result;
+        }
+        result.files.push_back(filename);
+        writers.push_back(std::move(writer));
+    }
+
+    if (options.includeMaster) {
+        std::wstring filename = options.directory + L"\\" + options.baseName + L".wav";
+        auto writer = std::make_unique<WavWriter>();
+        if (!writer->open(filename, format)) {
+            result.error = L"Failed to create " + filename;
+            return result;
+        }
+        result.files.push_back(filename);
+        writers.push_back(std::move(writer));
+    }
+
+    // Master bus: an offline copy of the reverb and the caller's EQ. The EQ
+    // delays the master, so it is rendered that much longer and the start
+    // is dropped.
+    std::unique_ptr<ConvolutionReverb> masterReverb;
+    size_t masterLatency = 0;
+    if (options.includeMaster) {
+        if (options.masterReverb) {
+            masterReverb = std::make_unique<ConvolutionReverb>(true);
+            if (!options.masterReverb->copyTo(*masterReverb)) {
+                masterReverb.reset();
+            }
+        }
+        if (options.masterEQ) {
+            masterLatency = options.masterEQLatencyFrames;
+        }
+    }
+
+    // Like playback, every file runs on past the timeline until the reverb
+    // tails have died away: the longest track tail, then the master's
+    size_t tailFrames = 0;
+    for (const auto& stem : stems) {
+        if (stem.reverb) {
+            tailFrames = std::max(tailFrames, stem.reverb->getTailFrames());
+        }
+    }
+    if (masterReverb) {
+        tailFrames += masterReverb->getTailFrames();
+    }
+    const size_t outputFrames = totalFrames + tailFrames;
+    const size_t renderFrames = outputFrames + masterLatency;
+
+    unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned numWorkers = options.workerThreads ? options.workerThreads : hardwareThreads;
+    numWorkers = std::max(1u, std::min(numWorkers, static_cast<unsigned>(stems.size())));
+
+    unsigned numWriters = options.writerThreads ? options.writerThreads : MAX_WRITER_THREADS;
+    numWriters = std::max(1u, std::min(numWriters, static_cast<unsigned>(writers.size())));
+
+    // Pre-allocate all block buffers up front
+    std::array<Slot, NUM_SLOTS> slots;
+    for (auto& slot : slots) {
+        slot.stemBuffers.assign(stems.size(), std::vector<float>(options.blockFrames * 2, 0.0f));
+        slot.master.assign(options.blockFrames * 2, 0.0f);
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    long long renderBlock = -1;     // Block the workers should render next
+    unsigned workersDone = 0;       // Workers finished with renderBlock
+    long long publishedBlock = -1;  // Highest block handed to the writers
+    bool finished = false;
+    std::atomic<bool> failed{false};
+
+    // Render workers: each owns a fixed stripe of stems
+    std::vector<std::thread> workerThreads;
+    for (unsigned w = 0; w < numWorkers; ++w) {
+        workerThreads.emplace_back([&, w]() {
+            for (long long next = 0;; ++next) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return renderBlock >= next || finished; });
+                    if (renderBlock < next) return;
+                }
+
+                // Tracks stop at the end of the timeline; their reverbs run on
+                Slot& slot = slots[next % NUM_SLOTS];
+                size_t trackFrames = slot.startFrame < totalFrames
+                                         ? std::min(slot.frameCount, totalFrames - slot.startFrame) : 0;
+                for (size_t i = w; i < stems.size(); i += numWorkers) {
+                    float* buffer = slot.stemBuffers[i].data();
+                    stems[i].track->renderBlock(slot.startFrame, trackFrames, options.sampleRate,
+                                                buffer, *stems[i].eq);
+                    std::fill(buffer + trackFrames * 2, buffer + slot.frameCount * 2, 0.0f);
+                    if (stems[i].reverb) {
+                        stems[i].reverb->process(buffer, buffer, slot.frameCount);
+                    }
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    ++workersDone;
+                }
+                cv.notify_all();
+            }
+        });
+    }
+
+    // I/O writers: each owns a fixed stripe of output files
+    std::vector<std::thread> writerThreads;
+    for (unsigned k = 0; k < numWriters; ++k) {
+        writerThreads.emplace_back([&, k]() {
+            for (long long next = 0;; ++next) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return publishedBlock >= next || finished; });
+                    if (publishedBlock < next) return;
+                }
+
+                Slot& slot = slots[next % NUM_SLOTS];
+                for (size_t file = k; file < writers.size(); file += numWriters) {
+                    bool isStem = file < stems.size();
+                    const float* data = isStem ? slot.stemBuffers[file].data()
+                                               : slot.master.data() + slot.masterOffset * 2;
+                    size_t frames = isStem ? slot.stemFrames : slot.frameCount - slot.masterOffset;
+                    if (frames > 0 && !failed && !writers[file]->write(data, frames)) {
+                        failed = true;
+                    }
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    --slot.writersPending;
+                }
+                cv.notify_all();
+            }
+        });
+    }
+
+    // Coordinator: drive the timeline one block at a time
+    size_t numBlocks = (renderFrames + options.blockFrames - 1) / options.blockFrames;
+    size_t masterSkip = masterLatency;
+    for (size_t block = 0; block < numBlocks && !failed; ++block) {
+        Slot& slot = slots[block % NUM_SLOTS];
+
+        // Wait until the writers are done with this slot's previous block
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return slot.writersPending == 0; });
+        }
+
+        slot.startFrame = block * options.blockFrames;
+        slot.frameCount = std::min(options.blockFrames, renderFrames - slot.startFrame);
+        slot.stemFrames = slot.startFrame < outputFrames ? std::min(slot.frameCount, outputFrames - slot.startFrame) : 0;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workersDone = 0;
+            renderBlock = static_cast<long long>(block);
+            cv.notify_all();
+            cv.wait(lock, [&] { return workersDone == numWorkers; });
+        }
+
+        if (options.includeMaster) {
+            size_t sampleCount = slot.frameCount * 2;
+            std::fill(slot.master.begin(), slot.master.begin() + sampleCount, 0.0f);
+            for (const auto& buffer : slot.stemBuffers) {
+                for (size_t i = 0; i < sampleCount; ++i) {
+                    slot.master[i] += buffer[i];
+                }
+            }
+            for (size_t i = 0; i < sampleCount; ++i) {
+                slot.master[i] *= options.masterVolume;
+            }
+            AudioEngine::processMasterBus(slot.master.data(), slot.frameCount, 2, options.sampleRate,
+                                          masterReverb.get(), options.masterEQ);
+
+            slot.masterOffset = std::min(masterSkip, slot.frameCount);
+            masterSkip -= slot.masterOffset;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.writersPending = numWriters;
+            publishedBlock = static_cast<long long>(block);
+        }
+        cv.notify_all();
+
+        if (progress) {
+            progress(static_cast<double>(block + 1) / numBlocks);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    cv.notify_all();
+
+    for (auto& thread : workerThreads) thread.join();
+    for (auto& thread : writerThreads) thread.join();
+
+    bool closed = true;
+    for (auto& writer : writers) {
+        closed = writer->close() && closed;
+    }
+
+    if (failed || !closed) {
+        result.error = L"Failed to write stem files";
+        return result;
+    }
+
+    result.success = true;
+    return result;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Track.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+
+// Renders every audible track to its own WAV file plus the master mix in a
+// single pass over the timeline, through the same track EQ, track reverb and
+// master bus chain as playback. Reverbs run offline, and all files extend
+// past the timeline until the reverb tails have died away. Tracks are spread
+// across worker threads and each output file is written from a dedicated I/O
+// thread, so exporting many stems costs about the same wall-clock time as
+// one mixdown.
+class StemExporter {
+public:
+    struct Options {
+        std::wstring directory;        // Output directory
+        std::wstring baseName;         // Master is <baseName>.wav, stems <baseName>_<Track>.wav
+        uint32_t sampleRate = 44100;
+        double duration = 0.0;         // Seconds to render from the start of the timeline
+        float masterVolume = 1.0f;
+        bool includeMaster = true;
+        unsigned workerThreads = 0;    // 0 = one per hardware thread
+        unsigned writerThreads = 0;    // 0 = one per output file (capped)
+        size_t blockFrames = 16384;    // Frames rendered per pipeline step
+
+        // Master bus chain, as in playback (AudioEngine::processMasterBus).
+        // The reverb's response is copied into an offline reverb. The EQ must
+        // be an instance of its own, not the one playback runs; its latency
+        // is compensated so the master lines up with the stems.
+        const ConvolutionReverb* masterReverb = nullptr;
+        AudioEngine::EQCallback masterEQ;
+        size_t masterEQLatencyFrames = 0;
+    };
+
+    struct Result {
+        bool success = false;
+        std::vector<std::wstring> files;
+        std::wstring error;
+    };
+
+    // Progress is reported from the calling thread as a fraction (0.0 to 1.0)
+    using ProgressCallback = std::function<void(double fraction)>;
+
+    static Result exportStems(const std::vector<std::shared_ptr<Track>>& tracks,
+                              const Options& options,
+                              ProgressCallback progress = nullptr);
+
+    // Replace characters that are not valid in Windows file names
+    static std::wstring sanitizeFileName(const std::wstring& name);
+
+private:
+    static constexpr unsigned MAX_WRITER_THREADS = 8;
+    static constexpr int NUM_SLOTS = 3;  // Blocks in flight between render and write
+};
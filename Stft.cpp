@@ -0,0 +1,45 @@
+#include "Stft.h"
+#include <algorithm>
+#include <cmath>
+
+Stft::Stft() {
+    configure(Config());
+}
+
+bool Stft::isValid(const Config& config) {
+    return FftPlan::get(config.fftSize) != nullptr && config.hop <= config.fftSize &&
+           config.hop >= config.fftSize / MAX_OVERLAP_FACTOR;
+}
+
+bool Stft::configure(const Config& config) {
+    if (!isValid(config)) {
+        return false;
+    }
+
+    m_config = config;
+    m_plan = FftPlan::get(config.fftSize);
+    m_frame.resize(config.fftSize);
+    m_re.resize(m_plan->getBinCount());
+    m_im.resize(m_plan->getBinCount());
+    m_workspace.resize(m_plan->getWorkspaceSize());
+    m_magnitudes.resize(m_plan->getBinCount());
+    m_magnitudeScale = 2.0f / m_plan->getWindowSum(config.window);
+    reset();
+    return true;
+}
+
+void Stft::reset() {
+    // Start from silence so the first frame comes one hop in
+    std::fill(m_frame.begin(), m_frame.end(), 0.0f);
+    m_fill = m_config.fftSize - m_config.hop;
+}
+
+void Stft::analyzeFrame() {
+    m_plan->forward(m_frame.data(), m_re.data(), m_im.data(), m_workspace.data(), m_config.window);
+    for (size_t bin = 0; bin < m_magnitudes.size(); ++bin) {
+        m_magnitudes[bin] = std::hypot(m_re[bin], m_im[bin]) * m_magnitudeScale;
+    }
+
+    std::move(m_frame.begin() + m_config.hop, m_frame.end(), m_frame.begin());
+    m_fill -= m_config.hop;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "FftPlan.h"
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+// Streaming short-time Fourier transform over a mono signal. Input arrives
+// in arbitrary block sizes; every hop samples a frame of the newest fftSize
+// samples is windowed, transformed and handed out as magnitudes, so the
+// frame rate depends only on the hop and the sample rate, never on how the
+// input was chunked. Magnitudes are scaled by the window's coherent gain so a
+// full-scale sine centred on a bin reads 1.0.
+//
+// Not thread-safe; owned by one analysis thread.
+class Stft {
+public:
+    // Overlap is capped (hop >= fftSize / MAX_OVERLAP_FACTOR) to bound the
+    // cost of running continuously
+    static constexpr size_t MAX_OVERLAP_FACTOR = 8;
+
+    struct Config {
+        size_t fftSize = 4096;
+        size_t hop = 1024;
+        FftPlan::Window window = FftPlan::Window::Hann;
+    };
+
+    Stft();
+
+    static bool isValid(const Config& config);
+
+    // Returns false (and keeps the current setup) for an invalid config.
+    // Reconfiguring clears the signal history.
+    bool configure(const Config& config);
+    const Config& getConfig() const { return m_config; }
+    size_t getBinCount() const { return m_plan->getBinCount(); }
+
+    void reset();
+
+    // Feed mono samples; onFrame(const float* magnitudes) runs once per
+    // completed frame with getBinCount() values
+    template <typename OnFrame>
+    void process(const float* samples, size_t count, OnFrame&& onFrame) {
+        while (count > 0) {
+            size_t take = std::min(count, m_config.fftSize - m_fill);
+            std::copy(samples, samples + take, m_frame.begin() + m_fill);
+            m_fill += take;
+            samples += take;
+            count -= take;
+
+            if (m_fill == m_config.fftSize) {
+                analyzeFrame();
+                onFrame(static_cast<const float*>(m_magnitudes.data()));
+            }
+        }
+    }
+
+private:
+    // Transform the full frame, then slide it left by one hop
+    void analyzeFrame();
+
+    Config m_config;
+    const FftPlan* m_plan = nullptr;
+    std::vector<float> m_frame;      // fftSize samples, oldest first
+    size_t m_fill = 0;               // Samples currently in m_frame
+    std::vector<float> m_re;
+    std::vector<float> m_im;
+    std::vector<float> m_workspace;
+    std::vector<float> m_magnitudes;
+    float m_magnitudeScale = 1.0f;
+};
@@ -0,0 +1,97 @@
+#include "ThreadPriority.h"
+#include <avrt.h>
+#include <cstdio>
+
+#pragma comment(lib, "Avrt.lib")
+
+std::atomic<int> ThreadPriority::s_audioCore{-1};
+std::atomic<unsigned> ThreadPriority::s_settingsGeneration{1};
+
+namespace {
+
+// MMCSS registration is per thread and must be reverted on the same thread
+thread_local HANDLE t_mmcssHandle = nullptr;
+thread_local unsigned t_appliedGeneration = 0;
+
+} // namespace
+
+ThreadPriority::Status ThreadPriority::makeCurrentThreadRealtime(Task task, int core) {
+    Status status;
+
+    if (!t_mmcssHandle) {
+        DWORD taskIndex = 0;
+        const wchar_t* taskName = (task == Task::ProAudio) ? L"Pro Audio" : L"Audio";
+        t_mmcssHandle = AvSetMmThreadCharacteristicsW(taskName, &taskIndex);
+    }
+
+    if (t_mmcssHandle) {
+        AVRT_PRIORITY priority = (task == Task::ProAudio) ? AVRT_PRIORITY_HIGH : AVRT_PRIORITY_NORMAL;
+        AvSetMmThreadPriority(t_mmcssHandle, priority);
+        status.mmcss = true;
+        status.raised = true;
+    }
+    else {
+        // MMCSS service disabled or unavailable
+        int priority = (task == Task::ProAudio) ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+        status.raised = SetThreadPriority(GetCurrentThread(), priority) != 0 ||
+                        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL) != 0;
+    }
+
+    if (core >= 0 && core < getCoreCount() && core < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+        status.pinned = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) != 0;
+    }
+
+    if (!status.raised || (core >= 0 && !status.pinned)) {
+        wchar_t buf[128];
+        swprintf_s(buf, L"Audio thread %lu: priority %s, pinning %s\n", GetCurrentThreadId(),
+                   status.raised ? L"raised" : L"unchanged",
+                   core < 0 ? L"off" : (status.pinned ? L"on" : L"failed"));
+        OutputDebugStringW(buf);
+    }
+    return status;
+}
+
+void ThreadPriority::revertCurrentThread() {
+    if (t_mmcssHandle) {
+        AvRevertMmThreadCharacteristics(t_mmcssHandle);
+        t_mmcssHandle = nullptr;
+    }
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_NORMAL);
+
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        SetThreadAffinityMask(GetCurrentThread(), processMask);
+    }
+    t_appliedGeneration = 0;
+}
+
+int ThreadPriority::getCoreCount() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<int>(info.dwNumberOfProcessors);
+}
+
+void ThreadPriority::ensureCurrentThreadRealtime(Task task) {
+    unsigned generation = s_settingsGeneration.load(std::memory_order_relaxed);
+    if (t_appliedGeneration == generation) {
+        return;
+    }
+    t_appliedGeneration = generation;
+
+    int core = s_audioCore.load();
+    if (core < 0) {
+        // Undo an earlier pin
+        DWORD_PTR processMask = 0;
+        DWORD_PTR systemMask = 0;
+        if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+            SetThreadAffinityMask(GetCurrentThread(), processMask);
+        }
+    }
+    makeCurrentThreadRealtime(task, core);
+}
+
+void ThreadPriority::setAudioCore(int core) {
+    s_audioCore = core;
+    s_settingsGeneration.fetch_add(1);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <Windows.h>
+#include <atomic>
+
+// Raises audio threads above the UI so heavy repaints can't starve mixing.
+// Threads register with MMCSS (the Multimedia Class Scheduler Service), which
+// gives them real-time scheduling without needing admin rights. When MMCSS is
+// unavailable it falls back to THREAD_PRIORITY_TIME_CRITICAL, and failing that
+// the thread simply keeps its priority. Optional pinning keeps a thread on one
+// core so its caches stay warm.
+//
+// Everything acts on the calling thread, so call it from the thread itself
+// (e.g. first thing in a thread function, or once from inside a device callback).
+class ThreadPriority {
+public:
+    enum class Task {
+        ProAudio,  // Device callbacks and the render thread
+        Audio      // DSP and analysis workers: real-time class, below ProAudio
+    };
+
+    struct Status {
+        bool mmcss = false;    // Registered with MMCSS
+        bool raised = false;   // Running above normal priority (MMCSS or fallback)
+        bool pinned = false;   // Affinity restricted to the requested core
+    };
+
+    // core < 0 leaves the thread free to move between cores
+    static Status makeCurrentThreadRealtime(Task task, int core = -1);
+
+    // Undo makeCurrentThreadRealtime() before a thread returns to a pool
+    // or goes back to ordinary work
+    static void revertCurrentThread();
+
+    static int getCoreCount();
+
+    // Apply once per thread and re-apply after setAudioCore() changes. For
+    // threads we don't own, such as the WinMM callback thread. Cheap enough
+    // to call from every callback.
+    static void ensureCurrentThreadRealtime(Task task);
+
+    // Core for audio threads (-1 = no pinning). Threads pick it up the next
+    // time they call ensureCurrentThreadRealtime(). Only the device and render
+    // threads should follow it; DSP workers use makeCurrentThreadRealtime()
+    // unpinned so they don't compete with the callback for its core.
+    static void setAudioCore(int core);
+    static int getAudioCore() { return s_audioCore.load(); }
+
+private:
+    static std::atomic<int> s_audioCore;
+    static std::atomic<unsigned> s_settingsGeneration;
+};
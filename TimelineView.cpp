@@ -1,5 +1,6 @@
 #include "TimelineView.h"
 #include "Application.h"
+#include "Spectrogram.h"
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
@@ -16,6 +17,7 @@ constexpr float SCROLLBAR_MIN_THUMB = 24.0f;
 
 TimelineView::~TimelineView() {
     releaseGeometries();
+    releaseSpectrogramBitmaps();
 
     if (m_editControl) {
         DestroyWindow(m_editControl);
@@ -215,6 +217,8 @@ void TimelineView::updateScrollMetrics() {
 }
 
 void TimelineView::onRender(ID2D1RenderTarget* rt) {
+    ++m_renderCount;
+
     // Initialize geometries on first render
     if (!m_playheadGeometry) {
         initializeGeometries();
@@ -263,6 +267,61 @@ void TimelineView::onRender(ID2D1RenderTarget* rt) {
     // Corner box (top-left)
     fillRect(0, 0, TRACK_HEADER_WIDTH, RULER_HEIGHT, DAWColors::TrackHeader);
     drawRect(0, 0, TRACK_HEADER_WIDTH, RULER_HEIGHT, DAWColors::GridLine);
+
+    if (m_showStatsOverlay) {
+        drawStatsOverlay(rt);
+    }
+}
+
+void TimelineView::setAudioStats(const AudioLoadMonitor::Snapshot& stats) {
+    m_audioStats = stats;
+    if (m_showStatsOverlay) {
+        invalidate();
+    }
+}
+
+void TimelineView::drawStatsOverlay(ID2D1RenderTarget* rt) {
+    const float width = 230.0f;
+    const float height = 118.0f;
+    const float x = getWidth() - width - 8.0f;
+    const float y = RULER_HEIGHT + 8.0f;
+
+    fillRect(x, y, width, height, Color(0.0f, 0.0f, 0.0f, 0.75f));
+    drawRect(x, y, width, height, DAWColors::GridLineMajor);
+
+    const Color warning(1.0f, 0.4f, 0.3f);
+    bool dropouts = m_audioStats.lateBlocks > 0 || m_audioStats.underruns > 0;
+
+    std::wstringstream ss;
+    ss << std::fixed << std::setprecision(0)
+       << L"DSP " << m_audioStats.lastLoad * 100.0f << L"%  avg "
+       << m_audioStats.averageLoad * 100.0f << L"%  peak "
+       << m_audioStats.peakLoad * 100.0f << L"%";
+    drawText(ss.str(), x + 6, y + 4, DAWColors::TextPrimary, width - 12);
+
+    ss.str(L"");
+    ss << L"Late " << m_audioStats.lateBlocks << L"  Underruns " << m_audioStats.underruns;
+    drawText(ss.str(), x + 6, y + 22, dropouts ? warning : DAWColors::TextSecondary, width - 12);
+
+    // Load histogram: one bar per 10% bin, the last bin is late blocks
+    const float chartX = x + 6.0f;
+    const float chartY = y + 44.0f;
+    const float chartHeight = height - 50.0f;
+    const float barWidth = (width - 12.0f) / AudioLoadMonitor::HISTOGRAM_BINS;
+
+    uint64_t maxCount = 1;
+    for (uint64_t count : m_audioStats.loadHistogram) {
+        maxCount = std::max(maxCount, count);
+    }
+    for (size_t i = 0; i < AudioLoadMonitor::HISTOGRAM_BINS; ++i) {
+        float barHeight = chartHeight * static_cast<float>(m_audioStats.loadHistogram[i]) / maxCount;
+        Color color = (i + 1 == AudioLoadMonitor::HISTOGRAM_BINS) ? warning
+                    : (i >= 8) ? Color(1.0f, 0.8f, 0.3f) : DAWColors::Waveform;
+        fillRect(chartX + i * barWidth + 1.0f, chartY + chartHeight - barHeight,
+                 barWidth - 2.0f, barHeight, color);
+    }
+    drawLine(chartX, chartY + chartHeight, chartX + barWidth * AudioLoadMonitor::HISTOGRAM_BINS,
+             chartY + chartHeight, DAWColors::GridLine);
 }
 
 void TimelineView::drawRuler(ID2D1RenderTarget* rt) {
@@ -524,6 +583,11 @@ void TimelineView::drawWaveform(ID2D1RenderTarget* rt, const TrackRegion& region
 
     if (clipEndTime <= clipStartTime) return;
 
+    if (region.showSpectrogram &&
+        drawSpectrogram(rt, region, visibleStart, visibleEnd, regionY, regionHeight, clipStartTime, clipEndTime)) {
+        return;
+    }
+
     // Get waveform data for the visible portion only
     int waveformWidth = visibleEnd - visibleStart;
     auto waveform = region.clip->getWaveformData(waveformWidth, clipStartTime, clipEndTime);
@@ -546,6 +610,146 @@ void TimelineView::drawWaveform(ID2D1RenderTarget* rt, const TrackRegion& region
     }
 }
 
+bool TimelineView::drawSpectrogram(ID2D1RenderTarget* rt, const TrackRegion& region, int visibleStart, int visibleEnd,
+    float regionY, float regionHeight, double clipStartTime, double clipEndTime) {
+    ClipSpectrogram* spectrogram = getClipSpectrogram(region.clip);
+    if (!spectrogram || !spectrogram->isReady()) {
+        // Waveform stays up while the sidecar is built
+        if (spectrogram && !spectrogram->hasFailed()) {
+            wchar_t label[48];
+            swprintf(label, 48, L"Analyzing spectrum... %d%%", static_cast<int>(spectrogram->getProgress() * 100.0f));
+            drawText(label, static_cast<float>(visibleStart + 6), regionY + 4, DAWColors::TextSecondary);
+        }
+        return false;
+    }
+
+    // Columns about a pixel wide, whatever the zoom
+    int level = spectrogram->chooseLevel(1.0 / m_pixelsPerSecond);
+    double columnSeconds = spectrogram->getColumnSeconds(level);
+    uint64_t columnCount = spectrogram->getColumnCount(level);
+    if (columnCount == 0) return false;
+    uint64_t firstColumn = static_cast<uint64_t>(clipStartTime / columnSeconds);
+    uint64_t lastColumn = std::min(columnCount - 1, static_cast<uint64_t>(clipEndTime / columnSeconds));
+    const uint64_t tileColumns = ClipSpectrogram::TILE_COLUMNS;
+
+    fillRect(static_cast<float>(visibleStart), regionY, static_cast<float>(visibleEnd - visibleStart), regionHeight,
+        Color(Spectrogram::getPalette()[0]));
+    rt->PushAxisAlignedClip(D2D1::RectF(static_cast<float>(visibleStart), regionY,
+        static_cast<float>(visibleEnd), regionY + regionHeight), D2D1_ANTIALIAS_MODE_ALIASED);
+
+    // Clip time -> x without rounding, so tiles butt together exactly
+    double clipOriginX = TRACK_HEADER_WIDTH + (region.startTime - region.clipOffset - m_scrollX) * m_pixelsPerSecond;
+    for (uint64_t tile = firstColumn / tileColumns; tile <= lastColumn / tileColumns; ++tile) {
+        ID2D1Bitmap* bitmap = getSpectrogramTileBitmap(rt, *spectrogram, level, tile);
+        if (!bitmap) continue;
+
+        uint64_t tileFirst = tile * tileColumns;
+        uint64_t validColumns = std::min(tileColumns, columnCount - tileFirst);
+        float x0 = static_cast<float>(clipOriginX + tileFirst * columnSeconds * m_pixelsPerSecond);
+        float x1 = static_cast<float>(clipOriginX + (tileFirst + validColumns) * columnSeconds * m_pixelsPerSecond);
+        rt->DrawBitmap(bitmap, D2D1::RectF(x0, regionY, x1, regionY + regionHeight), 1.0f,
+            D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+            D2D1::RectF(0.0f, 0.0f, static_cast<float>(validColumns), static_cast<float>(ClipSpectrogram::ROWS)));
+    }
+
+    rt->PopAxisAlignedClip();
+    return true;
+}
+
+ClipSpectrogram* TimelineView::getClipSpectrogram(const std::shared_ptr<AudioClip>& clip) {
+    if (!clip) return nullptr;
+
+    auto found = m_clipSpectrograms.find(clip.get());
+    if (found != m_clipSpectrograms.end()) {
+        return found->second.get();
+    }
+
+    // Drop spectrograms whose clips are no longer on the timeline
+    for (auto it = m_clipSpectrograms.begin(); it != m_clipSpectrograms.end();) {
+        if (it->second->getClip().use_count() == 1) {
+            releaseSpectrogramBitmaps(it->second.get());
+            it = m_clipSpectrograms.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto spectrogram = std::make_unique<ClipSpectrogram>(clip, ClipSpectrogram::sidecarPathFor(*clip));
+    spectrogram->start([this]() { invalidate(); });
+    return m_clipSpectrograms.emplace(clip.get(), std::move(spectrogram)).first->second.get();
+}
+
+ID2D1Bitmap* TimelineView::getSpectrogramTileBitmap(ID2D1RenderTarget* rt, ClipSpectrogram& spectrogram,
+    int level, uint64_t tileIndex) {
+    auto key = std::make_tuple(static_cast<const ClipSpectrogram*>(&spectrogram), level, tileIndex);
+    auto found = m_spectrogramBitmaps.find(key);
+    if (found != m_spectrogramBitmaps.end()) {
+        found->second.lastUsed = m_renderCount;
+        return found->second.bitmap;
+    }
+
+    auto tile = spectrogram.getTile(level, tileIndex);
+    if (!tile) return nullptr;
+
+    // Column-major levels -> row-major pixels, highest frequency at the top
+    const UINT32 columns = static_cast<UINT32>(ClipSpectrogram::TILE_COLUMNS);
+    const UINT32 rows = static_cast<UINT32>(ClipSpectrogram::ROWS);
+    const auto& palette = Spectrogram::getPalette();
+    std::vector<uint32_t> pixels(static_cast<size_t>(columns) * rows);
+    for (UINT32 column = 0; column < columns; ++column) {
+        const uint8_t* levels = tile->data() + static_cast<size_t>(column) * rows;
+        for (UINT32 row = 0; row < rows; ++row) {
+            pixels[static_cast<size_t>(rows - 1 - row) * columns + column] = palette[levels[row]];
+        }
+    }
+
+    ID2D1Bitmap* bitmap = nullptr;
+    D2D1_BITMAP_PROPERTIES props = D2D1::BitmapProperties(
+        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_IGNORE));
+    if (FAILED(rt->CreateBitmap(D2D1::SizeU(columns, rows), pixels.data(), columns * 4, props, &bitmap))) {
+        return nullptr;
+    }
+
+    if (m_spectrogramBitmaps.size() >= MAX_SPECTROGRAM_BITMAPS) {
+        auto oldest = std::min_element(m_spectrogramBitmaps.begin(), m_spectrogramBitmaps.end(),
+            [](const auto& a, const auto& b) { return a.second.lastUsed < b.second.lastUsed; });
+        oldest->second.bitmap->Release();
+        m_spectrogramBitmaps.erase(oldest);
+    }
+    m_spectrogramBitmaps[key] = {bitmap, m_renderCount};
+    return bitmap;
+}
+
+void TimelineView::releaseSpectrogramBitmaps(const ClipSpectrogram* spectrogram) {
+    for (auto it = m_spectrogramBitmaps.begin(); it != m_spectrogramBitmaps.end();) {
+        if (!spectrogram || std::get<0>(it->first) == spectrogram) {
+            it->second.bitmap->Release();
+            it = m_spectrogramBitmaps.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TimelineView::onDiscardDeviceResources() {
+    releaseSpectrogramBitmaps();
+}
+
+bool TimelineView::toggleSelectedRegionSpectrogram() {
+    if (m_selectedTrack < 0 || m_selectedTrack >= static_cast<int>(m_tracks.size())) {
+        return false;
+    }
+    auto& regions = m_tracks[m_selectedTrack]->getRegions();
+    if (m_selectedRegion < 0 || m_selectedRegion >= static_cast<int>(regions.size())) {
+        return false;
+    }
+
+    TrackRegion& region = regions[m_selectedRegion];
+    region.showSpectrogram = !region.showSpectrogram;
+    invalidate();
+    return region.showSpectrogram;
+}
+
 void TimelineView::drawPlayhead(ID2D1RenderTarget* rt) {
     int x = timeToPixel(m_playheadPosition);
 
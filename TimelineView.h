@@ -1,9 +1,14 @@
 #pragma once
 #include "D2DWindow.h"
 #include "Track.h"
+#include "AudioLoadMonitor.h"
+#include "ClipSpectrogram.h"
 #include <vector>
 #include <memory>
 #include <functional>
+#include <map>
+#include <tuple>
+#include <unordered_map>
 
 class TimelineView : public D2DWindow {
 public:
@@ -58,6 +63,11 @@ public:
     bool getShowGrid() const { return m_showGrid; }
     bool getSnapToGrid() const { return m_snapToGrid; }
 
+    // Debug overlay with audio callback load and dropout counters
+    void setStatsOverlayVisible(bool visible) { if (m_showStatsOverlay != visible) { m_showStatsOverlay = visible; invalidate(); } }
+    bool getStatsOverlayVisible() const { return m_showStatsOverlay; }
+    void setAudioStats(const AudioLoadMonitor::Snapshot& stats);
+
     // Selection
     int getSelectedTrackIndex() const { return m_selectedTrack; }
     void setSelectedTrackIndex(int index);
@@ -65,6 +75,10 @@ public:
     void setSelectedRegion(int trackIndex, int regionIndex);
     void clearRegionSelection();
 
+    // Switch the selected region between waveform and spectrogram display.
+    // Returns the new state (false if nothing is selected).
+    bool toggleSelectedRegionSpectrogram();
+
     // Track header width
     static constexpr int TRACK_HEADER_WIDTH = 200;
     static constexpr int RULER_HEIGHT = 30;
@@ -78,6 +92,7 @@ protected:
     void onMouseWheel(int x, int y, int delta) override;
     void onDoubleClick(int x, int y, int button) override;
     void onHScroll(HWND scrollBar, int request, int pos) override;
+    void onDiscardDeviceResources() override;
 
 private:
     void drawRuler(ID2D1RenderTarget* rt);
@@ -87,8 +102,16 @@ private:
     void drawTrackContent(ID2D1RenderTarget* rt, Track& track, float y, float height, size_t trackIndex);
     void drawWaveform(ID2D1RenderTarget* rt, const TrackRegion& region,
         float trackY, float trackHeight, const Color& color, bool isSelected);
+    // False (nothing drawn) until the clip's spectrogram is ready
+    bool drawSpectrogram(ID2D1RenderTarget* rt, const TrackRegion& region, int visibleStart, int visibleEnd,
+        float regionY, float regionHeight, double clipStartTime, double clipEndTime);
+    ClipSpectrogram* getClipSpectrogram(const std::shared_ptr<AudioClip>& clip);
+    ID2D1Bitmap* getSpectrogramTileBitmap(ID2D1RenderTarget* rt, ClipSpectrogram& spectrogram,
+        int level, uint64_t tileIndex);
+    void releaseSpectrogramBitmaps(const ClipSpectrogram* spectrogram = nullptr);
     void drawPlayhead(ID2D1RenderTarget* rt);
     void drawScrollbar(ID2D1RenderTarget* rt);
+    void drawStatsOverlay(ID2D1RenderTarget* rt);
 
     void initializeGeometries();
     void releaseGeometries();
@@ -147,6 +170,9 @@ private:
     bool m_showGrid = true;
     bool m_followPlayhead = true;  // Auto-scroll to follow playhead
 
+    bool m_showStatsOverlay = false;
+    AudioLoadMonitor::Snapshot m_audioStats;
+
     // Interaction state
     bool m_draggingPlayhead = false;
     bool m_draggingRegion = false;
@@ -172,4 +198,15 @@ private:
 
     // Cached geometries for performance
     ID2D1PathGeometry* m_playheadGeometry = nullptr;
+
+    // Spectral view: one background-built sidecar per clip, and GPU bitmaps
+    // for the most recently drawn tiles
+    static constexpr size_t MAX_SPECTROGRAM_BITMAPS = 128;
+    struct SpectrogramBitmap {
+        ID2D1Bitmap* bitmap = nullptr;
+        uint64_t lastUsed = 0;
+    };
+    std::unordered_map<const AudioClip*, std::unique_ptr<ClipSpectrogram>> m_clipSpectrograms;
+    std::map<std::tuple<const ClipSpectrogram*, int, uint64_t>, SpectrogramBitmap> m_spectrogramBitmaps;
+    uint64_t m_renderCount = 0;
 };
\ No newline at end of file
@@ -1,7 +1,8 @@
 #include "Track.h"
 #include <cmath>
 
-Track::Track(const std::wstring& name) : m_name(name) {
+Track::Track(const std::wstring& name)
+    : m_name(name), m_reverb(std::make_unique<ConvolutionReverb>()) {
     updateGains();  // Initialize cached gains
 }
 
@@ -37,53 +38,50 @@ void Track::removeRegion(size_t index) {
     }
 }
 
-void Track::getAudioAtTime(double time, float* leftOut, float* rightOut,
-                           uint32_t sampleRate) const {
-    *leftOut = 0.0f;
-    *rightOut = 0.0f;
-
-    // Skip armed tracks (to avoid feedback during recording)
-    // Note: We still process muted tracks for metering, but don't output audio
-    if (m_armed) return;
-
-    for (const auto& region : m_regions) {
-        // Early exit: regions are sorted, so if we've passed the time, stop searching
-        if (time < region.startTime) break;
-
-        if (time >= region.startTime && time < region.endTime()) {
-            double clipTime = region.clipOffset + (time - region.startTime);
-
-            if (region.clip) {
-                const auto& samples = region.clip->getSamples();
-                const auto& format = region.clip->getFormat();
-
-                size_t frameIndex = static_cast<size_t>(clipTime * format.sampleRate);
-                if (frameIndex < region.clip->getSampleCount()) {
-                    float left = samples[frameIndex * format.channels];
-                    float right = (format.channels > 1) ?
-                                  samples[frameIndex * format.channels + 1] : left;
-
-                    // Apply cached track volume and pan gains (updated when volume/pan changes)
-                    float processedLeft = left * m_cachedLeftGain;
-                    float processedRight = right * m_cachedRightGain;
-
-                    // Update peak level for metering (always, even when muted)
-                    float peak = std::max(std::abs(processedLeft), std::abs(processedRight));
-                    if (peak > m_peakLevel) {
-                        m_peakLevel = peak;
-                    }
-
-                    // Only output audio if not muted
-                    if (!m_muted) {
-                        *leftOut += processedLeft;
-                        *rightOut += processedRight;
-                    }
-                }
-            }
-            // Found matching region, no need to check further
-            break;
+float Track::renderBlock(size_t startFrame, size_t frameCount, uint32_t sampleRate,
+                         float* stereoOut, TrackEQ& eq) const {
+    std::fill(stereoOut, stereoOut + frameCount * 2, 0.0f);
+    if (m_armed || sampleRate == 0) return 0.0f;
+
+    // Regions are sorted by start time, so walk them alongside the frames
+    size_t regionIndex = 0;
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        double time = static_cast<double>(startFrame + frame) / sampleRate;
+
+        while (regionIndex < m_regions.size() && time >= m_regions[regionIndex].endTime()) {
+            ++regionIndex;
         }
+        if (regionIndex >= m_regions.size()) break;
+
+        const TrackRegion& region = m_regions[regionIndex];
+        if (time < region.startTime || !region.clip) continue;
+
+        const auto& samples = region.clip->getSamples();
+        const auto& format = region.clip->getFormat();
+        double clipTime = region.clipOffset + (time - region.startTime);
+        size_t frameIndex = static_cast<size_t>(clipTime * format.sampleRate);
+        if (frameIndex >= region.clip->getSampleCount()) continue;
+
+        float left = samples[frameIndex * format.channels];
+        float right = (format.channels > 1) ? samples[frameIndex * format.channels + 1] : left;
+
+        stereoOut[frame * 2] = left * m_cachedLeftGain;
+        stereoOut[frame * 2 + 1] = right * m_cachedRightGain;
+    }
+
+    // The EQ runs even while muted so its state is current when unmuted
+    eq.setGains(m_eqLow, m_eqMid, m_eqHigh, sampleRate);
+    eq.process(stereoOut, frameCount);
+
+    float peak = 0.0f;
+    for (size_t i = 0; i < frameCount * 2; ++i) {
+        peak = std::max(peak, std::abs(stereoOut[i]));
+    }
+
+    if (m_muted) {
+        std::fill(stereoOut, stereoOut + frameCount * 2, 0.0f);
     }
+    return peak;
 }
 
 void Track::updatePeakLevel(float level) {
@@ -1,5 +1,7 @@
 #pragma once
 #include "AudioEngine.h"
+#include "ConvolutionReverb.h"
+#include "TrackEQ.h"
 #include <string>
 #include <memory>
 #include <algorithm>
@@ -9,6 +11,7 @@ struct TrackRegion {
     double startTime = 0.0;      // Position on timeline (seconds)
     double clipOffset = 0.0;     // Offset within the clip (seconds)
     double duration = 0.0;       // Length of region (seconds)
+    bool showSpectrogram = false;  // Spectral instead of waveform display
     
     double endTime() const { return startTime + duration; }
 };
@@ -63,9 +66,21 @@ public:
     const std::vector<TrackRegion>& getRegions() const { return m_regions; }
     std::vector<TrackRegion>& getRegions() { return m_regions; }
 
-    // Get audio at a specific time (for mixing)
-    void getAudioAtTime(double time, float* leftOut, float* rightOut,
-                        uint32_t sampleRate) const;
+    // Render frameCount frames starting at timeline frame startFrame into an
+    // interleaved stereo buffer: the Low/Mid/High EQ (eq keeps the filter
+    // state from block to block), volume and pan. Armed tracks render silence
+    // to avoid feedback while recording, and so do muted ones, but the peak
+    // returned for metering is taken before the mute. Touches no track state,
+    // so export workers can call it with their own eq.
+    float renderBlock(size_t startFrame, size_t frameCount, uint32_t sampleRate,
+                      float* stereoOut, TrackEQ& eq) const;
+
+    // EQ state used by playback's renderBlock() calls (audio thread only)
+    TrackEQ& getPlaybackEQ() { return m_playbackEQ; }
+
+    // Convolution reverb on this track's signal, mixed into the master bus
+    ConvolutionReverb& getReverb() { return *m_reverb; }
+    const ConvolutionReverb& getReverb() const { return *m_reverb; }
 
     // Audio level metering (for VU meters)
     float getPeakLevel() const { return m_peakLevel; }
@@ -91,6 +106,9 @@ private:
 
     std::vector<TrackRegion> m_regions;
 
+    std::unique_ptr<ConvolutionReverb> m_reverb;
+    TrackEQ m_playbackEQ;
+
     // Cached gain values (updated when volume or pan changes)
     mutable float m_cachedLeftGain = 1.0f;
     mutable float m_cachedRightGain = 1.0f;
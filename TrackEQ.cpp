@@ -0,0 +1,26 @@
+#include "TrackEQ.h"
+
+void TrackEQ::setGains(float lowDB, float midDB, float highDB, uint32_t sampleRate) {
+    if (sampleRate == 0) return;
+    bool rateChanged = sampleRate != m_sampleRate;
+    if (!rateChanged && lowDB == m_lowDB && midDB == m_midDB && highDB == m_highDB) return;
+
+    float rate = static_cast<float>(sampleRate);
+    const BiquadCascade::Coefficients stages[] = {
+        BiquadCascade::lowShelf(LOW_FREQ, lowDB, rate),
+        BiquadCascade::peakingEQ(MID_FREQ, midDB, MID_Q, rate),
+        BiquadCascade::highShelf(HIGH_FREQ, highDB, rate),
+    };
+
+    if (rateChanged) {
+        m_cascade.setStages(stages, 3);
+        m_cascade.reset();
+    } else {
+        m_cascade.publish(stages, 3);
+    }
+
+    m_lowDB = lowDB;
+    m_midDB = midDB;
+    m_highDB = highDB;
+    m_sampleRate = sampleRate;
+}
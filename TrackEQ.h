@@ -0,0 +1,32 @@
+#pragma once
+#include "BiquadCascade.h"
+#include <cstddef>
+#include <cstdint>
+
+// The mixer strip's Low/Mid/High EQ: a low shelf, a mid peak and a high
+// shelf run as one BiquadCascade over interleaved stereo. Playback keeps one
+// per track and the stem exporter one per stem, so both apply the same
+// filters; bands at 0 dB are left out of the chain and cost nothing.
+class TrackEQ {
+public:
+    static constexpr float LOW_FREQ = 250.0f;
+    static constexpr float MID_FREQ = 1000.0f;
+    static constexpr float HIGH_FREQ = 4000.0f;
+    static constexpr float MID_Q = 0.707f;
+
+    // Processing thread, before process(). Redesigns the bands only when the
+    // gains (dB) or the rate changed: a new rate starts from silence, a gain
+    // change ramps in across the next block.
+    void setGains(float lowDB, float midDB, float highDB, uint32_t sampleRate);
+
+    // In place over interleaved stereo frames
+    void process(float* stereo, size_t frameCount) { m_cascade.process(stereo, frameCount, 2); }
+    void reset() { m_cascade.reset(); }
+
+private:
+    BiquadCascade m_cascade;
+    float m_lowDB = 0.0f;
+    float m_midDB = 0.0f;
+    float m_highDB = 0.0f;
+    uint32_t m_sampleRate = 0;
+};
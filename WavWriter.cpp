@@ -0,0 +1,109 @@
+#include "WavWriter.h"
+#include <algorithm>
+#include <limits>
+
+WavWriter::~WavWriter() {
+    close();
+}
+
+bool WavWriter::open(const std::wstring& filename, const AudioFormat& format) {
+    close();
+
+    // 16-bit PCM, 24-bit PCM and 32-bit float are supported; anything else
+    // falls back to 16-bit PCM (matches AudioClip::saveToFile)
+    m_format = format;
+    if (!SampleConvert::fromWaveFormat(format.bitsPerSample, format.isFloat, m_sampleFormat)) {
+        m_sampleFormat = SampleFormat::Int16;
+    }
+    m_format.bitsPerSample = SampleConvert::bitsPerSample(m_sampleFormat);
+    m_format.isFloat = (m_sampleFormat == SampleFormat::Float32);
+    m_dataBytes = 0;
+
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        return false;
+    }
+
+    m_filename = filename;
+    return writeHeader();
+}
+
+bool WavWriter::write(const float* samples, size_t frameCount) {
+    if (!m_file.is_open() || !samples) return false;
+    if (frameCount == 0) return true;
+
+    size_t sampleCount = frameCount * m_format.channels;
+    size_t byteCount = sampleCount * m_format.bytesPerSample();
+    if (m_conversionBuffer.size() < byteCount) {
+        m_conversionBuffer.resize(byteCount);
+    }
+
+    SampleConvert::fromFloat(samples, m_conversionBuffer.data(), sampleCount, m_sampleFormat);
+
+    m_file.write(reinterpret_cast<const char*>(m_conversionBuffer.data()), byteCount);
+    m_dataBytes += byteCount;
+    return m_file.good();
+}
+
+bool WavWriter::close() {
+    if (!m_file.is_open()) return true;
+
+    // Patch the RIFF and data chunk sizes now that the length is known
+    m_file.seekp(0, std::ios::beg);
+    bool ok = writeHeader();
+    m_file.close();
+    return ok;
+}
+
+bool WavWriter::flushHeader() {
+    if (!m_file.is_open()) return false;
+
+    std::streampos end = m_file.tellp();
+    m_file.seekp(0, std::ios::beg);
+    bool ok = writeHeader();
+    m_file.seekp(end);
+    m_file.flush();
+    return ok && m_file.good();
+}
+
+uint64_t WavWriter::getFramesWritten() const {
+    uint32_t bytesPerFrame = m_format.bytesPerFrame();
+    return bytesPerFrame > 0 ? m_dataBytes / bytesPerFrame : 0;
+}
+
+bool WavWriter::writeHeader() {
+    // WAV sizes are 32-bit; clamp rather than wrap for very long files
+    uint64_t maxData = std::numeric_limits<uint32_t>::max() - (HEADER_SIZE - 8);
+    uint32_t dataSize = static_cast<uint32_t>(std::min(m_dataBytes, maxData));
+    uint32_t fileSize = (HEADER_SIZE - 8) + dataSize;
+
+    // RIFF header
+    m_file.write("RIFF", 4);
+    m_file.write(reinterpret_cast<const char*>(&fileSize), 4);
+    m_file.write("WAVE", 4);
+
+    // fmt chunk
+    m_file.write("fmt ", 4);
+    uint32_t fmtSize = 16;
+    m_file.write(reinterpret_cast<const char*>(&fmtSize), 4);
+
+    uint16_t audioFormat = m_format.isFloat ? 3 : 1;  // IEEE float or PCM
+    uint16_t channels = m_format.channels;
+    uint32_t sampleRate = m_format.sampleRate;
+    uint16_t bitsPerSample = m_format.bitsPerSample;
+    uint32_t byteRate = sampleRate * channels * (bitsPerSample / 8);
+    uint16_t blockAlign = channels * (bitsPerSample / 8);
+
+    m_file.write(reinterpret_cast<const char*>(&audioFormat), 2);
+    m_file.write(reinterpret_cast<const char*>(&channels), 2);
+    m_file.write(reinterpret_cast<const char*>(&sampleRate), 4);
+    m_file.write(reinterpret_cast<const char*>(&byteRate), 4);
+    m_file.write(reinterpret_cast<const char*>(&blockAlign), 2);
+    m_file.write(reinterpret_cast<const char*>(&bitsPerSample), 2);
+
+    // data chunk header (samples follow)
+    m_file.write("data", 4);
+    m_file.write(reinterpret_cast<const char*>(&dataSize), 4);
+
+    return m_file.good();
+}
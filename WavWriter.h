@@ -0,0 +1,48 @@
+#pragma once
+#include "AudioEngine.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Streams interleaved float audio to a WAV file (16/24-bit PCM or 32-bit
+// float, per AudioFormat) block by block, so long renders never need the
+// whole file in memory. The RIFF and data sizes are written as placeholders
+// on open() and patched on close(); flushHeader() patches them mid-stream so
+// a file cut short by a crash is still a valid WAV up to the last patch.
+class WavWriter {
+public:
+    WavWriter() = default;
+    ~WavWriter();
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    bool open(const std::wstring& filename, const AudioFormat& format);
+    bool write(const float* samples, size_t frameCount);
+    bool close();
+
+    // Rewrite the RIFF/data sizes for what has been written so far and flush
+    // everything to the OS. Writing continues where it left off.
+    bool flushHeader();
+
+    bool isOpen() const { return m_file.is_open(); }
+    const std::wstring& getFilename() const { return m_filename; }
+    const AudioFormat& getFormat() const { return m_format; }
+    uint64_t getFramesWritten() const;
+
+private:
+    bool writeHeader();
+
+    std::ofstream m_file;
+    std::wstring m_filename;
+    AudioFormat m_format;
+    uint64_t m_dataBytes = 0;
+
+    SampleFormat m_sampleFormat = SampleFormat::Int16;
+
+    // Reused conversion buffer (avoids per-block allocation)
+    std::vector<uint8_t> m_conversionBuffer;
+
+    static constexpr uint32_t HEADER_SIZE = 44;
+};
@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include "../AdaptiveBufferController.h"
+
+namespace {
+
+constexpr double PERIOD = 0.01;  // 10 ms blocks, 100 per window
+
+// Feed one full window of blocks at a constant load
+bool runWindow(AdaptiveBufferController& controller, float load) {
+    bool changed = false;
+    for (int i = 0; i < 100; ++i) {
+        changed |= controller.onBlock(load, false, PERIOD);
+    }
+    return changed;
+}
+
+AudioBufferConfig startLayout(int buffers, int frames) {
+    AudioBufferConfig config;
+    config.playbackBuffers = buffers;
+    config.playbackBufferFrames = frames;
+    return config;
+}
+
+} // namespace
+
+// Test an underrun grows the buffer size immediately, then holds for a window
+TEST(AdaptiveBufferControllerTests, UnderrunGrowsSize) {
+    AdaptiveBufferController controller;
+    controller.configure({}, startLayout(3, 512));
+
+    EXPECT_TRUE(controller.onBlock(0.2f, true, PERIOD));
+    EXPECT_EQ(controller.getBufferFrames(), 1024);
+    EXPECT_EQ(controller.getBufferCount(), 3);
+
+    // Held: another underrun right away does not grow again
+    EXPECT_FALSE(controller.onBlock(0.2f, true, PERIOD));
+    EXPECT_EQ(controller.getBufferFrames(), 1024);
+}
+
+// Test sustained heavy load grows size up to the limit, then count
+TEST(AdaptiveBufferControllerTests, HeavyLoadGrowsSizeThenCount) {
+    AdaptiveBufferController::Params params;
+    params.maxBufferFrames = 2048;
+    params.maxBuffers = 4;
+
+    AdaptiveBufferController controller;
+    controller.configure(params, startLayout(3, 1024));
+
+    EXPECT_TRUE(runWindow(controller, 0.8f));
+    EXPECT_EQ(controller.getBufferFrames(), 2048);
+    runWindow(controller, 0.8f);  // Hold window
+    EXPECT_TRUE(runWindow(controller, 0.8f));
+    EXPECT_EQ(controller.getBufferCount(), 4);
+
+    // Nothing left to grow
+    runWindow(controller, 0.8f);
+    EXPECT_FALSE(runWindow(controller, 0.8f));
+}
+
+// Test the limits never sit below the configured layout, so adapting starts
+// from exactly what the user chose even at the largest sizes
+TEST(AdaptiveBufferControllerTests, StartsAtConfiguredLayout) {
+    AdaptiveBufferController controller;
+    controller.configure({}, startLayout(4, AudioBufferConfig::MAX_BUFFER_FRAMES));
+    EXPECT_EQ(controller.getBufferFrames(), AudioBufferConfig::MAX_BUFFER_FRAMES);
+    EXPECT_EQ(controller.getMaxBufferFrames(), AudioBufferConfig::MAX_BUFFER_FRAMES);
+
+    AdaptiveBufferController::Params params;
+    params.maxBufferFrames = 2048;
+    params.maxBuffers = 4;
+    controller.configure(params, startLayout(12, 8192));
+    EXPECT_EQ(controller.getBufferFrames(), 8192);
+    EXPECT_EQ(controller.getBufferCount(), 12);
+    EXPECT_EQ(controller.getMaxBufferFrames(), 8192);
+    EXPECT_EQ(controller.getMaxBufferCount(), 12);
+}
+
+// Test quiet windows shrink count back first, then size down to the latency target
+TEST(AdaptiveBufferControllerTests, ShrinksTowardsTarget) {
+    AdaptiveBufferController::Params params;
+    params.targetLatencyFrames = 3 * 512;
+
+    AdaptiveBufferController controller;
+    controller.configure(params, startLayout(3, 2048));
+
+    // Quiet windows until nothing changes any more
+    for (int i = 0; i < 100; ++i) {
+        runWindow(controller, 0.1f);
+    }
+    EXPECT_EQ(controller.getBufferCount(), 3);
+    EXPECT_EQ(controller.getBufferFrames(), 512);
+}
+
+// Test moderate load neither grows nor shrinks
+TEST(AdaptiveBufferControllerTests, StableInBetween) {
+    AdaptiveBufferController controller;
+    controller.configure({}, startLayout(3, 2048));
+
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_FALSE(runWindow(controller, 0.5f));
+    }
+    EXPECT_EQ(controller.getBufferFrames(), 2048);
+}
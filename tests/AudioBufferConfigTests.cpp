@@ -0,0 +1,46 @@
+#include "gtest/gtest.h"
+#include "../AudioBufferConfig.h"
+
+// Test defaults match the previous fixed buffer layout
+TEST(AudioBufferConfigTests, Defaults) {
+    AudioBufferConfig config;
+    EXPECT_EQ(config.playbackBuffers, 3);
+    EXPECT_EQ(config.playbackBufferFrames, 2048);
+    EXPECT_EQ(config.recordBuffers, 4);
+    EXPECT_EQ(config.recordBufferFrames, 4096);
+    EXPECT_EQ(config.clamped(), config);
+}
+
+// Test out-of-range values are limited to the supported range
+TEST(AudioBufferConfigTests, Clamped) {
+    AudioBufferConfig config;
+    config.playbackBuffers = 0;
+    config.playbackBufferFrames = 1;
+    config.recordBuffers = 100;
+    config.recordBufferFrames = 1 << 20;
+
+    AudioBufferConfig safe = config.clamped();
+    EXPECT_EQ(safe.playbackBuffers, AudioBufferConfig::MIN_BUFFERS);
+    EXPECT_EQ(safe.playbackBufferFrames, AudioBufferConfig::MIN_BUFFER_FRAMES);
+    EXPECT_EQ(safe.recordBuffers, AudioBufferConfig::MAX_BUFFERS);
+    EXPECT_EQ(safe.recordBufferFrames, AudioBufferConfig::MAX_BUFFER_FRAMES);
+}
+
+// Test latency in frames and milliseconds
+TEST(AudioBufferConfigTests, Latency) {
+    AudioBufferConfig config;
+    config.playbackBuffers = 4;
+    config.playbackBufferFrames = 480;
+    config.recordBufferFrames = 960;
+
+    AudioLatency latency = AudioLatency::compute(config, 48000, 1440);
+    EXPECT_EQ(latency.inputFrames, 960u);
+    EXPECT_EQ(latency.outputFrames, 1920u);
+    EXPECT_EQ(latency.roundTripFrames, 960u + 1440u + 1920u);
+    EXPECT_DOUBLE_EQ(latency.inputMs, 20.0);
+    EXPECT_DOUBLE_EQ(latency.outputMs, 40.0);
+    EXPECT_DOUBLE_EQ(latency.roundTripMs, 90.0);
+
+    // Without monitor buffering the round trip is just input + output
+    EXPECT_EQ(AudioLatency::compute(config, 48000).roundTripFrames, 960u + 1920u);
+}
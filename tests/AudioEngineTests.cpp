@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "../AudioEngine.h"
+#include "../Track.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// Stereo track holding a constant level for the given length
+std::shared_ptr<Track> makeTrack(float value, double seconds, uint32_t sampleRate = 44100) {
+    auto clip = std::make_shared<AudioClip>();
+    AudioFormat format;
+    format.channels = 2;
+    format.sampleRate = sampleRate;
+    clip->setFormat(format);
+    clip->getSamplesWritable().assign(static_cast<size_t>(seconds * sampleRate) * 2, value);
+
+    auto track = std::make_shared<Track>(L"Track");
+    TrackRegion region;
+    region.clip = clip;
+    region.duration = seconds;
+    track->addRegion(region);
+    return track;
+}
+
+bool waitUntilStopped(const AudioEngine& engine, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (engine.isPlaying()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+} // namespace
+
+// Test render-ahead playback that ran to the end can be started again (the
+// renderer left over from the first pass is joined, not overwritten)
+TEST(AudioEngineTests, RenderAheadPlaysAgainAfterEnd) {
+    AudioEngine engine;
+    if (!engine.initialize(44100, 2)) {
+        GTEST_SKIP() << "No audio output device";
+    }
+    engine.setVolume(0.0f);  // Nothing audible on the test machine
+    ASSERT_TRUE(engine.setRenderAhead(true, 4096));
+
+    std::vector<std::shared_ptr<Track>> tracks = {makeTrack(0.25f, 0.25)};
+    engine.setTracks(&tracks);
+    engine.setDuration(0.25);
+
+    for (int pass = 0; pass < 3; ++pass) {
+        engine.setPosition(0.0);
+        ASSERT_TRUE(engine.play()) << "pass " << pass;
+        EXPECT_TRUE(waitUntilStopped(engine, std::chrono::seconds(5))) << "pass " << pass;
+
+        // Let the last buffers the device was given play out
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    }
+    engine.shutdown();
+}
+
+// Test stopping a take hands over a clip the writer thread built while
+// recording, matching the take file without reading it back
+TEST(AudioEngineTests, RecordedClipMatchesTakeFile) {
+    AudioEngine engine;
+    if (!engine.initialize(44100, 2)) {
+        GTEST_SKIP() << "No audio output device";
+    }
+    std::shared_ptr<AudioClip> recorded;
+    engine.setRecordingCallback([&](std::shared_ptr<AudioClip> clip) { recorded = std::move(clip); });
+    if (!engine.startRecording()) {
+        GTEST_SKIP() << "No audio input device";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    engine.stopRecording();
+    const std::wstring take = engine.getRecordedFilename();
+
+    ASSERT_TRUE(recorded);
+    EXPECT_EQ(recorded->getFilename(), take);
+    EXPECT_GT(recorded->getSampleCount(), 0u);
+    EXPECT_DOUBLE_EQ(recorded->getDuration(), engine.getRecordingDuration());
+
+    AudioClip onDisk;
+    ASSERT_TRUE(onDisk.loadFromFile(take));
+    EXPECT_EQ(onDisk.getFormat().channels, recorded->getFormat().channels);
+    EXPECT_EQ(onDisk.getFormat().sampleRate, recorded->getFormat().sampleRate);
+    ASSERT_EQ(onDisk.getSamples().size(), recorded->getSamples().size());
+    for (size_t i = 0; i < onDisk.getSamples().size(); ++i) {
+        // The file is 16-bit, so allow a rounding step either way
+        ASSERT_NEAR(onDisk.getSamples()[i], recorded->getSamples()[i], 2.0f / 32768.0f) << "sample " << i;
+    }
+
+    engine.shutdown();
+    DeleteFile(take.c_str());
+}
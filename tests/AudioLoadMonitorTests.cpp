@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+#include "../AudioLoadMonitor.h"
+
+// Test load is render time over buffer period and lands in the right bin
+TEST(AudioLoadMonitorTests, RecordsLoad) {
+    AudioLoadMonitor monitor;
+    monitor.recordBlock(0.0025, 0.010);
+    monitor.recordBlock(0.0050, 0.010);
+
+    auto stats = monitor.getSnapshot();
+    EXPECT_EQ(stats.blocks, 2u);
+    EXPECT_EQ(stats.lateBlocks, 0u);
+    EXPECT_FLOAT_EQ(stats.lastLoad, 0.5f);
+    EXPECT_FLOAT_EQ(stats.peakLoad, 0.5f);
+    EXPECT_EQ(stats.loadHistogram[2], 1u);
+    EXPECT_EQ(stats.loadHistogram[5], 1u);
+}
+
+// Test blocks that take longer than their period are counted late
+TEST(AudioLoadMonitorTests, LateBlocks) {
+    AudioLoadMonitor monitor;
+    monitor.recordBlock(0.009, 0.010);
+    monitor.recordBlock(0.012, 0.010);
+    monitor.recordBlock(0.030, 0.010);
+
+    auto stats = monitor.getSnapshot();
+    EXPECT_EQ(stats.lateBlocks, 2u);
+    EXPECT_EQ(stats.loadHistogram[AudioLoadMonitor::HISTOGRAM_BINS - 1], 2u);
+    EXPECT_FLOAT_EQ(stats.peakLoad, 3.0f);
+    EXPECT_NEAR(stats.fractionAtOrAbove(0.9f), 1.0, 1e-9);
+    EXPECT_NEAR(stats.fractionAtOrAbove(1.0f), 2.0 / 3.0, 1e-9);
+}
+
+// Test the bin for a load value, including out-of-range input
+TEST(AudioLoadMonitorTests, BinForLoad) {
+    EXPECT_EQ(AudioLoadMonitor::binForLoad(-1.0f), 0u);
+    EXPECT_EQ(AudioLoadMonitor::binForLoad(0.0f), 0u);
+    EXPECT_EQ(AudioLoadMonitor::binForLoad(0.099f), 0u);
+    EXPECT_EQ(AudioLoadMonitor::binForLoad(0.1f), 1u);
+    EXPECT_EQ(AudioLoadMonitor::binForLoad(0.95f), 9u);
+    EXPECT_EQ(AudioLoadMonitor::binForLoad(50.0f), AudioLoadMonitor::HISTOGRAM_BINS - 1);
+}
+
+// Test reset clears every counter
+TEST(AudioLoadMonitorTests, Reset) {
+    AudioLoadMonitor monitor;
+    monitor.recordBlock(0.02, 0.01);
+    monitor.recordUnderrun();
+    monitor.reset();
+
+    auto stats = monitor.getSnapshot();
+    EXPECT_EQ(stats.blocks, 0u);
+    EXPECT_EQ(stats.lateBlocks, 0u);
+    EXPECT_EQ(stats.underruns, 0u);
+    EXPECT_FLOAT_EQ(stats.peakLoad, 0.0f);
+    EXPECT_EQ(stats.fractionAtOrAbove(0.0f), 0.0);
+}
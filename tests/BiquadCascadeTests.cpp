@@ -0,0 +1,293 @@
+#include "gtest/gtest.h"
+#include "../BiquadCascade.h"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const std::array<float, 12> FREQUENCIES = {31.5f, 63.0f, 125.0f, 250.0f, 500.0f, 1000.0f,
+                                           2000.0f, 4000.0f, 8000.0f, 16000.0f, 20000.0f, 20000.0f};
+
+std::vector<float> noise(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> samples(count);
+    for (float& sample : samples) {
+        sample = dist(rng);
+    }
+    return samples;
+}
+
+// The array-of-structs loop SpectrumWindow::applyEQ used before the
+// cascade: reference for correctness and the benchmark baseline
+struct ScalarBiquad {
+    BiquadCascade::Coefficients c;
+    float z1L = 0.0f, z2L = 0.0f, z1R = 0.0f, z2R = 0.0f;
+
+    float process(float input, float& z1, float& z2) const {
+        float output = input * c.b0 + z1;
+        z1 = input * c.b1 + z2 - c.a1 * output;
+        z2 = input * c.b2 - c.a2 * output;
+        return output;
+    }
+};
+
+void scalarEQ(std::array<ScalarBiquad, 12>& filters, float* samples, size_t frameCount) {
+    for (size_t frame = 0; frame < frameCount; frame++) {
+        float left = samples[frame * 2];
+        float right = samples[frame * 2 + 1];
+        for (auto& filter : filters) {
+            left = filter.process(left, filter.z1L, filter.z2L);
+            right = filter.process(right, filter.z1R, filter.z2R);
+        }
+        samples[frame * 2] = left;
+        samples[frame * 2 + 1] = right;
+    }
+}
+
+std::array<BiquadCascade::Coefficients, 12> bands(const std::array<float, 12>& gains) {
+    std::array<BiquadCascade::Coefficients, 12> stages;
+    for (size_t i = 0; i < stages.size(); ++i) {
+        stages[i] = BiquadCascade::peakingEQ(FREQUENCIES[i], gains[i], 1.414f, 44100.0f);
+    }
+    return stages;
+}
+
+} // namespace
+
+// Test the cascade matches the scalar per-band loop, across block splits
+TEST(BiquadCascadeTests, MatchesScalarLoop) {
+    const std::array<float, 12> gains = {6.0f, -3.0f, 0.0f, 12.0f, -12.0f, 2.5f,
+                                         0.0f, -6.0f, 4.0f, 9.0f, -1.0f, 0.0f};
+    auto stages = bands(gains);
+
+    std::array<ScalarBiquad, 12> reference;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        reference[i].c = stages[i];
+    }
+    BiquadCascade cascade;
+    cascade.setStages(stages.data(), static_cast<int>(stages.size()));
+    EXPECT_EQ(cascade.getActiveStageCount(), 9);
+
+    auto expected = noise(4096 * 2, 1);
+    auto actual = expected;
+    scalarEQ(reference, expected.data(), 4096);
+    cascade.process(actual.data(), 1000, 2);
+    cascade.process(actual.data() + 2000, 3096, 2);
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_NEAR(actual[i], expected[i], 1e-4f) << "sample " << i;
+    }
+}
+
+// Test bands at 0 dB are dropped from the chain and a flat EQ is a no-op
+TEST(BiquadCascadeTests, SkipsFlatBands) {
+    std::array<float, 12> gains{};
+    auto stages = bands(gains);
+    for (const auto& stage : stages) {
+        EXPECT_TRUE(stage.isIdentity());
+    }
+
+    BiquadCascade cascade;
+    cascade.setStages(stages.data(), static_cast<int>(stages.size()));
+    EXPECT_EQ(cascade.getActiveStageCount(), 0);
+
+    auto samples = noise(512, 2);
+    auto original = samples;
+    cascade.process(samples.data(), 256, 2);
+    EXPECT_EQ(samples, original);
+
+    gains[5] = 3.0f;
+    stages = bands(gains);
+    cascade.setStages(stages.data(), static_cast<int>(stages.size()));
+    EXPECT_EQ(cascade.getActiveStageCount(), 1);
+}
+
+// Test the shelves are identity when flat and reach their gain at the shelved end
+TEST(BiquadCascadeTests, ShelvesReachTheirGain) {
+    EXPECT_TRUE(BiquadCascade::lowShelf(250.0f, 0.0f, 44100.0f).isIdentity());
+    EXPECT_TRUE(BiquadCascade::highShelf(4000.0f, 0.0f, 44100.0f).isIdentity());
+
+    // |H| at DC is (b0 + b1 + b2) / (1 + a1 + a2), at Nyquist (b0 - b1 + b2) / (1 - a1 + a2)
+    auto dcGain = [](const BiquadCascade::Coefficients& c) { return (c.b0 + c.b1 + c.b2) / (1.0f + c.a1 + c.a2); };
+    auto nyquistGain = [](const BiquadCascade::Coefficients& c) { return (c.b0 - c.b1 + c.b2) / (1.0f - c.a1 + c.a2); };
+    const float boost = std::pow(10.0f, 6.0f / 20.0f);
+
+    auto low = BiquadCascade::lowShelf(250.0f, 6.0f, 44100.0f);
+    EXPECT_NEAR(dcGain(low), boost, 1e-3f);
+    EXPECT_NEAR(nyquistGain(low), 1.0f, 1e-3f);
+
+    auto high = BiquadCascade::highShelf(4000.0f, 6.0f, 44100.0f);
+    EXPECT_NEAR(dcGain(high), 1.0f, 1e-3f);
+    EXPECT_NEAR(nyquistGain(high), boost, 1e-3f);
+}
+
+// Test each lane is an independent channel, for every supported width
+TEST(BiquadCascadeTests, ChannelsAreIndependent) {
+    std::array<float, 12> gains{};
+    gains[2] = 9.0f;
+    gains[7] = -9.0f;
+    auto stages = bands(gains);
+
+    const size_t frames = 1024;
+    for (int channels = 1; channels <= BiquadCascade::MAX_CHANNELS; ++channels) {
+        // A different signal per channel, each checked against a mono run
+        std::vector<std::vector<float>> expected;
+        std::vector<float> interleaved(frames * channels);
+        for (int ch = 0; ch < channels; ++ch) {
+            auto mono = noise(frames, 10 + ch);
+            for (size_t i = 0; i < frames; ++i) {
+                interleaved[i * channels + ch] = mono[i];
+            }
+            BiquadCascade single;
+            single.setStages(stages.data(), static_cast<int>(stages.size()));
+            single.process(mono.data(), frames, 1);
+            expected.push_back(mono);
+        }
+
+        BiquadCascade cascade;
+        cascade.setStages(stages.data(), static_cast<int>(stages.size()));
+        cascade.process(interleaved.data(), frames, channels);
+        for (size_t i = 0; i < frames; ++i) {
+            for (int ch = 0; ch < channels; ++ch) {
+                ASSERT_FLOAT_EQ(interleaved[i * channels + ch], expected[ch][i]);
+            }
+        }
+    }
+}
+
+// Test a published set is swapped in at the next block and ramped to
+TEST(BiquadCascadeTests, PublishedSetRampsIn) {
+    std::array<float, 12> gains{};
+    gains[5] = 12.0f;  // 1 kHz
+    auto target = bands(gains);
+
+    std::vector<float> sine(1024 * 2);
+    for (size_t i = 0; i < 1024; ++i) {
+        sine[i * 2] = sine[i * 2 + 1] = 0.25f * std::sin(2.0f * 3.14159265f * 1000.0f * i / 44100.0f);
+    }
+
+    BiquadCascade immediate;
+    immediate.setStages(target.data(), static_cast<int>(target.size()));
+    auto stepped = sine;
+    immediate.process(stepped.data(), 1024, 2);
+
+    BiquadCascade ramped;
+    ramped.publish(target.data(), static_cast<int>(target.size()));
+    EXPECT_EQ(ramped.getStageCount(), 0);  // Nothing changes before the block
+    auto smooth = sine;
+    ramped.process(smooth.data(), 1024, 2);
+
+    // Target reached exactly by the end of the block
+    ASSERT_EQ(ramped.getStageCount(), 12);
+    EXPECT_EQ(ramped.getActiveStageCount(), 1);
+    EXPECT_EQ(ramped.getStage(5).b0, target[5].b0);
+    EXPECT_EQ(ramped.getStage(5).a2, target[5].a2);
+
+    // The first step stays much closer to the dry signal than a hard swap
+    double rampedError = 0.0, steppedError = 0.0;
+    for (size_t i = 0; i < 32 * 2; ++i) {
+        rampedError += std::abs(smooth[i] - sine[i]);
+        steppedError += std::abs(stepped[i] - sine[i]);
+    }
+    EXPECT_LT(rampedError, steppedError * 0.25);
+
+    // Only the newest of several publishes is used
+    gains[5] = 0.0f;
+    gains[0] = 6.0f;
+    auto first = bands(gains);
+    gains[0] = 0.0f;
+    auto second = bands(gains);
+    ramped.publish(first.data(), static_cast<int>(first.size()));
+    ramped.publish(second.data(), static_cast<int>(second.size()));
+    ramped.process(smooth.data(), 256, 2);
+    EXPECT_EQ(ramped.getActiveStageCount(), 0);
+}
+
+// Test sets published from another thread are never seen half-written
+TEST(BiquadCascadeTests, ConcurrentPublishNeverTears) {
+    BiquadCascade cascade;
+    std::atomic<bool> running{true};
+
+    // Every set is uniform, so a mix of two sets shows up as unequal values
+    std::thread writer([&]() {
+        std::array<BiquadCascade::Coefficients, BiquadCascade::MAX_STAGES> stages;
+        for (float value = 1.0f; running; value += 1.0f) {
+            for (auto& stage : stages) {
+                stage = {value, value, value, value, value};
+            }
+            cascade.publish(stages.data(), static_cast<int>(stages.size()));
+        }
+    });
+
+    float block[2] = {};
+    int swaps = 0;
+    for (int i = 0; i < 200000; ++i) {
+        float before = cascade.getStageCount() ? cascade.getStage(0).b0 : 0.0f;
+        cascade.process(block, 0, 2);  // Swap only, no audio
+        if (cascade.getStageCount() == 0) continue;
+
+        float value = cascade.getStage(0).b0;
+        if (value != before) swaps++;
+        for (int stage = 0; stage < cascade.getStageCount(); ++stage) {
+            const auto& c = cascade.getStage(stage);
+            ASSERT_EQ(c.b0, value);
+            ASSERT_EQ(c.b1, value);
+            ASSERT_EQ(c.b2, value);
+            ASSERT_EQ(c.a1, value);
+            ASSERT_EQ(c.a2, value);
+        }
+    }
+
+    running = false;
+    writer.join();
+    EXPECT_GT(swaps, 0);
+}
+
+// Benchmark against the scalar loop. Disabled by default;
+// run with --gtest_also_run_disabled_tests --gtest_filter=BiquadCascadeTests.*
+TEST(BiquadCascadeTests, DISABLED_Benchmark) {
+    using Clock = std::chrono::steady_clock;
+    const size_t frames = 512;
+    const int iterations = 20000;
+
+    const std::array<float, 12> allBands = {3.0f, -3.0f, 2.0f, -2.0f, 4.0f, -4.0f,
+                                            1.0f, -1.0f, 5.0f, -5.0f, 6.0f, -6.0f};
+    const std::array<float, 12> fewBands = {3.0f, 0.0f, 0.0f, 0.0f, -4.0f, 0.0f,
+                                            0.0f, 0.0f, 5.0f, 0.0f, 0.0f, 0.0f};
+
+    for (const auto* gains : {&allBands, &fewBands}) {
+        auto stages = bands(*gains);
+        auto input = noise(frames * 2, 4);
+        auto buffer = input;
+
+        std::array<ScalarBiquad, 12> reference;
+        for (size_t i = 0; i < reference.size(); ++i) {
+            reference[i].c = stages[i];
+        }
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            buffer = input;
+            scalarEQ(reference, buffer.data(), frames);
+        }
+        double baseline = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+
+        BiquadCascade cascade;
+        cascade.setStages(stages.data(), static_cast<int>(stages.size()));
+        start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            buffer = input;
+            cascade.process(buffer.data(), frames, 2);
+        }
+        double simd = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+
+        std::printf("EQ %2d active bands, %zu stereo frames: scalar %7.2f us, cascade %7.2f us (%.1fx)\n",
+                    cascade.getActiveStageCount(), frames, baseline, simd, baseline / simd);
+    }
+}
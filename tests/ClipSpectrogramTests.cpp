@@ -0,0 +1,159 @@
+#include "gtest/gtest.h"
+#include "../ClipSpectrogram.h"
+#include "../Spectrogram.h"
+#include "../RecordingRecovery.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <thread>
+
+namespace {
+
+std::shared_ptr<AudioClip> makeSineClip(double frequency, double seconds, uint32_t sampleRate = 44100) {
+    auto clip = std::make_shared<AudioClip>();
+    AudioFormat format;
+    format.channels = 2;
+    format.sampleRate = sampleRate;
+    clip->setFormat(format);
+
+    size_t frames = static_cast<size_t>(seconds * sampleRate);
+    auto& samples = clip->getSamplesWritable();
+    samples.resize(frames * 2);
+    for (size_t i = 0; i < frames; ++i) {
+        float value = 0.5f * static_cast<float>(std::sin(2.0 * 3.14159265358979 * frequency * i / sampleRate));
+        samples[i * 2] = value;
+        samples[i * 2 + 1] = value;
+    }
+    return clip;
+}
+
+std::wstring tempSidecar(const wchar_t* name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path.wstring();
+}
+
+bool waitReady(const ClipSpectrogram& spectrogram) {
+    for (int i = 0; i < 500 && !spectrogram.isReady() && !spectrogram.hasFailed(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return spectrogram.isReady();
+}
+
+} // namespace
+
+// Test the sidecar's pyramid: tone in the right row, halving column counts
+// down to one, and each coarser column the max of the two below it
+TEST(ClipSpectrogramTests, BuildsPyramid) {
+    auto clip = makeSineClip(1000.0, 3.0);
+    std::wstring path = tempSidecar(L"ClipSpectrogramTests_pyramid.spec");
+
+    std::atomic<bool> cancel{false};
+    std::atomic<float> progress{0.0f};
+    ASSERT_TRUE(ClipSpectrogram::build(*clip, path, cancel, progress));
+
+    std::vector<uint64_t> levelColumns;
+    ASSERT_TRUE(ClipSpectrogram::readHeader(path, *clip, levelColumns));
+    EXPECT_EQ(levelColumns[0], (clip->getSampleCount() + ClipSpectrogram::BASE_HOP - 1) / ClipSpectrogram::BASE_HOP);
+    EXPECT_EQ(levelColumns.back(), 1u);
+    for (size_t level = 1; level < levelColumns.size(); ++level) {
+        EXPECT_EQ(levelColumns[level], (levelColumns[level - 1] + 1) / 2);
+    }
+
+    ClipSpectrogram spectrogram(clip, path);
+    spectrogram.start(nullptr);
+    ASSERT_TRUE(waitReady(spectrogram));
+
+    auto base = spectrogram.getTile(0, 0);
+    auto pooled = spectrogram.getTile(1, 0);
+    ASSERT_NE(base, nullptr);
+    ASSERT_NE(pooled, nullptr);
+
+    const size_t rows = ClipSpectrogram::ROWS;
+    const uint8_t* middle = base->data() + 100 * rows;
+    int loudest = static_cast<int>(std::max_element(middle, middle + rows) - middle);
+    double rowsPerOctave = rows / std::log2(Spectrogram::MAX_FREQ / Spectrogram::MIN_FREQ);
+    EXPECT_NEAR(loudest, std::log2(1000.0 / Spectrogram::MIN_FREQ) * rowsPerOctave, 2.0);
+    EXPECT_GT(middle[loudest], 200);
+
+    for (size_t column = 0; column < 50; ++column) {
+        for (size_t row = 0; row < rows; ++row) {
+            uint8_t expected = std::max(base->at(2 * column * rows + row), base->at((2 * column + 1) * rows + row));
+            ASSERT_EQ(pooled->at(column * rows + row), expected);
+        }
+    }
+
+    // Past the last column is out of range
+    uint64_t tiles = (levelColumns[0] + ClipSpectrogram::TILE_COLUMNS - 1) / ClipSpectrogram::TILE_COLUMNS;
+    EXPECT_NE(spectrogram.getTile(0, tiles - 1), nullptr);
+    EXPECT_EQ(spectrogram.getTile(0, tiles), nullptr);
+
+    std::filesystem::remove(path);
+}
+
+// Test a sidecar made for different audio is rebuilt rather than reused
+TEST(ClipSpectrogramTests, RejectsStaleSidecar) {
+    auto clip = makeSineClip(500.0, 1.0);
+    std::wstring path = tempSidecar(L"ClipSpectrogramTests_stale.spec");
+    std::atomic<bool> cancel{false};
+    std::atomic<float> progress{0.0f};
+    ASSERT_TRUE(ClipSpectrogram::build(*clip, path, cancel, progress));
+
+    auto edited = makeSineClip(4000.0, 1.0);
+    std::vector<uint64_t> levelColumns;
+    EXPECT_FALSE(ClipSpectrogram::readHeader(path, *edited, levelColumns));
+
+    ClipSpectrogram spectrogram(edited, path);
+    bool notified = false;
+    spectrogram.start([&]() { notified = true; });
+    ASSERT_TRUE(waitReady(spectrogram));
+    EXPECT_TRUE(notified);
+    EXPECT_TRUE(ClipSpectrogram::readHeader(path, *edited, levelColumns));
+
+    std::filesystem::remove(path);
+}
+
+// Test the zoom level picks the coarsest columns no wider than a pixel
+TEST(ClipSpectrogramTests, ChooseLevel) {
+    auto clip = makeSineClip(250.0, 10.0, 48000);
+    std::wstring path = tempSidecar(L"ClipSpectrogramTests_levels.spec");
+    ClipSpectrogram spectrogram(clip, path);
+    spectrogram.start(nullptr);
+    ASSERT_TRUE(waitReady(spectrogram));
+
+    const double baseSeconds = static_cast<double>(ClipSpectrogram::BASE_HOP) / 48000.0;
+    EXPECT_DOUBLE_EQ(spectrogram.getColumnSeconds(0), baseSeconds);
+    EXPECT_EQ(spectrogram.chooseLevel(baseSeconds * 0.5), 0);
+    EXPECT_EQ(spectrogram.chooseLevel(baseSeconds * 4.5), 2);
+    EXPECT_EQ(spectrogram.chooseLevel(1e6), spectrogram.getLevelCount() - 1);
+
+    std::filesystem::remove(path);
+}
+
+// Test a recorded take's sidecar follows the take into the project folder
+// instead of staying beside the journal file it was recorded to
+TEST(ClipSpectrogramTests, RecordedTakeSidecarBesideProjectFile) {
+    auto directory = std::filesystem::temp_directory_path() / L"ClipSpectrogramTests_project";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const std::wstring take = (directory / L"take_1.partial.wav").wstring();
+    const std::wstring projectFile = (directory / L"Song_Track1_Take1.wav").wstring();
+
+    // As stopRecording() hands it over: loaded from the journal file
+    ASSERT_TRUE(makeSineClip(500.0, 1.0)->saveToFile(take));
+    auto clip = std::make_shared<AudioClip>();
+    ASSERT_TRUE(clip->loadFromFile(take));
+
+    ASSERT_TRUE(RecordingRecovery::adoptTake(*clip, take, projectFile));
+    EXPECT_EQ(clip->getFilename(), projectFile);
+    EXPECT_FALSE(std::filesystem::exists(take));
+
+    ClipSpectrogram spectrogram(clip, ClipSpectrogram::sidecarPathFor(*clip));
+    spectrogram.start(nullptr);
+    ASSERT_TRUE(waitReady(spectrogram));
+    EXPECT_TRUE(std::filesystem::exists(projectFile + L".spec"));
+    EXPECT_FALSE(std::filesystem::exists(take + L".spec"));
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,248 @@
+#include "gtest/gtest.h"
+#include "../ConvolutionReverb.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<float> noise(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> samples(count);
+    for (float& sample : samples) {
+        sample = dist(rng);
+    }
+    return samples;
+}
+
+// Exponentially decaying noise, like a room
+std::vector<float> decayingNoise(size_t count, unsigned seed) {
+    auto samples = noise(count, seed);
+    for (size_t n = 0; n < count; ++n) {
+        samples[n] *= static_cast<float>(std::exp(-3.0 * n / count));
+    }
+    return samples;
+}
+
+// Direct convolution of one channel of interleaved stereo at a few output frames
+float directAt(const std::vector<float>& input, int channel, const std::vector<float>& ir, size_t frame) {
+    double sum = 0.0;
+    for (size_t k = 0; k < ir.size() && k <= frame; ++k) {
+        sum += double(ir[k]) * input[(frame - k) * 2 + channel];
+    }
+    return static_cast<float>(sum);
+}
+
+// Runs stereo input through the reverb in host blocks of blockFrames; returns the wet signal
+std::vector<float> render(ConvolutionReverb& reverb, const std::vector<float>& input, size_t blockFrames,
+                          bool paced = false) {
+    std::vector<float> output(input.size(), 0.0f);
+    size_t frames = input.size() / 2;
+    for (size_t offset = 0; offset < frames; offset += blockFrames) {
+        size_t count = std::min(blockFrames, frames - offset);
+        reverb.process(&input[offset * 2], &output[offset * 2], count);
+        if (paced) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    return output;
+}
+
+} // namespace
+
+// Test the wet signal equals the direct convolution, one head block late,
+// across the head and both tail levels
+TEST(ConvolutionReverbTests, MatchesDirectConvolution) {
+    const size_t irLength = 40000;   // Reaches into the 8192 level
+    const size_t frames = 60000;
+    auto left = decayingNoise(irLength, 1);
+    auto right = decayingNoise(irLength, 2);
+    auto input = noise(frames * 2, 3);
+
+    ConvolutionReverb reverb(true);
+    reverb.setWetLevel(1.0f);
+    ASSERT_TRUE(reverb.setImpulseResponse(left, right));
+    auto output = render(reverb, input, 300);
+
+    const size_t latency = ConvolutionReverb::HEAD_BLOCK;
+    for (size_t frame : {size_t(0), size_t(1000), size_t(2047), size_t(2048), size_t(5000), size_t(16383),
+                         size_t(16384), size_t(30000), size_t(45000), frames - latency - 1}) {
+        EXPECT_NEAR(output[(frame + latency) * 2], directAt(input, 0, left, frame), 2e-3f) << "frame " << frame;
+        EXPECT_NEAR(output[(frame + latency) * 2 + 1], directAt(input, 1, right, frame), 2e-3f) << "frame " << frame;
+    }
+    for (size_t frame = 0; frame < latency; ++frame) {
+        EXPECT_EQ(output[frame * 2], 0.0f);
+    }
+    EXPECT_EQ(reverb.getLateBlocks(), 0u);
+}
+
+// Test the wet signal is added to the output, which may be the input itself
+TEST(ConvolutionReverbTests, AddsToOutputInPlace) {
+    std::vector<float> ir = {1.0f, 0.0f, 0.5f};
+    ConvolutionReverb reverb(true);
+    reverb.setWetLevel(0.5f);
+    ASSERT_TRUE(reverb.setImpulseResponse(ir, ir));
+
+    const size_t frames = ConvolutionReverb::HEAD_BLOCK * 3;
+    std::vector<float> samples(frames * 2, 0.0f);
+    samples[0] = 1.0f;   // Left impulse
+    samples[3] = 2.0f;   // Right impulse at frame 1
+    reverb.process(samples.data(), samples.data(), frames);
+
+    const size_t latency = ConvolutionReverb::HEAD_BLOCK;
+    EXPECT_FLOAT_EQ(samples[0], 1.0f);   // Dry signal untouched
+    EXPECT_NEAR(samples[latency * 2], 0.5f, 1e-5f);
+    EXPECT_NEAR(samples[(latency + 2) * 2], 0.25f, 1e-5f);
+    EXPECT_NEAR(samples[(latency + 1) * 2 + 1], 1.0f, 1e-5f);
+    EXPECT_NEAR(samples[(latency + 3) * 2 + 1], 0.5f, 1e-5f);
+    EXPECT_NEAR(samples[(latency + 1) * 2], 0.0f, 1e-5f);
+}
+
+// Test a loaded clip is resampled, trimmed of silence and normalized, and a
+// mono clip feeds both channels
+TEST(ConvolutionReverbTests, PreparesResponse) {
+    AudioClip clip;
+    AudioFormat format;
+    format.channels = 1;
+    format.sampleRate = 22050;
+    clip.setFormat(format);
+    auto& samples = clip.getSamplesWritable();
+    samples.assign(20000, 0.0f);
+    for (size_t n = 0; n < 5000; ++n) {
+        samples[n] = (n % 2 ? 0.5f : -0.5f) * static_cast<float>(std::exp(-4.0 * n / 5000));
+    }
+
+    std::vector<float> left, right;
+    ASSERT_TRUE(ConvolutionReverb::prepareResponse(clip, 44100, left, right));
+    EXPECT_EQ(left, right);
+    EXPECT_NEAR(static_cast<double>(left.size()), 10000.0, 2.0);   // Trailing silence gone, rate doubled
+
+    double energy = 0.0;
+    for (float sample : left) {
+        energy += double(sample) * sample;
+    }
+    EXPECT_NEAR(energy, 1.0, 1e-4);
+
+    // Silence is rejected
+    std::fill(samples.begin(), samples.end(), 0.0f);
+    EXPECT_FALSE(ConvolutionReverb::prepareResponse(clip, 44100, left, right));
+    ConvolutionReverb reverb;
+    EXPECT_FALSE(reverb.setImpulseResponse(clip, 44100));
+    EXPECT_FALSE(reverb.hasImpulseResponse());
+}
+
+// Test the worker-driven tail gives the same result as offline rendering
+// when the audio thread keeps to real-time-like pacing
+TEST(ConvolutionReverbTests, WorkerMatchesOffline) {
+    auto ir = decayingNoise(30000, 4);
+    auto input = noise(50000 * 2, 5);
+
+    ConvolutionReverb offline(true);
+    ConvolutionReverb realtime(false);
+    offline.setImpulseResponse(ir, ir);
+    realtime.setImpulseResponse(ir, ir);
+
+    auto expected = render(offline, input, 128);
+    auto actual = render(realtime, input, 128, true);
+
+    ASSERT_EQ(realtime.getLateBlocks(), 0u);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_NEAR(actual[i], expected[i], 1e-5f) << "sample " << i;
+    }
+}
+
+// Test clearing the response silences the wet signal
+TEST(ConvolutionReverbTests, ClearSilences) {
+    std::vector<float> ir(5000, 0.01f);
+    ConvolutionReverb reverb(true);
+    reverb.setImpulseResponse(ir, ir, L"room.wav");
+    EXPECT_TRUE(reverb.hasImpulseResponse());
+    EXPECT_EQ(reverb.getImpulseResponsePath(), L"room.wav");
+
+    auto input = noise(1024 * 2, 6);
+    auto output = render(reverb, input, 256);
+    EXPECT_NE(output[1000], 0.0f);
+
+    reverb.clearImpulseResponse();
+    EXPECT_FALSE(reverb.hasImpulseResponse());
+    output = render(reverb, input, 256);
+    for (float sample : output) {
+        ASSERT_EQ(sample, 0.0f);
+    }
+}
+
+// Test a copy sounds the same and the wet signal ends getTailFrames() after the input
+TEST(ConvolutionReverbTests, CopyRingsOutForTailFrames) {
+    auto ir = decayingNoise(3000, 7);
+    ConvolutionReverb reverb(true);
+    EXPECT_EQ(reverb.getTailFrames(), 0u);
+    reverb.setImpulseResponse(ir, ir, L"hall.wav");
+    reverb.setWetLevel(0.5f);
+    EXPECT_EQ(reverb.getTailFrames(), ir.size() + ConvolutionReverb::HEAD_BLOCK);
+
+    ConvolutionReverb copy(true);
+    ASSERT_TRUE(reverb.copyTo(copy));
+    EXPECT_EQ(copy.getImpulseResponsePath(), L"hall.wav");
+    EXPECT_FLOAT_EQ(copy.getWetLevel(), 0.5f);
+    EXPECT_EQ(copy.getTailFrames(), reverb.getTailFrames());
+
+    // 1000 frames of input, then silence
+    std::vector<float> input(8192 * 2, 0.0f);
+    auto burst = noise(1000 * 2, 8);
+    std::copy(burst.begin(), burst.end(), input.begin());
+    auto original = render(reverb, input, 256);
+    auto copied = render(copy, input, 256);
+    for (size_t i = 0; i < original.size(); ++i) {
+        ASSERT_NEAR(copied[i], original[i], 1e-6f) << "sample " << i;
+    }
+
+    // Past the tail only FFT rounding is left
+    size_t end = 1000 + reverb.getTailFrames();
+    EXPECT_GT(std::abs(original[(end - 200) * 2]), 1e-4f);
+    for (size_t i = end * 2; i < original.size(); ++i) {
+        ASSERT_NEAR(original[i], 0.0f, 1e-6f) << "sample " << i;
+    }
+
+    ConvolutionReverb empty(true);
+    EXPECT_FALSE(empty.copyTo(copy));
+}
+
+// Benchmark 16 tracks with a 6 s stereo response at 48 kHz in 128-frame
+// blocks, counting head and tail work together, as a fraction of one core.
+// Disabled by default; run with --gtest_also_run_disabled_tests --gtest_filter=ConvolutionReverbTests.*
+TEST(ConvolutionReverbTests, DISABLED_Benchmark) {
+    using Clock = std::chrono::steady_clock;
+    const size_t tracks = 16;
+    const uint32_t sampleRate = 48000;
+    const size_t irLength = sampleRate * 6;
+    const size_t block = 128;
+    const size_t frames = sampleRate * 10;
+
+    auto left = decayingNoise(irLength, 7);
+    auto right = decayingNoise(irLength, 8);
+    std::vector<std::unique_ptr<ConvolutionReverb>> reverbs;
+    for (size_t t = 0; t < tracks; ++t) {
+        reverbs.push_back(std::make_unique<ConvolutionReverb>(true));
+        reverbs.back()->setImpulseResponse(left, right);
+    }
+
+    auto input = noise(block * 2, 9);
+    std::vector<float> output(block * 2);
+    auto start = Clock::now();
+    for (size_t offset = 0; offset < frames; offset += block) {
+        for (auto& reverb : reverbs) {
+            reverb->process(input.data(), output.data(), block);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    double audioSeconds = double(frames) / sampleRate;
+
+    std::printf("%zu x %.0f s stereo IR, %zu-frame blocks: %.3f s for %.0f s of audio (%.1f%% of one core)\n",
+                tracks, double(irLength) / sampleRate, block, seconds, audioSeconds,
+                100.0 * seconds / audioSeconds);
+}
@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "../DirectMonitor.h"
+#include <vector>
+
+namespace {
+
+// A recorded block whose left channel counts up from start and right mirrors it
+std::vector<int16_t> rampBlock(uint32_t frames, int16_t start) {
+    std::vector<int16_t> samples(frames * 2);
+    for (uint32_t i = 0; i < frames; ++i) {
+        samples[i * 2] = static_cast<int16_t>(start + i);
+        samples[i * 2 + 1] = static_cast<int16_t>(-(start + static_cast<int>(i)));
+    }
+    return samples;
+}
+
+WAVEHDR headerFor(std::vector<int16_t>& samples, bool recorded) {
+    WAVEHDR header = {};
+    header.lpData = reinterpret_cast<LPSTR>(samples.data());
+    header.dwBufferLength = static_cast<DWORD>(samples.size() * sizeof(int16_t));
+    header.dwBytesRecorded = recorded ? header.dwBufferLength : 0;
+    return header;
+}
+
+} // namespace
+
+// Test the block size is clamped to the supported range
+TEST(DirectMonitorTests, ClampsBlockFrames) {
+    DirectMonitor monitor;
+    monitor.configure(48000, 2, 16);
+    EXPECT_EQ(monitor.getBlockFrames(), DirectMonitor::MIN_BLOCK_FRAMES);
+    monitor.configure(48000, 2, 4096);
+    EXPECT_EQ(monitor.getBlockFrames(), DirectMonitor::MAX_BLOCK_FRAMES);
+}
+
+// Test output stays silent until two blocks are buffered, then passes input through
+TEST(DirectMonitorTests, BuffersTwoBlocksBeforePassingThrough) {
+    DirectMonitor monitor;
+    monitor.configure(48000, 2, 64);
+
+    std::vector<int16_t> out(64 * 2, 1234);
+    WAVEHDR outHeader = headerFor(out, false);
+
+    auto first = rampBlock(64, 1000);
+    WAVEHDR inHeader = headerFor(first, true);
+    monitor.processInput(&inHeader);
+    monitor.fillOutput(&outHeader);
+    EXPECT_EQ(out[0], 0);  // Still priming
+    EXPECT_EQ(out[127], 0);
+
+    auto second = rampBlock(64, 1064);
+    inHeader = headerFor(second, true);
+    monitor.processInput(&inHeader);
+    monitor.fillOutput(&outHeader);
+    EXPECT_NEAR(out[0], 1000, 1);
+    EXPECT_NEAR(out[1], -1000, 1);
+    EXPECT_NEAR(out[126], 1063, 1);
+    EXPECT_EQ(monitor.getStats().underruns, 0u);
+}
+
+// Test an empty recorded block is ignored
+TEST(DirectMonitorTests, IgnoresEmptyInput) {
+    DirectMonitor monitor;
+    monitor.configure(48000, 2, 64);
+
+    auto block = rampBlock(64, 1000);
+    WAVEHDR inHeader = headerFor(block, false);
+    monitor.processInput(&inHeader);
+    EXPECT_EQ(monitor.getStats().fillFrames, 0u);
+}
+
+// Test the monitor gain scales the passed-through signal
+TEST(DirectMonitorTests, AppliesGain) {
+    DirectMonitor monitor;
+    monitor.configure(48000, 2, 64);
+    monitor.setGain(0.5f);
+
+    for (int16_t start : {8000, 8064}) {
+        auto block = rampBlock(64, start);
+        WAVEHDR inHeader = headerFor(block, true);
+        monitor.processInput(&inHeader);
+    }
+
+    std::vector<int16_t> out(64 * 2, 0);
+    WAVEHDR outHeader = headerFor(out, false);
+    monitor.fillOutput(&outHeader);
+    EXPECT_NEAR(out[0], 4000, 1);
+    EXPECT_NEAR(out[1], -4000, 1);
+    EXPECT_NEAR(out[2], 4000, 1);
+}
+
+// Test a device that cannot be opened fails start() and leaves the monitor stopped
+TEST(DirectMonitorTests, StartFailsWithoutDevice) {
+    DirectMonitor monitor;
+    EXPECT_FALSE(monitor.start(9999, 48000, 2));
+    EXPECT_FALSE(monitor.isRunning());
+}
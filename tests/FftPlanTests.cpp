@@ -0,0 +1,185 @@
+#include "gtest/gtest.h"
+#include "../FftPlan.h"
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+std::vector<float> noise(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> samples(count);
+    for (float& sample : samples) {
+        sample = dist(rng);
+    }
+    return samples;
+}
+
+// The radix-2 complex FFT the spectrum analyzer used before FftPlan, kept as
+// the benchmark baseline
+void radix2Fft(std::vector<std::complex<float>>& buffer,
+               const std::vector<std::vector<std::complex<float>>>& twiddles) {
+    const int n = static_cast<int>(buffer.size());
+    int j = 0;
+    for (int i = 0; i < n - 1; i++) {
+        if (i < j) {
+            std::swap(buffer[i], buffer[j]);
+        }
+        int k = n / 2;
+        while (k <= j) {
+            j -= k;
+            k /= 2;
+        }
+        j += k;
+    }
+
+    int stage = 0;
+    for (int len = 2; len <= n; len *= 2) {
+        int halfLen = len / 2;
+        for (int i = 0; i < n; i += len) {
+            for (int k = 0; k < halfLen; k++) {
+                std::complex<float> u = buffer[i + k];
+                std::complex<float> v = buffer[i + k + halfLen] * twiddles[stage][k];
+                buffer[i + k] = u + v;
+                buffer[i + k + halfLen] = u - v;
+            }
+        }
+        stage++;
+    }
+}
+
+} // namespace
+
+// Test only powers of two in range get a plan, and plans are shared
+TEST(FftPlanTests, PlanCache) {
+    EXPECT_EQ(FftPlan::get(32), nullptr);
+    EXPECT_EQ(FftPlan::get(1000), nullptr);
+    EXPECT_EQ(FftPlan::get(131072), nullptr);
+
+    for (size_t size = FftPlan::MIN_SIZE; size <= FftPlan::MAX_SIZE; size *= 2) {
+        const FftPlan* plan = FftPlan::get(size);
+        ASSERT_NE(plan, nullptr);
+        EXPECT_EQ(plan->getSize(), size);
+        EXPECT_EQ(plan->getBinCount(), size / 2 + 1);
+        EXPECT_EQ(FftPlan::get(size), plan);
+    }
+}
+
+// Test the real transform matches a direct DFT, for both odd and even
+// numbers of radix-2 stages and with a window applied
+TEST(FftPlanTests, MatchesDirectDft) {
+    for (size_t size : {size_t(64), size_t(128), size_t(1024)}) {
+        const FftPlan* plan = FftPlan::get(size);
+        ASSERT_NE(plan, nullptr);
+        auto input = noise(size, static_cast<unsigned>(size));
+        const float* window = plan->getWindow(FftPlan::Window::Hann);
+
+        std::vector<float> re(plan->getBinCount()), im(plan->getBinCount());
+        std::vector<float> workspace(plan->getWorkspaceSize());
+        plan->forward(input.data(), re.data(), im.data(), workspace.data(), FftPlan::Window::Hann);
+
+        for (size_t k = 0; k < plan->getBinCount(); ++k) {
+            double sumRe = 0.0, sumIm = 0.0;
+            for (size_t n = 0; n < size; ++n) {
+                double angle = -2.0 * PI * k * n / size;
+                sumRe += input[n] * window[n] * std::cos(angle);
+                sumIm += input[n] * window[n] * std::sin(angle);
+            }
+            EXPECT_NEAR(re[k], sumRe, 1e-3) << "size " << size << " bin " << k;
+            EXPECT_NEAR(im[k], sumIm, 1e-3) << "size " << size << " bin " << k;
+        }
+    }
+}
+
+// Test inverse() undoes forward() at the smallest and largest sizes
+TEST(FftPlanTests, RoundTrip) {
+    for (size_t size : {FftPlan::MIN_SIZE, size_t(2048), FftPlan::MAX_SIZE}) {
+        const FftPlan* plan = FftPlan::get(size);
+        ASSERT_NE(plan, nullptr);
+        auto input = noise(size, 7);
+
+        std::vector<float> re(plan->getBinCount()), im(plan->getBinCount());
+        std::vector<float> workspace(plan->getWorkspaceSize());
+        std::vector<float> output(size);
+        plan->forward(input.data(), re.data(), im.data(), workspace.data());
+        plan->inverse(re.data(), im.data(), output.data(), workspace.data());
+
+        float maxError = 0.0f;
+        for (size_t i = 0; i < size; ++i) {
+            maxError = std::max(maxError, std::abs(output[i] - input[i]));
+        }
+        EXPECT_LT(maxError, 1e-4f) << "size " << size;
+    }
+}
+
+// Test a bin-centred sine lands in its bin with the window's coherent gain
+TEST(FftPlanTests, WindowGain) {
+    const FftPlan* plan = FftPlan::get(4096);
+    ASSERT_NE(plan, nullptr);
+    std::vector<float> input(4096);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>(std::sin(2.0 * PI * 100 * i / input.size()));
+    }
+
+    std::vector<float> re(plan->getBinCount()), im(plan->getBinCount());
+    std::vector<float> workspace(plan->getWorkspaceSize());
+    for (auto window : {FftPlan::Window::Rectangular, FftPlan::Window::Hann,
+                        FftPlan::Window::Hamming, FftPlan::Window::BlackmanHarris}) {
+        plan->forward(input.data(), re.data(), im.data(), workspace.data(), window);
+        float magnitude = std::hypot(re[100], im[100]);
+        EXPECT_NEAR(magnitude, plan->getWindowSum(window) / 2.0f, 0.5f);
+    }
+}
+
+// Benchmark against the previous radix-2 complex FFT. Disabled by default;
+// run with --gtest_also_run_disabled_tests --gtest_filter=FftPlanTests.*
+TEST(FftPlanTests, DISABLED_Benchmark) {
+    using Clock = std::chrono::steady_clock;
+
+    for (size_t size = 256; size <= FftPlan::MAX_SIZE; size *= 4) {
+        const FftPlan* plan = FftPlan::get(size);
+        ASSERT_NE(plan, nullptr);
+        auto input = noise(size, 1);
+        const float* window = plan->getWindow(FftPlan::Window::Hann);
+        const int iterations = static_cast<int>(std::max<size_t>(16, (1 << 22) / size));
+
+        std::vector<std::vector<std::complex<float>>> twiddles;
+        for (size_t len = 2; len <= size; len *= 2) {
+            std::vector<std::complex<float>> stage(len / 2);
+            for (size_t j = 0; j < len / 2; j++) {
+                stage[j] = std::polar(1.0f, static_cast<float>(-2.0 * PI * j / len));
+            }
+            twiddles.push_back(std::move(stage));
+        }
+        std::vector<std::complex<float>> buffer(size);
+        float sink = 0.0f;
+
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            for (size_t n = 0; n < size; ++n) {
+                buffer[n] = std::complex<float>(input[n] * window[n], 0.0f);
+            }
+            radix2Fft(buffer, twiddles);
+            sink += buffer[1].real();
+        }
+        double baseline = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+
+        std::vector<float> re(plan->getBinCount()), im(plan->getBinCount());
+        std::vector<float> workspace(plan->getWorkspaceSize());
+        start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            plan->forward(input.data(), re.data(), im.data(), workspace.data(), FftPlan::Window::Hann);
+            sink += re[1];
+        }
+        double planned = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+
+        std::printf("FFT %6zu: radix-2 complex %9.2f us, real plan %9.2f us (%.1fx)%s\n",
+                    size, baseline, planned, baseline / planned, sink == 0.12345f ? " " : "");
+    }
+}
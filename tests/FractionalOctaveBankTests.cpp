@@ -0,0 +1,173 @@
+#include "gtest/gtest.h"
+#include "../FractionalOctaveBank.h"
+#include "../FftPlan.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+std::vector<float> sine(double freq, float amplitude, size_t count, int sampleRate) {
+    std::vector<float> samples(count);
+    for (size_t n = 0; n < count; ++n) {
+        samples[n] = amplitude * static_cast<float>(std::sin(2.0 * PI * freq * n / sampleRate));
+    }
+    return samples;
+}
+
+// Band levels after settling on the signal: the first part is discarded
+std::vector<float> measure(FractionalOctaveBank& bank, const std::vector<float>& signal, size_t settle) {
+    std::vector<float> levels(bank.getBandCount());
+    bank.process(signal.data(), settle);
+    bank.takeLevels(levels.data());
+    // Odd block sizes, unrelated to the bank's chunking
+    for (size_t offset = settle; offset < signal.size(); offset += 1000) {
+        bank.process(&signal[offset], std::min<size_t>(1000, signal.size() - offset));
+    }
+    bank.takeLevels(levels.data());
+    return levels;
+}
+
+size_t nearestBand(const FractionalOctaveBank& bank, double freq) {
+    const auto& centers = bank.getCenters();
+    size_t best = 0;
+    for (size_t i = 1; i < centers.size(); ++i) {
+        if (std::abs(std::log(centers[i] / freq)) < std::abs(std::log(centers[best] / freq))) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+double dB(float level) {
+    return 20.0 * std::log10(std::max(level, 1e-9f));
+}
+
+} // namespace
+
+// Test the band layout: base-2 centres through 1 kHz, 20 Hz to 20 kHz,
+// nothing too close to Nyquist
+TEST(FractionalOctaveBankTests, BandLayout) {
+    FractionalOctaveBank bank;
+    ASSERT_TRUE(bank.configure(3, 44100));
+    const auto& centers = bank.getCenters();
+    EXPECT_EQ(centers.size(), 30u);
+    EXPECT_NEAR(centers.front(), 19.69f, 0.01f);
+    EXPECT_NEAR(centers.back(), 16000.0f, 0.5f);
+    EXPECT_NE(std::find(centers.begin(), centers.end(), 1000.0f), centers.end());
+    for (size_t i = 1; i < centers.size(); ++i) {
+        EXPECT_NEAR(centers[i] / centers[i - 1], std::pow(2.0, 1.0 / 3.0), 1e-4);
+    }
+
+    ASSERT_TRUE(bank.configure(6, 48000));
+    EXPECT_EQ(bank.getBandCount(), 60u);
+
+    // Lower rates lose the top bands
+    ASSERT_TRUE(bank.configure(3, 22050));
+    EXPECT_LT(bank.getCenters().back() * std::pow(2.0f, 1.0f / 6.0f), 0.48f * 22050);
+
+    EXPECT_FALSE(bank.configure(0, 44100));
+    EXPECT_FALSE(bank.configure(3, 0));
+    EXPECT_EQ(bank.getBandsPerOctave(), 3);
+}
+
+// Test a sine at a band centre reads its amplitude in that band, on every
+// decimation level, and bands an octave away are far down
+TEST(FractionalOctaveBankTests, SineLandsInItsBand) {
+    const int sampleRate = 44100;
+    for (int bandsPerOctave : {3, 6}) {
+        FractionalOctaveBank bank;
+        ASSERT_TRUE(bank.configure(bandsPerOctave, sampleRate));
+
+        for (double freq : {25.0, 31.5, 100.0, 1000.0, 5000.0, 12500.0}) {
+            size_t band = nearestBand(bank, freq);
+            double center = bank.getCenters()[band];
+            auto signal = sine(center, 0.5f, sampleRate * 3, sampleRate);
+            bank.reset();
+            auto levels = measure(bank, signal, sampleRate);
+
+            EXPECT_NEAR(dB(levels[band]), dB(0.5f), 0.3) << bandsPerOctave << " " << freq;
+            size_t octave = static_cast<size_t>(bandsPerOctave);
+            if (band >= octave) {
+                EXPECT_LT(dB(levels[band - octave]), dB(0.5f) - 40.0) << bandsPerOctave << " " << freq;
+            }
+            if (band + octave < levels.size()) {
+                EXPECT_LT(dB(levels[band + octave]), dB(0.5f) - 40.0) << bandsPerOctave << " " << freq;
+            }
+        }
+    }
+}
+
+// Test low tones a few hertz apart, which share a bin at 4096 points, are
+// told apart
+TEST(FractionalOctaveBankTests, ResolvesLowFrequencies) {
+    const int sampleRate = 44100;
+    FractionalOctaveBank bank;
+    ASSERT_TRUE(bank.configure(6, sampleRate));
+
+    size_t low = nearestBand(bank, 40.0);
+    size_t high = low + 1;
+    EXPECT_LT(bank.getCenters()[high] - bank.getCenters()[low], sampleRate / 4096.0);
+
+    auto signal = sine(bank.getCenters()[low], 0.5f, sampleRate * 4, sampleRate);
+    auto levels = measure(bank, signal, sampleRate * 2);
+    EXPECT_GT(dB(levels[low]) - dB(levels[high]), 10.0);
+    EXPECT_GT(dB(levels[low]) - dB(levels[high + 1]), 30.0);
+}
+
+// Test reset forgets accumulated energy and filter state
+TEST(FractionalOctaveBankTests, ResetClears) {
+    FractionalOctaveBank bank;
+    ASSERT_TRUE(bank.configure(3, 44100));
+    auto signal = sine(1000.0, 0.5f, 4410, 44100);
+    bank.process(signal.data(), signal.size());
+    bank.reset();
+
+    std::vector<float> silence(4410, 0.0f);
+    bank.process(silence.data(), silence.size());
+    std::vector<float> levels(bank.getBandCount());
+    bank.takeLevels(levels.data());
+    for (float level : levels) {
+        EXPECT_EQ(level, 0.0f);
+    }
+}
+
+// Benchmark the 1/6-octave bank over one 1024-frame hop against the single
+// 32768-point FFT an STFT needs for similar resolution at 40 Hz.
+// Disabled by default; run with --gtest_also_run_disabled_tests --gtest_filter=FractionalOctaveBankTests.*
+TEST(FractionalOctaveBankTests, DISABLED_Benchmark) {
+    using Clock = std::chrono::steady_clock;
+    const int sampleRate = 44100;
+    const size_t hop = 1024;
+    auto signal = sine(440.0, 0.5f, hop, sampleRate);
+    const int iterations = 2000;
+
+    for (int bandsPerOctave : {3, 6}) {
+        FractionalOctaveBank bank;
+        bank.configure(bandsPerOctave, sampleRate);
+        std::vector<float> levels(bank.getBandCount());
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            bank.process(signal.data(), hop);
+            bank.takeLevels(levels.data());
+        }
+        double bankUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+        std::printf("1/%d octave bank (%zu bands): %7.2f us per %zu-frame hop\n",
+                    bandsPerOctave, bank.getBandCount(), bankUs, hop);
+    }
+
+    const FftPlan* plan = FftPlan::get(32768);
+    ASSERT_NE(plan, nullptr);
+    std::vector<float> frame(plan->getSize(), 0.25f), re(plan->getBinCount()), im(plan->getBinCount());
+    std::vector<float> workspace(plan->getWorkspaceSize());
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        plan->forward(frame.data(), re.data(), im.data(), workspace.data());
+    }
+    double fftUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+    std::printf("32768-point FFT:               %7.2f us per hop\n", fftUs);
+}
@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+#include "../InputMonitorBuffer.h"
+#include <vector>
+
+namespace {
+
+// Stereo frames whose left channel counts up from start
+std::vector<float> rampFrames(size_t frames, float start) {
+    std::vector<float> samples(frames * 2);
+    for (size_t i = 0; i < frames; ++i) {
+        samples[i * 2] = start + static_cast<float>(i);
+        samples[i * 2 + 1] = -(start + static_cast<float>(i));
+    }
+    return samples;
+}
+
+} // namespace
+
+// Test output stays silent until the target latency is buffered
+TEST(InputMonitorBufferTests, PrimesToTargetLatency) {
+    InputMonitorBuffer monitor;
+    monitor.configure(2, 4096, 256);
+
+    std::vector<float> out(64 * 2, 1.0f);
+    auto input = rampFrames(128, 1.0f);
+    monitor.push(input.data(), 128);
+    monitor.pull(out.data(), 64);
+    EXPECT_FLOAT_EQ(out[0], 0.0f);  // Still priming
+    EXPECT_EQ(monitor.getStats().underruns, 0u);
+
+    auto more = rampFrames(128, 129.0f);
+    monitor.push(more.data(), 128);
+    monitor.pull(out.data(), 64);
+    EXPECT_FLOAT_EQ(out[0], 1.0f);
+    EXPECT_FLOAT_EQ(out[1], -1.0f);
+    EXPECT_FLOAT_EQ(out[126], 64.0f);
+}
+
+// Test running dry pads with silence, counts an underrun and re-primes
+TEST(InputMonitorBufferTests, UnderrunPadsAndReprimes) {
+    InputMonitorBuffer monitor;
+    monitor.configure(2, 4096, 80);
+
+    auto input = rampFrames(100, 1.0f);
+    monitor.push(input.data(), 100);
+
+    std::vector<float> out(80 * 2);
+    monitor.pull(out.data(), 80);
+    monitor.pull(out.data(), 80);  // Only 20 frames left
+    EXPECT_FLOAT_EQ(out[19 * 2], 100.0f);
+    EXPECT_FLOAT_EQ(out[20 * 2], 0.0f);
+    EXPECT_EQ(monitor.getStats().underruns, 1u);
+
+    // Not enough buffered to restart yet
+    monitor.push(input.data(), 40);
+    monitor.pull(out.data(), 80);
+    EXPECT_FLOAT_EQ(out[0], 0.0f);
+    EXPECT_EQ(monitor.getStats().underruns, 1u);
+}
+
+// Test input is dropped and counted when the ring is full
+TEST(InputMonitorBufferTests, OverrunWhenFull) {
+    InputMonitorBuffer monitor;
+    monitor.configure(2, 256, 64);
+
+    auto input = rampFrames(200, 1.0f);
+    monitor.push(input.data(), 200);
+    EXPECT_EQ(monitor.getStats().overruns, 0u);
+    monitor.push(input.data(), 200);
+    EXPECT_EQ(monitor.getStats().overruns, 1u);
+    EXPECT_EQ(monitor.getStats().fillFrames, 256u);
+}
+
+// Test a stalled consumer has its backlog cut back to the target latency
+TEST(InputMonitorBufferTests, LatencyBound) {
+    InputMonitorBuffer monitor;
+    monitor.configure(2, 8192, 128);
+
+    auto input = rampFrames(2000, 1.0f);
+    monitor.push(input.data(), 2000);
+
+    std::vector<float> out(64 * 2);
+    monitor.pull(out.data(), 64);
+    EXPECT_EQ(monitor.getStats().overruns, 1u);
+    EXPECT_EQ(monitor.getStats().fillFrames, 128u - 64u);
+    EXPECT_FLOAT_EQ(out[0], 2000.0f - 128.0f + 1.0f);  // Newest 128 frames kept
+}
+
+// Test drift correction holds the fill level near target when clocks differ
+TEST(InputMonitorBufferTests, DriftCorrection) {
+    constexpr size_t BLOCK = 256;
+    constexpr size_t TARGET = 1024;
+
+    for (size_t producerBlock : {BLOCK + 1, BLOCK - 1}) {
+        InputMonitorBuffer monitor;
+        monitor.configure(2, 16384, TARGET);
+
+        std::vector<float> input(producerBlock * 2, 0.5f);
+        std::vector<float> out(BLOCK * 2);
+
+        // Prime, then run both sides at slightly different rates
+        for (size_t i = 0; i < TARGET / producerBlock + 1; ++i) {
+            monitor.push(input.data(), producerBlock);
+        }
+        for (int i = 0; i < 5000; ++i) {
+            monitor.push(input.data(), producerBlock);
+            monitor.pull(out.data(), BLOCK);
+        }
+
+        // Fill is sampled after a pull, so add the block back before comparing
+        auto stats = monitor.getStats();
+        EXPECT_EQ(stats.underruns, 0u);
+        EXPECT_EQ(stats.overruns, 0u);
+        EXPECT_GT(stats.correctedFrames, 0u);
+        EXPECT_NEAR(static_cast<double>(stats.fillFrames + BLOCK), static_cast<double>(TARGET), TARGET / 2.0);
+    }
+}
@@ -0,0 +1,138 @@
+#include "gtest/gtest.h"
+#include "../PartitionedConvolver.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<float> noise(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> samples(count);
+    for (float& sample : samples) {
+        sample = dist(rng);
+    }
+    return samples;
+}
+
+std::vector<float> directConvolution(const std::vector<float>& input, const std::vector<float>& ir) {
+    std::vector<float> output(input.size(), 0.0f);
+    for (size_t n = 0; n < input.size(); ++n) {
+        double sum = 0.0;
+        for (size_t k = 0; k < ir.size() && k <= n; ++k) {
+            sum += double(ir[k]) * input[n - k];
+        }
+        output[n] = static_cast<float>(sum);
+    }
+    return output;
+}
+
+std::vector<float> convolve(PartitionedConvolver& convolver, const PartitionedConvolver::Kernel& kernel,
+                            const std::vector<float>& input) {
+    size_t block = convolver.getBlockSize();
+    std::vector<float> output(input.size(), 0.0f);
+    for (size_t offset = 0; offset + block <= input.size(); offset += block) {
+        convolver.processBlock(&input[offset], &output[offset], kernel);
+    }
+    return output;
+}
+
+} // namespace
+
+// Test the partitioned result equals direct convolution, for IR lengths
+// shorter than, equal to and not a multiple of the block
+TEST(PartitionedConvolverTests, MatchesDirectConvolution) {
+    const size_t block = 64;
+    auto input = noise(block * 40, 1);
+
+    for (size_t length : {size_t(10), block, size_t(1000)}) {
+        auto ir = noise(length, 2 + static_cast<unsigned>(length));
+        auto kernel = PartitionedConvolver::makeKernel(ir.data(), ir.size(), block);
+        ASSERT_NE(kernel, nullptr);
+        EXPECT_EQ(kernel->partitionCount, (length + block - 1) / block);
+
+        PartitionedConvolver convolver;
+        ASSERT_TRUE(convolver.configure(block, kernel->partitionCount));
+        auto actual = convolve(convolver, *kernel, input);
+        auto expected = directConvolution(input, ir);
+        for (size_t i = 0; i < input.size(); ++i) {
+            ASSERT_NEAR(actual[i], expected[i], 1e-4f) << "length " << length << " sample " << i;
+        }
+    }
+}
+
+// Test a crossfade starts at the old kernel's output and ends at the new one's
+TEST(PartitionedConvolverTests, CrossfadesBetweenKernels) {
+    const size_t block = 64;
+    std::vector<float> unit = {1.0f};
+    std::vector<float> half = {0.5f};
+    auto from = PartitionedConvolver::makeKernel(unit.data(), unit.size(), block);
+    auto to = PartitionedConvolver::makeKernel(half.data(), half.size(), block);
+
+    PartitionedConvolver convolver;
+    ASSERT_TRUE(convolver.configure(block, 1));
+    std::vector<float> input(block, 1.0f), output(block);
+    convolver.processBlock(input.data(), output.data(), *to, from.get());
+
+    EXPECT_NEAR(output[0], 1.0f - 0.5f / block, 1e-4f);
+    EXPECT_NEAR(output[block / 2 - 1], 0.75f, 1e-4f);
+    EXPECT_NEAR(output[block - 1], 0.5f, 1e-4f);
+    for (size_t i = 1; i < block; ++i) {
+        EXPECT_LE(output[i], output[i - 1] + 1e-6f);
+    }
+}
+
+// Test unsupported block sizes are rejected
+TEST(PartitionedConvolverTests, RejectsUnsupportedBlockSizes) {
+    std::vector<float> ir(100, 0.1f);
+    EXPECT_EQ(PartitionedConvolver::makeKernel(ir.data(), ir.size(), 100), nullptr);
+    EXPECT_EQ(PartitionedConvolver::makeKernel(ir.data(), 0, 64), nullptr);
+
+    PartitionedConvolver convolver;
+    EXPECT_FALSE(convolver.configure(100, 4));
+    EXPECT_FALSE(convolver.configure(64, 0));
+}
+
+// Benchmark cost per block as the IR grows, against a direct-form FIR.
+// Disabled by default; run with --gtest_also_run_disabled_tests --gtest_filter=PartitionedConvolverTests.*
+TEST(PartitionedConvolverTests, DISABLED_Benchmark) {
+    using Clock = std::chrono::steady_clock;
+    const size_t block = 256;
+    auto input = noise(block, 3);
+    std::vector<float> output(block);
+
+    for (size_t length : {size_t(1024), size_t(4096), size_t(8192), size_t(16384), size_t(65536)}) {
+        auto ir = noise(length, 4);
+        auto kernel = PartitionedConvolver::makeKernel(ir.data(), ir.size(), block);
+        PartitionedConvolver convolver;
+        convolver.configure(block, kernel->partitionCount);
+
+        const int iterations = 2000;
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            convolver.processBlock(input.data(), output.data(), *kernel);
+        }
+        double partitioned = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+
+        // Direct form over the same block, with the history in front of it
+        std::vector<float> history(length + block, 0.25f);
+        const int directIterations = 20;
+        start = Clock::now();
+        for (int i = 0; i < directIterations; ++i) {
+            for (size_t n = 0; n < block; ++n) {
+                float sum = 0.0f;
+                const float* x = &history[length + n];
+                for (size_t k = 0; k < length; ++k) {
+                    sum += ir[k] * x[-static_cast<ptrdiff_t>(k)];
+                }
+                output[n] = sum;
+            }
+        }
+        double direct = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / directIterations;
+
+        std::printf("IR %6zu taps, %zu-frame blocks: partitioned %8.2f us, direct %10.2f us (%.0fx)\n",
+                    length, block, partitioned, direct, direct / partitioned);
+    }
+}
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include "../PlayheadClock.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+using Clock = PlayheadClock::Clock;
+
+Clock::time_point at(double seconds) {
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+}
+
+} // namespace
+
+// Test the playhead advances at the sample rate between updates and holds when stopped
+TEST(PlayheadClockTests, ExtrapolatesBetweenUpdates) {
+    PlayheadClock clock;
+    clock.publish(48000, at(10.0), 48000.0, true);
+
+    auto snapshot = clock.read();
+    EXPECT_EQ(snapshot.frame, 48000);
+    EXPECT_EQ(snapshot.epoch, 1u);
+    EXPECT_NEAR(PlayheadClock::frameAt(snapshot, at(10.01), 4096.0), 48480.0, 0.5);
+    EXPECT_NEAR(PlayheadClock::frameAt(snapshot, at(9.99), 4096.0), 47520.0, 0.5);
+
+    // Stalled device: extrapolation is capped
+    EXPECT_NEAR(PlayheadClock::frameAt(snapshot, at(11.0), 4096.0), 52096.0, 0.5);
+
+    clock.publish(50000, at(12.0), 0.0, false);
+    EXPECT_NEAR(PlayheadClock::frameAt(clock.read(), at(20.0), 4096.0), 50000.0, 1e-9);
+    EXPECT_EQ(clock.read().epoch, 1u);
+}
+
+// Test the interpolator hides small backward corrections but follows seeks
+TEST(PlayheadClockTests, InterpolatorMonotonicWithinEpoch) {
+    PlayheadClock clock;
+    PlayheadInterpolator interpolator;
+    interpolator.setMaxExtrapolation(1e9);
+
+    clock.publish(0, at(1.0), 1000.0, true);
+    EXPECT_NEAR(interpolator.frameAt(clock.read(), at(1.5)), 500.0, 1e-6);
+
+    // Device reports it is slightly behind the extrapolation
+    clock.publish(490, at(1.5), 1000.0, false);
+    EXPECT_NEAR(interpolator.frameAt(clock.read(), at(1.505)), 500.0, 1e-6);
+    EXPECT_NEAR(interpolator.frameAt(clock.read(), at(1.52)), 510.0, 1e-6);
+
+    // Seek back jumps immediately
+    clock.publish(100, at(1.6), 1000.0, true);
+    EXPECT_NEAR(interpolator.frameAt(clock.read(), at(1.6)), 100.0, 1e-6);
+}
+
+// Test output latency shifts the audible position back
+TEST(PlayheadClockTests, OutputLatency) {
+    PlayheadClock clock;
+    PlayheadInterpolator interpolator;
+    interpolator.setOutputLatency(0.02);
+
+    clock.publish(10000, at(5.0), 1000.0, true);
+    EXPECT_NEAR(interpolator.frameAt(clock.read(), at(5.1)), 10080.0, 1e-3);
+}
+
+// Test readers never see a frame from one update paired with another's timestamp
+TEST(PlayheadClockTests, ConcurrentReadsAreConsistent) {
+    PlayheadClock clock;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (int64_t i = 1; i <= 200000; ++i) {
+            clock.publish(i, Clock::time_point(Clock::duration(i * 3)), static_cast<double>(i), false);
+        }
+        done = true;
+    });
+
+    int torn = 0;
+    while (!done) {
+        auto snapshot = clock.read();
+        if (snapshot.time.time_since_epoch().count() != snapshot.frame * 3 ||
+            snapshot.rate != static_cast<double>(snapshot.frame)) {
+            ++torn;
+        }
+    }
+    writer.join();
+    EXPECT_EQ(torn, 0);
+}
@@ -0,0 +1,205 @@
+#include "gtest/gtest.h"
+#include "../RealtimeCheck.h"
+#include "../SpscRingBuffer.h"
+#include "../InputMonitorBuffer.h"
+#include "../RenderAheadQueue.h"
+#include "../AudioLoadMonitor.h"
+#include "../AdaptiveBufferController.h"
+#include "../SampleFormat.h"
+#include "../AudioEngine.h"
+#include "../Track.h"
+#include "../ConvolutionReverb.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Starts each test with an empty violation log
+class RealtimeCheckTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!RealtimeCheck::ENABLED) {
+            GTEST_SKIP() << "Built without WAVPLAYER_RT_CHECKS";
+        }
+        RealtimeCheck::clearViolations();
+    }
+
+    // Lists recorded violations so a failing test shows what went wrong
+    static std::string describeViolations() {
+        std::string text;
+        size_t count = std::min(RealtimeCheck::getViolationCount(), RealtimeCheck::MAX_VIOLATIONS);
+        for (size_t i = 0; i < count; ++i) {
+            auto violation = RealtimeCheck::getViolation(i);
+            text += std::string(RealtimeCheck::kindName(violation.kind)) + " (" + violation.what +
+                    ") in " + violation.context + "\n";
+        }
+        return text;
+    }
+};
+
+} // namespace
+
+// Test a heap allocation inside a real-time scope is recorded with its context
+TEST_F(RealtimeCheckTest, DetectsAllocation) {
+    std::unique_ptr<int> value;
+    {
+        RealtimeCheck::Scope realtime("DetectsAllocation");
+        value = std::make_unique<int>(42);
+    }
+
+    ASSERT_EQ(RealtimeCheck::getViolationCount(), 1u);
+    auto violation = RealtimeCheck::getViolation(0);
+    EXPECT_EQ(violation.kind, RealtimeCheck::Kind::Allocation);
+    EXPECT_STREQ(violation.context, "DetectsAllocation");
+}
+
+// Test nothing is recorded outside a scope or inside an Allow block
+TEST_F(RealtimeCheckTest, IgnoresNonRealtimeWork) {
+    std::vector<float> outside(1024);
+    {
+        RealtimeCheck::Scope realtime("IgnoresNonRealtimeWork");
+        RealtimeCheck::Allow allow;
+        std::vector<float> allowed(1024);
+    }
+    EXPECT_FALSE(RealtimeCheck::isRealtimeThread());
+    EXPECT_EQ(RealtimeCheck::getViolationCount(), 0u) << describeViolations();
+}
+
+// Test locks and annotated blocking calls are recorded; try_lock is allowed
+TEST_F(RealtimeCheckTest, DetectsLocksAndBlockingCalls) {
+    CheckedMutex mutex("TestMutex");
+    {
+        RealtimeCheck::Scope outer("Outer");
+        {
+            RealtimeCheck::Scope inner("Inner");
+            std::lock_guard<CheckedMutex> lock(mutex);
+        }
+        if (mutex.try_lock()) {
+            mutex.unlock();
+        }
+        RealtimeCheck::blockingCall("Sleep");
+    }
+
+    ASSERT_EQ(RealtimeCheck::getViolationCount(), 2u) << describeViolations();
+    EXPECT_EQ(RealtimeCheck::getViolation(0).kind, RealtimeCheck::Kind::Lock);
+    EXPECT_STREQ(RealtimeCheck::getViolation(0).what, "TestMutex");
+    EXPECT_STREQ(RealtimeCheck::getViolation(0).context, "Inner");
+    EXPECT_EQ(RealtimeCheck::getViolation(1).kind, RealtimeCheck::Kind::Blocking);
+    EXPECT_STREQ(RealtimeCheck::getViolation(1).context, "Outer");
+}
+
+// Test the callback-side operations of the audio-thread building blocks stay
+// real-time safe once configured
+TEST_F(RealtimeCheckTest, AudioPathIsRealtimeSafe) {
+    constexpr size_t FRAMES = 256;
+
+    SpscRingBuffer<float> ring;
+    ring.resize(FRAMES * 8);
+    InputMonitorBuffer monitor;
+    monitor.configure(2, FRAMES * 16, FRAMES * 2);
+    RenderAheadQueue queue;
+    queue.configure(2, FRAMES, 4);
+    AudioLoadMonitor loadMonitor;
+    AdaptiveBufferController controller;
+    controller.configure(AdaptiveBufferController::Params(), AudioBufferConfig());
+
+    std::vector<float> input(FRAMES * 2, 0.25f);
+    std::vector<float> output(FRAMES * 2);
+    std::vector<int16_t> device(FRAMES * 2);
+
+    {
+        RealtimeCheck::Scope realtime("AudioPathIsRealtimeSafe");
+
+        for (int block = 0; block < 16; ++block) {
+            ring.write(input.data(), input.size());
+            ring.read(output.data(), output.size());
+
+            monitor.push(input.data(), FRAMES);
+            monitor.pull(output.data(), FRAMES);
+
+            if (auto* rendered = queue.acquire()) {
+                rendered->generation = 0;
+                rendered->startFrame = block * FRAMES;
+                queue.publish(rendered);
+            }
+            size_t nextFrame = block * FRAMES;
+            queue.read(output.data(), FRAMES, 0, nextFrame);
+
+            SampleConvert::fromFloat(output.data(), device.data(), output.size(), SampleFormat::Int16);
+            SampleConvert::toFloat(device.data(), output.data(), output.size(), SampleFormat::Int16);
+
+            loadMonitor.recordBlock(0.002, 0.005);
+            controller.onBlock(0.4f, false, 0.005);
+        }
+    }
+
+    EXPECT_EQ(RealtimeCheck::getViolationCount(), 0u) << describeViolations();
+}
+
+// Test the playback mix - track EQ, pan, mute, track and master reverb - and
+// picking up a new track list stay real-time safe once the first block is out
+TEST_F(RealtimeCheckTest, TrackMixIsRealtimeSafe) {
+    constexpr size_t FRAMES = 512;
+    constexpr uint32_t RATE = 44100;
+
+    AudioEngine engine;
+    engine.initializeOffline(RATE, 2, FRAMES);
+
+    std::vector<std::shared_ptr<Track>> tracks;
+    for (int i = 0; i < 4; ++i) {
+        auto clip = std::make_shared<AudioClip>();
+        AudioFormat format;
+        format.channels = 1;
+        format.sampleRate = RATE;
+        clip->setFormat(format);
+        clip->getSamplesWritable().assign(RATE, 0.1f);
+
+        auto track = std::make_shared<Track>(L"Track " + std::to_wstring(i + 1));
+        TrackRegion region;
+        region.clip = clip;
+        region.duration = 1.0;
+        track->addRegion(region);
+        tracks.push_back(track);
+    }
+    tracks[0]->setEQLow(6.0f);
+    tracks[1]->setPan(-0.5f);
+    tracks[2]->setMuted(true);
+    // Longer than the head partition, so the tail workers are woken from the mix
+    std::vector<float> response(4096);
+    for (size_t i = 0; i < response.size(); ++i) {
+        response[i] = 0.5f * std::exp(-static_cast<float>(i) / 1024.0f);
+    }
+    tracks[3]->getReverb().setImpulseResponse(response, response);
+    engine.getMasterReverb().setImpulseResponse(response, response);
+    engine.setTracks(&tracks);
+    engine.setDuration(1.0);
+
+    std::vector<float> buffer(FRAMES * 2);
+    size_t position = 0;
+    engine.render(buffer.data(), FRAMES, position);  // Picks up tracks and reverbs
+
+    {
+        RealtimeCheck::Scope realtime("TrackMixIsRealtimeSafe");
+        for (int block = 0; block < 8; ++block) {
+            engine.render(buffer.data(), FRAMES, position);
+        }
+    }
+
+    // A new list and changed EQ gains are picked up without allocating either
+    tracks.pop_back();
+    tracks[0]->setEQHigh(-6.0f);
+    engine.setTracks(&tracks);
+    {
+        RealtimeCheck::Scope realtime("TrackMixIsRealtimeSafe");
+        for (int block = 0; block < 8; ++block) {
+            engine.render(buffer.data(), FRAMES, position);
+        }
+    }
+
+    EXPECT_EQ(position, 17 * FRAMES);
+    EXPECT_GT(std::abs(buffer[0]), 0.0f);
+    EXPECT_EQ(RealtimeCheck::getViolationCount(), 0u) << describeViolations();
+}
@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+#include "../RecordingRecovery.h"
+#include "../WavWriter.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+std::filesystem::path testDirectory() {
+    auto dir = std::filesystem::temp_directory_path() / "WavPlayerRecoveryTests";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+// Write a stereo 16-bit take with the given number of frames
+void writeTake(const std::filesystem::path& path, size_t frames) {
+    AudioFormat format;
+    std::vector<float> samples(frames * 2, 0.25f);
+    WavWriter writer;
+    writer.open(path.wstring(), format);
+    writer.write(samples.data(), frames);
+    writer.close();
+}
+
+// Overwrite the RIFF and data sizes the way a crash before any patch leaves them
+void zeroHeaderSizes(const std::filesystem::path& path) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    uint32_t zero = 0;
+    file.seekp(4);
+    file.write(reinterpret_cast<const char*>(&zero), 4);
+    file.seekp(40);
+    file.write(reinterpret_cast<const char*>(&zero), 4);
+}
+
+} // namespace
+
+// Test that flushHeader makes the data written so far readable mid-stream
+TEST(RecordingRecoveryTests, FlushHeaderMidStream) {
+    auto path = testDirectory() / "stream.wav";
+    AudioFormat format;
+    std::vector<float> samples(100 * 2, 0.5f);
+
+    WavWriter writer;
+    ASSERT_TRUE(writer.open(path.wstring(), format));
+    ASSERT_TRUE(writer.write(samples.data(), 100));
+    ASSERT_TRUE(writer.flushHeader());
+
+    AudioClip partial;
+    ASSERT_TRUE(partial.loadFromFile(path.wstring()));
+    EXPECT_EQ(partial.getSampleCount(), 100u);
+
+    // Writing continues after the patch
+    ASSERT_TRUE(writer.write(samples.data(), 100));
+    ASSERT_TRUE(writer.close());
+
+    AudioClip full;
+    ASSERT_TRUE(full.loadFromFile(path.wstring()));
+    EXPECT_EQ(full.getSampleCount(), 200u);
+}
+
+// Test repairing a take whose header sizes were never patched
+TEST(RecordingRecoveryTests, RepairTake) {
+    auto path = testDirectory() / "take.partial.wav";
+    writeTake(path, 500);
+    zeroHeaderSizes(path);
+
+    // A torn final frame is dropped
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file.write("\x01\x02", 2);
+    }
+
+    EXPECT_EQ(RecordingRecovery::repairTake(path.wstring()), 500u);
+
+    AudioClip clip;
+    ASSERT_TRUE(clip.loadFromFile(path.wstring()));
+    EXPECT_EQ(clip.getSampleCount(), 500u);
+    EXPECT_NEAR(clip.getSamples()[0], 0.25f, 1.0f / 16384.0f);
+}
+
+// Test that only .partial.wav files old enough are reported as orphans
+TEST(RecordingRecoveryTests, FindOrphanedTakes) {
+    auto dir = testDirectory();
+    writeTake(dir / "take_1.partial.wav", 10);
+    writeTake(dir / "take_2.wav", 10);
+
+    auto orphans = RecordingRecovery::findOrphanedTakes(dir.wstring(), 0);
+    ASSERT_EQ(orphans.size(), 1u);
+    EXPECT_EQ(std::filesystem::path(orphans[0]).filename(), "take_1.partial.wav");
+
+    // A recently written take may still be recording in another instance
+    EXPECT_TRUE(RecordingRecovery::findOrphanedTakes(dir.wstring(), 3600).empty());
+}
+
+// Test recovering renames the take and header-only takes are removed
+TEST(RecordingRecoveryTests, RecoverTake) {
+    auto dir = testDirectory();
+    auto take = dir / "take_1.partial.wav";
+    writeTake(take, 50);
+    zeroHeaderSizes(take);
+
+    std::wstring recovered = RecordingRecovery::recoverTake(take.wstring());
+    EXPECT_EQ(std::filesystem::path(recovered).filename(), "take_1.wav");
+    EXPECT_TRUE(std::filesystem::exists(recovered));
+    EXPECT_FALSE(std::filesystem::exists(take));
+
+    auto empty = dir / "take_2.partial.wav";
+    writeTake(empty, 0);
+    EXPECT_TRUE(RecordingRecovery::recoverTake(empty.wstring()).empty());
+    EXPECT_FALSE(std::filesystem::exists(empty));
+}
@@ -0,0 +1,157 @@
+#include "gtest/gtest.h"
+#include "../RenderAheadQueue.h"
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Mono block whose samples are their project frame numbers
+void renderBlock(RenderAheadQueue::Block* block, uint64_t generation, size_t startFrame) {
+    block->generation = generation;
+    block->startFrame = startFrame;
+    for (size_t i = 0; i < block->samples.size(); ++i) {
+        block->samples[i] = static_cast<float>(startFrame + i);
+    }
+}
+
+} // namespace
+
+// Test the pool runs dry once every block is rendered and refills as they are read
+TEST(RenderAheadQueueTests, PoolLimitsLookAhead) {
+    RenderAheadQueue queue;
+    queue.configure(1, 64, 4);
+    EXPECT_EQ(queue.getLookAheadFrames(), 256u);
+
+    for (size_t i = 0; i < 4; ++i) {
+        auto* block = queue.acquire();
+        ASSERT_NE(block, nullptr);
+        renderBlock(block, 0, i * 64);
+        queue.publish(block);
+    }
+    EXPECT_EQ(queue.acquire(), nullptr);
+
+    std::vector<float> out(64);
+    size_t nextFrame = 0;
+    EXPECT_EQ(queue.read(out.data(), 64, 0, nextFrame), 64u);
+    EXPECT_NE(queue.acquire(), nullptr);
+}
+
+// Test reads span block boundaries and report the next project frame
+TEST(RenderAheadQueueTests, ReadsAcrossBlocks) {
+    RenderAheadQueue queue;
+    queue.configure(1, 64, 4);
+    for (size_t i = 0; i < 3; ++i) {
+        auto* block = queue.acquire();
+        renderBlock(block, 0, 1000 + i * 64);
+        queue.publish(block);
+    }
+
+    std::vector<float> out(100);
+    size_t nextFrame = 0;
+    EXPECT_EQ(queue.read(out.data(), 100, 0, nextFrame), 100u);
+    EXPECT_FLOAT_EQ(out[0], 1000.0f);
+    EXPECT_FLOAT_EQ(out[99], 1099.0f);
+    EXPECT_EQ(nextFrame, 1100u);
+
+    // Only 92 frames left
+    EXPECT_EQ(queue.read(out.data(), 100, 0, nextFrame), 92u);
+    EXPECT_EQ(nextFrame, 1192u);
+    EXPECT_EQ(queue.readyBlocks(), 0u);
+}
+
+// Test blocks from an older generation are recycled unheard
+TEST(RenderAheadQueueTests, FlushByGeneration) {
+    RenderAheadQueue queue;
+    queue.configure(1, 64, 4);
+    for (size_t i = 0; i < 2; ++i) {
+        auto* block = queue.acquire();
+        renderBlock(block, 0, i * 64);
+        queue.publish(block);
+    }
+
+    // A seek to frame 5000 bumped the generation after these were rendered
+    auto* block = queue.acquire();
+    renderBlock(block, 1, 5000);
+    queue.publish(block);
+
+    std::vector<float> out(64);
+    size_t nextFrame = 0;
+    EXPECT_EQ(queue.read(out.data(), 64, 1, nextFrame), 64u);
+    EXPECT_FLOAT_EQ(out[0], 5000.0f);
+    EXPECT_EQ(nextFrame, 5064u);
+
+    // Every block is free again
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NE(queue.acquire(), nullptr);
+    }
+}
+
+// Test audio arrives complete and in order across threads
+TEST(RenderAheadQueueTests, ConcurrentProducerConsumer) {
+    constexpr size_t BLOCK = 32;
+    constexpr size_t TOTAL = BLOCK * 500;
+
+    RenderAheadQueue queue;
+    queue.configure(1, BLOCK, 8);
+
+    std::thread producer([&queue]() {
+        size_t position = 0;
+        while (position < TOTAL) {
+            auto* block = queue.acquire();
+            if (!block) {
+                std::this_thread::yield();
+                continue;
+            }
+            renderBlock(block, 0, position);
+            queue.publish(block);
+            position += BLOCK;
+        }
+    });
+
+    std::vector<float> out(50);
+    size_t expected = 0;
+    bool inOrder = true;
+    while (expected < TOTAL) {
+        size_t nextFrame = 0;
+        size_t count = queue.read(out.data(), std::min<size_t>(out.size(), TOTAL - expected), 0, nextFrame);
+        for (size_t i = 0; i < count; ++i) {
+            inOrder &= (out[i] == static_cast<float>(expected + i));
+        }
+        expected += count;
+    }
+    producer.join();
+
+    EXPECT_TRUE(inOrder);
+    EXPECT_EQ(expected, TOTAL);
+}
+
+// Test parameter-change flushes are limited to one per look-ahead of playback,
+// with a request inside the window kept until it ends
+TEST(RenderAheadQueueTests, ThrottlesParameterFlushes) {
+    RenderAheadQueue queue;
+    queue.configure(2, 512, 4);  // 2048 frames of look-ahead
+    EXPECT_FALSE(queue.takeFlush(0));
+
+    queue.requestFlush();
+    EXPECT_TRUE(queue.takeFlush(1000));  // First one straight away
+    EXPECT_FALSE(queue.takeFlush(1000));
+
+    // A slider drag: every move requests, one flush per window goes through
+    queue.requestFlush();
+    EXPECT_FALSE(queue.takeFlush(1500));
+    queue.requestFlush();
+    EXPECT_FALSE(queue.takeFlush(3047));
+    EXPECT_TRUE(queue.takeFlush(3048));  // Deferred request, window over
+    EXPECT_FALSE(queue.takeFlush(6000));
+
+    // Playback moved back (a seek): no window to wait out
+    queue.requestFlush();
+    EXPECT_TRUE(queue.takeFlush(100));
+
+    // A fresh start forgets both the request and the window
+    queue.requestFlush();
+    queue.reset();
+    EXPECT_FALSE(queue.takeFlush(200));
+    queue.requestFlush();
+    EXPECT_TRUE(queue.takeFlush(200));
+}
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+#include "../SampleFormat.h"
+#include "../WavWriter.h"
+#include <filesystem>
+#include <vector>
+
+// Test sample sizes for each format
+TEST(SampleFormatTests, BytesPerSample) {
+    EXPECT_EQ(SampleConvert::bytesPerSample(SampleFormat::Int16), 2u);
+    EXPECT_EQ(SampleConvert::bytesPerSample(SampleFormat::Int24), 3u);
+    EXPECT_EQ(SampleConvert::bytesPerSample(SampleFormat::Float32), 4u);
+    EXPECT_EQ(SampleConvert::bitsPerSample(SampleFormat::Int24), 24);
+}
+
+// Test mapping WAV format descriptions to sample formats
+TEST(SampleFormatTests, FromWaveFormat) {
+    SampleFormat format;
+    ASSERT_TRUE(SampleConvert::fromWaveFormat(16, false, format));
+    EXPECT_EQ(format, SampleFormat::Int16);
+    ASSERT_TRUE(SampleConvert::fromWaveFormat(24, false, format));
+    EXPECT_EQ(format, SampleFormat::Int24);
+    ASSERT_TRUE(SampleConvert::fromWaveFormat(32, true, format));
+    EXPECT_EQ(format, SampleFormat::Float32);
+    EXPECT_FALSE(SampleConvert::fromWaveFormat(8, false, format));
+    EXPECT_FALSE(SampleConvert::fromWaveFormat(64, true, format));
+}
+
+// Test that 16-bit conversion clamps out-of-range samples
+TEST(SampleFormatTests, Int16Clamps) {
+    std::vector<float> input = {0.0f, 0.5f, 1.5f, -2.0f};
+    std::vector<int16_t> output(input.size());
+    SampleConvert::fromFloat(input.data(), output.data(), input.size(), SampleFormat::Int16);
+
+    EXPECT_EQ(output[0], 0);
+    EXPECT_EQ(output[1], 16383);
+    EXPECT_EQ(output[2], 32767);
+    EXPECT_EQ(output[3], -32767);
+}
+
+// Test 24-bit packing is little-endian and round-trips
+TEST(SampleFormatTests, Int24RoundTrip) {
+    std::vector<float> input = {1.0f, -1.0f, 0.25f, -0.125f, 3.0f};
+    std::vector<uint8_t> packed(input.size() * 3);
+    SampleConvert::fromFloat(input.data(), packed.data(), input.size(), SampleFormat::Int24);
+
+    // Full scale positive is 0x7FFFFF
+    EXPECT_EQ(packed[0], 0xFF);
+    EXPECT_EQ(packed[1], 0xFF);
+    EXPECT_EQ(packed[2], 0x7F);
+
+    std::vector<float> output(input.size());
+    SampleConvert::toFloat(packed.data(), output.data(), input.size(), SampleFormat::Int24);
+    EXPECT_NEAR(output[0], 1.0f, 1e-6f);
+    EXPECT_NEAR(output[1], -1.0f, 1e-6f);
+    EXPECT_NEAR(output[2], 0.25f, 1e-6f);
+    EXPECT_NEAR(output[3], -0.125f, 1e-6f);
+    EXPECT_NEAR(output[4], 1.0f, 1e-6f);  // Clamped
+}
+
+// Test float output keeps headroom (no clamping)
+TEST(SampleFormatTests, Float32PassThrough) {
+    std::vector<float> input = {1.5f, -0.75f};
+    std::vector<float> output(input.size());
+    SampleConvert::fromFloat(input.data(), output.data(), input.size(), SampleFormat::Float32);
+    EXPECT_FLOAT_EQ(output[0], 1.5f);
+    EXPECT_FLOAT_EQ(output[1], -0.75f);
+}
+
+// Test WavWriter 24-bit and float files load back through AudioClip
+TEST(SampleFormatTests, WavWriterHighResolution) {
+    auto dir = std::filesystem::temp_directory_path() / "WavPlayerSampleFormatTests";
+    std::filesystem::create_directories(dir);
+
+    std::vector<float> samples = {0.1f, -0.2f, 0.3f, -0.4f};
+
+    AudioFormat pcm24;
+    pcm24.bitsPerSample = 24;
+    AudioFormat float32;
+    float32.bitsPerSample = 32;
+    float32.isFloat = true;
+
+    for (const AudioFormat& format : {pcm24, float32}) {
+        std::wstring filename = (dir / (format.isFloat ? L"float.wav" : L"pcm24.wav")).wstring();
+
+        WavWriter writer;
+        ASSERT_TRUE(writer.open(filename, format));
+        ASSERT_TRUE(writer.write(samples.data(), 2));
+        ASSERT_TRUE(writer.close());
+
+        AudioClip clip;
+        ASSERT_TRUE(clip.loadFromFile(filename));
+        EXPECT_EQ(clip.getFormat().bitsPerSample, format.bitsPerSample);
+        EXPECT_EQ(clip.getFormat().isFloat, format.isFloat);
+        ASSERT_EQ(clip.getSampleCount(), 2u);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            EXPECT_NEAR(clip.getSamples()[i], samples[i], 1e-6f);
+        }
+    }
+}
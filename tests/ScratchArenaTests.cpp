@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+#include "../ScratchArena.h"
+#include "../RealtimeCheck.h"
+#include <cstdint>
+
+namespace {
+
+bool isAligned(const void* ptr) {
+    return reinterpret_cast<uintptr_t>(ptr) % ScratchArena::ALIGNMENT == 0;
+}
+
+} // namespace
+
+// Test every span starts on a 64-byte boundary, whatever the previous span's size
+TEST(ScratchArenaTests, SpansAreAligned) {
+    ScratchArena arena;
+    arena.configure(4096);
+
+    float* a = arena.allocate<float>(3);
+    int16_t* b = arena.allocate<int16_t>(7);
+    double* c = arena.allocate<double>(1);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    ASSERT_NE(c, nullptr);
+    EXPECT_TRUE(isAligned(a));
+    EXPECT_TRUE(isAligned(b));
+    EXPECT_TRUE(isAligned(c));
+    EXPECT_EQ(arena.getUsed(), 3 * ScratchArena::ALIGNMENT);
+}
+
+// Test capacity computed for a block layout holds exactly that many spans
+TEST(ScratchArenaTests, SizedFromBlockLayout) {
+    ScratchArena arena;
+    arena.configure(ScratchArena::bytesForBlock(1000, 2, 2));
+
+    EXPECT_NE(arena.allocate<float>(2000), nullptr);
+    EXPECT_NE(arena.allocate<float>(2000), nullptr);
+    EXPECT_EQ(arena.allocate<float>(1), nullptr);
+    EXPECT_EQ(arena.getOverflows(), 1u);
+}
+
+// Test frames hand space back on exit and nest
+TEST(ScratchArenaTests, FramesReset) {
+    ScratchArena arena;
+    arena.configure(1024);
+
+    float* outer = nullptr;
+    {
+        ScratchArena::Frame frame(arena);
+        outer = arena.allocate<float>(16);
+        {
+            ScratchArena::Frame inner(arena);
+            arena.allocate<float>(64);
+            EXPECT_EQ(arena.getUsed(), 5 * ScratchArena::ALIGNMENT);
+        }
+        EXPECT_EQ(arena.getUsed(), ScratchArena::ALIGNMENT);
+    }
+    EXPECT_EQ(arena.getUsed(), 0u);
+    EXPECT_EQ(arena.getHighWater(), 5 * ScratchArena::ALIGNMENT);
+
+    // Same memory comes back for the next callback
+    ScratchArena::Frame frame(arena);
+    EXPECT_EQ(arena.allocate<float>(16), outer);
+}
+
+// Test handing out and resetting spans never touches the heap
+TEST(ScratchArenaTests, RealtimeSafe) {
+    ScratchArena arena;
+    arena.configure(ScratchArena::bytesForBlock(512, 2, 2));
+
+    RealtimeCheck::clearViolations();
+    {
+        RealtimeCheck::Scope realtime("ScratchArenaTests");
+        for (int i = 0; i < 100; ++i) {
+            ScratchArena::Frame frame(arena);
+            arena.allocate<float>(1024);
+            arena.allocate<float>(1024);
+        }
+    }
+    EXPECT_EQ(RealtimeCheck::getViolationCount(), 0u);
+}
@@ -113,3 +113,28 @@ TEST_F(SettingsTest, EdgeCaseNumericValues) {
     settings->setBPM(300.0);
     EXPECT_DOUBLE_EQ(settings->getBPM(), 300.0);
 }
+
+// Test audio buffer settings default and are clamped when set
+TEST_F(SettingsTest, AudioBufferConfig) {
+    EXPECT_EQ(settings->getAudioBufferConfig(), AudioBufferConfig());
+
+    AudioBufferConfig config;
+    config.playbackBuffers = 2;
+    config.playbackBufferFrames = 256;
+    config.recordBuffers = 1;
+    settings->setAudioBufferConfig(config);
+
+    EXPECT_EQ(settings->getAudioBufferConfig().playbackBuffers, 2);
+    EXPECT_EQ(settings->getAudioBufferConfig().playbackBufferFrames, 256);
+    EXPECT_EQ(settings->getAudioBufferConfig().recordBuffers, AudioBufferConfig::MIN_BUFFERS);
+}
+
+// Test the render-ahead length is clamped when set
+TEST_F(SettingsTest, RenderAheadFramesClamped) {
+    EXPECT_EQ(settings->getRenderAheadFrames(), 8192);
+
+    settings->setRenderAheadFrames(-5);
+    EXPECT_EQ(settings->getRenderAheadFrames(), Settings::MIN_RENDER_AHEAD_FRAMES);
+    settings->setRenderAheadFrames(1 << 30);
+    EXPECT_EQ(settings->getRenderAheadFrames(), Settings::MAX_RENDER_AHEAD_FRAMES);
+}
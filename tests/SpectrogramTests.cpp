@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+#include "../Spectrogram.h"
+#include "../SpectrumAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Test a single full-scale bin shows up at full level in its log-frequency row
+TEST(SpectrogramTests, ToneLandsInRow) {
+    Spectrogram spectrogram;
+    const size_t binCount = 2049;  // 4096-point FFT
+    const int sampleRate = 48000;
+    const float binHz = sampleRate / 4096.0f;
+
+    std::vector<float> magnitudes(binCount, 0.0f);
+    size_t toneBin = static_cast<size_t>(std::lround(1000.0f / binHz));
+    magnitudes[toneBin] = 1.0f;
+    spectrogram.addColumn(magnitudes.data(), binCount, sampleRate);
+    ASSERT_EQ(spectrogram.getColumnCount(), 1u);
+
+    std::vector<uint8_t> levels(Spectrogram::ROWS);
+    ASSERT_TRUE(spectrogram.readColumn(0, levels.data()));
+
+    // Row whose range holds toneBin's frequency
+    double rowsPerOctave = Spectrogram::ROWS / std::log2(Spectrogram::MAX_FREQ / Spectrogram::MIN_FREQ);
+    int expectedRow = static_cast<int>(std::log2(toneBin * binHz / Spectrogram::MIN_FREQ) * rowsPerOctave);
+    int loudest = static_cast<int>(std::max_element(levels.begin(), levels.end()) - levels.begin());
+    EXPECT_NEAR(loudest, expectedRow, 2);
+    EXPECT_EQ(levels[loudest], 255);
+    EXPECT_EQ(levels[0], 0);
+    EXPECT_EQ(levels[Spectrogram::ROWS - 1], 0);
+}
+
+// Test the ring keeps the newest columns and refuses overwritten ones
+TEST(SpectrogramTests, RingKeepsNewestColumns) {
+    Spectrogram spectrogram;
+    std::vector<float> magnitudes(513);
+    std::vector<uint8_t> levels(Spectrogram::ROWS);
+
+    for (size_t column = 0; column < Spectrogram::CAPACITY + 10; ++column) {
+        // Level tracks the column number so stale reads would show
+        float dB = Spectrogram::FLOOR_DB + (column % 100);
+        std::fill(magnitudes.begin(), magnitudes.end(), std::pow(10.0f, dB / 20.0f));
+        spectrogram.addColumn(magnitudes.data(), magnitudes.size(), 44100);
+    }
+
+    const uint64_t count = spectrogram.getColumnCount();
+    EXPECT_EQ(count, Spectrogram::CAPACITY + 10);
+    EXPECT_FALSE(spectrogram.readColumn(0, levels.data()));
+    EXPECT_FALSE(spectrogram.readColumn(10, levels.data()));
+    EXPECT_FALSE(spectrogram.readColumn(count, levels.data()));
+
+    for (uint64_t column : {uint64_t(11), count - 1}) {
+        ASSERT_TRUE(spectrogram.readColumn(column, levels.data()));
+        float expected = (column % 100) / (Spectrogram::CEIL_DB - Spectrogram::FLOOR_DB) * 255.0f;
+        EXPECT_NEAR(levels[Spectrogram::ROWS / 2], expected, 1.0f);
+    }
+}
+
+// Test the palette runs from near-black to white
+TEST(SpectrogramTests, Palette) {
+    const auto& palette = Spectrogram::getPalette();
+    EXPECT_EQ(palette[255], 0xFFFFFFFFu);
+    EXPECT_EQ(palette[0] >> 24, 0xFFu);
+    EXPECT_LT(palette[0] & 0xFFFFFFu, 0x000020u);
+}
+
+// Test the analyzer's worker side writes one column per STFT frame
+TEST(SpectrogramTests, AnalyzerWritesColumns) {
+    SpectrumAnalyzer analyzer({125.0f, 1000.0f, 8000.0f});
+    std::vector<float> samples(SpectrumAnalyzer::ANALYSIS_HOP * 3 * 2, 0.25f);
+    analyzer.pushSamples(samples.data(), samples.size(), 44100);
+    ASSERT_TRUE(analyzer.analyzePending());
+    EXPECT_EQ(analyzer.getSpectrogram().getColumnCount(), 3u);
+}
@@ -0,0 +1,165 @@
+#include "gtest/gtest.h"
+#include "../SpectrumAnalyzer.h"
+#include "../RealtimeCheck.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const std::vector<float> BANDS = {31.5f, 63.0f, 125.0f, 250.0f, 500.0f, 1000.0f,
+                                  2000.0f, 4000.0f, 8000.0f, 16000.0f};
+
+// Interleaved stereo sine
+std::vector<float> sine(double frequency, size_t frames, int sampleRate, size_t startFrame = 0) {
+    std::vector<float> samples(frames * 2);
+    for (size_t i = 0; i < frames; ++i) {
+        float value = 0.5f * static_cast<float>(std::sin(2.0 * 3.14159265358979 * frequency * (startFrame + i) / sampleRate));
+        samples[i * 2] = value;
+        samples[i * 2 + 1] = value;
+    }
+    return samples;
+}
+
+} // namespace
+
+// Test analysis waits for a hop of new input and finds a tone in its band
+TEST(SpectrumAnalyzerTests, DetectsToneBand) {
+    SpectrumAnalyzer analyzer(BANDS);
+
+    auto partial = sine(1000.0, SpectrumAnalyzer::ANALYSIS_HOP / 2, 48000);
+    analyzer.pushSamples(partial.data(), partial.size(), 48000);
+    EXPECT_FALSE(analyzer.analyzePending());
+    EXPECT_EQ(analyzer.getSnapshot().sequence, 0u);
+
+    for (size_t block = 0; block < 16; ++block) {
+        auto samples = sine(1000.0, SpectrumAnalyzer::ANALYSIS_HOP, 48000, (block + 1) * SpectrumAnalyzer::ANALYSIS_HOP);
+        analyzer.pushSamples(samples.data(), samples.size(), 48000);
+        EXPECT_TRUE(analyzer.analyzePending());
+    }
+
+    auto snapshot = analyzer.getSnapshot();
+    EXPECT_EQ(snapshot.sequence, 16u);
+    ASSERT_EQ(snapshot.bands.size(), BANDS.size());
+    auto loudest = std::max_element(snapshot.bands.begin(), snapshot.bands.end()) - snapshot.bands.begin();
+    EXPECT_EQ(loudest, 5);
+    EXPECT_GT(snapshot.bands[5], 0.5f);
+    EXPECT_LT(snapshot.bands[0], 0.3f);
+}
+
+// Test clearing empties the published bands
+TEST(SpectrumAnalyzerTests, Clear) {
+    SpectrumAnalyzer analyzer(BANDS);
+    auto samples = sine(250.0, SpectrumAnalyzer::FFT_SIZE, 44100);
+    analyzer.pushSamples(samples.data(), samples.size(), 44100);
+    ASSERT_TRUE(analyzer.analyzePending());
+    EXPECT_GT(analyzer.getSnapshot().bands[3], 0.0f);
+
+    analyzer.clear();
+    EXPECT_FLOAT_EQ(analyzer.getSnapshot().bands[3], 0.0f);
+    EXPECT_FALSE(analyzer.analyzePending());
+}
+
+// Test the audio-thread side never allocates or locks, and drops input
+// rather than blocking when the worker falls behind
+TEST(SpectrumAnalyzerTests, PushIsRealtimeSafe) {
+    SpectrumAnalyzer analyzer(BANDS);
+    auto samples = sine(440.0, 2048, 44100);
+
+    RealtimeCheck::clearViolations();
+    {
+        RealtimeCheck::Scope realtime("SpectrumAnalyzerTests");
+        for (int i = 0; i < 16; ++i) {
+            analyzer.pushSamples(samples.data(), samples.size(), 44100);
+        }
+    }
+    EXPECT_EQ(RealtimeCheck::getViolationCount(), 0u);
+    EXPECT_EQ(analyzer.getDroppedFrames(), 16u * 2048u - SpectrumAnalyzer::RING_FRAMES);
+}
+
+// Test the worker thread publishes snapshots while the producer keeps pushing
+TEST(SpectrumAnalyzerTests, WorkerPublishes) {
+    SpectrumAnalyzer analyzer(BANDS);
+    std::atomic<int> updates{0};
+    analyzer.setUpdateCallback([&]() { ++updates; });
+    analyzer.start();
+
+    for (size_t block = 0; block < 40 && updates < 3; ++block) {
+        auto samples = sine(4000.0, SpectrumAnalyzer::ANALYSIS_HOP, 44100, block * SpectrumAnalyzer::ANALYSIS_HOP);
+        analyzer.pushSamples(samples.data(), samples.size(), 44100);
+        std::this_thread::sleep_for(std::chrono::milliseconds(SpectrumAnalyzer::WORKER_INTERVAL_MS));
+    }
+    analyzer.stop();
+
+    EXPECT_GE(updates.load(), 3);
+    EXPECT_GT(analyzer.getSnapshot().sequence, 0u);
+}
+
+// Test band smoothing runs per STFT frame, so the result doesn't depend on
+// how the audio was buffered or how often analysis ran
+TEST(SpectrumAnalyzerTests, SmoothingIndependentOfBlockSize) {
+    SpectrumAnalyzer small(BANDS);
+    SpectrumAnalyzer large(BANDS);
+    ASSERT_TRUE(small.setStftConfig({2048, 512, FftPlan::Window::Hann}));
+    ASSERT_TRUE(large.setStftConfig({2048, 512, FftPlan::Window::Hann}));
+    EXPECT_FALSE(small.setStftConfig({2048, 4096, FftPlan::Window::Hann}));
+    EXPECT_EQ(small.getStftConfig().fftSize, 2048u);
+    small.analyzePending();
+    large.analyzePending();
+
+    auto samples = sine(500.0, 8192, 44100);
+    for (size_t offset = 0; offset < samples.size(); offset += 128 * 2) {
+        small.pushSamples(samples.data() + offset, 128 * 2, 44100);
+        small.analyzePending();
+    }
+    large.pushSamples(samples.data(), samples.size(), 44100);
+    ASSERT_TRUE(large.analyzePending());
+
+    auto a = small.getSnapshot();
+    auto b = large.getSnapshot();
+    for (size_t band = 0; band < BANDS.size(); ++band) {
+        EXPECT_NEAR(a.bands[band], b.bands[band], 1e-5f);
+        EXPECT_NEAR(a.peaks[band], b.peaks[band], 1e-5f);
+    }
+    EXPECT_GT(a.bands[4], 0.5f);
+}
+
+// Test the fractional-octave source replaces the bands and their centres,
+// lands a low tone in its 1/6-octave band, and switches back to the FFT bands
+TEST(SpectrumAnalyzerTests, FractionalOctaveSource) {
+    const int sampleRate = 48000;
+    SpectrumAnalyzer analyzer(BANDS);
+    analyzer.setBandSource(SpectrumAnalyzer::BandSource::SixthOctave);
+
+    FractionalOctaveBank reference;
+    ASSERT_TRUE(reference.configure(6, sampleRate));
+    const size_t band = std::find(reference.getCenters().begin(), reference.getCenters().end(), 1000.0f) -
+                        reference.getCenters().begin() - 12;  // 250 Hz
+    const double freq = reference.getCenters()[band];
+
+    for (size_t block = 0; block < 32; ++block) {
+        auto samples = sine(freq, SpectrumAnalyzer::ANALYSIS_HOP, sampleRate, block * SpectrumAnalyzer::ANALYSIS_HOP);
+        analyzer.pushSamples(samples.data(), samples.size(), sampleRate);
+        EXPECT_TRUE(analyzer.analyzePending());
+    }
+
+    auto snapshot = analyzer.getSnapshot();
+    EXPECT_EQ(snapshot.source, SpectrumAnalyzer::BandSource::SixthOctave);
+    EXPECT_EQ(snapshot.centers, reference.getCenters());
+    ASSERT_EQ(snapshot.bands.size(), reference.getBandCount());
+    auto loudest = std::max_element(snapshot.bands.begin(), snapshot.bands.end()) - snapshot.bands.begin();
+    EXPECT_EQ(static_cast<size_t>(loudest), band);
+    EXPECT_GT(snapshot.bands[band], 0.5f);
+    EXPECT_LT(snapshot.bands[band + 6], 0.3f);
+
+    analyzer.setBandSource(SpectrumAnalyzer::BandSource::Fft);
+    auto samples = sine(freq, SpectrumAnalyzer::ANALYSIS_HOP, sampleRate);
+    analyzer.pushSamples(samples.data(), samples.size(), sampleRate);
+    ASSERT_TRUE(analyzer.analyzePending());
+    snapshot = analyzer.getSnapshot();
+    EXPECT_EQ(snapshot.source, SpectrumAnalyzer::BandSource::Fft);
+    EXPECT_EQ(snapshot.centers, BANDS);
+    EXPECT_EQ(snapshot.bands.size(), BANDS.size());
+}
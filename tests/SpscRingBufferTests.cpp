@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "../SpscRingBuffer.h"
+#include <thread>
+#include <vector>
+
+// Test capacity rounds up to a power of two
+TEST(SpscRingBufferTests, CapacityRoundsUp) {
+    SpscRingBuffer<float> ring(100);
+    EXPECT_EQ(ring.capacity(), 128u);
+    EXPECT_EQ(ring.availableToRead(), 0u);
+    EXPECT_EQ(ring.availableToWrite(), 128u);
+}
+
+// Test writes are truncated when the ring is full
+TEST(SpscRingBufferTests, WriteStopsWhenFull) {
+    SpscRingBuffer<int> ring(8);
+    std::vector<int> data = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+    EXPECT_EQ(ring.write(data.data(), data.size()), 8u);
+    EXPECT_EQ(ring.availableToWrite(), 0u);
+    EXPECT_EQ(ring.write(data.data(), 1), 0u);
+
+    std::vector<int> out(8);
+    EXPECT_EQ(ring.read(out.data(), out.size()), 8u);
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[7], 8);
+    EXPECT_EQ(ring.read(out.data(), 1), 0u);
+}
+
+// Test block copies across the wrap point
+TEST(SpscRingBufferTests, WrapAround) {
+    SpscRingBuffer<int> ring(8);
+    std::vector<int> data = {1, 2, 3, 4, 5, 6};
+    std::vector<int> out(6);
+
+    ring.write(data.data(), 6);
+    ring.read(out.data(), 6);
+
+    // Next write starts at offset 6 and wraps
+    ring.write(data.data(), 6);
+    ASSERT_EQ(ring.read(out.data(), 6), 6u);
+    EXPECT_EQ(out, data);
+}
+
+// Test discard skips elements without copying
+TEST(SpscRingBufferTests, Discard) {
+    SpscRingBuffer<int> ring(8);
+    std::vector<int> data = {1, 2, 3, 4};
+    ring.write(data.data(), 4);
+
+    EXPECT_EQ(ring.discard(3), 3u);
+    int value = 0;
+    ASSERT_EQ(ring.read(&value, 1), 1u);
+    EXPECT_EQ(value, 4);
+    EXPECT_EQ(ring.discard(5), 0u);
+}
+
+// Test one producer and one consumer thread see every element in order
+TEST(SpscRingBufferTests, ProducerConsumerThreads) {
+    constexpr int TOTAL = 200000;
+    SpscRingBuffer<int> ring(1024);
+
+    std::thread producer([&ring]() {
+        int next = 0;
+        int block[64];
+        while (next < TOTAL) {
+            int count = std::min(64, TOTAL - next);
+            for (int i = 0; i < count; ++i) block[i] = next + i;
+            next += static_cast<int>(ring.write(block, count));
+        }
+    });
+
+    int expected = 0;
+    bool inOrder = true;
+    int block[100];
+    while (expected < TOTAL) {
+        size_t count = ring.read(block, 100);
+        for (size_t i = 0; i < count; ++i) {
+            inOrder = inOrder && (block[i] == expected);
+            ++expected;
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(inOrder);
+    EXPECT_EQ(ring.availableToRead(), 0u);
+}
@@ -0,0 +1,239 @@
+#include "gtest/gtest.h"
+#include "../StemExporter.h"
+#include "../WavWriter.h"
+#include <filesystem>
+#include <cmath>
+
+namespace {
+
+// Build a mono clip holding a constant value
+std::shared_ptr<AudioClip> makeConstantClip(float value, size_t frames, uint32_t sampleRate = 44100) {
+    auto clip = std::make_shared<AudioClip>();
+    AudioFormat format;
+    format.channels = 1;
+    format.sampleRate = sampleRate;
+    clip->setFormat(format);
+    clip->getSamplesWritable().assign(frames, value);
+    return clip;
+}
+
+std::shared_ptr<Track> makeTrack(const std::wstring& name, float value, double seconds) {
+    auto track = std::make_shared<Track>(name);
+    TrackRegion region;
+    region.clip = makeConstantClip(value, static_cast<size_t>(seconds * 44100));
+    region.duration = seconds;
+    track->addRegion(region);
+    return track;
+}
+
+std::wstring tempDirectory() {
+    auto dir = std::filesystem::temp_directory_path() / "WavPlayerStemTests";
+    std::filesystem::create_directories(dir);
+    return dir.wstring();
+}
+
+} // namespace
+
+// Test that WavWriter output round-trips through AudioClip::loadFromFile
+TEST(StemExporterTests, WavWriterRoundTrip) {
+    std::wstring filename = tempDirectory() + L"\\writer.wav";
+
+    AudioFormat format;
+    format.channels = 2;
+    format.sampleRate = 48000;
+
+    std::vector<float> samples = {0.0f, 0.5f, -0.5f, 0.25f, 1.0f, -1.0f};
+    WavWriter writer;
+    ASSERT_TRUE(writer.open(filename, format));
+    ASSERT_TRUE(writer.write(samples.data(), 2));
+    ASSERT_TRUE(writer.write(samples.data() + 4, 1));
+    EXPECT_EQ(writer.getFramesWritten(), 3u);
+    ASSERT_TRUE(writer.close());
+
+    AudioClip clip;
+    ASSERT_TRUE(clip.loadFromFile(filename));
+    EXPECT_EQ(clip.getFormat().channels, 2);
+    EXPECT_EQ(clip.getFormat().sampleRate, 48000u);
+    ASSERT_EQ(clip.getSampleCount(), 3u);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        EXPECT_NEAR(clip.getSamples()[i], samples[i], 1.0f / 16384.0f);
+    }
+}
+
+// Test that Track::renderBlock applies volume and pan
+TEST(StemExporterTests, RenderBlockAppliesGains) {
+    auto track = makeTrack(L"Gain", 0.5f, 1.0);
+    track->setVolume(0.5f);
+    track->setPan(-1.0f);
+
+    TrackEQ eq;
+    std::vector<float> buffer(64 * 2, 1.0f);
+    EXPECT_FLOAT_EQ(track->renderBlock(0, 64, 44100, buffer.data(), eq), 0.25f);
+    EXPECT_FLOAT_EQ(buffer[0], 0.25f);
+    EXPECT_FLOAT_EQ(buffer[1], 0.0f);
+
+    // Past the end of the region is silence
+    track->renderBlock(44100, 64, 44100, buffer.data(), eq);
+    EXPECT_FLOAT_EQ(buffer[0], 0.0f);
+}
+
+// Test that muted tracks render silence but still report their peak, and armed tracks are silent
+TEST(StemExporterTests, RenderBlockMuteAndArm) {
+    auto track = makeTrack(L"Vox", 0.5f, 1.0);
+    TrackEQ eq;
+    std::vector<float> buffer(64 * 2, 1.0f);
+
+    track->setMuted(true);
+    EXPECT_FLOAT_EQ(track->renderBlock(0, 64, 44100, buffer.data(), eq), 0.5f);
+    EXPECT_FLOAT_EQ(buffer[0], 0.0f);
+
+    track->setMuted(false);
+    track->setArmed(true);
+    EXPECT_FLOAT_EQ(track->renderBlock(0, 64, 44100, buffer.data(), eq), 0.0f);
+    EXPECT_FLOAT_EQ(buffer[0], 0.0f);
+}
+
+// Test that the track EQ is applied: a low shelf boost lifts a constant signal by its gain
+TEST(StemExporterTests, RenderBlockAppliesTrackEQ) {
+    auto track = makeTrack(L"Bass", 0.1f, 1.0);
+    track->setEQLow(6.0f);
+
+    TrackEQ eq;
+    std::vector<float> buffer(4096 * 2);
+    for (size_t start = 0; start < 8 * 4096; start += 4096) {
+        track->renderBlock(start, 4096, 44100, buffer.data(), eq);
+    }
+    float expected = 0.1f * std::pow(10.0f, 6.0f / 20.0f);
+    EXPECT_NEAR(buffer[4095 * 2], expected, 1e-3f);
+    EXPECT_NEAR(buffer[4095 * 2 + 1], expected, 1e-3f);
+}
+
+// Test exporting stems plus master mix in one pass
+TEST(StemExporterTests, ExportsStemsAndMaster) {
+    std::vector<std::shared_ptr<Track>> tracks = {
+        makeTrack(L"Drums", 0.25f, 1.0),
+        makeTrack(L"Bass", 0.125f, 0.5),
+        makeTrack(L"Muted", 0.5f, 1.0),
+    };
+    tracks[2]->setMuted(true);
+
+    StemExporter::Options options;
+    options.directory = tempDirectory();
+    options.baseName = L"Export";
+    options.duration = 1.0;
+    options.workerThreads = 2;
+    options.blockFrames = 1000;  // Not a divisor of the length, exercises the partial last block
+
+    auto result = StemExporter::exportStems(tracks, options);
+    ASSERT_TRUE(result.success);
+    ASSERT_EQ(result.files.size(), 3u);  // Two stems + master (muted track skipped)
+
+    AudioClip drums, bass, master;
+    ASSERT_TRUE(drums.loadFromFile(result.files[0]));
+    ASSERT_TRUE(bass.loadFromFile(result.files[1]));
+    ASSERT_TRUE(master.loadFromFile(result.files[2]));
+    EXPECT_EQ(master.getSampleCount(), 44100u);
+
+    const float tolerance = 2.0f / 32768.0f;
+    EXPECT_NEAR(drums.getSamples()[0], 0.25f, tolerance);
+    EXPECT_NEAR(bass.getSamples()[0], 0.125f, tolerance);
+    EXPECT_NEAR(master.getSamples()[0], 0.375f, tolerance);
+
+    // After the bass region ends only the drums remain in the master
+    size_t late = 30000 * 2;
+    EXPECT_NEAR(bass.getSamples()[late], 0.0f, tolerance);
+    EXPECT_NEAR(master.getSamples()[late], 0.25f, tolerance);
+}
+
+// Test that the master runs through the bus EQ with its latency compensated
+TEST(StemExporterTests, MasterEQLatencyCompensated) {
+    std::vector<std::shared_ptr<Track>> tracks = {makeTrack(L"Keys", 0.25f, 0.5)};
+
+    // Halves the level, 300 frames late
+    constexpr size_t LATENCY = 300;
+    auto delay = std::make_shared<std::vector<float>>(LATENCY * 2, 0.0f);
+    auto delayPos = std::make_shared<size_t>(0);
+
+    StemExporter::Options options;
+    options.directory = tempDirectory();
+    options.baseName = L"Delayed";
+    options.duration = 0.5;
+    options.blockFrames = 256;  // Latency spans more than one block
+    options.masterEQ = [delay, delayPos](float* samples, size_t frameCount, int) {
+        for (size_t i = 0; i < frameCount * 2; ++i) {
+            float out = (*delay)[*delayPos];
+            (*delay)[*delayPos] = samples[i] * 0.5f;
+            *delayPos = (*delayPos + 1) % delay->size();
+            samples[i] = out;
+        }
+    };
+    options.masterEQLatencyFrames = LATENCY;
+
+    auto result = StemExporter::exportStems(tracks, options);
+    ASSERT_TRUE(result.success);
+    ASSERT_EQ(result.files.size(), 2u);
+
+    AudioClip stem, master;
+    ASSERT_TRUE(stem.loadFromFile(result.files[0]));
+    ASSERT_TRUE(master.loadFromFile(result.files[1]));
+    EXPECT_EQ(stem.getSampleCount(), 22050u);
+    EXPECT_EQ(master.getSampleCount(), 22050u);
+
+    const float tolerance = 2.0f / 32768.0f;
+    EXPECT_NEAR(master.getSamples()[0], 0.125f, tolerance);
+    EXPECT_NEAR(master.getSamples()[22049 * 2], 0.125f, tolerance);
+}
+
+// Test that track reverbs are rendered into their stem and ring out past the timeline
+TEST(StemExporterTests, TrackReverbRingsOut) {
+    std::vector<std::shared_ptr<Track>> tracks = {makeTrack(L"Snare", 0.25f, 0.5)};
+
+    // A single tap: the wet signal is the input at half level, one head block late
+    ConvolutionReverb& reverb = tracks[0]->getReverb();
+    reverb.setImpulseResponse({0.5f}, {0.5f});
+    reverb.setWetLevel(1.0f);
+    const size_t delay = ConvolutionReverb::HEAD_BLOCK;
+
+    StemExporter::Options options;
+    options.directory = tempDirectory();
+    options.baseName = L"Reverb";
+    options.duration = 0.5;
+    options.blockFrames = 1000;
+
+    auto result = StemExporter::exportStems(tracks, options);
+    ASSERT_TRUE(result.success);
+
+    AudioClip stem, master;
+    ASSERT_TRUE(stem.loadFromFile(result.files[0]));
+    ASSERT_TRUE(master.loadFromFile(result.files[1]));
+    EXPECT_EQ(stem.getSampleCount(), 22050u + reverb.getTailFrames());
+    EXPECT_EQ(master.getSampleCount(), stem.getSampleCount());
+
+    const float tolerance = 2.0f / 32768.0f;
+    EXPECT_NEAR(stem.getSamples()[(delay / 2) * 2], 0.25f, tolerance);
+    EXPECT_NEAR(stem.getSamples()[1000 * 2], 0.375f, tolerance);
+    EXPECT_NEAR(stem.getSamples()[(22050 + delay / 2) * 2], 0.125f, tolerance);
+    EXPECT_NEAR(master.getSamples()[(22050 + delay / 2) * 2], 0.125f, tolerance);
+    EXPECT_NEAR(stem.getSamples()[(22050 + delay) * 2], 0.0f, tolerance);
+}
+
+// Test that nothing is exported when every track is muted
+TEST(StemExporterTests, NoAudibleTracks) {
+    std::vector<std::shared_ptr<Track>> tracks = {makeTrack(L"Muted", 0.5f, 1.0)};
+    tracks[0]->setMuted(true);
+
+    StemExporter::Options options;
+    options.directory = tempDirectory();
+    options.baseName = L"Empty";
+    options.duration = 1.0;
+
+    auto result = StemExporter::exportStems(tracks, options);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.files.empty());
+}
+
+// Test file name sanitizing
+TEST(StemExporterTests, SanitizeFileName) {
+    EXPECT_EQ(StemExporter::sanitizeFileName(L"Vox: Lead/Dbl"), L"Vox_ Lead_Dbl");
+    EXPECT_EQ(StemExporter::sanitizeFileName(L""), L"Track");
+}
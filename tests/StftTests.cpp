@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+#include "../Stft.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+std::vector<float> sine(double cyclesPerSample, size_t count) {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] = static_cast<float>(std::sin(2.0 * 3.14159265358979323846 * cyclesPerSample * i));
+    }
+    return samples;
+}
+
+} // namespace
+
+// Test configs outside the plan sizes or the overlap limit are rejected
+TEST(StftTests, ValidatesConfig) {
+    Stft stft;
+    EXPECT_FALSE(stft.configure({1000, 250, FftPlan::Window::Hann}));
+    EXPECT_FALSE(stft.configure({1024, 2048, FftPlan::Window::Hann}));
+    EXPECT_FALSE(stft.configure({1024, 1024 / Stft::MAX_OVERLAP_FACTOR - 1, FftPlan::Window::Hann}));
+    EXPECT_EQ(stft.getConfig().fftSize, 4096u);
+
+    EXPECT_TRUE(stft.configure({1024, 256, FftPlan::Window::BlackmanHarris}));
+    EXPECT_EQ(stft.getBinCount(), 513u);
+}
+
+// Test one frame per hop, identical however the input is chunked
+TEST(StftTests, FramesIndependentOfBlockSize) {
+    const Stft::Config config{1024, 256, FftPlan::Window::Hann};
+    auto input = sine(0.013, 5000);
+
+    Stft whole;
+    ASSERT_TRUE(whole.configure(config));
+    std::vector<std::vector<float>> expected;
+    whole.process(input.data(), input.size(), [&](const float* magnitudes) {
+        expected.emplace_back(magnitudes, magnitudes + whole.getBinCount());
+    });
+    EXPECT_EQ(expected.size(), input.size() / config.hop);
+
+    Stft chunked;
+    ASSERT_TRUE(chunked.configure(config));
+    size_t frame = 0;
+    const size_t chunkSizes[] = {1, 37, 256, 511, 1300};
+    for (size_t offset = 0, i = 0; offset < input.size(); ++i) {
+        size_t count = std::min(chunkSizes[i % 5], input.size() - offset);
+        chunked.process(input.data() + offset, count, [&](const float* magnitudes) {
+            ASSERT_LT(frame, expected.size());
+            for (size_t bin = 0; bin < chunked.getBinCount(); ++bin) {
+                EXPECT_FLOAT_EQ(magnitudes[bin], expected[frame][bin]);
+            }
+            ++frame;
+        });
+        offset += count;
+    }
+    EXPECT_EQ(frame, expected.size());
+}
+
+// Test a full-scale bin-centred sine reads 1.0 with every window
+TEST(StftTests, MagnitudeScale) {
+    auto input = sine(64.0 / 2048.0, 2048);
+    for (auto window : {FftPlan::Window::Rectangular, FftPlan::Window::Hann,
+                        FftPlan::Window::Hamming, FftPlan::Window::BlackmanHarris}) {
+        Stft stft;
+        ASSERT_TRUE(stft.configure({2048, 2048, window}));
+        int frames = 0;
+        stft.process(input.data(), input.size(), [&](const float* magnitudes) {
+            EXPECT_NEAR(magnitudes[64], 1.0f, 0.01f);
+            EXPECT_LT(magnitudes[300], 0.01f);
+            ++frames;
+        });
+        EXPECT_EQ(frames, 1);
+    }
+}
@@ -142,3 +142,19 @@ TEST(ProjectTest, HasAudioLoaded) {
 TEST(ProjectTest, FileExtension) {
     EXPECT_STREQ(Project::FILE_EXTENSION, L".austd");
 }
+
+// Test registering an already-loaded clip in the cache
+TEST(ProjectTest, AddClipToCache) {
+    Project project;
+    auto clip = std::make_shared<AudioClip>();
+    clip->getSamplesWritable().assign(16, 0.5f);
+
+    project.addClipToCache(L"C:\\Audio\\take.wav", clip);
+    ASSERT_EQ(project.getClipCache().size(), 1u);
+    EXPECT_EQ(project.getOrLoadClip(L"C:\\Audio\\take.wav"), clip);  // No reload
+
+    // Re-registering the same path replaces the entry
+    auto replacement = std::make_shared<AudioClip>();
+    project.addClipToCache(L"C:\\Audio\\take.wav", replacement);
+    EXPECT_EQ(project.getOrLoadClip(L"C:\\Audio\\take.wav"), replacement);
+}